@@ -331,10 +331,20 @@ def bundle_with_fixed_images(
         shot.pose.translation = [s.t[0], s.t[1], s.t[2]]
         shot.covariance = s.get_covariance_inv_param()
 
+    # Errors are flat, one per observation, with 2D errors zero-padded
+    point_errors = defaultdict(dict)
+    observations_ids = ba.get_projection_observations_ids()
+    for (shot_id, point_id), error in zip(
+        observations_ids, ba.get_reprojection_errors()
+    ):
+        camera = reconstruction.shots[shot_id].camera
+        size = 3 if camera.projection_type == "spherical" else 2
+        point_errors[point_id][shot_id] = error[:size]
+
     for point in reconstruction.points.values():
         p = ba.get_point(point.id)
         point.coordinates = [p.p[0], p.p[1], p.p[2]]
-        point.reprojection_errors = p.reprojection_errors
+        point.reprojection_errors = point_errors[point.id]
 
     chrono.lap("teardown")
 
@@ -1,8 +1,10 @@
 # pyre-unsafe
 import logging
 from collections import defaultdict
+from typing import Optional
 
 import numpy as np
+from opensfm import pymap, pysfm
 from opensfm.dataset import DataSet
 from opensfm.large import tools
 from opensfm.large.metadataset import MetaDataSet
@@ -19,17 +21,20 @@ def run_dataset(data: DataSet) -> None:
     meta_data.remove_submodels()
     data.init_reference()
     _create_image_list(data, meta_data)
+    tracks_manager = data.load_tracks_manager() if data.tracks_exists() else None
 
     if meta_data.image_groups_exists():
         _read_image_groups(meta_data)
+        _add_cluster_neighbors(meta_data, data.config["submodel_overlap"])
+    elif data.config["submodel_partition"] == "covisibility":
+        _partition_images(data, meta_data, tracks_manager)
     else:
         _cluster_images(meta_data, data.config["submodel_size"])
-
-    _add_cluster_neighbors(meta_data, data.config["submodel_overlap"])
+        _add_cluster_neighbors(meta_data, data.config["submodel_overlap"])
     _save_clusters_geojson(meta_data)
     _save_cluster_neighbors_geojson(meta_data)
 
-    meta_data.create_submodels(meta_data.load_clusters_with_neighbors())
+    meta_data.create_submodels(meta_data.load_clusters_with_neighbors(), tracks_manager)
 
 
 def _create_image_list(data: DataSet, meta_data) -> None:
@@ -105,6 +110,49 @@ def _cluster_images(meta_data: MetaDataSet, cluster_size: float) -> None:
     meta_data.save_clusters(images, positions, labels, centers)
 
 
+def _partition_images(
+    data: DataSet, meta_data: MetaDataSet, tracks_manager: Optional[pymap.TracksManager]
+) -> None:
+    """Split images into submodels of covisible images, with their overlap.
+
+    Images are connected by their common tracks, so all the images of the
+    tracks are partitioned, with or without GPS. GPS is only used to locate
+    the clusters : images without it are placed at their cluster center.
+    """
+    if tracks_manager is None:
+        raise RuntimeError("Covisibility partition requires the tracks of the dataset")
+    images = sorted(tracks_manager.get_shot_ids())
+    labels, clusters = pysfm.partition_shots(
+        tracks_manager,
+        images,
+        data.config["submodel_size"],
+        data.config["submodel_covisibility_overlap"],
+        data.config["submodel_min_common_tracks"],
+        data.config["processes"],
+    )
+    labels = np.array([labels[image] for image in images])
+
+    gps = {image: [lat, lon] for image, lat, lon in meta_data.images_with_gps()}
+    has_gps = np.array([image in gps for image in images], dtype=bool)
+    positions = np.zeros((len(images), 2), np.float32)
+    for i, image in enumerate(images):
+        if has_gps[i]:
+            positions[i] = gps[image]
+
+    default_center = positions[has_gps].mean(axis=0) if has_gps.any() else np.zeros(2)
+    centers = np.zeros((len(clusters), 2))
+    for label in range(len(clusters)):
+        located = (labels == label) & has_gps
+        if located.any():
+            centers[label] = positions[located].mean(axis=0)
+        else:
+            centers[label] = default_center
+    positions[~has_gps] = centers[labels[~has_gps]]
+
+    meta_data.save_clusters(np.array(images), positions, labels, centers)
+    meta_data.save_clusters_with_neighbors(clusters)
+
+
 def _add_cluster_neighbors(meta_data: MetaDataSet, max_distance) -> None:
     images, positions, labels, centers = meta_data.load_clusters()
     clusters = tools.add_cluster_neighbors(positions, labels, centers, max_distance)
@@ -125,6 +173,8 @@ def _save_cluster_neighbors_geojson(meta_data: MetaDataSet) -> None:
     clusters = meta_data.load_clusters_with_neighbors()
     for cluster_idx, images in enumerate(clusters):
         for image in images:
+            if image not in image_coordinates:
+                continue
             features.append(
                 {
                     "type": "Feature",
@@ -147,6 +197,8 @@ def _save_clusters_geojson(meta_data: MetaDataSet) -> None:
     features = []
     images, positions, labels, centers = meta_data.load_clusters()
     for image, label in zip(images, labels):
+        if image not in image_coordinates:
+            continue
         features.append(
             {
                 "type": "Feature",
@@ -1,5 +1,5 @@
 # pyre-unsafe
-from opensfm import mesh
+from opensfm import pymap
 from opensfm.dataset_base import DataSetBase
 
 
@@ -9,13 +9,8 @@ def run_dataset(data: DataSetBase) -> None:
     tracks_manager = data.load_tracks_manager()
     reconstructions = data.load_reconstruction()
 
-    all_shot_ids = set(tracks_manager.get_shot_ids())
     for r in reconstructions:
-        for shot in r.shots.values():
-            if shot.id in all_shot_ids:
-                vertices, faces = mesh.triangle_mesh(shot.id, r, tracks_manager)
-                shot.mesh.vertices = vertices
-                shot.mesh.faces = faces
+        pymap.compute_shot_meshes(r.map, tracks_manager, data.config["processes"])
 
     data.save_reconstruction(
         reconstructions, filename="reconstruction.meshed.json", minify=True
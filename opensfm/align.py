@@ -60,17 +60,8 @@ def apply_similarity(
     :param A: The rotation matrix (3x3)
     :param b: The translation vector (3)
     """
-    # Align points.
-    for point in reconstruction.points.values():
-        point.coordinates = s * A.dot(point.coordinates) + b
-
-    # Align rig instances
-    for rig_instance in reconstruction.rig_instances.values():
-        apply_similarity_pose(rig_instance.pose, s, A, b)
-
-    # Scale rig cameras
-    for rig_camera in reconstruction.rig_cameras.values():
-        apply_similarity_pose(rig_camera.pose, s, np.eye(3), np.array([0, 0, 0]))
+    # Align points and rig instances, and scale rig cameras
+    reconstruction.map.apply_similarity(s, np.asarray(A), np.asarray(b))
 
 
 def compute_reconstruction_similarity(
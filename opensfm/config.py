@@ -32,6 +32,8 @@ class OpenSfMConfig:
     # Same as above but for panorama images
     feature_process_size_panorama: int = 4096
     feature_use_adaptive_suppression: bool = False
+    # If true, SIFT and HAHOG detect features only once at their lowest threshold, and reduce the threshold over the detected features instead of detecting again.
+    feature_reuse_scale_space: bool = False
     # Bake segmentation info (class and instance) in the feature data. Thus it is done once for all at extraction time.
     features_bake_segmentation: bool = False
 
@@ -82,6 +84,8 @@ class OpenSfMConfig:
     ##################################
     hahog_peak_threshold: float = 0.00001
     hahog_edge_threshold: float = 10
+    # Lowest peak threshold reached when reducing it (only with feature_reuse_scale_space)
+    hahog_min_peak_threshold: float = 0.000001
     hahog_normalize_to_uchar: bool = True
 
     ##################################
@@ -290,6 +294,8 @@ class OpenSfMConfig:
     local_bundle_min_common_points: int = 20
     # Max number of shots to optimize during local bundle adjustment
     local_bundle_max_shots: int = 30
+    # Number of most recent images optimized together by the online sequential reconstruction
+    online_window_size: int = 10
 
     # Save reconstructions at every iteration
     save_partial_reconstructions: bool = False
@@ -357,6 +363,11 @@ class OpenSfMConfig:
     depthmap_min_consistent_views: int = 3
     # Save debug files with partial reconstruction results
     depthmap_save_debug_files: bool = False
+    # Compute PATCH_MATCH depthmaps by tiles of this size, streamed to disk,
+    # to bound memory for very large images. Set to 0 to disable tiling.
+    depthmap_tile_size: int = 0
+    # Margin of each tile, in pixels, over which PatchMatch propagates
+    depthmap_tile_halo: int = 32
 
     ##################################
     # Params for multi-processing/threading
@@ -373,6 +384,15 @@ class OpenSfMConfig:
     submodel_size: int = 80
     # Radius of the overlapping region between submodels
     submodel_overlap: float = 30.0
+    # How images are split into submodels: gps (k-means of the GPS positions)
+    # or covisibility (partition of the graph of images sharing tracks)
+    submodel_partition: str = "gps"
+    # With covisibility partition, number of images added to each submodel
+    # from its neighbors, as a fraction of its size
+    submodel_covisibility_overlap: float = 0.3
+    # With covisibility partition, minimum number of common tracks for two
+    # images to be connected
+    submodel_min_common_tracks: int = 20
     # Relative path to the submodels directory
     submodels_relpath: str = "submodels"
     # Template to generate the relative path to a submodel directory
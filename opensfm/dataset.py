@@ -5,7 +5,7 @@ import logging
 import os
 import pickle
 from io import BytesIO
-from typing import Any, Dict, IO, List, Optional, Tuple
+from typing import Any, Dict, IO, List, Optional, Tuple, Union
 
 import numpy as np
 from numpy.typing import NDArray
@@ -397,16 +397,20 @@ class DataSet(DataSetBase):
     ) -> pymap.TracksManager:
         """Return the tracks manager"""
         with self.io_handler.open_rt(self._tracks_manager_file(filename)) as f:
-            return pymap.TracksManager.instanciate_from_string(f.read())
+            return pymap.TracksManager.instanciate_from_string(
+                f.read(), self.config["processes"]
+            )
 
     def tracks_exists(self, filename: Optional[str] = None) -> bool:
         return self.io_handler.isfile(self._tracks_manager_file(filename))
 
     def save_tracks_manager(
-        self, tracks_manager: pymap.TracksManager, filename: Optional[str] = None
+        self,
+        tracks_manager: Union[pymap.TracksManager, pymap.TracksManagerView],
+        filename: Optional[str] = None,
     ) -> None:
         with self.io_handler.open_wt(self._tracks_manager_file(filename)) as fw:
-            fw.write(tracks_manager.as_string())
+            fw.write(tracks_manager.as_string(self.config["processes"]))
 
     def _reconstruction_file(self, filename: Optional[str]) -> str:
         """Return path of reconstruction file"""
@@ -955,14 +959,16 @@ class UndistortedDataSet:
     def load_undistorted_tracks_manager(self) -> pymap.TracksManager:
         filename = os.path.join(self.data_path, "tracks.csv")
         with self.io_handler.open_rt(filename) as f:
-            return pymap.TracksManager.instanciate_from_string(f.read())
+            return pymap.TracksManager.instanciate_from_string(
+                f.read(), self.config["processes"]
+            )
 
     def save_undistorted_tracks_manager(
         self, tracks_manager: pymap.TracksManager
     ) -> None:
         filename = os.path.join(self.data_path, "tracks.csv")
         with self.io_handler.open_wt(filename) as fw:
-            fw.write(tracks_manager.as_string())
+            fw.write(tracks_manager.as_string(self.config["processes"]))
 
     def load_undistorted_reconstruction(self) -> List[types.Reconstruction]:
         filename = os.path.join(self.data_path, "reconstruction.json")
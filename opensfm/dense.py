@@ -1,5 +1,8 @@
 # pyre-unsafe
+import contextlib
 import logging
+import os
+import tempfile
 import typing as t
 
 import cv2
@@ -109,6 +112,19 @@ def compute_depthmap(arguments):
     de.set_min_patch_sd(data.config["depthmap_min_patch_sd"])
     add_views_to_depth_estimator(data, neighbors, de)
 
+    tile_size = data.config["depthmap_tile_size"]
+    if tile_size > 0 and method in ("PATCH_MATCH", "PATCH_MATCH_SAMPLE"):
+        with compute_depthmap_tiled(
+            de,
+            tile_size,
+            data.config["depthmap_tile_halo"],
+            method == "PATCH_MATCH_SAMPLE",
+        ) as (depth, plane, score, nghbr):
+            save_raw_depthmap(
+                data, neighbors, max_depth, shot, depth, plane, score, nghbr
+            )
+        return
+
     if method == "BRUTE_FORCE":
         depth, plane, score, nghbr = de.compute_brute_force()
     elif method == "PATCH_MATCH":
@@ -120,9 +136,22 @@ def compute_depthmap(arguments):
             "Unknown depthmap method type "
             "(must be BRUTE_FORCE, PATCH_MATCH or PATCH_MATCH_SAMPLE)"
         )
+    save_raw_depthmap(data, neighbors, max_depth, shot, depth, plane, score, nghbr)
 
+
+def save_raw_depthmap(
+    data: UndistortedDataSet,
+    neighbors,
+    max_depth: float,
+    shot,
+    depth: np.ndarray,
+    plane: np.ndarray,
+    score: np.ndarray,
+    nghbr: np.ndarray,
+) -> None:
+    """Filter a computed depthmap in place and save it."""
     good_score = score > data.config["depthmap_min_correlation_score"]
-    depth = depth * (depth < max_depth) * good_score
+    np.multiply(depth, (depth < max_depth) & good_score, out=depth)
 
     # Save and display results
     neighbor_ids = [i.id for i in neighbors[1:]]
@@ -156,6 +185,25 @@ def compute_depthmap(arguments):
         plt.show()
 
 
+@contextlib.contextmanager
+def compute_depthmap_tiled(
+    de: pydense.DepthmapEstimator, tile_size: int, halo: int, sample: bool
+) -> t.Iterator[t.List[np.ndarray]]:
+    """Compute a depthmap tile by tile, streaming the tiles to disk.
+
+    Only the estimator inputs and one tile of results are held in memory
+    while computing. The results are memory-mapped from temporary files,
+    which are removed when leaving the context.
+    """
+    with tempfile.TemporaryDirectory() as tmpdir:
+        prefix = os.path.join(tmpdir, "")
+        de.compute_patch_match_tiled(tile_size, halo, sample, prefix)
+        yield [
+            np.load(prefix + name + ".npy", mmap_mode="r+")
+            for name in ("depth", "plane", "score", "nghbr")
+        ]
+
+
 def clean_depthmap(arguments):
     """Clean depthmap by checking consistency with neighbors."""
     log.setup()
@@ -355,44 +355,99 @@ def _in_mask(point: np.ndarray, width: int, height: int, mask: np.ndarray) -> bo
     return mask[int(v), int(u)] != 0
 
 
-def extract_features_sift(
-    image: np.ndarray, config: Dict[str, Any], features_count: int
-) -> Tuple[np.ndarray, np.ndarray]:
+def _create_sift(config: Dict[str, Any], sift_peak_threshold: float) -> Tuple[Any, Any]:
+    """Create the SIFT detector and descriptor extractor for a peak threshold."""
     sift_edge_threshold = config["sift_edge_threshold"]
-    sift_peak_threshold = float(config["sift_peak_threshold"])
     sift_nfeatures = config["sift_nfeatures"]
     sift_octave_layers = config["sift_octave_layers"]
     sift_sigma = float(config["sift_sigma"])
+    # SIFT support is in cv2 main from version 4.4.0
+    if context.OPENCV44 or context.OPENCV5:
+        detector = cv2.SIFT_create(
+            nfeatures=sift_nfeatures,
+            nOctaveLayers=sift_octave_layers,
+            contrastThreshold=sift_peak_threshold,
+            edgeThreshold=sift_edge_threshold,
+            sigma=sift_sigma,
+        )
+        descriptor = detector
+    elif context.OPENCV3:
+        detector = cv2.xfeatures2d.SIFT_create(
+            nfeatures=sift_nfeatures,
+            nOctaveLayers=sift_octave_layers,
+            contrastThreshold=sift_peak_threshold,
+            edgeThreshold=sift_edge_threshold,
+            sigma=sift_sigma,
+        )
+        descriptor = detector
+    else:
+        detector = cv2.FeatureDetector_create("SIFT")
+        descriptor = cv2.DescriptorExtractor_create("SIFT")
+        detector.setDouble("edgeThreshold", sift_edge_threshold)
+    return detector, descriptor
+
+
+def _select_sift_points(
+    image: np.ndarray,
+    config: Dict[str, Any],
+    features_count: int,
+    sift_peak_threshold: float,
+) -> List[Any]:
+    """Detect SIFT points once at the lowest threshold that the decreasing
+    threshold loop can reach, and lower the threshold over their responses.
+
+    OpenCV rejects the points whose response times the number of octave
+    layers is below the contrast threshold, so selecting the points at a
+    given threshold gives the ones that a detection at that threshold would
+    find, up to their pre-filtering.
+    """
+    min_threshold = sift_peak_threshold
+    while min_threshold > 0.0001:
+        min_threshold = (min_threshold * 2) / 3
+    detector, _ = _create_sift(config, min_threshold)
+    t = time.time()
+    all_points = detector.detect(image)
+    logger.debug(
+        "Found {0} points at threshold {1} in {2}s".format(
+            len(all_points), min_threshold, time.time() - t
+        )
+    )
+
+    contrasts = (
+        np.array([p.response for p in all_points], dtype=np.float64)
+        * config["sift_octave_layers"]
+    )
+    selected = contrasts >= sift_peak_threshold
+    while np.count_nonzero(selected) < features_count and sift_peak_threshold > 0.0001:
+        sift_peak_threshold = (sift_peak_threshold * 2) / 3
+        selected = contrasts >= sift_peak_threshold
+        logger.debug(
+            "Selected {0} points with threshold {1}".format(
+                np.count_nonzero(selected), sift_peak_threshold
+            )
+        )
+    return [p for p, keep in zip(all_points, selected) if keep]
+
+
+def extract_features_sift(
+    image: np.ndarray, config: Dict[str, Any], features_count: int
+) -> Tuple[np.ndarray, np.ndarray]:
+    sift_peak_threshold = float(config["sift_peak_threshold"])
+    reuse_scale_space = config["feature_reuse_scale_space"] and (
+        context.OPENCV3 or context.OPENCV44 or context.OPENCV5
+    )
     while True:
         logger.debug("Computing sift with threshold {0}".format(sift_peak_threshold))
         t = time.time()
-        # SIFT support is in cv2 main from version 4.4.0
-        if context.OPENCV44 or context.OPENCV5:
-            detector = cv2.SIFT_create(
-                nfeatures=sift_nfeatures,
-                nOctaveLayers=sift_octave_layers,
-                contrastThreshold=sift_peak_threshold,
-                edgeThreshold=sift_edge_threshold,
-                sigma=sift_sigma,
-            )
-            descriptor = detector
-        elif context.OPENCV3:
-            detector = cv2.xfeatures2d.SIFT_create(
-                nfeatures=sift_nfeatures,
-                nOctaveLayers=sift_octave_layers,
-                contrastThreshold=sift_peak_threshold,
-                edgeThreshold=sift_edge_threshold,
-                sigma=sift_sigma,
-            )
-            descriptor = detector
-        else:
-            detector = cv2.FeatureDetector_create("SIFT")
-            descriptor = cv2.DescriptorExtractor_create("SIFT")
-            detector.setDouble("edgeThreshold", sift_edge_threshold)
-
+        detector, descriptor = _create_sift(config, sift_peak_threshold)
         points = detector.detect(image)
         logger.debug("Found {0} points in {1}s".format(len(points), time.time() - t))
         if len(points) < features_count and sift_peak_threshold > 0.0001:
+            if reuse_scale_space:
+                points = _select_sift_points(
+                    image, config, features_count, sift_peak_threshold
+                )
+                break
             sift_peak_threshold = (sift_peak_threshold * 2) / 3
             logger.debug("reducing threshold")
         else:
@@ -514,6 +569,11 @@ def extract_features_hahog(
         peak_threshold=config["hahog_peak_threshold"],
         edge_threshold=config["hahog_edge_threshold"],
         target_num_features=features_count,
+        min_peak_threshold=(
+            config["hahog_min_peak_threshold"]
+            if config["feature_reuse_scale_space"]
+            else 0.0
+        ),
     )
 
     if config["feature_root"]:
@@ -6,7 +6,7 @@ import shutil
 import sys
 
 import numpy as np
-from opensfm import config, io
+from opensfm import config, io, pymap
 from opensfm.dataset import DataSet
 
 
@@ -166,7 +166,7 @@ class MetaDataSet:
         for path in paths:
             shutil.rmtree(path)
 
-    def create_submodels(self, clusters):
+    def create_submodels(self, clusters, tracks_manager=None):
         data = DataSet(self.data_path)
         for i, cluster in enumerate(clusters):
             # create sub model dirs
@@ -216,6 +216,12 @@ class MetaDataSet:
             for filepath in filepaths:
                 self._create_symlink(submodel_path, filepath)
 
+            # write the tracks of the submodel images, read in place from
+            # the global ones so that track ids are shared among submodels
+            if tracks_manager is not None:
+                submodel_tracks = pymap.TracksManagerView(tracks_manager, cluster)
+                DataSet(submodel_path).save_tracks_manager(submodel_tracks)
+
     def get_submodel_paths(self):
         submodel_paths = []
         for i in range(999999):
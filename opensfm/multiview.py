@@ -222,63 +222,6 @@ class TestLinearKernel:
         return self.y - model * self.x
 
 
-class PlaneKernel:
-    """
-    A kernel for estimating plane from on-plane points and vectors
-    """
-
-    def __init__(
-        self, points, vectors, verticals, point_threshold=1.0, vector_threshold=5.0
-    ) -> None:
-        self.points = points
-        self.vectors = vectors
-        self.verticals = verticals
-        self.required_samples = 3
-        self.point_threshold = point_threshold
-        self.vector_threshold = vector_threshold
-
-    def num_samples(self) -> int:
-        return len(self.points)
-
-    def sampling(self) -> Dict[str, Any]:
-        samples = {}
-        if len(self.vectors) > 0:
-            samples["points"] = self.points[
-                random.sample(range(len(self.points)), 2), :
-            ]
-            samples["vectors"] = [
-                self.vectors[i] for i in random.sample(range(len(self.vectors)), 1)
-            ]
-        else:
-            samples["points"] = self.points[
-                :, random.sample(range(len(self.points)), 3)
-            ]
-            samples["vectors"] = None
-        return samples
-
-    def fit(self, samples: Dict[str, np.ndarray]) -> List[np.ndarray]:
-        model = fit_plane(samples["points"], samples["vectors"], self.verticals)
-        return [model]
-
-    def evaluate(self, model) -> np.ndarray:
-        # only evaluate on points
-        normal = model[0:3]
-        normal_norm = np.linalg.norm(normal) + 1e-10
-        point_error = np.abs(model.T.dot(homogeneous(self.points).T)) / normal_norm
-        vectors = np.array(self.vectors)
-        vector_norm = np.sum(vectors * vectors, axis=1)
-        vectors = (vectors.T / vector_norm).T
-        vector_error = abs(
-            np.rad2deg(abs(np.arccos(vectors.dot(normal) / normal_norm))) - 90
-        )
-        vector_error[vector_error < self.vector_threshold] = 0.0
-        vector_error[vector_error >= self.vector_threshold] = self.point_threshold + 0.1
-        point_error[point_error < self.point_threshold] = 0.0
-        point_error[point_error >= self.point_threshold] = self.point_threshold + 0.1
-        errors = np.hstack((point_error, vector_error))
-        return errors
-
-
 def fit_plane_ransac(
     points: np.ndarray,
     vectors: np.ndarray,
@@ -286,20 +229,28 @@ def fit_plane_ransac(
     point_threshold: float = 1.2,
     vector_threshold: float = 5.0,
 ) -> TRansacSolution:
-    vectors = np.array([v / math.pi * 180.0 for v in vectors])
-    kernel = PlaneKernel(
+    """Robustly estimate a plane from on-plane points and vectors.
+
+    Inliers index the points first, then the vectors. Vectors are inliers
+    when their angle to the plane is below vector_threshold degrees.
+    """
+    points = np.asarray(points, dtype=float)
+    vectors = np.asarray(vectors, dtype=float).reshape(-1, 3)
+    params = pyrobust.RobustEstimatorParams()
+    result = pyrobust.ransac_plane(
         points - points.mean(axis=0),
         vectors,
-        verticals,
         point_threshold,
         vector_threshold,
+        params,
+        pyrobust.RansacType.RANSAC,
     )
-    p, inliers, error = ransac(kernel, point_threshold)
+    inliers = np.array(result.inliers_indices, dtype=int)
+    error = (len(points) + len(vectors) - len(inliers)) * point_threshold
+
     num_point = points.shape[0]
     points_inliers = points[inliers[inliers < num_point], :]
-    vectors_inliers = np.array(
-        [vectors[i - num_point] for i in inliers[inliers >= num_point]]
-    )
+    vectors_inliers = vectors[inliers[inliers >= num_point] - num_point, :]
     p = fit_plane(
         points_inliers - points_inliers.mean(axis=0), vectors_inliers, verticals
     )
@@ -391,39 +342,28 @@ def fit_similarity_transform(
     p1: np.ndarray, p2: np.ndarray, max_iterations: int = 1000, threshold: float = 1
 ) -> Tuple[np.ndarray, np.ndarray]:
     """Fit a similarity transform T such as p2 = T . p1 between two points sets p1 and p2"""
-    # TODO (Yubin): adapt to RANSAC class
-
-    num_points, dim = p1.shape[0:2]
+    dim = p1.shape[1]
 
     assert p1.shape[0] == p2.shape[0]
 
-    best_inliers = []
-    best_T = np.array((3, 4))
-    for _ in range(max_iterations):
-        rnd = np.random.permutation(num_points)
-        rnd = rnd[0:dim]
-
-        T = tf.affine_matrix_from_points(p1[rnd, :].T, p2[rnd, :].T, shear=False)
-        p1h = homogeneous(p1)
-        p2h = homogeneous(p2)
-
-        errors = np.sqrt(np.sum((p2h.T - np.dot(T, p1h.T)) ** 2, axis=0))
-        inliers = np.argwhere(errors < threshold)[:, 0]
-        if len(inliers) >= len(best_inliers):
-            best_T = T.copy()
-            best_inliers = np.argwhere(errors < threshold)[:, 0]
+    params = pyrobust.RobustEstimatorParams()
+    params.iterations = max_iterations
+    result = pyrobust.ransac_similarity(
+        p1, p2, threshold, params, pyrobust.RansacType.RANSAC
+    )
+    best_T = result.lo_model
+    best_inliers = np.array(result.inliers_indices, dtype=int)
 
     # Estimate similarity transform with inliers
     if len(best_inliers) > dim + 3:
         best_T = tf.affine_matrix_from_points(
             p1[best_inliers, :].T, p2[best_inliers, :].T, shear=False
         )
+        p1h = homogeneous(p1)
+        p2h = homogeneous(p2)
         errors = np.sqrt(np.sum((p2h.T - np.dot(best_T, p1h.T)) ** 2, axis=0))
         best_inliers = np.argwhere(errors < threshold)[:, 0]
 
-    # pyre-fixme[7]: Expected `Tuple[ndarray[typing.Any, typing.Any],
-    #  ndarray[typing.Any, typing.Any]]` but got `Tuple[ndarray[typing.Any,
-    #  typing.Any], Union[List[typing.Any], ndarray[typing.Any, dtype[typing.Any]]]]`.
     return best_T, best_inliers
 
 
@@ -64,6 +64,12 @@ def log_bundle_stats(bundle_type: str, bundle_report: Dict[str, Any]) -> None:
 
     logger.info(msg)
 
+    memory = bundle_report.get("memory_usage")
+    if memory:
+        logger.debug(
+            f"{bundle_type} bundle memory estimate: {memory['total'] / 1e6:.1f} MB"
+        )
+
 
 def bundle(
     reconstruction: types.Reconstruction,
@@ -1186,25 +1192,22 @@ def retriangulate(
     return report
 
 
-def get_error_distribution(points: Dict[str, pymap.Landmark]) -> Tuple[float, float]:
-    all_errors = []
-    for track in points.values():
-        all_errors += track.reprojection_errors.values()
-    robust_mean = np.median(all_errors, axis=0)
-    robust_std = 1.486 * np.median(
-        np.linalg.norm(np.array(all_errors) - robust_mean, axis=1)
-    )
+def get_error_distribution(errors: np.ndarray) -> Tuple[float, float]:
+    """Robust mean and deviation of reprojection errors, one per row."""
+    robust_mean = np.median(errors, axis=0)
+    robust_std = 1.486 * np.median(np.linalg.norm(errors - robust_mean, axis=1))
     return robust_mean, robust_std
 
 
 def get_actual_threshold(
-    config: Dict[str, Any], points: Dict[str, pymap.Landmark]
+    config: Dict[str, Any], reconstruction: types.Reconstruction
 ) -> float:
     filter_type = config["bundle_outlier_filtering_type"]
     if filter_type == "FIXED":
         return config["bundle_outlier_fixed_threshold"]
     elif filter_type == "AUTO":
-        mean, std = get_error_distribution(points)
+        _, _, errors = reconstruction.map.get_reprojection_errors()
+        mean, std = get_error_distribution(errors)
         return config["bundle_outlier_auto_ratio"] * np.linalg.norm(mean + std)
     else:
         return 1.0
@@ -1220,21 +1223,19 @@ def remove_outliers(
     A list of point ids to be processed can be given in ``points``.
     """
     if points is None:
-        points = reconstruction.points
-    threshold_sqr = get_actual_threshold(config, reconstruction.points) ** 2
-    outliers = []
-    for point_id in points:
-        for shot_id, error in reconstruction.points[
-            point_id
-        ].reprojection_errors.items():
-            error_sqr = error[0] ** 2 + error[1] ** 2
-            if error_sqr > threshold_sqr:
-                outliers.append((point_id, shot_id))
+        point_ids, shot_ids, errors = reconstruction.map.get_reprojection_errors()
+    else:
+        point_ids, shot_ids, errors = reconstruction.map.get_reprojection_errors(
+            list(points)
+        )
+    threshold_sqr = get_actual_threshold(config, reconstruction) ** 2
+    errors_sqr = np.sum(errors[:, :2] ** 2, axis=1)
+    outliers = np.flatnonzero(errors_sqr > threshold_sqr)
 
     track_ids = set()
-    for track, shot_id in outliers:
-        reconstruction.map.remove_observation(shot_id, track)
-        track_ids.add(track)
+    for i in outliers:
+        reconstruction.map.remove_observation(shot_ids[i], point_ids[i])
+        track_ids.add(point_ids[i])
 
     for track in track_ids:
         if track in reconstruction.points:
@@ -1291,18 +1292,9 @@ def merge_two_reconstructions(
     threshold: float = 1,
 ) -> List[types.Reconstruction]:
     """Merge two reconstructions with common tracks IDs."""
-    common_tracks = list(set(r1.points) & set(r2.points))
-    worked, T, inliers = align_two_reconstruction(r1, r2, common_tracks, threshold)
-
-    if T and worked and len(inliers) >= 10:
-        s, A, b = multiview.decompose_similarity_transform(T)
-        r1p = r1
-        apply_similarity(r1p, s, A, b)
-        r = r2
-        r.shots.update(r1p.shots)
-        r.points.update(r1p.points)
-        align_reconstruction(r, [], config)
-        return [r]
+    if pysfm.merge_two_maps(r1.map, r2.map, threshold, config["processes"]):
+        align_reconstruction(r2, [], config)
+        return [r2]
     else:
         return [r1, r2]
 
@@ -1311,33 +1303,18 @@ def merge_reconstructions(
     reconstructions: List[types.Reconstruction], config: Dict[str, Any]
 ) -> List[types.Reconstruction]:
     """Greedily merge reconstructions with common tracks."""
-    num_reconstruction = len(reconstructions)
-    ids_reconstructions = np.arange(num_reconstruction)
-    remaining_reconstruction = ids_reconstructions
+    groups = pysfm.merge_maps(
+        [r.map for r in reconstructions], num_threads=config["processes"]
+    )
+
     reconstructions_merged = []
     num_merge = 0
-
-    for i, j in combinations(ids_reconstructions, 2):
-        if (i in remaining_reconstruction) and (j in remaining_reconstruction):
-            r = merge_two_reconstructions(
-                reconstructions[i], reconstructions[j], config
-            )
-            if len(r) == 1:
-                remaining_reconstruction = list(set(remaining_reconstruction) - {i, j})
-                for k in remaining_reconstruction:
-                    rr = merge_two_reconstructions(r[0], reconstructions[k], config)
-                    if len(r) == 2:
-                        break
-                    else:
-                        r = rr
-                        remaining_reconstruction = list(
-                            set(remaining_reconstruction) - {k}
-                        )
-                reconstructions_merged.append(r[0])
-                num_merge += 1
-
-    for k in remaining_reconstruction:
-        reconstructions_merged.append(reconstructions[k])
+    for group in groups:
+        r = reconstructions[group[0]]
+        if len(group) > 1:
+            align_reconstruction(r, [], config)
+            num_merge += 1
+        reconstructions_merged.append(r)
 
     logger.info("Merged {0} reconstructions".format(num_merge))
 
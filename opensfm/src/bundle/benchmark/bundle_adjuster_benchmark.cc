@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include <bundle/bundle_adjuster.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+
+namespace {
+
+/* Synthetic sequence : shots along the X axis looking forward (Z), with
+ * points on a wall in front of them. Each point is seen by the shots at
+ * most 'visibility' meters away. Poses and points are perturbed, so that the
+ * adjustment has actual work to do. */
+void SetupSequenceProblem(int shots_count, bundle::BundleAdjuster* ba) {
+  constexpr int points_per_meter = 200;
+  constexpr double visibility = 2.0;
+
+  std::mt19937 gen(42);
+  std::normal_distribution<> noise(0.0, 0.01);
+  std::uniform_real_distribution<> rand(0.0, 1.0);
+
+  const auto camera = geometry::Camera::CreatePerspectiveCamera(1.0, 0.0, 0.0);
+  ba->AddCamera("camera", camera, camera, false);
+  ba->AddRigCamera("rig_camera", geometry::Pose(), geometry::Pose(), true);
+
+  std::vector<geometry::Pose> poses;
+  for (int i = 0; i < shots_count; ++i) {
+    const auto shot_id = std::to_string(i);
+    geometry::Pose pose;
+    pose.SetOrigin(Vec3d(i, 0.0, 0.0));
+    poses.push_back(pose);
+
+    const geometry::Pose noisy(Vec3d(noise(gen), noise(gen), noise(gen)),
+                               pose.TranslationWorldToCamera() +
+                                   Vec3d(noise(gen), noise(gen), noise(gen)));
+    ba->AddRigInstance(shot_id, noisy, {{shot_id, "camera"}},
+                       {{shot_id, "rig_camera"}}, i == 0);
+  }
+  if (shots_count > 1) {
+    ba->AddRigInstancePositionPrior("1", Vec3d(1.0, 0.0, 0.0),
+                                    Vec3d::Constant(0.1), "");
+  }
+
+  const int points_count = shots_count * points_per_meter;
+  for (int i = 0; i < points_count; ++i) {
+    const auto point_id = "p" + std::to_string(i);
+    const Vec3d point(rand(gen) * shots_count, rand(gen) - 0.5,
+                      5.0 + rand(gen));
+    ba->AddPoint(point_id,
+                 point + Vec3d(noise(gen), noise(gen), noise(gen)), false);
+
+    for (int j = 0; j < shots_count; ++j) {
+      if (std::abs(point[0] - j) > visibility) {
+        continue;
+      }
+      const Vec2d projection =
+          camera.Project(poses[j].TransformWorldToCamera(point));
+      ba->AddPointProjectionObservation(std::to_string(j), point_id,
+                                        projection, 0.001);
+    }
+  }
+}
+
+void BM_BundleAdjusterRun(benchmark::State& state) {
+  for (auto _ : state) {
+    bundle::BundleAdjuster ba;
+    SetupSequenceProblem(state.range(0), &ba);
+    ba.SetMaxNumIterations(10);
+    ba.SetUseAnalyticDerivatives(state.range(1));
+    ba.Run();
+    benchmark::DoNotOptimize(ba.GetRigInstance("0"));
+  }
+}
+
+BENCHMARK(BM_BundleAdjusterRun)
+    ->ArgNames({"shots", "analytic"})
+    ->ArgsProduct({{10, 100, 500}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+#include <bundle/error/projection_errors.h>
+
+#include <memory>
+
+namespace {
+
+template <class CAMERA>
+struct CameraTraits;
+
+#define OPENSFM_CAMERA_TRAITS(CAMERA, TYPE)                             \
+  template <>                                                           \
+  struct CameraTraits<geometry::CAMERA> {                               \
+    static constexpr geometry::ProjectionType Type =                    \
+        geometry::ProjectionType::TYPE;                                 \
+  };
+
+OPENSFM_CAMERA_TRAITS(PerspectiveCamera, PERSPECTIVE)
+OPENSFM_CAMERA_TRAITS(BrownCamera, BROWN)
+OPENSFM_CAMERA_TRAITS(FisheyeCamera, FISHEYE)
+OPENSFM_CAMERA_TRAITS(FisheyeOpencvCamera, FISHEYE_OPENCV)
+OPENSFM_CAMERA_TRAITS(Fisheye62Camera, FISHEYE62)
+OPENSFM_CAMERA_TRAITS(Fisheye624Camera, FISHEYE624)
+OPENSFM_CAMERA_TRAITS(RadialCamera, RADIAL)
+OPENSFM_CAMERA_TRAITS(SimpleRadialCamera, SIMPLE_RADIAL)
+OPENSFM_CAMERA_TRAITS(DualCamera, DUAL)
+#undef OPENSFM_CAMERA_TRAITS
+
+// Parameters and jacobians storage shared by all the benchmarks below
+template <class CAMERA>
+struct ProjectionData {
+  ProjectionData() {
+    for (int i = 0; i < CAMERA::Size; ++i) {
+      camera[i] = 0.01 * (i + 1);
+    }
+    camera[0] = 0.3;
+  }
+
+  Vec2d observed{0.1, -0.2};
+  double camera[CAMERA::Size];
+  double rig_instance[6] = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6};
+  double rig_camera[6] = {0., 0., 0., 0., 0., 0.};
+  double point[3] = {1.0, 2.0, 3.0};
+
+  double residuals[3];
+  double jac_camera[3 * CAMERA::Size];
+  double jac_rig_instance[3 * 6];
+  double jac_rig_camera[3 * 6];
+  double jac_point[3 * 3];
+};
+
+// Runtime-dispatched error, as used before camera-specialized errors
+template <class CAMERA>
+void BM_ReprojectionError2DDispatched(benchmark::State& state) {
+  ProjectionData<CAMERA> d;
+  bundle::ReprojectionError2DAnalytic<CAMERA::Size> error(
+      CameraTraits<CAMERA>::Type, d.observed, 1.0, false);
+  const double* params[] = {d.camera, d.rig_instance, d.rig_camera, d.point};
+  double* jacobians[] = {d.jac_camera, d.jac_rig_instance, d.jac_rig_camera,
+                         d.jac_point};
+  for (auto _ : state) {
+    error.Evaluate(params, d.residuals, jacobians);
+    benchmark::DoNotOptimize(d.residuals);
+  }
+}
+
+template <class CAMERA>
+void BM_ReprojectionError2DAnalyticRig(benchmark::State& state) {
+  ProjectionData<CAMERA> d;
+  bundle::ReprojectionError2DAnalyticRig<CAMERA> error(d.observed, 1.0);
+  const double* params[] = {d.camera, d.rig_instance, d.rig_camera, d.point};
+  double* jacobians[] = {d.jac_camera, d.jac_rig_instance, d.jac_rig_camera,
+                         d.jac_point};
+  for (auto _ : state) {
+    error.Evaluate(params, d.residuals, jacobians);
+    benchmark::DoNotOptimize(d.residuals);
+  }
+}
+
+template <class CAMERA>
+void BM_ReprojectionError2DAnalyticNoRig(benchmark::State& state) {
+  ProjectionData<CAMERA> d;
+  bundle::ReprojectionError2DAnalyticNoRig<CAMERA> error(d.observed, 1.0);
+  const double* params[] = {d.camera, d.rig_instance, d.point};
+  double* jacobians[] = {d.jac_camera, d.jac_rig_instance, d.jac_point};
+  for (auto _ : state) {
+    error.Evaluate(params, d.residuals, jacobians);
+    benchmark::DoNotOptimize(d.residuals);
+  }
+}
+
+template <class CAMERA>
+void BM_ReprojectionError2DAutoDiffNoRig(benchmark::State& state) {
+  ProjectionData<CAMERA> d;
+  std::unique_ptr<ceres::CostFunction> error(
+      bundle::ReprojectionError2DNoRig<CAMERA>::Create(d.observed, 1.0));
+  const double* params[] = {d.camera, d.rig_instance, d.point};
+  double* jacobians[] = {d.jac_camera, d.jac_rig_instance, d.jac_point};
+  for (auto _ : state) {
+    error->Evaluate(params, d.residuals, jacobians);
+    benchmark::DoNotOptimize(d.residuals);
+  }
+}
+
+void BM_ReprojectionError3DDispatched(benchmark::State& state) {
+  ProjectionData<geometry::SphericalCamera> d;
+  bundle::ReprojectionError3DAnalytic error(
+      geometry::ProjectionType::SPHERICAL, d.observed, 1.0, false);
+  const double* params[] = {d.camera, d.rig_instance, d.rig_camera, d.point};
+  double* jacobians[] = {d.jac_camera, d.jac_rig_instance, d.jac_rig_camera,
+                         d.jac_point};
+  for (auto _ : state) {
+    error.Evaluate(params, d.residuals, jacobians);
+    benchmark::DoNotOptimize(d.residuals);
+  }
+}
+
+void BM_ReprojectionError3DAnalyticNoRig(benchmark::State& state) {
+  ProjectionData<geometry::SphericalCamera> d;
+  bundle::ReprojectionError3DAnalyticNoRig error(d.observed, 1.0);
+  const double* params[] = {d.rig_instance, d.point};
+  double* jacobians[] = {d.jac_rig_instance, d.jac_point};
+  for (auto _ : state) {
+    error.Evaluate(params, d.residuals, jacobians);
+    benchmark::DoNotOptimize(d.residuals);
+  }
+}
+
+#define OPENSFM_PROJECTION_BENCHMARKS(CAMERA)                                 \
+  BENCHMARK_TEMPLATE(BM_ReprojectionError2DDispatched, geometry::CAMERA);    \
+  BENCHMARK_TEMPLATE(BM_ReprojectionError2DAnalyticRig, geometry::CAMERA);   \
+  BENCHMARK_TEMPLATE(BM_ReprojectionError2DAnalyticNoRig, geometry::CAMERA); \
+  BENCHMARK_TEMPLATE(BM_ReprojectionError2DAutoDiffNoRig, geometry::CAMERA);
+
+OPENSFM_PROJECTION_BENCHMARKS(PerspectiveCamera)
+OPENSFM_PROJECTION_BENCHMARKS(BrownCamera)
+OPENSFM_PROJECTION_BENCHMARKS(FisheyeCamera)
+OPENSFM_PROJECTION_BENCHMARKS(FisheyeOpencvCamera)
+OPENSFM_PROJECTION_BENCHMARKS(Fisheye62Camera)
+OPENSFM_PROJECTION_BENCHMARKS(Fisheye624Camera)
+OPENSFM_PROJECTION_BENCHMARKS(RadialCamera)
+OPENSFM_PROJECTION_BENCHMARKS(SimpleRadialCamera)
+OPENSFM_PROJECTION_BENCHMARKS(DualCamera)
+#undef OPENSFM_PROJECTION_BENCHMARKS
+
+BENCHMARK(BM_ReprojectionError3DDispatched);
+BENCHMARK(BM_ReprojectionError3DAnalyticNoRig);
+
+}  // namespace
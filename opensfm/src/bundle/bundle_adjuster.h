@@ -6,6 +6,7 @@
 #include <bundle/data/point.h>
 #include <bundle/data/pose.h>
 #include <bundle/data/shot.h>
+#include <foundation/memory_usage.h>
 #include <foundation/optional.h>
 #include <geometry/camera.h>
 #include <geometry/pose.h>
@@ -164,6 +165,10 @@ struct LinearMotion {
   double orientation_std_deviation;
 };
 
+// Robust loss from its configuration name, or nullptr (the trivial loss for
+// ceres) for unknown names. The caller owns the returned loss.
+ceres::LossFunction *CreateLossFunction(std::string name, double threshold);
+
 class BundleAdjuster {
  public:
   BundleAdjuster();
@@ -248,6 +253,7 @@ class BundleAdjuster {
 
   void SetMaxNumIterations(int miter);
   void SetNumThreads(int n);
+  int GetNumThreads() const { return num_threads_; }
   void SetUseAnalyticDerivatives(bool use);
   void SetLinearSolverType(std::string t);
   void SetCovarianceAlgorithmType(std::string t);
@@ -267,6 +273,11 @@ class BundleAdjuster {
   void ComputeCovariances(ceres::Problem *problem);
   void ComputeReprojectionErrors();
 
+  // Reprojection errors, indexed as the point projection observations
+  const std::vector<VecMax3d> &GetReprojectionErrors() const;
+  const std::vector<PointProjectionObservation>
+      &GetPointProjectionObservations() const;
+
   // Getters
   int GetProjectionsCount() const;
   int GetRelativeMotionsCount() const;
@@ -284,6 +295,14 @@ class BundleAdjuster {
   std::string BriefReport() const;
   std::string FullReport() const;
 
+  // Wall time (in seconds) spent building and releasing the Ceres problem
+  double GetProblemSetupTime() const;
+  double GetProblemTeardownTime() const;
+
+  // Memory used by the problem data, and estimate of the memory used by the
+  // residual blocks and the Ceres problem once built by Run
+  foundation::MemoryUsage MemoryUsage() const;
+
  private:
   // default sigmas
   geometry::Camera GetDefaultCameraSigma(const geometry::Camera &camera) const;
@@ -305,6 +324,7 @@ class BundleAdjuster {
 
   // reprojection observation
   std::vector<PointProjectionObservation> point_projection_observations_;
+  std::vector<VecMax3d> reprojection_errors_;
   std::map<std::string, std::shared_ptr<HeatmapInterpolator>> heatmaps_;
 
   // relative motion between shots
@@ -356,5 +376,7 @@ class BundleAdjuster {
 
   // internal
   ceres::Solver::Summary last_run_summary_;
+  double problem_setup_time_{0.};
+  double problem_teardown_time_{0.};
 };
 }  // namespace bundle
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <foundation/memory_usage.h>
 #include <foundation/optional.h>
 #include <foundation/types.h>
 
@@ -12,6 +13,7 @@ namespace bundle {
 struct DataNode {
   explicit DataNode(const std::string &id) : id_(id) {}
   std::string GetID() const { return id_; }
+  size_t HeapBytes() const { return foundation::memory::HeapBytes(id_); }
 
  protected:
   std::string id_;
@@ -28,6 +30,7 @@ struct Data : public DataNode {
   virtual ~Data() {}
 
   VecXd &GetValueData() { return value_data_; }
+  const VecXd &GetValueData() const { return value_data_; }
   T GetValue() const {
     T v = value_;
     DataToValue(value_data_, v);
@@ -73,6 +76,17 @@ struct Data : public DataNode {
     parameters_to_optimize_ = parameters;
   }
 
+  // Heap memory owned by the data, except the one of its value
+  size_t HeapBytes() const {
+    size_t bytes = DataNode::HeapBytes() +
+                   foundation::memory::HeapBytes(value_data_) +
+                   foundation::memory::HeapBytes(parameters_to_optimize_);
+    if (covariance_.HasValue()) {
+      bytes += foundation::memory::HeapBytes(covariance_.Value());
+    }
+    return bytes;
+  }
+
   virtual void ValueToData(const T &value, VecXd &data) const = 0;
   virtual void DataToValue(const VecXd &data, T &value) const = 0;
 
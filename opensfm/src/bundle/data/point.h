@@ -19,7 +19,6 @@ struct Point : public Data<Vec3d> {
     Init();
   }
 
-  std::map<std::string, VecXd> reprojection_errors;
   bool has_altitude_prior{true};
 
  private:
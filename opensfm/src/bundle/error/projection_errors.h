@@ -6,6 +6,7 @@
 #include <foundation/types.h>
 #include <geometry/functions.h>
 
+#include <algorithm>
 #include <unordered_set>
 
 #include "foundation/optional.h"
@@ -373,4 +374,362 @@ class ReprojectionError3DAnalytic
     return true;
   }
 };
+
+/* Reprojection errors specialized at compile-time on the camera model. As
+ * opposed to the errors above, no projection type dispatch happens while
+ * evaluating and the rig camera block is only part of the residual when it
+ * is actually useful (RIG_CAMERA = true). The non-rig variants drop it
+ * altogether, shrinking the jacobians Ceres has to evaluate and store. */
+class StaticReprojectionError {
+ public:
+  StaticReprojectionError(const Vec2d& observed, double std_deviation)
+      : observed_(observed), scale_(1.0 / std_deviation) {}
+
+ protected:
+  const Vec2d observed_;
+  const double scale_;
+};
+
+/* Copy the [offset, offset + BlockSize[ columns of a row-major jacobian of
+ * stride Stride into a Ceres jacobian block, while applying the scale. */
+template <int Size, int BlockSize, int Stride>
+void UnfoldJacobianBlock(const double* jacobian, int offset, double scale,
+                         double* block) {
+  if (!block) {
+    return;
+  }
+  for (int i = 0; i < Size; ++i) {
+    for (int j = 0; j < BlockSize; ++j) {
+      block[i * BlockSize + j] = scale * jacobian[i * Stride + offset + j];
+    }
+  }
+}
+
+template <class CAMERA>
+class ReprojectionError2DRig : public StaticReprojectionError {
+ public:
+  using StaticReprojectionError::StaticReprojectionError;
+  constexpr static int Size = 2;
+
+  template <typename T>
+  bool operator()(const T* const camera, const T* const rig_instance,
+                  const T* const rig_camera, const T* const point,
+                  T* residuals) const {
+    T scale_one = T(1.0);
+    T camera_point[3];
+    WorldToCameraCoordinatesRig(&scale_one, rig_instance, rig_camera, point,
+                                &camera_point[0]);
+
+    T predicted[2];
+    CAMERA::Forward(&camera_point[0], camera, &predicted[0]);
+
+    residuals[0] = T(scale_) * (predicted[0] - T(observed_[0]));
+    residuals[1] = T(scale_) * (predicted[1] - T(observed_[1]));
+    return true;
+  }
+
+  using CostFunction =
+      ceres::AutoDiffCostFunction<ReprojectionError2DRig, Size, CAMERA::Size,
+                                  6, 6, 3>;
+  static ceres::CostFunction* Create(const Vec2d& observed,
+                                     double std_deviation) {
+    return new CostFunction(
+        new ReprojectionError2DRig(observed, std_deviation));
+  }
+};
+
+template <class CAMERA>
+class ReprojectionError2DNoRig : public StaticReprojectionError {
+ public:
+  using StaticReprojectionError::StaticReprojectionError;
+  constexpr static int Size = 2;
+
+  template <typename T>
+  bool operator()(const T* const camera, const T* const rig_instance,
+                  const T* const point, T* residuals) const {
+    T scale_one = T(1.0);
+    T camera_point[3];
+    WorldToLocal(&scale_one, rig_instance, point, &camera_point[0]);
+
+    T predicted[2];
+    CAMERA::Forward(&camera_point[0], camera, &predicted[0]);
+
+    residuals[0] = T(scale_) * (predicted[0] - T(observed_[0]));
+    residuals[1] = T(scale_) * (predicted[1] - T(observed_[1]));
+    return true;
+  }
+
+  using CostFunction = ceres::AutoDiffCostFunction<ReprojectionError2DNoRig,
+                                                   Size, CAMERA::Size, 6, 3>;
+  static ceres::CostFunction* Create(const Vec2d& observed,
+                                     double std_deviation) {
+    return new CostFunction(
+        new ReprojectionError2DNoRig(observed, std_deviation));
+  }
+};
+
+/* Parameters blocks are : | camera | rig_instance | rig_camera | point | */
+template <class CAMERA>
+class ReprojectionError2DAnalyticRig
+    : public StaticReprojectionError,
+      public ceres::SizedCostFunction<2, CAMERA::Size, 6, 6, 3> {
+ public:
+  using StaticReprojectionError::StaticReprojectionError;
+  constexpr static int Size = 2;
+
+  bool Evaluate(double const* const* parameters, double* residuals,
+                double** jacobians) const {
+    const double* camera = parameters[0];
+    const double* rig_instance = parameters[1];
+    const double* rig_camera = parameters[2];
+    const double* point = parameters[3];
+
+    constexpr int PointSize = 3;
+    constexpr int PoseSize = 6;
+    constexpr int CameraSize = CAMERA::Size;
+    double predicted[Size];
+
+    if (!jacobians) {
+      double transformed[PointSize];
+      geometry::PoseFunctor::Forward(point, rig_instance, &transformed[0]);
+      geometry::PoseFunctor::Forward(&transformed[0], rig_camera,
+                                     &transformed[0]);
+      CAMERA::Forward(&transformed[0], camera, &predicted[0]);
+    } else {
+      double all_params[PoseSize + PoseSize + CameraSize];
+      std::copy_n(rig_instance, PoseSize, &all_params[0]);
+      std::copy_n(rig_camera, PoseSize, &all_params[PoseSize]);
+      std::copy_n(camera, CameraSize, &all_params[2 * PoseSize]);
+
+      // Jacobian is stored as | point | rig_instance | rig_camera | camera |
+      constexpr int StrideFull = PointSize + CameraSize + 2 * PoseSize;
+      double jacobian[Size * StrideFull];
+      geometry::ProjectRigPoseDerivatives::Apply<CAMERA>(
+          point, &all_params[0], &predicted[0], &jacobian[0]);
+
+      UnfoldJacobianBlock<Size, CameraSize, StrideFull>(
+          jacobian, PointSize + 2 * PoseSize, scale_, jacobians[0]);
+      UnfoldJacobianBlock<Size, PoseSize, StrideFull>(jacobian, PointSize,
+                                                      scale_, jacobians[1]);
+      UnfoldJacobianBlock<Size, PoseSize, StrideFull>(
+          jacobian, PointSize + PoseSize, scale_, jacobians[2]);
+      UnfoldJacobianBlock<Size, PointSize, StrideFull>(jacobian, 0, scale_,
+                                                       jacobians[3]);
+    }
+
+    for (int i = 0; i < Size; ++i) {
+      residuals[i] = scale_ * (predicted[i] - observed_[i]);
+    }
+    return true;
+  }
+};
+
+/* Parameters blocks are : | camera | rig_instance | point | */
+template <class CAMERA>
+class ReprojectionError2DAnalyticNoRig
+    : public StaticReprojectionError,
+      public ceres::SizedCostFunction<2, CAMERA::Size, 6, 3> {
+ public:
+  using StaticReprojectionError::StaticReprojectionError;
+  constexpr static int Size = 2;
+
+  bool Evaluate(double const* const* parameters, double* residuals,
+                double** jacobians) const {
+    const double* camera = parameters[0];
+    const double* rig_instance = parameters[1];
+    const double* point = parameters[2];
+
+    constexpr int PointSize = 3;
+    constexpr int PoseSize = 6;
+    constexpr int CameraSize = CAMERA::Size;
+    double predicted[Size];
+
+    if (!jacobians) {
+      double transformed[PointSize];
+      geometry::PoseFunctor::Forward(point, rig_instance, &transformed[0]);
+      CAMERA::Forward(&transformed[0], camera, &predicted[0]);
+    } else {
+      double all_params[PoseSize + CameraSize];
+      std::copy_n(rig_instance, PoseSize, &all_params[0]);
+      std::copy_n(camera, CameraSize, &all_params[PoseSize]);
+
+      // Jacobian is stored as | point | rig_instance | camera |
+      constexpr int StrideFull = PointSize + CameraSize + PoseSize;
+      double jacobian[Size * StrideFull];
+      geometry::ProjectPoseDerivatives::Apply<CAMERA>(
+          point, &all_params[0], &predicted[0], &jacobian[0]);
+
+      UnfoldJacobianBlock<Size, CameraSize, StrideFull>(
+          jacobian, PointSize + PoseSize, scale_, jacobians[0]);
+      UnfoldJacobianBlock<Size, PoseSize, StrideFull>(jacobian, PointSize,
+                                                      scale_, jacobians[1]);
+      UnfoldJacobianBlock<Size, PointSize, StrideFull>(jacobian, 0, scale_,
+                                                       jacobians[2]);
+    }
+
+    for (int i = 0; i < Size; ++i) {
+      residuals[i] = scale_ * (predicted[i] - observed_[i]);
+    }
+    return true;
+  }
+};
+
+/* Spherical counterparts : the camera has no parameters, so its block is
+ * dropped as well. */
+class StaticReprojectionError3D : public StaticReprojectionError {
+ public:
+  constexpr static int Size = 3;
+
+  StaticReprojectionError3D(const Vec2d& observed, double std_deviation)
+      : StaticReprojectionError(observed, std_deviation) {
+    const double lon = observed[0] * 2 * M_PI;
+    const double lat = -observed[1] * 2 * M_PI;
+    bearing_vector_[0] = std::cos(lat) * std::sin(lon);
+    bearing_vector_[1] = -std::sin(lat);
+    bearing_vector_[2] = std::cos(lat) * std::cos(lon);
+  }
+
+ protected:
+  Vec3d bearing_vector_;
+};
+
+class ReprojectionError3DRig : public StaticReprojectionError3D {
+ public:
+  using StaticReprojectionError3D::StaticReprojectionError3D;
+
+  template <typename T>
+  bool operator()(const T* const rig_instance, const T* const rig_camera,
+                  const T* const point, T* residuals) const {
+    T scale_one = T(1.0);
+    Vec3<T> predicted;
+    WorldToCameraCoordinatesRig(&scale_one, rig_instance, rig_camera, point,
+                                predicted.data());
+    predicted.normalize();
+
+    Eigen::Map<Vec3<T>> residuals_mapped(residuals);
+    residuals_mapped = T(scale_) * (predicted - bearing_vector_.cast<T>());
+    return true;
+  }
+
+  using CostFunction =
+      ceres::AutoDiffCostFunction<ReprojectionError3DRig, Size, 6, 6, 3>;
+  static ceres::CostFunction* Create(const Vec2d& observed,
+                                     double std_deviation) {
+    return new CostFunction(
+        new ReprojectionError3DRig(observed, std_deviation));
+  }
+};
+
+class ReprojectionError3DNoRig : public StaticReprojectionError3D {
+ public:
+  using StaticReprojectionError3D::StaticReprojectionError3D;
+
+  template <typename T>
+  bool operator()(const T* const rig_instance, const T* const point,
+                  T* residuals) const {
+    T scale_one = T(1.0);
+    Vec3<T> predicted;
+    WorldToLocal(&scale_one, rig_instance, point, predicted.data());
+    predicted.normalize();
+
+    Eigen::Map<Vec3<T>> residuals_mapped(residuals);
+    residuals_mapped = T(scale_) * (predicted - bearing_vector_.cast<T>());
+    return true;
+  }
+
+  using CostFunction =
+      ceres::AutoDiffCostFunction<ReprojectionError3DNoRig, Size, 6, 3>;
+  static ceres::CostFunction* Create(const Vec2d& observed,
+                                     double std_deviation) {
+    return new CostFunction(
+        new ReprojectionError3DNoRig(observed, std_deviation));
+  }
+};
+
+/* Parameters blocks are : | rig_instance | rig_camera | point | */
+class ReprojectionError3DAnalyticRig
+    : public StaticReprojectionError3D,
+      public ceres::SizedCostFunction<3, 6, 6, 3> {
+ public:
+  using StaticReprojectionError3D::StaticReprojectionError3D;
+
+  bool Evaluate(double const* const* parameters, double* residuals,
+                double** jacobians) const {
+    const double* rig_instance = parameters[0];
+    const double* rig_camera = parameters[1];
+    const double* point = parameters[2];
+
+    constexpr int PointSize = 3;
+    constexpr int PoseSize = 6;
+    Vec3d transformed;
+
+    if (!jacobians) {
+      geometry::PoseFunctor::Forward(point, rig_instance, transformed.data());
+      geometry::PoseFunctor::Forward(transformed.data(), rig_camera,
+                                     transformed.data());
+      transformed.normalize();
+    } else {
+      double all_params[PoseSize + PoseSize];
+      std::copy_n(rig_instance, PoseSize, &all_params[0]);
+      std::copy_n(rig_camera, PoseSize, &all_params[PoseSize]);
+
+      // Jacobian is stored as | point | rig_instance | rig_camera |
+      constexpr int StrideFull = PointSize + 2 * PoseSize;
+      double jacobian[Size * StrideFull];
+      geometry::RigPoseNormalizedDerivatives::Apply<geometry::SphericalCamera>(
+          point, &all_params[0], transformed.data(), &jacobian[0]);
+
+      UnfoldJacobianBlock<Size, PoseSize, StrideFull>(jacobian, PointSize,
+                                                      scale_, jacobians[0]);
+      UnfoldJacobianBlock<Size, PoseSize, StrideFull>(
+          jacobian, PointSize + PoseSize, scale_, jacobians[1]);
+      UnfoldJacobianBlock<Size, PointSize, StrideFull>(jacobian, 0, scale_,
+                                                       jacobians[2]);
+    }
+
+    for (int i = 0; i < Size; ++i) {
+      residuals[i] = scale_ * (transformed[i] - bearing_vector_[i]);
+    }
+    return true;
+  }
+};
+
+/* Parameters blocks are : | rig_instance | point | */
+class ReprojectionError3DAnalyticNoRig
+    : public StaticReprojectionError3D,
+      public ceres::SizedCostFunction<3, 6, 3> {
+ public:
+  using StaticReprojectionError3D::StaticReprojectionError3D;
+
+  bool Evaluate(double const* const* parameters, double* residuals,
+                double** jacobians) const {
+    const double* rig_instance = parameters[0];
+    const double* point = parameters[1];
+
+    constexpr int PointSize = 3;
+    constexpr int PoseSize = 6;
+    Vec3d transformed;
+
+    if (!jacobians) {
+      geometry::PoseFunctor::Forward(point, rig_instance, transformed.data());
+      transformed.normalize();
+    } else {
+      // Jacobian is stored as | point | rig_instance |
+      constexpr int StrideFull = PointSize + PoseSize;
+      double jacobian[Size * StrideFull];
+      geometry::PoseNormalizedDerivatives::Apply<geometry::SphericalCamera>(
+          point, rig_instance, transformed.data(), &jacobian[0]);
+
+      UnfoldJacobianBlock<Size, PoseSize, StrideFull>(jacobian, PointSize,
+                                                      scale_, jacobians[0]);
+      UnfoldJacobianBlock<Size, PointSize, StrideFull>(jacobian, 0, scale_,
+                                                       jacobians[1]);
+    }
+
+    for (int i = 0; i < Size; ++i) {
+      residuals[i] = scale_ * (transformed[i] - bearing_vector_[i]);
+    }
+    return true;
+  }
+};
 }  // namespace bundle
@@ -25,6 +25,10 @@ __all__ = [
     "ReconstructionAlignment",
     "RelativeMotion",
     "RelativeRotation",
+    "clear_tracing",
+    "get_tracing_events",
+    "is_tracing_enabled",
+    "set_tracing_enabled",
 ]
 
 class BundleAdjuster:
@@ -95,10 +99,15 @@ class BundleAdjuster:
     def get_camera(self, arg0: str) -> opensfm.pygeometry.Camera: ...
     def get_covariance_estimation_valid(self) -> bool: ...
     def get_point(self, arg0: str) -> Point: ...
+    def get_problem_setup_time(self) -> float: ...
+    def get_problem_teardown_time(self) -> float: ...
+    def get_projection_observations_ids(self) -> List[Tuple[str, str]]: ...
     def get_reconstruction(self, arg0: str) -> Reconstruction: ...
+    def get_reprojection_errors(self) -> numpy.ndarray: ...
     def get_rig_camera_pose(self, arg0: str) -> opensfm.pygeometry.Pose: ...
     def get_rig_instance_pose(self, arg0: str) -> opensfm.pygeometry.Pose: ...
     def has_point(self, arg0: str) -> bool: ...
+    def memory_usage(self) -> Dict[str, int]: ...
     def run(self) -> None: ...
     def set_adjust_absolute_position_std(self, arg0: bool) -> None: ...
     def set_compute_covariances(self, arg0: bool) -> None: ...
@@ -128,10 +137,6 @@ class Point:
     def id(self) -> str: ...
     @property
     def p(self) -> numpy.ndarray: ...
-    @property
-    def reprojection_errors(self) -> Dict[str, numpy.ndarray]: ...
-    @reprojection_errors.setter
-    def reprojection_errors(self, arg0: Dict[str, numpy.ndarray]) -> None: ...
 
 class RAReconstruction:
     def __init__(self) -> None: ...
@@ -345,3 +350,8 @@ class RelativeRotation:
     def shot_j(self) -> str: ...
     @shot_j.setter
     def shot_j(self, arg0: str) -> None: ...
+
+def clear_tracing() -> None: ...
+def get_tracing_events() -> str: ...
+def is_tracing_enabled() -> bool: ...
+def set_tracing_enabled(arg0: bool) -> None: ...
@@ -1,11 +1,13 @@
 #include <bundle/bundle_adjuster.h>
 #include <bundle/reconstruction_alignment.h>
 #include <foundation/python_types.h>
+#include <foundation/tracing_bind.h>
 #include <pybind11/eigen.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 PYBIND11_MODULE(pybundle, m) {
+  foundation::AddTracingBindings(m);
   py::module::import("opensfm.pygeometry");
   py::module::import("opensfm.pymap");
 
@@ -38,9 +40,7 @@ PYBIND11_MODULE(pybundle, m) {
       .def_property_readonly(
           "p", [](const bundle::Point &p) { return p.GetValue(); })
       .def_property_readonly("id",
-                             [](const bundle::Point &p) { return p.GetID(); })
-      .def_readwrite("reprojection_errors",
-                     &bundle::Point::reprojection_errors);
+                             [](const bundle::Point &p) { return p.GetID(); });
 
   py::class_<bundle::BundleAdjuster>(m, "BundleAdjuster")
       .def(py::init())
@@ -101,6 +101,27 @@ PYBIND11_MODULE(pybundle, m) {
            &bundle::BundleAdjuster::GetCovarianceEstimationValid)
       .def("set_compute_reprojection_errors",
            &bundle::BundleAdjuster::SetComputeReprojectionErrors)
+      .def("get_reprojection_errors",
+           [](const bundle::BundleAdjuster &ba) {
+             // One row per observation, 2D errors have a zero last column
+             const auto &errors = ba.GetReprojectionErrors();
+             MatX3d flat = MatX3d::Zero(errors.size(), 3);
+             for (size_t i = 0; i < errors.size(); ++i) {
+               flat.row(i).head(errors[i].size()) = errors[i].transpose();
+             }
+             return flat;
+           })
+      .def("get_projection_observations_ids",
+           [](const bundle::BundleAdjuster &ba) {
+             const auto &observations = ba.GetPointProjectionObservations();
+             std::vector<std::pair<std::string, std::string>> ids;
+             ids.reserve(observations.size());
+             for (const auto &observation : observations) {
+               ids.emplace_back(observation.shot->GetID(),
+                                observation.point->GetID());
+             }
+             return ids;
+           })
       .def("set_max_num_iterations",
            &bundle::BundleAdjuster::SetMaxNumIterations)
       .def("set_adjust_absolute_position_std",
@@ -111,7 +132,12 @@ PYBIND11_MODULE(pybundle, m) {
       .def("set_linear_solver_type",
            &bundle::BundleAdjuster::SetLinearSolverType)
       .def("brief_report", &bundle::BundleAdjuster::BriefReport)
-      .def("full_report", &bundle::BundleAdjuster::FullReport);
+      .def("full_report", &bundle::BundleAdjuster::FullReport)
+      .def("get_problem_setup_time",
+           &bundle::BundleAdjuster::GetProblemSetupTime)
+      .def("get_problem_teardown_time",
+           &bundle::BundleAdjuster::GetProblemTeardownTime)
+      .def("memory_usage", &bundle::BundleAdjuster::MemoryUsage);
 
   ///////////////////////////////////
   // Reconstruction Alignment
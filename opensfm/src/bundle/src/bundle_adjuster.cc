@@ -7,10 +7,16 @@
 #include <bundle/error/projection_errors.h>
 #include <bundle/error/relative_depth_error.h>
 #include <bundle/error/relative_motion_errors.h>
+#include <foundation/object_arena.h>
+#include <foundation/tracing.h>
 #include <foundation/types.h>
 
+#include <ceres/version.h>
+
+#include <chrono>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "bundle/data/bias.h"
 
@@ -19,6 +25,23 @@ bool IsRigCameraUseful(bundle::RigCamera &rig_camera) {
   return !(rig_camera.GetParametersToOptimize().empty() &&
            rig_camera.GetValueData().isConstant(0.));
 }
+
+// Auto-differentiated cost function with its functor, both in the arena.
+// AutoDiffCostFunction can only leave its functor alone since Ceres 2.2 :
+// with older versions it owns it, so the functor is heap-allocated there.
+template <class CostFunction, class Functor, class... Args>
+ceres::CostFunction *CreateAutoDiffCostFunction(
+    foundation::ObjectArena *arena, Args &&...args) {
+#if CERES_VERSION_MAJOR > 2 || \
+    (CERES_VERSION_MAJOR == 2 && CERES_VERSION_MINOR >= 2)
+  return arena->Create<CostFunction>(
+      arena->Create<Functor>(std::forward<Args>(args)...),
+      ceres::DO_NOT_TAKE_OWNERSHIP);
+#else
+  return arena->Create<CostFunction>(
+      new Functor(std::forward<Args>(args)...));
+#endif
+}
 }  // namespace
 
 namespace bundle {
@@ -424,10 +447,34 @@ ceres::LossFunction *CreateLossFunction(std::string name, double threshold) {
     return new ceres::CauchyLoss(threshold);
   } else if (name.compare("ArctanLoss") == 0) {
     return new ceres::ArctanLoss(threshold);
+  } else if (name.compare("TukeyLoss") == 0) {
+    return new ceres::TukeyLoss(threshold);
   }
   return nullptr;
 }
 
+/* Loss functions are stateless, so a single instance per (name, threshold)
+ * is shared by all the residual blocks using it, and owned by the arena. */
+class LossFunctionCache {
+ public:
+  explicit LossFunctionCache(foundation::ObjectArena *arena) : arena_(arena) {}
+
+  ceres::LossFunction *Get(const std::string &name, double threshold) {
+    const auto key = std::make_pair(name, threshold);
+    const auto it = losses_.find(key);
+    if (it != losses_.end()) {
+      return it->second;
+    }
+    auto *loss = arena_->Adopt(CreateLossFunction(name, threshold));
+    losses_[key] = loss;
+    return loss;
+  }
+
+ private:
+  foundation::ObjectArena *arena_;
+  std::map<std::pair<std::string, double>, ceres::LossFunction *> losses_;
+};
+
 void BundleAdjuster::AddLinearMotion(const std::string &shot0_id,
                                      const std::string &shot1_id,
                                      const std::string &shot2_id, double alpha,
@@ -443,64 +490,158 @@ void BundleAdjuster::AddLinearMotion(const std::string &shot0_id,
   linear_motion_prior_.push_back(a);
 }
 
+/* Select, at problem-build time, the reprojection error specialized for the
+ * camera model T and for whether the rig camera block is used or not. */
+template <class T, bool RIG_CAMERA>
+struct ProjectionErrorTraits;
+
 template <class T>
-struct ErrorTraits {
-  using Type = ReprojectionError2D;
+struct ProjectionErrorTraits<T, true> {
+  using AutoDiffType = ReprojectionError2DRig<T>;
+  using AnalyticType = ReprojectionError2DAnalyticRig<T>;
+
+  static void AddResidualBlock(const PointProjectionObservation &obs,
+                               ceres::CostFunction *cost_function,
+                               ceres::LossFunction *loss,
+                               ceres::Problem *problem) {
+    problem->AddResidualBlock(cost_function, loss,
+                              obs.camera->GetValueData().data(),
+                              obs.shot->GetRigInstance()->GetValueData().data(),
+                              obs.shot->GetRigCamera()->GetValueData().data(),
+                              obs.point->GetValueData().data());
+  }
+
+  static void Evaluate(const PointProjectionObservation &obs,
+                       const AnalyticType &error, double *residuals) {
+    const double *params[] = {
+        obs.camera->GetValueData().data(),
+        obs.shot->GetRigInstance()->GetValueData().data(),
+        obs.shot->GetRigCamera()->GetValueData().data(),
+        obs.point->GetValueData().data()};
+    error.Evaluate(params, residuals, nullptr);
+  }
 };
-template <>
-struct ErrorTraits<geometry::SphericalCamera> {
-  using Type = ReprojectionError3D;
+
+template <class T>
+struct ProjectionErrorTraits<T, false> {
+  using AutoDiffType = ReprojectionError2DNoRig<T>;
+  using AnalyticType = ReprojectionError2DAnalyticNoRig<T>;
+
+  static void AddResidualBlock(const PointProjectionObservation &obs,
+                               ceres::CostFunction *cost_function,
+                               ceres::LossFunction *loss,
+                               ceres::Problem *problem) {
+    problem->AddResidualBlock(cost_function, loss,
+                              obs.camera->GetValueData().data(),
+                              obs.shot->GetRigInstance()->GetValueData().data(),
+                              obs.point->GetValueData().data());
+  }
+
+  static void Evaluate(const PointProjectionObservation &obs,
+                       const AnalyticType &error, double *residuals) {
+    const double *params[] = {
+        obs.camera->GetValueData().data(),
+        obs.shot->GetRigInstance()->GetValueData().data(),
+        obs.point->GetValueData().data()};
+    error.Evaluate(params, residuals, nullptr);
+  }
 };
 
-template <class T, int C>
-struct ErrorTraitsAnalytic {
-  using Type = ReprojectionError2DAnalytic<C>;
+template <>
+struct ProjectionErrorTraits<geometry::SphericalCamera, true> {
+  using AutoDiffType = ReprojectionError3DRig;
+  using AnalyticType = ReprojectionError3DAnalyticRig;
+
+  static void AddResidualBlock(const PointProjectionObservation &obs,
+                               ceres::CostFunction *cost_function,
+                               ceres::LossFunction *loss,
+                               ceres::Problem *problem) {
+    problem->AddResidualBlock(cost_function, loss,
+                              obs.shot->GetRigInstance()->GetValueData().data(),
+                              obs.shot->GetRigCamera()->GetValueData().data(),
+                              obs.point->GetValueData().data());
+  }
+
+  static void Evaluate(const PointProjectionObservation &obs,
+                       const AnalyticType &error, double *residuals) {
+    const double *params[] = {
+        obs.shot->GetRigInstance()->GetValueData().data(),
+        obs.shot->GetRigCamera()->GetValueData().data(),
+        obs.point->GetValueData().data()};
+    error.Evaluate(params, residuals, nullptr);
+  }
 };
 
 template <>
-struct ErrorTraitsAnalytic<geometry::SphericalCamera, 1> {
-  using Type = ReprojectionError3DAnalytic;
+struct ProjectionErrorTraits<geometry::SphericalCamera, false> {
+  using AutoDiffType = ReprojectionError3DNoRig;
+  using AnalyticType = ReprojectionError3DAnalyticNoRig;
+
+  static void AddResidualBlock(const PointProjectionObservation &obs,
+                               ceres::CostFunction *cost_function,
+                               ceres::LossFunction *loss,
+                               ceres::Problem *problem) {
+    problem->AddResidualBlock(cost_function, loss,
+                              obs.shot->GetRigInstance()->GetValueData().data(),
+                              obs.point->GetValueData().data());
+  }
+
+  static void Evaluate(const PointProjectionObservation &obs,
+                       const AnalyticType &error, double *residuals) {
+    const double *params[] = {
+        obs.shot->GetRigInstance()->GetValueData().data(),
+        obs.point->GetValueData().data()};
+    error.Evaluate(params, residuals, nullptr);
+  }
 };
 
 struct AddProjectionError {
   template <class T>
   static void Apply(bool use_analytical, const PointProjectionObservation &obs,
-                    ceres::LossFunction *loss, ceres::Problem *problem) {
-    constexpr static int ErrorSize = ErrorTraits<T>::Type::Size;
-    constexpr static int CameraSize = T::Size;
-    constexpr static int ShotSize = 6;
+                    ceres::LossFunction *loss, ceres::Problem *problem,
+                    foundation::ObjectArena *arena) {
+    if (IsRigCameraUseful(*obs.shot->GetRigCamera())) {
+      Add<ProjectionErrorTraits<T, true>>(use_analytical, obs, loss, problem,
+                                          arena);
+    } else {
+      Add<ProjectionErrorTraits<T, false>>(use_analytical, obs, loss, problem,
+                                           arena);
+    }
+  }
 
-    const bool is_rig_camera_useful =
-        IsRigCameraUseful(*obs.shot->GetRigCamera());
+  template <class TRAITS>
+  static void Add(bool use_analytical, const PointProjectionObservation &obs,
+                  ceres::LossFunction *loss, ceres::Problem *problem,
+                  foundation::ObjectArena *arena) {
     ceres::CostFunction *cost_function = nullptr;
     if (use_analytical) {
-      using ErrorType = typename ErrorTraitsAnalytic<T, CameraSize>::Type;
-      cost_function = new ErrorType(obs.camera->GetValue().GetProjectionType(),
-                                    obs.coordinates, obs.std_deviation,
-                                    is_rig_camera_useful);
+      cost_function = arena->Create<typename TRAITS::AnalyticType>(
+          obs.coordinates, obs.std_deviation);
     } else {
-      using ErrorType = typename ErrorTraits<T>::Type;
+      using ErrorType = typename TRAITS::AutoDiffType;
       cost_function =
-          new ceres::AutoDiffCostFunction<ErrorType, ErrorSize, CameraSize,
-                                          ShotSize, ShotSize, 3>(new ErrorType(
-              obs.camera->GetValue().GetProjectionType(), obs.coordinates,
-              obs.std_deviation, is_rig_camera_useful));
+          CreateAutoDiffCostFunction<typename ErrorType::CostFunction,
+                                     ErrorType>(arena, obs.coordinates,
+                                                obs.std_deviation);
     }
-    problem->AddResidualBlock(cost_function, loss,
-                              obs.camera->GetValueData().data(),
-                              obs.shot->GetRigInstance()->GetValueData().data(),
-                              obs.shot->GetRigCamera()->GetValueData().data(),
-                              obs.point->GetValueData().data());
+    TRAITS::AddResidualBlock(obs, cost_function, loss, problem);
   }
 };
 
+// Relative depth error of a point, with respect to the rig instance, the
+// rig camera and the point
+constexpr int kRelativeDepthShotSize = 6;
+constexpr int kRelativeDepthPointSize = 3;
+using RelativeDepthCostFunction =
+    ceres::AutoDiffCostFunction<RelativeDepthError, RelativeDepthError::Size,
+                                kRelativeDepthShotSize, kRelativeDepthShotSize,
+                                kRelativeDepthPointSize>;
+
 struct AddRelativeDepthError {
   template <class T>
   static void Apply(const PointProjectionObservation &obs,
-                    ceres::LossFunction *loss, ceres::Problem *problem) {
-    constexpr static int ShotSize = 6;
-    constexpr static int PointSize = 3;
-
+                    ceres::LossFunction *loss, ceres::Problem *problem,
+                    foundation::ObjectArena *arena) {
     if (!obs.depth_prior.has_value()) {
       return;
     }
@@ -514,12 +655,10 @@ struct AddRelativeDepthError {
         IsRigCameraUseful(*obs.shot->GetRigCamera());
     ceres::CostFunction *cost_function = nullptr;
 
-    cost_function =
-        new ceres::AutoDiffCostFunction<RelativeDepthError,
-                                        RelativeDepthError::Size, ShotSize,
-                                        ShotSize, PointSize>(
-            new RelativeDepthError(depth.value, depth.std_deviation,
-                                   is_rig_camera_useful, depth.is_radial));
+    cost_function = CreateAutoDiffCostFunction<RelativeDepthCostFunction,
+                                               RelativeDepthError>(
+        arena, depth.value, depth.std_deviation, is_rig_camera_useful,
+        depth.is_radial);
 
     problem->AddResidualBlock(cost_function, loss,
                               obs.shot->GetRigInstance()->GetValueData().data(),
@@ -530,44 +669,73 @@ struct AddRelativeDepthError {
 
 struct ComputeResidualError {
   template <class T>
-  static void Apply(bool use_analytical,
-                    const PointProjectionObservation &obs) {
-    const bool is_rig_camera_useful =
-        IsRigCameraUseful(*obs.shot->GetRigCamera());
-    if (use_analytical) {
-      constexpr static int CameraSize = T::Size;
-      using ErrorType = typename ErrorTraitsAnalytic<T, CameraSize>::Type;
-      constexpr static int ErrorSize = ErrorType::Size;
-
-      VecNd<ErrorSize> residuals;
-      ErrorType error(obs.camera->GetValue().GetProjectionType(),
-                      obs.coordinates, 1.0, is_rig_camera_useful);
-      const double *params[] = {
-          obs.camera->GetValueData().data(),
-          obs.shot->GetRigInstance()->GetValueData().data(),
-          obs.shot->GetRigCamera()->GetValueData().data(),
-          obs.point->GetValueData().data()};
-      error.Evaluate(params, residuals.data(), nullptr);
-      obs.point->reprojection_errors[obs.shot->GetID()] = residuals;
+  static void Apply(const PointProjectionObservation &obs, VecMax3d *error) {
+    if (IsRigCameraUseful(*obs.shot->GetRigCamera())) {
+      Compute<ProjectionErrorTraits<T, true>>(obs, error);
     } else {
-      using ErrorType = typename ErrorTraits<T>::Type;
-      constexpr static int ErrorSize = ErrorType::Size;
-
-      VecNd<ErrorSize> residuals;
-      ErrorType error(obs.camera->GetValue().GetProjectionType(),
-                      obs.coordinates, 1.0, is_rig_camera_useful);
-      error(obs.camera->GetValueData().data(),
-            obs.shot->GetRigInstance()->GetValueData().data(),
-            obs.shot->GetRigCamera()->GetValueData().data(),
-            obs.point->GetValueData().data(), residuals.data());
-      obs.point->reprojection_errors[obs.shot->GetID()] = residuals;
+      Compute<ProjectionErrorTraits<T, false>>(obs, error);
+    }
+  }
+
+  // Residuals are evaluated with the analytic error (error-only path) for
+  // both analytic and auto-differentiated problems, as they are identical.
+  template <class TRAITS>
+  static void Compute(const PointProjectionObservation &obs,
+                      VecMax3d *error) {
+    using ErrorType = typename TRAITS::AnalyticType;
+    constexpr static int ErrorSize = ErrorType::Size;
+
+    VecNd<ErrorSize> residuals;
+    ErrorType error_function(obs.coordinates, 1.0);
+    TRAITS::Evaluate(obs, error_function, residuals.data());
+    *error = residuals;
+  }
+};
+
+// Ceres structures of the reprojection error of an observation
+struct ProjectionErrorFootprint {
+  size_t cost_function_bytes{0};
+  int residuals{0};
+  int parameter_blocks{0};
+  int parameters{0};
+};
+
+struct ComputeProjectionErrorFootprint {
+  template <class T>
+  static void Apply(bool use_analytical, const PointProjectionObservation &obs,
+                    ProjectionErrorFootprint *footprint) {
+    if (IsRigCameraUseful(*obs.shot->GetRigCamera())) {
+      Compute<ProjectionErrorTraits<T, true>>(use_analytical, obs, footprint);
+    } else {
+      Compute<ProjectionErrorTraits<T, false>>(use_analytical, obs,
+                                               footprint);
+    }
+  }
+
+  template <class TRAITS>
+  static void Compute(bool use_analytical,
+                      const PointProjectionObservation &obs,
+                      ProjectionErrorFootprint *footprint) {
+    using ErrorType = typename TRAITS::AutoDiffType;
+    footprint->cost_function_bytes =
+        use_analytical
+            ? sizeof(typename TRAITS::AnalyticType)
+            : sizeof(typename ErrorType::CostFunction) + sizeof(ErrorType);
+
+    const typename TRAITS::AnalyticType error(obs.coordinates, 1.0);
+    footprint->residuals = error.num_residuals();
+    footprint->parameter_blocks = error.parameter_block_sizes().size();
+    footprint->parameters = 0;
+    for (const int size : error.parameter_block_sizes()) {
+      footprint->parameters += size;
     }
   }
 };
 
 struct AddCameraPriorError {
   template <class T>
-  static void Apply(Camera &camera, ceres::Problem *problem) {
+  static void Apply(Camera &camera, ceres::Problem *problem,
+                    foundation::ObjectArena *arena) {
     auto *prior_function = new DataPriorError<geometry::Camera>(&camera);
 
     // Set some logarithmic prior for Focal and Aspect ratio (if any)
@@ -583,8 +751,8 @@ struct AddCameraPriorError {
     }
 
     constexpr static int CameraSize = T::Size;
-    auto *cost_function = new ceres::DynamicAutoDiffCostFunction<
-        DataPriorError<geometry::Camera>>(prior_function);
+    auto *cost_function = arena->Create<ceres::DynamicAutoDiffCostFunction<
+        DataPriorError<geometry::Camera>>>(prior_function);
     cost_function->SetNumResiduals(CameraSize);
     cost_function->AddParameterBlock(CameraSize);
     problem->AddResidualBlock(cost_function, nullptr,
@@ -593,7 +761,23 @@ struct AddCameraPriorError {
 };
 
 void BundleAdjuster::Run() {
-  ceres::Problem problem;
+  OPENSFM_TRACE_SCOPE("bundle", "BundleAdjuster::Run");
+  OPENSFM_TRACE_COUNTER("bundle", "projections",
+                        point_projection_observations_.size());
+  const auto timer_start = std::chrono::high_resolution_clock::now();
+
+  // Cost and loss functions, and the auto-diff functors of the projections
+  // and depth priors, are all owned by the arena, which is released right
+  // after the problem, instead of being deleted one by one by Ceres.
+  auto arena_ptr = std::make_unique<foundation::ObjectArena>();
+  auto &arena = *arena_ptr;
+  LossFunctionCache losses(arena_ptr.get());
+
+  ceres::Problem::Options problem_options;
+  problem_options.cost_function_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+  problem_options.loss_function_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+  auto problem_ptr = std::make_unique<ceres::Problem>(problem_options);
+  auto &problem = *problem_ptr;
 
   // Add cameras
   for (auto &[_, cam] : cameras_) {
@@ -617,8 +801,8 @@ void BundleAdjuster::Run() {
       }
       if (index >= 0) {
         ceres::CostFunction *transition_barrier =
-            new ceres::AutoDiffCostFunction<ParameterBarrier, 1,
-                                            geometry::DualCamera::Size>(
+            arena.Create<ceres::AutoDiffCostFunction<
+                ParameterBarrier, 1, geometry::DualCamera::Size>>(
                 new ParameterBarrier(0.0, 1.0, index));
         problem.AddResidualBlock(transition_barrier, nullptr, data.data());
       }
@@ -698,7 +882,7 @@ void BundleAdjuster::Run() {
           {Point::Parameter::PX, Point::Parameter::PY});
     }
     auto *cost_function =
-        new ceres::DynamicAutoDiffCostFunction<DataPriorError<Vec3d>>(
+        arena.Create<ceres::DynamicAutoDiffCostFunction<DataPriorError<Vec3d>>>(
             position_prior);
     cost_function->SetNumResiduals(i.second.has_altitude_prior ? 3 : 2);
     cost_function->AddParameterBlock(3);
@@ -728,7 +912,8 @@ void BundleAdjuster::Run() {
   if (adjust_absolute_position_std_) {
     for (int i = 0; i < std_deviations.size(); ++i) {
       ceres::CostFunction *std_dev_cost_function =
-          new ceres::AutoDiffCostFunction<StdDeviationConstraint, 1, 1>(
+          arena.Create<ceres::AutoDiffCostFunction<StdDeviationConstraint, 1,
+                                                   1>>(
               new StdDeviationConstraint());
       problem.AddResidualBlock(std_dev_cost_function, nullptr,
                                &std_deviations[i]);
@@ -765,7 +950,8 @@ void BundleAdjuster::Run() {
     auto *scale_param = &std_deviations.at(std_dev_group_remap.at(scale_group));
 
     auto *cost_function =
-        new ceres::DynamicAutoDiffCostFunction<PriorType>(position_prior);
+        arena.Create<ceres::DynamicAutoDiffCostFunction<PriorType>>(
+            position_prior);
     cost_function->SetNumResiduals(3);
     cost_function->AddParameterBlock(Pose::Parameter::NUM_PARAMS);
     cost_function->AddParameterBlock(Similarity::Parameter::NUM_PARAMS);
@@ -779,9 +965,9 @@ void BundleAdjuster::Run() {
       continue;
     }
     auto *pose_prior = new DataPriorError<geometry::Pose>(&rc.second);
-    auto *cost_function =
-        new ceres::DynamicAutoDiffCostFunction<DataPriorError<geometry::Pose>>(
-            pose_prior);
+    auto *cost_function = arena.Create<
+        ceres::DynamicAutoDiffCostFunction<DataPriorError<geometry::Pose>>>(
+        pose_prior);
     cost_function->SetNumResiduals(Pose::Parameter::NUM_PARAMS);
     cost_function->AddParameterBlock(Pose::Parameter::NUM_PARAMS);
     problem.AddResidualBlock(cost_function, nullptr,
@@ -791,25 +977,26 @@ void BundleAdjuster::Run() {
   for (auto &i : cameras_) {
     const auto projection_type = i.second.GetValue().GetProjectionType();
     geometry::Dispatch<AddCameraPriorError>(projection_type, i.second,
-                                            &problem);
+                                            &problem, &arena);
   }
 
   // Add reprojection error blocks
   ceres::LossFunction *projection_loss =
       point_projection_observations_.empty()
           ? nullptr
-          : CreateLossFunction(point_projection_loss_name_,
-                               point_projection_loss_threshold_);
+          : losses.Get(point_projection_loss_name_,
+                       point_projection_loss_threshold_);
 
   for (auto &observation : point_projection_observations_) {
     const auto projection_type =
         observation.camera->GetValue().GetProjectionType();
-    geometry::Dispatch<AddProjectionError>(
-        projection_type, use_analytic_, observation, projection_loss, &problem);
+    geometry::Dispatch<AddProjectionError>(projection_type, use_analytic_,
+                                           observation, projection_loss,
+                                           &problem, &arena);
 
     // Add relative depth error blocks
-    geometry::Dispatch<AddRelativeDepthError>(projection_type, observation,
-                                              projection_loss, &problem);
+    geometry::Dispatch<AddRelativeDepthError>(
+        projection_type, observation, projection_loss, &problem, &arena);
   }
 
   // Add relative motion errors
@@ -817,12 +1004,12 @@ void BundleAdjuster::Run() {
     double robust_threshold =
         relative_motion_loss_threshold_ * rp.robust_multiplier;
     ceres::LossFunction *relative_motion_loss =
-        CreateLossFunction(relative_motion_loss_name_, robust_threshold);
+        losses.Get(relative_motion_loss_name_, robust_threshold);
 
     auto *relative_motion = new RelativeMotionError(
         rp.parameters, rp.scale_matrix, rp.observed_scale);
     auto *cost_function =
-        new ceres::DynamicAutoDiffCostFunction<RelativeMotionError>(
+        arena.Create<ceres::DynamicAutoDiffCostFunction<RelativeMotionError>>(
             relative_motion);
     cost_function->AddParameterBlock(6);
     cost_function->AddParameterBlock(6);
@@ -856,13 +1043,13 @@ void BundleAdjuster::Run() {
   ceres::LossFunction *relative_rotation_loss =
       relative_rotations_.empty()
           ? nullptr
-          : CreateLossFunction(relative_motion_loss_name_,
-                               relative_motion_loss_threshold_);
+          : losses.Get(relative_motion_loss_name_,
+                       relative_motion_loss_threshold_);
   for (auto &rr : relative_rotations_) {
     auto *relative_rotation =
         new RelativeRotationError(rr.rotation, rr.scale_matrix);
     auto *cost_function =
-        new ceres::DynamicAutoDiffCostFunction<RelativeRotationError>(
+        arena.Create<ceres::DynamicAutoDiffCostFunction<RelativeRotationError>>(
             relative_rotation);
     cost_function->AddParameterBlock(6);
     cost_function->AddParameterBlock(6);
@@ -901,11 +1088,11 @@ void BundleAdjuster::Run() {
   ceres::LossFunction *common_position_loss = nullptr;
   for (auto &c : common_positions_) {
     if (common_position_loss == nullptr) {
-      common_position_loss = new ceres::TukeyLoss(1);
+      common_position_loss = losses.Get("TukeyLoss", 1);
     }
     auto *common_position = new CommonPositionError(c.margin, c.std_deviation);
     auto *cost_function =
-        new ceres::DynamicAutoDiffCostFunction<CommonPositionError>(
+        arena.Create<ceres::DynamicAutoDiffCostFunction<CommonPositionError>>(
             common_position);
     cost_function->AddParameterBlock(6);
     cost_function->AddParameterBlock(6);
@@ -942,9 +1129,9 @@ void BundleAdjuster::Run() {
 
   // Add heatmap cost
   for (const auto &a : absolute_positions_heatmaps_) {
-    auto *cost_function = HeatmapdCostFunctor::Create(
+    auto *cost_function = arena.Adopt(HeatmapdCostFunctor::Create(
         a.heatmap->interpolator, a.x_offset, a.y_offset, a.heatmap->height,
-        a.heatmap->width, a.heatmap->resolution, a.std_deviation);
+        a.heatmap->width, a.heatmap->resolution, a.std_deviation));
     auto &shot = shots_.at(a.shot_id);
     problem.AddResidualBlock(cost_function, nullptr,
                              shot.GetRigInstance()->GetValueData().data(),
@@ -956,11 +1143,11 @@ void BundleAdjuster::Run() {
   for (auto &a : absolute_up_vectors_) {
     if (a.std_deviation > 0) {
       if (up_vector_loss == nullptr) {
-        up_vector_loss = new ceres::CauchyLoss(1);
+        up_vector_loss = losses.Get("CauchyLoss", 1);
       }
 
       ceres::CostFunction *up_cost_function =
-          new ceres::AutoDiffCostFunction<UpVectorError, 3, 6, 6>(
+          arena.Create<ceres::AutoDiffCostFunction<UpVectorError, 3, 6, 6>>(
               new UpVectorError(a.up_vector, a.std_deviation));
       auto &shot = shots_.at(a.shot_id);
       problem.AddResidualBlock(up_cost_function, up_vector_loss,
@@ -974,10 +1161,10 @@ void BundleAdjuster::Run() {
   for (auto &a : absolute_pans_) {
     if (a.std_deviation > 0) {
       if (pan_loss == nullptr) {
-        pan_loss = new ceres::CauchyLoss(1);
+        pan_loss = losses.Get("CauchyLoss", 1);
       }
       ceres::CostFunction *pan_cost_function =
-          new ceres::AutoDiffCostFunction<PanAngleError, 1, 6, 6>(
+          arena.Create<ceres::AutoDiffCostFunction<PanAngleError, 1, 6, 6>>(
               new PanAngleError(a.angle, a.std_deviation));
       auto &shot = shots_.at(a.shot_id);
       problem.AddResidualBlock(pan_cost_function, pan_loss,
@@ -991,10 +1178,10 @@ void BundleAdjuster::Run() {
   for (auto &a : absolute_tilts_) {
     if (a.std_deviation > 0) {
       if (tilt_loss == nullptr) {
-        tilt_loss = new ceres::CauchyLoss(1);
+        tilt_loss = losses.Get("CauchyLoss", 1);
       }
       ceres::CostFunction *tilt_cost_function =
-          new ceres::AutoDiffCostFunction<TiltAngleError, 1, 6, 6>(
+          arena.Create<ceres::AutoDiffCostFunction<TiltAngleError, 1, 6, 6>>(
               new TiltAngleError(a.angle, a.std_deviation));
       auto &shot = shots_.at(a.shot_id);
       problem.AddResidualBlock(tilt_cost_function, tilt_loss,
@@ -1008,10 +1195,10 @@ void BundleAdjuster::Run() {
   for (auto &a : absolute_rolls_) {
     if (a.std_deviation > 0) {
       if (roll_loss == nullptr) {
-        roll_loss = new ceres::CauchyLoss(1);
+        roll_loss = losses.Get("CauchyLoss", 1);
       }
       ceres::CostFunction *roll_cost_function =
-          new ceres::AutoDiffCostFunction<RollAngleError, 1, 6, 6>(
+          arena.Create<ceres::AutoDiffCostFunction<RollAngleError, 1, 6, 6>>(
               new RollAngleError(a.angle, a.std_deviation));
       auto &shot = shots_.at(a.shot_id);
       problem.AddResidualBlock(roll_cost_function, roll_loss,
@@ -1024,13 +1211,13 @@ void BundleAdjuster::Run() {
   ceres::LossFunction *linear_motion_prior_loss_ = nullptr;
   for (auto &a : linear_motion_prior_) {
     if (linear_motion_prior_loss_ == nullptr) {
-      linear_motion_prior_loss_ = new ceres::CauchyLoss(1);
+      linear_motion_prior_loss_ = losses.Get("CauchyLoss", 1);
     }
 
     auto *linear_motion = new LinearMotionError(
         a.alpha, a.position_std_deviation, a.orientation_std_deviation);
     auto *cost_function =
-        new ceres::DynamicAutoDiffCostFunction<LinearMotionError>(
+        arena.Create<ceres::DynamicAutoDiffCostFunction<LinearMotionError>>(
             linear_motion);
     cost_function->AddParameterBlock(6);
     cost_function->AddParameterBlock(6);
@@ -1091,7 +1278,8 @@ void BundleAdjuster::Run() {
             .norm();
 
     ceres::CostFunction *cost_function =
-        new ceres::AutoDiffCostFunction<TranslationPriorError, 1, 6, 6>(
+        arena.Create<ceres::AutoDiffCostFunction<TranslationPriorError, 1, 6,
+                                                 6>>(
             new TranslationPriorError(norm));
 
     problem.AddResidualBlock(cost_function, nullptr,
@@ -1099,6 +1287,8 @@ void BundleAdjuster::Run() {
                              instance2->GetValueData().data());
   }
 
+  const auto timer_setup = std::chrono::high_resolution_clock::now();
+
   // Solve
   ceres::Solver::Options options;
   if (!ceres::StringToLinearSolverType(linear_solver_type_,
@@ -1109,7 +1299,10 @@ void BundleAdjuster::Run() {
   options.num_threads = num_threads_;
   options.max_num_iterations = max_num_iterations_;
 
-  ceres::Solve(options, &problem, &last_run_summary_);
+  {
+    OPENSFM_TRACE_SCOPE("bundle", "ceres::Solve");
+    ceres::Solve(options, &problem, &last_run_summary_);
+  }
 
   if (compute_covariances_) {
     ComputeCovariances(&problem);
@@ -1117,9 +1310,23 @@ void BundleAdjuster::Run() {
   if (compute_reprojection_errors_) {
     ComputeReprojectionErrors();
   }
+
+  const auto timer_teardown = std::chrono::high_resolution_clock::now();
+  {
+    OPENSFM_TRACE_SCOPE("bundle", "BundleAdjuster::Teardown");
+    problem_ptr.reset();
+    arena_ptr.reset();
+  }
+  const auto timer_end = std::chrono::high_resolution_clock::now();
+
+  problem_setup_time_ =
+      std::chrono::duration<double>(timer_setup - timer_start).count();
+  problem_teardown_time_ =
+      std::chrono::duration<double>(timer_end - timer_teardown).count();
 }
 
 void BundleAdjuster::ComputeCovariances(ceres::Problem *problem) {
+  OPENSFM_TRACE_SCOPE("bundle", "BundleAdjuster::ComputeCovariances");
   bool computed = false;
 
   if (last_run_summary_.termination_type != ceres::FAILURE) {
@@ -1192,19 +1399,31 @@ void BundleAdjuster::ComputeCovariances(ceres::Problem *problem) {
 }
 
 void BundleAdjuster::ComputeReprojectionErrors() {
-  // Init errors
-  for (auto &i : points_) {
-    i.second.reprojection_errors.clear();
-  }
-
-  for (auto &observation : point_projection_observations_) {
+  OPENSFM_TRACE_SCOPE("bundle", "BundleAdjuster::ComputeReprojectionErrors");
+  // Errors are stored flat, in the same order as the observations, so that
+  // each one can be evaluated independently without touching shared state
+  const int count = point_projection_observations_.size();
+  reprojection_errors_.resize(count);
+
+#pragma omp parallel for num_threads(num_threads_) schedule(static)
+  for (int i = 0; i < count; ++i) {
+    const auto &observation = point_projection_observations_[i];
     const auto projection_type =
         observation.camera->GetValue().GetProjectionType();
-    geometry::Dispatch<ComputeResidualError>(projection_type, use_analytic_,
-                                             observation);
+    geometry::Dispatch<ComputeResidualError>(projection_type, observation,
+                                             &reprojection_errors_[i]);
   }
 }
 
+const std::vector<VecMax3d> &BundleAdjuster::GetReprojectionErrors() const {
+  return reprojection_errors_;
+}
+
+const std::vector<PointProjectionObservation>
+    &BundleAdjuster::GetPointProjectionObservations() const {
+  return point_projection_observations_;
+}
+
 int BundleAdjuster::GetProjectionsCount() const {
   return point_projection_observations_.size();
 }
@@ -1270,6 +1489,146 @@ std::map<std::string, RigInstance> BundleAdjuster::GetRigInstances() const {
   return rig_instances_;
 }
 
+double BundleAdjuster::GetProblemSetupTime() const {
+  return problem_setup_time_;
+}
+
+double BundleAdjuster::GetProblemTeardownTime() const {
+  return problem_teardown_time_;
+}
+
+foundation::MemoryUsage BundleAdjuster::MemoryUsage() const {
+  namespace memory = foundation::memory;
+  foundation::MemoryUsage usage;
+  usage["ids"] =
+      memory::KeysBytes(cameras_) + memory::KeysBytes(bias_) +
+      memory::KeysBytes(shots_) + memory::KeysBytes(reconstructions_) +
+      memory::KeysBytes(reconstructions_assignments_) +
+      memory::KeysBytes(points_) + memory::KeysBytes(rig_cameras_) +
+      memory::KeysBytes(rig_instances_) + memory::KeysBytes(heatmaps_);
+  usage["indices"] =
+      memory::IndexBytes(cameras_) + memory::IndexBytes(bias_) +
+      memory::IndexBytes(shots_) + memory::IndexBytes(reconstructions_) +
+      memory::IndexBytes(reconstructions_assignments_) +
+      memory::IndexBytes(points_) + memory::IndexBytes(rig_cameras_) +
+      memory::IndexBytes(rig_instances_) + memory::IndexBytes(heatmaps_);
+
+  // Parameter blocks, and the parameters they hold
+  size_t parameter_blocks = 0;
+  size_t parameters = 0;
+  size_t parameters_bytes = 0;
+  const auto add_parameters = [&](const auto &data_map) {
+    parameters_bytes += memory::ElementsBytes(data_map);
+    for (const auto &data : data_map) {
+      parameters_bytes += data.second.HeapBytes();
+      parameters += data.second.GetValueData().size();
+    }
+    parameter_blocks += data_map.size();
+  };
+  add_parameters(cameras_);
+  add_parameters(bias_);
+  add_parameters(points_);
+  add_parameters(rig_cameras_);
+  add_parameters(rig_instances_);
+  parameters_bytes +=
+      memory::ElementsBytes(shots_) + memory::ElementsBytes(reconstructions_);
+  for (const auto &shot : shots_) {
+    parameters_bytes += shot.second.HeapBytes();
+  }
+  for (const auto &reconstruction : reconstructions_) {
+    const auto &scales = reconstruction.second.scales;
+    parameters_bytes += memory::HeapBytes(reconstruction.second.id) +
+                        memory::ElementsBytes(scales) +
+                        memory::IndexBytes(scales) + memory::KeysBytes(scales);
+    parameter_blocks += scales.size();
+    parameters += scales.size();
+  }
+  usage["parameters"] = parameters_bytes;
+
+  usage["observations"] =
+      memory::HeapBytes(point_projection_observations_) +
+      memory::HeapBytes(reprojection_errors_) +
+      memory::HeapBytes(relative_motions_) +
+      memory::HeapBytes(relative_rotations_) +
+      memory::HeapBytes(common_positions_) +
+      memory::HeapBytes(absolute_positions_heatmaps_) +
+      memory::HeapBytes(absolute_up_vectors_) +
+      memory::HeapBytes(absolute_pans_) + memory::HeapBytes(absolute_tilts_) +
+      memory::HeapBytes(absolute_rolls_) +
+      memory::HeapBytes(linear_motion_prior_);
+  for (const auto &heatmap : heatmaps_) {
+    usage["observations"] += memory::HeapBytes(heatmap.second->heatmap) +
+                             sizeof(HeatmapInterpolator);
+  }
+
+  // Ceres' ResidualBlock holds its cost and loss functions, the array of its
+  // parameter blocks and its index, and the program points to it
+  constexpr size_t kResidualBlockBytes = 4 * sizeof(void *) + sizeof(int);
+  // Ceres' ParameterBlock holds about ten pointers and integers (states,
+  // sizes, offsets, manifold and bounds), and is the value of a node of the
+  // problem's std::map (three links, color, key and value)
+  constexpr size_t kParameterBlockBytes = 16 * sizeof(void *);
+  // The jacobian block structure has a cell {block id, position} per
+  // parameter block of each residual block
+  constexpr size_t kJacobianCellBytes = 2 * sizeof(int);
+  // The trust region minimizer keeps eight vectors of the size of the
+  // parameters : x, x + delta, delta, gradient, candidate x, projected
+  // gradient step, negative gradient and the Levenberg-Marquardt diagonal
+  constexpr size_t kParametersCopies = 8;
+  // Priors and constraints other than projections are auto-differentiated
+  // cost functions of about two parameter blocks, owning a functor of a few
+  // measurement vectors
+  constexpr size_t kConstraintCostFunctionBytes =
+      sizeof(ceres::CostFunction) + sizeof(void *) + 8 * sizeof(double);
+  constexpr size_t kConstraintParameterBlocks = 2;
+
+  // Residual blocks : priors on the parameters, other constraints, and
+  // projections (with their depth prior) whose size depends on their camera
+  // and on whether they use the rig camera block
+  size_t residual_blocks =
+      parameter_blocks + relative_motions_.size() +
+      relative_rotations_.size() + common_positions_.size() +
+      absolute_positions_heatmaps_.size() + absolute_up_vectors_.size() +
+      absolute_pans_.size() + absolute_tilts_.size() +
+      absolute_rolls_.size() + linear_motion_prior_.size();
+  size_t residual_parameter_blocks =
+      parameter_blocks +
+      (residual_blocks - parameter_blocks) * kConstraintParameterBlocks;
+  size_t cost_functions_bytes = residual_blocks * kConstraintCostFunctionBytes;
+  size_t jacobian_values = 0;
+  for (const auto &observation : point_projection_observations_) {
+    ProjectionErrorFootprint footprint;
+    geometry::Dispatch<ComputeProjectionErrorFootprint>(
+        observation.camera->GetValue().GetProjectionType(), use_analytic_,
+        observation, &footprint);
+    residual_blocks += 1;
+    residual_parameter_blocks += footprint.parameter_blocks;
+    cost_functions_bytes += footprint.cost_function_bytes;
+    jacobian_values += footprint.residuals * footprint.parameters;
+
+    if (observation.depth_prior) {
+      residual_blocks += 1;
+      residual_parameter_blocks += 3;
+      cost_functions_bytes +=
+          sizeof(RelativeDepthCostFunction) + sizeof(RelativeDepthError);
+      jacobian_values +=
+          RelativeDepthError::Size *
+          (2 * kRelativeDepthShotSize + kRelativeDepthPointSize);
+    }
+  }
+
+  usage["residual_blocks"] = cost_functions_bytes;
+  usage["ceres_problem"] =
+      residual_blocks * kResidualBlockBytes +
+      residual_parameter_blocks * (sizeof(void *) + kJacobianCellBytes) +
+      parameter_blocks * kParameterBlockBytes +
+      jacobian_values * sizeof(double) +
+      parameters * kParametersCopies * sizeof(double);
+
+  memory::UpdateTotal(&usage);
+  return usage;
+}
+
 std::string BundleAdjuster::BriefReport() const {
   return last_run_summary_.BriefReport();
 }
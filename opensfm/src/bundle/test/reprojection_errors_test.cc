@@ -3,7 +3,9 @@
 #include <gtest/gtest.h>
 
 #include <Eigen/Dense>
+#include <memory>
 #include <unsupported/Eigen/AutoDiff>
+#include <vector>
 
 class ReprojectionError2DFixtureBase : public ::testing::Test {
  public:
@@ -263,3 +265,160 @@ TEST_F(ReprojectionError3DFixture, AnalyticErrorEvaluatesOK) {
   // Check
   CheckJacobians();
 }
+
+template <class CAMERA>
+class StaticReprojectionErrorFixture : public ::testing::Test {
+ public:
+  StaticReprojectionErrorFixture() {
+    observed << 0.5, 0.5;
+    for (int i = 0; i < CAMERA::Size; ++i) {
+      camera[i] = 0.01 * (i + 1);
+    }
+    // Keep focal-like and aspect-ratio-like parameters away from zero
+    camera[0] = 0.3;
+  }
+
+  // Compare analytic and auto-differentiated cost functions evaluated on
+  // the same parameters blocks
+  void CheckCostFunctions(const ceres::CostFunction& analytic,
+                          const ceres::CostFunction& autodiff,
+                          const std::vector<const double*>& params) {
+    const int num_residuals = analytic.num_residuals();
+    const auto& blocks_sizes = analytic.parameter_block_sizes();
+    ASSERT_EQ(num_residuals, autodiff.num_residuals());
+    ASSERT_EQ(blocks_sizes, autodiff.parameter_block_sizes());
+    ASSERT_EQ(blocks_sizes.size(), params.size());
+
+    std::vector<std::vector<double>> jac_analytic, jac_autodiff;
+    std::vector<double*> ptr_analytic, ptr_autodiff;
+    for (const auto size : blocks_sizes) {
+      jac_analytic.emplace_back(num_residuals * size);
+      jac_autodiff.emplace_back(num_residuals * size);
+    }
+    for (size_t i = 0; i < blocks_sizes.size(); ++i) {
+      ptr_analytic.push_back(jac_analytic[i].data());
+      ptr_autodiff.push_back(jac_autodiff[i].data());
+    }
+    std::vector<double> res_analytic(num_residuals),
+        res_autodiff(num_residuals);
+
+    analytic.Evaluate(params.data(), res_analytic.data(), ptr_analytic.data());
+    autodiff.Evaluate(params.data(), res_autodiff.data(), ptr_autodiff.data());
+
+    const double eps = 1e-12;
+    for (int i = 0; i < num_residuals; ++i) {
+      ASSERT_NEAR(res_analytic[i], res_autodiff[i], eps);
+    }
+    for (size_t i = 0; i < blocks_sizes.size(); ++i) {
+      for (size_t j = 0; j < jac_analytic[i].size(); ++j) {
+        ASSERT_NEAR(jac_analytic[i][j], jac_autodiff[i][j], eps);
+      }
+    }
+  }
+
+  Vec2d observed;
+  double scale{0.1};
+  double camera[CAMERA::Size];
+  const double point[3] = {1.0, 2.0, 3.0};
+  const double rt_instance[6] = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6};
+  const double rt_camera[6] = {0.3, 0.2, 0.1, 0.6, 0.5, 0.4};
+};
+
+using PlanarCameras =
+    ::testing::Types<geometry::PerspectiveCamera, geometry::BrownCamera,
+                     geometry::FisheyeCamera, geometry::FisheyeOpencvCamera,
+                     geometry::Fisheye62Camera, geometry::Fisheye624Camera,
+                     geometry::RadialCamera, geometry::SimpleRadialCamera,
+                     geometry::DualCamera>;
+TYPED_TEST_CASE(StaticReprojectionErrorFixture, PlanarCameras);
+
+TYPED_TEST(StaticReprojectionErrorFixture, RigAnalyticMatchesAutoDiff) {
+  bundle::ReprojectionError2DAnalyticRig<TypeParam> analytic(this->observed,
+                                                             this->scale);
+  std::unique_ptr<ceres::CostFunction> autodiff(
+      bundle::ReprojectionError2DRig<TypeParam>::Create(this->observed,
+                                                        this->scale));
+  this->CheckCostFunctions(analytic, *autodiff,
+                           {this->camera, this->rt_instance, this->rt_camera,
+                            this->point});
+}
+
+TYPED_TEST(StaticReprojectionErrorFixture, NoRigAnalyticMatchesAutoDiff) {
+  bundle::ReprojectionError2DAnalyticNoRig<TypeParam> analytic(this->observed,
+                                                               this->scale);
+  std::unique_ptr<ceres::CostFunction> autodiff(
+      bundle::ReprojectionError2DNoRig<TypeParam>::Create(this->observed,
+                                                          this->scale));
+  this->CheckCostFunctions(analytic, *autodiff,
+                           {this->camera, this->rt_instance, this->point});
+}
+
+TYPED_TEST(StaticReprojectionErrorFixture, NoRigMatchesIdentityRig) {
+  // Dropping the rig camera block is the same as using an identity one
+  double residuals_static[2];
+  bundle::ReprojectionError2DNoRig<TypeParam> error_static(this->observed,
+                                                           this->scale);
+  error_static(this->camera, this->rt_instance, this->point,
+               residuals_static);
+
+  double residuals_rig[2];
+  const double identity[6] = {0., 0., 0., 0., 0., 0.};
+  bundle::ReprojectionError2DRig<TypeParam> error_rig(this->observed,
+                                                      this->scale);
+  error_rig(this->camera, this->rt_instance, identity, this->point,
+            residuals_rig);
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_NEAR(residuals_static[i], residuals_rig[i], 1e-14);
+  }
+}
+
+TEST_F(ReprojectionError3DFixture, StaticAnalyticMatchesAutoDiff) {
+  const double eps = 1e-12;
+  double jac_rig_instance[size * size_rt], jac_rig_camera[size * size_rt],
+      jac_pt[size * size_point];
+  double jac_rig_instance_ad[size * size_rt], jac_rig_camera_ad[size * size_rt],
+      jac_pt_ad[size * size_point];
+  double residuals_ad[size];
+
+  {
+    const double* params[] = {rt_instance, rt_camera, point};
+    double* jacobians[] = {jac_rig_instance, jac_rig_camera, jac_pt};
+    double* jacobians_ad[] = {jac_rig_instance_ad, jac_rig_camera_ad,
+                              jac_pt_ad};
+    bundle::ReprojectionError3DAnalyticRig analytic(observed, scale);
+    std::unique_ptr<ceres::CostFunction> autodiff(
+        bundle::ReprojectionError3DRig::Create(observed, scale));
+    analytic.Evaluate(params, residuals, jacobians);
+    autodiff->Evaluate(params, residuals_ad, jacobians_ad);
+    for (int i = 0; i < size; ++i) {
+      ASSERT_NEAR(residuals[i], residuals_ad[i], eps);
+    }
+    for (int i = 0; i < size * size_rt; ++i) {
+      ASSERT_NEAR(jac_rig_instance[i], jac_rig_instance_ad[i], eps);
+      ASSERT_NEAR(jac_rig_camera[i], jac_rig_camera_ad[i], eps);
+    }
+    for (int i = 0; i < size * size_point; ++i) {
+      ASSERT_NEAR(jac_pt[i], jac_pt_ad[i], eps);
+    }
+  }
+  {
+    const double* params[] = {rt_instance, point};
+    double* jacobians[] = {jac_rig_instance, jac_pt};
+    double* jacobians_ad[] = {jac_rig_instance_ad, jac_pt_ad};
+    bundle::ReprojectionError3DAnalyticNoRig analytic(observed, scale);
+    std::unique_ptr<ceres::CostFunction> autodiff(
+        bundle::ReprojectionError3DNoRig::Create(observed, scale));
+    analytic.Evaluate(params, residuals, jacobians);
+    autodiff->Evaluate(params, residuals_ad, jacobians_ad);
+    for (int i = 0; i < size; ++i) {
+      ASSERT_NEAR(residuals[i], residuals_ad[i], eps);
+    }
+    for (int i = 0; i < size * size_rt; ++i) {
+      ASSERT_NEAR(jac_rig_instance[i], jac_rig_instance_ad[i], eps);
+    }
+    for (int i = 0; i < size * size_point; ++i) {
+      ASSERT_NEAR(jac_pt[i], jac_pt_ad[i], eps);
+    }
+  }
+}
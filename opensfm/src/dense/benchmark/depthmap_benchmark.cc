@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <dense/depthmap.h>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+/* Synthetic views of a textured fronto-parallel plane at depth 'depth',
+ * seen from cameras translated along the X axis. */
+struct PlaneViews {
+  PlaneViews(int image_width, int image_height, int views_count)
+      : width(image_width), height(image_height) {
+    const double focal = width;
+    const double depth = 5.0;
+    K = {focal, 0.0, 0.5 * width, 0.0, focal, 0.5 * height, 0.0, 0.0, 1.0};
+    R = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0};
+
+    for (int k = 0; k < views_count; ++k) {
+      const double center = 0.3 * k;
+      ts.push_back({-center, 0.0, 0.0});
+
+      std::vector<unsigned char> image(width * height);
+      for (int v = 0; v < height; ++v) {
+        for (int u = 0; u < width; ++u) {
+          const double x = (u - K[2]) / focal * depth + center;
+          const double y = (v - K[5]) / focal * depth;
+          const double texture =
+              128.0 + 60.0 * std::sin(13.0 * x) * std::cos(17.0 * y) +
+              40.0 * std::sin(71.0 * x + 37.0 * y);
+          image[v * width + u] = static_cast<unsigned char>(texture);
+        }
+      }
+      images.push_back(image);
+    }
+    mask.assign(width * height, 255);
+  }
+
+  dense::DepthmapEstimator CreateEstimator() const {
+    dense::DepthmapEstimator estimator;
+    for (size_t k = 0; k < images.size(); ++k) {
+      estimator.AddView(K.data(), R.data(), ts[k].data(), images[k].data(),
+                        mask.data(), width, height);
+    }
+    estimator.SetDepthRange(2.0, 10.0, 50);
+    return estimator;
+  }
+
+  int width;
+  int height;
+  std::array<double, 9> K;
+  std::array<double, 9> R;
+  std::vector<std::array<double, 3>> ts;
+  std::vector<std::vector<unsigned char>> images;
+  std::vector<unsigned char> mask;
+};
+
+void BM_DepthmapEstimatorPatchMatch(benchmark::State& state) {
+  const PlaneViews views(state.range(0), 3 * state.range(0) / 4, 4);
+  for (auto _ : state) {
+    auto estimator = views.CreateEstimator();
+    dense::DepthmapEstimatorResult result;
+    estimator.ComputePatchMatch(&result);
+    benchmark::DoNotOptimize(result.depth.data);
+  }
+  state.SetItemsProcessed(state.iterations() * views.width * views.height);
+}
+
+void BM_DepthmapEstimatorBruteForce(benchmark::State& state) {
+  const PlaneViews views(state.range(0), 3 * state.range(0) / 4, 4);
+  for (auto _ : state) {
+    auto estimator = views.CreateEstimator();
+    dense::DepthmapEstimatorResult result;
+    estimator.ComputeBruteForce(&result);
+    benchmark::DoNotOptimize(result.depth.data);
+  }
+  state.SetItemsProcessed(state.iterations() * views.width * views.height);
+}
+
+BENCHMARK(BM_DepthmapEstimatorPatchMatch)
+    ->Arg(160)
+    ->Arg(640)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DepthmapEstimatorBruteForce)
+    ->Arg(160)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <fstream>
 #include <opencv2/opencv.hpp>
 #include <random>
+#include <string>
 
 namespace dense {
 
@@ -54,6 +56,34 @@ struct DepthmapEstimatorResult {
   cv::Mat nghbr;
 };
 
+// Receives the results of ComputePatchMatchTiled, one tile of the reference
+// image at a time
+class DepthmapTileWriter {
+ public:
+  virtual ~DepthmapTileWriter() = default;
+  virtual void Write(const cv::Rect &tile,
+                     const DepthmapEstimatorResult &result) = 0;
+};
+
+// Streams the tiles to <prefix>depth.npy, <prefix>plane.npy,
+// <prefix>score.npy and <prefix>nghbr.npy, which can be memory-mapped
+class DepthmapNpyWriter : public DepthmapTileWriter {
+ public:
+  DepthmapNpyWriter(const std::string &prefix, int width, int height);
+  void Write(const cv::Rect &tile,
+             const DepthmapEstimatorResult &result) override;
+
+ private:
+  struct File {
+    std::fstream stream;
+    std::streamoff data_offset;
+  };
+  void WriteTile(const cv::Rect &tile, const cv::Mat &values, File *file);
+
+  int width_, height_;
+  File depth_, plane_, score_, nghbr_;
+};
+
 class DepthmapEstimator {
  public:
   DepthmapEstimator();
@@ -67,6 +97,12 @@ class DepthmapEstimator {
   void ComputeBruteForce(DepthmapEstimatorResult *result);
   void ComputePatchMatch(DepthmapEstimatorResult *result);
   void ComputePatchMatchSample(DepthmapEstimatorResult *result);
+  // Same as ComputePatchMatch(Sample), on overlapping tiles of the reference
+  // image computed one at a time. Each tile only uses the regions of the
+  // neighbour views which its depth range can reach.
+  void ComputePatchMatchTiled(int tile_size, int halo, bool sample,
+                              DepthmapTileWriter *writer);
+  cv::Rect ReachableRegion(const cv::Rect &region, int other) const;
   void AssignMatrices(DepthmapEstimatorResult *result);
   void RandomInitialization(DepthmapEstimatorResult *result, bool sample);
   void ComputeIgnoreMask(DepthmapEstimatorResult *result);
@@ -91,6 +127,9 @@ class DepthmapEstimator {
   void PostProcess(DepthmapEstimatorResult *result);
 
  private:
+  void PushView(const cv::Matx33d &K, const cv::Matx33d &R,
+                const cv::Vec3d &t, const cv::Mat &image, const cv::Mat &mask);
+
   std::vector<cv::Mat> images_;
   std::vector<cv::Mat> masks_;
   std::vector<cv::Matx33d> Ks_;
@@ -16,6 +16,11 @@ class DepthmapEstimatorWrapper {
     }
     de_.AddView(K.data(), R.data(), t.data(), image.data(), mask.data(),
                 image.shape(1), image.shape(0));
+    if (!has_reference_) {
+      width_ = image.shape(1);
+      height_ = image.shape(0);
+      has_reference_ = true;
+    }
   }
 
   void SetDepthRange(double min_depth, double max_depth, int num_depth_planes) {
@@ -55,6 +60,13 @@ class DepthmapEstimatorWrapper {
     return ComputeReturnValues(result);
   }
 
+  void ComputePatchMatchTiled(int tile_size, int halo, bool sample,
+                              const std::string &prefix) {
+    py::gil_scoped_release release;
+    DepthmapNpyWriter writer(prefix, width_, height_);
+    de_.ComputePatchMatchTiled(tile_size, halo, sample, &writer);
+  }
+
   py::object ComputeReturnValues(const DepthmapEstimatorResult &result) {
     py::list retn;
     retn.append(foundation::py_array_from_data(
@@ -70,6 +82,9 @@ class DepthmapEstimatorWrapper {
 
  private:
   DepthmapEstimator de_;
+  bool has_reference_{false};
+  int width_{0};
+  int height_{0};
 };
 
 class DepthmapCleanerWrapper {
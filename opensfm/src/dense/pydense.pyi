@@ -16,7 +16,11 @@ __all__  = [
 "DepthmapCleaner",
 "DepthmapEstimator",
 "DepthmapPruner",
-"OpenMVSExporter"
+"OpenMVSExporter",
+"clear_tracing",
+"get_tracing_events",
+"is_tracing_enabled",
+"set_tracing_enabled"
 ]
 class DepthmapCleaner:
     def __init__(self) -> None: ...
@@ -30,6 +34,7 @@ class DepthmapEstimator:
     def compute_brute_force(self) -> object: ...
     def compute_patch_match(self) -> object: ...
     def compute_patch_match_sample(self) -> object: ...
+    def compute_patch_match_tiled(self, tile_size: int, halo: int, sample: bool, prefix: str) -> None: ...
     def set_depth_range(self, arg0: float, arg1: float, arg2: int) -> None: ...
     def set_min_patch_sd(self, arg0: float) -> None: ...
     def set_patch_size(self, arg0: int) -> None: ...
@@ -45,3 +50,8 @@ class OpenMVSExporter:
     def add_point(self, arg0: numpy.ndarray, arg1: list) -> None: ...
     def add_shot(self, arg0: str, arg1: str, arg2: str, arg3: str, arg4: numpy.ndarray, arg5: numpy.ndarray) -> None: ...
     def export(self, arg0: str) -> None: ...
+
+def clear_tracing() -> None: ...
+def get_tracing_events() -> str: ...
+def is_tracing_enabled() -> bool: ...
+def set_tracing_enabled(arg0: bool) -> None: ...
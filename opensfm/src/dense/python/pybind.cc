@@ -1,11 +1,13 @@
 #include <dense/depthmap_bind.h>
 #include <dense/openmvs_exporter.h>
 #include <foundation/python_types.h>
+#include <foundation/tracing_bind.h>
 #include <pybind11/eigen.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 PYBIND11_MODULE(pydense, m) {
+  foundation::AddTracingBindings(m);
   py::class_<dense::OpenMVSExporter>(m, "OpenMVSExporter")
       .def(py::init())
       .def("add_camera", &dense::OpenMVSExporter::AddCamera)
@@ -26,7 +28,11 @@ PYBIND11_MODULE(pydense, m) {
       .def("compute_patch_match_sample",
            &dense::DepthmapEstimatorWrapper::ComputePatchMatchSample)
       .def("compute_brute_force",
-           &dense::DepthmapEstimatorWrapper::ComputeBruteForce);
+           &dense::DepthmapEstimatorWrapper::ComputeBruteForce)
+      .def("compute_patch_match_tiled",
+           &dense::DepthmapEstimatorWrapper::ComputePatchMatchTiled,
+           py::arg("tile_size"), py::arg("halo"), py::arg("sample"),
+           py::arg("prefix"));
 
   py::class_<dense::DepthmapCleanerWrapper>(m, "DepthmapCleaner")
       .def(py::init())
@@ -1,6 +1,10 @@
 #include "../depthmap.h"
 
+#include <foundation/tracing.h>
+
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <opencv2/opencv.hpp>
 #include <random>
 
@@ -148,14 +152,22 @@ void DepthmapEstimator::AddView(const double *pK, const double *pR,
                                 const double *pt, const unsigned char *pimage,
                                 const unsigned char *pmask, int width,
                                 int height) {
-  Ks_.emplace_back(pK);
-  Rs_.emplace_back(pR);
-  ts_.emplace_back(pt);
+  PushView(cv::Matx33d(pK), cv::Matx33d(pR), cv::Vec3d(pt),
+           cv::Mat(height, width, CV_8U, (void *)pimage).clone(),
+           cv::Mat(height, width, CV_8U, (void *)pmask).clone());
+}
+
+void DepthmapEstimator::PushView(const cv::Matx33d &K, const cv::Matx33d &R,
+                                 const cv::Vec3d &t, const cv::Mat &image,
+                                 const cv::Mat &mask) {
+  Ks_.emplace_back(K);
+  Rs_.emplace_back(R);
+  ts_.emplace_back(t);
   Kinvs_.emplace_back(Ks_.back().inv());
   Qs_.emplace_back(Rs_.back() * Rs_.front().t());
   as_.emplace_back(Qs_.back() * ts_.front() - ts_.back());
-  images_.emplace_back(cv::Mat(height, width, CV_8U, (void *)pimage).clone());
-  masks_.emplace_back(cv::Mat(height, width, CV_8U, (void *)pmask).clone());
+  images_.emplace_back(image);
+  masks_.emplace_back(mask);
   std::size_t size = images_.size();
   int a = (size > 1) ? 1 : 0;
   int b = (size > 1) ? size - 1 : 0;
@@ -183,6 +195,7 @@ void DepthmapEstimator::SetMinPatchSD(float sd) {
 }
 
 void DepthmapEstimator::ComputeBruteForce(DepthmapEstimatorResult *result) {
+  OPENSFM_TRACE_SCOPE("dense", "DepthmapEstimator::ComputeBruteForce");
   AssignMatrices(result);
 
   int hpz = (patch_size_ - 1) / 2;
@@ -201,6 +214,7 @@ void DepthmapEstimator::ComputeBruteForce(DepthmapEstimatorResult *result) {
 }
 
 void DepthmapEstimator::ComputePatchMatch(DepthmapEstimatorResult *result) {
+  OPENSFM_TRACE_SCOPE("dense", "DepthmapEstimator::ComputePatchMatch");
   AssignMatrices(result);
   RandomInitialization(result, false);
   ComputeIgnoreMask(result);
@@ -215,6 +229,7 @@ void DepthmapEstimator::ComputePatchMatch(DepthmapEstimatorResult *result) {
 
 void DepthmapEstimator::ComputePatchMatchSample(
     DepthmapEstimatorResult *result) {
+  OPENSFM_TRACE_SCOPE("dense", "DepthmapEstimator::ComputePatchMatchSample");
   AssignMatrices(result);
   RandomInitialization(result, true);
   ComputeIgnoreMask(result);
@@ -227,7 +242,122 @@ void DepthmapEstimator::ComputePatchMatchSample(
   PostProcess(result);
 }
 
+cv::Rect DepthmapEstimator::ReachableRegion(const cv::Rect &region,
+                                            int other) const {
+  const cv::Rect image(0, 0, images_[other].cols, images_[other].rows);
+
+  // The points of 'region' within the depth range are in the frustum of its
+  // corners. When all in front of 'other', their projections are inside the
+  // convex hull of the projected frustum corners.
+  double x_min = std::numeric_limits<double>::max(), x_max = -x_min;
+  double y_min = x_min, y_max = -x_min;
+  for (int corner = 0; corner < 4; ++corner) {
+    const double x = region.x + (corner & 1 ? region.width - 1 : 0);
+    const double y = region.y + (corner & 2 ? region.height - 1 : 0);
+    for (const double depth : {min_depth_, max_depth_}) {
+      const cv::Vec3d point = Backproject(x, y, depth, Ks_[0], Rs_[0], ts_[0]);
+      const cv::Vec3d p = Project(point, Ks_[other], Rs_[other], ts_[other]);
+      if (p(2) < z_epsilon) {
+        return image;
+      }
+      x_min = std::min(x_min, p(0) / p(2));
+      x_max = std::max(x_max, p(0) / p(2));
+      y_min = std::min(y_min, p(1) / p(2));
+      y_max = std::max(y_max, p(1) / p(2));
+    }
+  }
+
+  // Margin for the patches around the projections
+  const int margin = 2 * patch_size_;
+  const double x0 = std::max(std::floor(x_min) - margin, 0.0);
+  const double y0 = std::max(std::floor(y_min) - margin, 0.0);
+  const double x1 =
+      std::min(std::ceil(x_max) + margin + 1, double(image.width));
+  const double y1 =
+      std::min(std::ceil(y_max) + margin + 1, double(image.height));
+  if (x1 <= x0 || y1 <= y0) {
+    return cv::Rect();
+  }
+  return cv::Rect(int(x0), int(y0), int(x1 - x0), int(y1 - y0));
+}
+
+void DepthmapEstimator::ComputePatchMatchTiled(int tile_size, int halo,
+                                               bool sample,
+                                               DepthmapTileWriter *writer) {
+  OPENSFM_TRACE_SCOPE("dense", "DepthmapEstimator::ComputePatchMatchTiled");
+  if (images_.empty()) {
+    throw std::runtime_error("No view added to the depthmap estimator");
+  }
+  if (tile_size <= 0) {
+    throw std::runtime_error("Tile size must be positive");
+  }
+
+  // The halo must at least cover the patches and the post-processing
+  // median filter of the tile borders
+  const int hpz = (patch_size_ - 1) / 2;
+  halo = std::max(halo, hpz + 2);
+
+  const cv::Rect image(0, 0, images_[0].cols, images_[0].rows);
+  const int num_views = images_.size();
+  for (int y = 0; y < image.height; y += tile_size) {
+    for (int x = 0; x < image.width; x += tile_size) {
+      OPENSFM_TRACE_SCOPE("dense", "DepthmapEstimator::ComputeTile");
+      const cv::Rect tile = cv::Rect(x, y, tile_size, tile_size) & image;
+      const cv::Rect region =
+          cv::Rect(tile.x - halo, tile.y - halo, tile.width + 2 * halo,
+                   tile.height + 2 * halo) &
+          image;
+
+      // Estimator of the region, with the reachable part of each neighbour
+      // view. Cropping a view shifts its principal point.
+      DepthmapEstimator estimator;
+      estimator.SetDepthRange(min_depth_, max_depth_, num_depth_planes_);
+      estimator.SetPatchMatchIterations(patchmatch_iterations_);
+      estimator.SetPatchSize(patch_size_);
+      estimator.min_patch_variance_ = min_patch_variance_;
+      std::vector<int> views;
+      for (int view = 0; view < num_views; ++view) {
+        const cv::Rect crop =
+            view == 0 ? region : ReachableRegion(region, view);
+        if (crop.empty()) {
+          continue;
+        }
+        const cv::Matx33d shift(1, 0, -crop.x, 0, 1, -crop.y, 0, 0, 1);
+        estimator.PushView(shift * Ks_[view], Rs_[view], ts_[view],
+                           images_[view](crop).clone(),
+                           masks_[view](crop).clone());
+        views.push_back(view);
+      }
+
+      DepthmapEstimatorResult result;
+      if (views.size() < 2) {
+        estimator.AssignMatrices(&result);
+      } else if (sample) {
+        estimator.ComputePatchMatchSample(&result);
+      } else {
+        estimator.ComputePatchMatch(&result);
+      }
+      for (int i = 0; i < result.nghbr.rows; ++i) {
+        for (int j = 0; j < result.nghbr.cols; ++j) {
+          int &nghbr = result.nghbr.at<int>(i, j);
+          nghbr = views[nghbr];
+        }
+      }
+
+      const cv::Rect roi = tile - region.tl();
+      DepthmapEstimatorResult tile_result;
+      tile_result.depth = result.depth(roi);
+      tile_result.plane = result.plane(roi);
+      tile_result.score = result.score(roi);
+      tile_result.nghbr = result.nghbr(roi);
+      writer->Write(tile, tile_result);
+    }
+  }
+}
+
 void DepthmapEstimator::AssignMatrices(DepthmapEstimatorResult *result) {
+  OPENSFM_TRACE_COUNTER("dense", "pixels", images_[0].rows * images_[0].cols);
+  OPENSFM_TRACE_COUNTER("dense", "views", images_.size());
   result->depth = cv::Mat(images_[0].rows, images_[0].cols, CV_32F, 0.0f);
   result->plane = cv::Mat(images_[0].rows, images_[0].cols, CV_32FC3, 0.0f);
   result->score = cv::Mat(images_[0].rows, images_[0].cols, CV_32F, 0.0f);
@@ -488,6 +618,7 @@ float DepthmapEstimator::BilateralWeight(float dcolor, float dx, float dy) {
 }
 
 void DepthmapEstimator::PostProcess(DepthmapEstimatorResult *result) {
+  OPENSFM_TRACE_SCOPE("dense", "DepthmapEstimator::PostProcess");
   cv::Mat depth_filtered;
   cv::medianBlur(result->depth, depth_filtered, 5);
 
@@ -502,6 +633,94 @@ void DepthmapEstimator::PostProcess(DepthmapEstimatorResult *result) {
   }
 }
 
+namespace {
+
+// Header of a version 1.0 .npy file, padded for the data to be aligned on 64
+// bytes
+std::string NpyHeader(const std::string &descr, int height, int width,
+                      int channels) {
+  std::string shape = std::to_string(height) + ", " + std::to_string(width);
+  if (channels > 1) {
+    shape += ", " + std::to_string(channels);
+  }
+  std::string dict = "{'descr': '" + descr +
+                     "', 'fortran_order': False, 'shape': (" + shape + "), }";
+  const int prefix_size = 10;
+  dict.append((64 - (prefix_size + dict.size() + 1) % 64) % 64, ' ');
+  dict.push_back('\n');
+
+  std::string header("\x93NUMPY\x01\x00", 8);
+  header.push_back(static_cast<char>(dict.size() & 0xff));
+  header.push_back(static_cast<char>(dict.size() >> 8));
+  return header + dict;
+}
+}  // namespace
+
+DepthmapNpyWriter::DepthmapNpyWriter(const std::string &prefix, int width,
+                                     int height)
+    : width_(width), height_(height) {
+  const struct {
+    const char *name;
+    const char *descr;
+    int channels;
+    File *file;
+  } outputs[] = {{"depth", "<f4", 1, &depth_},
+                 {"plane", "<f4", 3, &plane_},
+                 {"score", "<f4", 1, &score_},
+                 {"nghbr", "<i4", 1, &nghbr_}};
+  for (const auto &output : outputs) {
+    const std::string filename = prefix + output.name + ".npy";
+    const std::string header =
+        NpyHeader(output.descr, height, width, output.channels);
+    const std::streamoff data_size =
+        std::streamoff(4) * output.channels * width * height;
+
+    // Allocate the whole file, then reopen it for writing tiles in place
+    {
+      std::ofstream create(filename, std::ios::binary | std::ios::trunc);
+      create << header;
+      if (data_size > 0) {
+        create.seekp(header.size() + data_size - 1);
+        create.put('\0');
+      }
+      if (!create) {
+        throw std::runtime_error("Can't write depthmap file " + filename);
+      }
+    }
+    output.file->stream.open(filename,
+                             std::ios::binary | std::ios::in | std::ios::out);
+    if (!output.file->stream.is_open()) {
+      throw std::runtime_error("Can't write depthmap file " + filename);
+    }
+    output.file->data_offset = header.size();
+  }
+}
+
+void DepthmapNpyWriter::Write(const cv::Rect &tile,
+                              const DepthmapEstimatorResult &result) {
+  if ((tile & cv::Rect(0, 0, width_, height_)) != tile) {
+    throw std::runtime_error("Depthmap tile is outside of the image");
+  }
+  WriteTile(tile, result.depth, &depth_);
+  WriteTile(tile, result.plane, &plane_);
+  WriteTile(tile, result.score, &score_);
+  WriteTile(tile, result.nghbr, &nghbr_);
+}
+
+void DepthmapNpyWriter::WriteTile(const cv::Rect &tile, const cv::Mat &values,
+                                  File *file) {
+  const std::streamoff element_size = values.elemSize();
+  for (int i = 0; i < tile.height; ++i) {
+    const std::streamoff position =
+        std::streamoff(tile.y + i) * width_ + tile.x;
+    file->stream.seekp(file->data_offset + position * element_size);
+    file->stream.write(values.ptr<char>(i), tile.width * element_size);
+  }
+  if (!file->stream) {
+    throw std::runtime_error("Can't write depthmap tile");
+  }
+}
+
 DepthmapCleaner::DepthmapCleaner()
     : same_depth_threshold_(0.01), min_consistent_views_(2) {}
 
@@ -1,6 +1,10 @@
 #include <dense/depthmap.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 #include <opencv2/calib3d/calib3d.hpp>
 
 namespace {
@@ -71,4 +75,173 @@ TEST(NCCEstimator, Simple) {
   EXPECT_NEAR(ncc.Get(), 1.0, 1e-6);
 }
 
+// Views of a textured plane at depth 5, from cameras translated along x
+class TexturedPlaneTest : public ::testing::Test {
+ protected:
+  void AddView(DepthmapEstimator *estimator, double center_x) {
+    const cv::Matx33d R = cv::Matx33d::eye();
+    const cv::Vec3d t(-center_x, 0, 0);
+    cv::Mat image(height, width, CV_8U);
+    for (int i = 0; i < height; ++i) {
+      for (int j = 0; j < width; ++j) {
+        const double x = (j - K(0, 2)) / K(0, 0) * depth + center_x;
+        const double y = (i - K(1, 2)) / K(1, 1) * depth;
+        const double value = 128 + 50 * std::sin(9 * x + 2 * y) +
+                             40 * std::sin(40 * x) * std::sin(37 * y);
+        image.at<unsigned char>(i, j) = cv::saturate_cast<uchar>(value);
+      }
+    }
+    const cv::Mat mask(height, width, CV_8U, cv::Scalar(255));
+    estimator->AddView(K.val, R.val, t.val, image.ptr<uchar>(0),
+                       mask.ptr<uchar>(0), width, height);
+  }
+
+  const int width = 200;
+  const int height = 150;
+  const double depth = 5.0;
+  const cv::Matx33d K{200, 0, 100, 0, 200, 75, 0, 0, 1};
+};
+
+class CollectingTileWriter : public DepthmapTileWriter {
+ public:
+  CollectingTileWriter(int width, int height)
+      : depth(height, width, CV_32F, 0.0f),
+        coverage(height, width, CV_32S, cv::Scalar(0)) {}
+
+  void Write(const cv::Rect &tile,
+             const DepthmapEstimatorResult &result) override {
+    result.depth.copyTo(depth(tile));
+    cv::Mat tile_coverage = coverage(tile);
+    tile_coverage += 1;
+  }
+
+  cv::Mat depth;
+  cv::Mat coverage;
+};
+
+TEST_F(TexturedPlaneTest, ReachableRegionContainsDepthRange) {
+  DepthmapEstimator estimator;
+  estimator.SetDepthRange(2, 10, 50);
+  AddView(&estimator, 0.0);
+  AddView(&estimator, 0.5);
+
+  const cv::Rect region(120, 40, 40, 30);
+  const cv::Rect reachable = estimator.ReachableRegion(region, 1);
+  ASSERT_FALSE(reachable.empty());
+  ASSERT_LT(reachable.area(), width * height);
+  for (const double d : {2.0, 3.0, 5.0, 10.0}) {
+    for (const auto &corner : {region.tl(), region.br() - cv::Point(1, 1)}) {
+      const cv::Vec3d point = Backproject(corner.x, corner.y, d, K,
+                                          cv::Matx33d::eye(), cv::Vec3d());
+      const cv::Vec3d p =
+          Project(point, K, cv::Matx33d::eye(), cv::Vec3d(-0.5, 0, 0));
+      const cv::Point2d pixel(p(0) / p(2), p(1) / p(2));
+      if (pixel.inside(cv::Rect2d(0, 0, width, height))) {
+        EXPECT_TRUE(pixel.inside(cv::Rect2d(reachable)));
+      }
+    }
+  }
+}
+
+TEST_F(TexturedPlaneTest, TiledPatchMatchFindsPlane) {
+  DepthmapEstimator estimator;
+  estimator.SetDepthRange(2, 10, 50);
+  AddView(&estimator, 0.0);
+  AddView(&estimator, 0.5);
+
+  CollectingTileWriter writer(width, height);
+  estimator.ComputePatchMatchTiled(64, 16, false, &writer);
+  EXPECT_EQ(width * height, cv::countNonZero(writer.coverage == 1));
+
+  // Most of the pixels seen by both views are on the plane
+  const cv::Rect overlap(30, 10, 140, 130);
+  int on_plane = 0;
+  for (int i = overlap.y; i < overlap.br().y; ++i) {
+    for (int j = overlap.x; j < overlap.br().x; ++j) {
+      const float d = writer.depth.at<float>(i, j);
+      on_plane += std::abs(d - depth) < 0.05 * depth;
+    }
+  }
+  EXPECT_GT(on_plane, 0.5 * overlap.area());
+}
+
+TEST_F(TexturedPlaneTest, TiledPatchMatchMatchesUntiled) {
+  DepthmapEstimator untiled_estimator;
+  untiled_estimator.SetDepthRange(2, 10, 50);
+  AddView(&untiled_estimator, 0.0);
+  AddView(&untiled_estimator, 0.5);
+  DepthmapEstimatorResult untiled;
+  untiled_estimator.ComputePatchMatch(&untiled);
+
+  DepthmapEstimator tiled_estimator;
+  tiled_estimator.SetDepthRange(2, 10, 50);
+  AddView(&tiled_estimator, 0.0);
+  AddView(&tiled_estimator, 0.5);
+  CollectingTileWriter tiled(width, height);
+  tiled_estimator.ComputePatchMatchTiled(64, 16, false, &tiled);
+  ASSERT_EQ(untiled.depth.size(), tiled.depth.size());
+
+  // Initializations are random, so depths only agree where both found the
+  // plane, and tiles find it about as often as the whole image
+  const cv::Rect overlap(30, 10, 140, 130);
+  int untiled_on_plane = 0, tiled_on_plane = 0, both_valid = 0, agree = 0;
+  for (int i = overlap.y; i < overlap.br().y; ++i) {
+    for (int j = overlap.x; j < overlap.br().x; ++j) {
+      const float d_untiled = untiled.depth.at<float>(i, j);
+      const float d_tiled = tiled.depth.at<float>(i, j);
+      untiled_on_plane += std::abs(d_untiled - depth) < 0.05 * depth;
+      tiled_on_plane += std::abs(d_tiled - depth) < 0.05 * depth;
+      if (d_untiled > 0 && d_tiled > 0) {
+        ++both_valid;
+        agree += std::abs(d_untiled - d_tiled) < 0.05 * depth;
+      }
+    }
+  }
+  EXPECT_GT(untiled_on_plane, 0.5 * overlap.area());
+  EXPECT_GT(tiled_on_plane, 0.9 * untiled_on_plane);
+  ASSERT_GT(both_valid, 0);
+  EXPECT_GT(agree, 0.8 * both_valid);
+}
+
+TEST(DepthmapNpyWriter, WritesTilesInPlace) {
+  const std::string prefix = std::tmpnam(nullptr);
+  {
+    DepthmapNpyWriter writer(prefix, 3, 2);
+    for (int x = 0; x < 3; x += 2) {
+      const cv::Rect tile(x, 0, std::min(2, 3 - x), 2);
+      DepthmapEstimatorResult result;
+      result.depth = cv::Mat(tile.size(), CV_32F);
+      for (int i = 0; i < tile.height; ++i) {
+        for (int j = 0; j < tile.width; ++j) {
+          result.depth.at<float>(i, j) = (i + tile.y) * 3 + j + tile.x;
+        }
+      }
+      result.plane = cv::Mat(tile.size(), CV_32FC3, cv::Scalar(1, 2, 3));
+      result.score = cv::Mat(tile.size(), CV_32F, 0.5f);
+      result.nghbr = cv::Mat(tile.size(), CV_32S, cv::Scalar(1));
+      writer.Write(tile, result);
+    }
+  }
+
+  for (const std::string name : {"depth", "plane", "score", "nghbr"}) {
+    std::ifstream file(prefix + name + ".npy", std::ios::binary);
+    const std::string content((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+    std::remove((prefix + name + ".npy").c_str());
+    ASSERT_EQ("\x93NUMPY", content.substr(0, 6));
+    const size_t data_size = (name == "plane" ? 3 : 1) * 6 * 4;
+    ASSERT_GT(content.size(), data_size);
+    const size_t data_offset = content.size() - data_size;
+    EXPECT_EQ(0, data_offset % 64);
+    EXPECT_EQ('\n', content[data_offset - 1]);
+    if (name == "depth") {
+      const float *depth =
+          reinterpret_cast<const float *>(content.data() + data_offset);
+      for (int k = 0; k < 6; ++k) {
+        EXPECT_EQ(k, depth[k]);
+      }
+    }
+  }
+}
+
 }  // namespace
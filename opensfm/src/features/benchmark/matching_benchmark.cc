@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+#include <features/matching.h>
+
+#include <opencv2/core/core.hpp>
+
+namespace {
+
+/* Synthetic features : the second image holds noisy copies of the first
+ * image descriptors, and each feature is assigned 'words_count' random
+ * words of a vocabulary of 'vocabulary_size' words. */
+struct WordsMatchingData {
+  WordsMatchingData(int features_count, int words_count)
+      : f1(features_count, 128, CV_32F),
+        w1(features_count, words_count, CV_32S),
+        f2(features_count, 128, CV_32F),
+        w2(features_count, words_count, CV_32S) {
+    constexpr int vocabulary_size = 1000;
+
+    cv::RNG rng(42);
+    rng.fill(f1, cv::RNG::UNIFORM, 0.0, 1.0);
+    cv::Mat noise(f1.size(), CV_32F);
+    rng.fill(noise, cv::RNG::NORMAL, 0.0, 0.05);
+    f2 = f1 + noise;
+
+    rng.fill(w1, cv::RNG::UNIFORM, 0, vocabulary_size);
+    w1.copyTo(w2);
+    // Only the best word of a feature is guaranteed to be shared
+    cv::Mat other_words = w2.colRange(1, words_count);
+    rng.fill(other_words, cv::RNG::UNIFORM, 0, vocabulary_size);
+  }
+
+  cv::Mat f1, w1, f2, w2;
+};
+
+void BM_MatchUsingWords(benchmark::State& state) {
+  const WordsMatchingData data(state.range(0), 10);
+  cv::Mat matches;
+  for (auto _ : state) {
+    features::MatchUsingWords(data.f1, data.w1, data.f2, data.w2, 0.8, 50,
+                              &matches);
+    benchmark::DoNotOptimize(matches.data);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_MatchUsingWords)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -4,7 +4,12 @@
 
 namespace features {
 
+// Detect Hessian-affine features and compute their SIFT descriptors. If
+// 'min_peak_threshold' is lower than 'peak_threshold', the scale space is
+// built once and the threshold is lowered by steps of 2/3, down to
+// 'min_peak_threshold', until 'target_num_features' are found.
 py::tuple hahog(foundation::pyarray_f image, float peak_threshold,
-                float edge_threshold, int target_num_features);
+                float edge_threshold, int target_num_features,
+                float min_peak_threshold);
 
 }
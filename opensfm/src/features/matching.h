@@ -7,6 +7,10 @@
 
 namespace features {
 
+void MatchUsingWords(const cv::Mat &f1, const cv::Mat &w1, const cv::Mat &f2,
+                     const cv::Mat &w2, float lowes_ratio, int max_checks,
+                     cv::Mat *matches);
+
 py::array_t<int> match_using_words(foundation::pyarray_f features1,
                                    foundation::pyarray_int words1,
                                    foundation::pyarray_f features2,
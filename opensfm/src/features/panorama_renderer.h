@@ -0,0 +1,56 @@
+#pragma once
+
+#include <foundation/types.h>
+#include <geometry/camera.h>
+
+#include <opencv2/core/core.hpp>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace features {
+
+/* Render perspective views of panoramas by remapping their pixels.
+ *
+ * The remap grids only depend on the panorama camera and image size, the view
+ * camera and the view rotation relative to the panorama. They are the same
+ * for all the panoramas of a dataset, so they are computed once and cached.
+ * The oldest grids are dropped once 'max_cached_grids' are stored. */
+class PanoramaRenderer {
+ public:
+  explicit PanoramaRenderer(size_t max_cached_grids = 32);
+
+  // Render one view of 'image' per camera and rotation. Rotations are from
+  // the view camera to the panorama camera coordinates. 'interpolation' and
+  // 'border_mode' are OpenCV's remap flags.
+  std::vector<cv::Mat> Render(const cv::Mat& image,
+                              const geometry::Camera& panorama_camera,
+                              const std::vector<geometry::Camera>& cameras,
+                              const std::vector<Mat3d>& rotations,
+                              int interpolation, int border_mode,
+                              int num_threads);
+
+  size_t NumCachedGrids() const;
+  void ClearCache();
+
+ private:
+  struct Grid {
+    cv::Mat x;
+    cv::Mat y;
+  };
+
+  std::shared_ptr<const Grid> GetGrid(const geometry::Camera& panorama_camera,
+                                      int panorama_width, int panorama_height,
+                                      const geometry::Camera& camera,
+                                      const Mat3d& rotation, int num_threads);
+
+  const size_t max_cached_grids_;
+  mutable std::mutex mutex_;
+  std::map<std::string, std::shared_ptr<const Grid>> grids_;
+  std::deque<std::string> grids_order_;
+};
+}  // namespace features
@@ -11,16 +11,22 @@
 # pyre-ignore-all-errors[5,24]
 
 import numpy
+import opensfm.pygeometry
 from typing import *
 __all__  = [
 "AKAZEOptions",
 "AkazeDescriptorType",
 "AkazeDiffusivityType",
+"PanoramaRenderer",
 "akaze",
+"clear_tracing",
 "compute_vlad_descriptor",
 "compute_vlad_distances",
+"get_tracing_events",
 "hahog",
-"match_using_words"
+"is_tracing_enabled",
+"match_using_words",
+"set_tracing_enabled"
 ]
 class AKAZEOptions:
     def __init__(self) -> None: ...
@@ -138,8 +144,17 @@ class AkazeDiffusivityType:
     __members__: Dict[str, "AkazeDiffusivityType"]
     @property
     def name(self) -> str: ...
+class PanoramaRenderer:
+    def __init__(self, max_cached_grids: int = 32) -> None: ...
+    def clear_cache(self) -> None: ...
+    def num_cached_grids(self) -> int: ...
+    def render(self, image: numpy.ndarray, panorama_camera: opensfm.pygeometry.Camera, cameras: List[opensfm.pygeometry.Camera], rotations: List[numpy.ndarray], interpolation: int, border_mode: int, num_threads: int = 1) -> list: ...
 def akaze(arg0: numpy.ndarray, arg1: AKAZEOptions) -> tuple:...
+def clear_tracing() -> None:...
 def compute_vlad_descriptor(arg0: numpy.ndarray, arg1: numpy.ndarray) -> numpy.ndarray:...
 def compute_vlad_distances(arg0: Dict[str, numpy.ndarray], arg1: str, arg2: Set[str]) -> Tuple[List[float], List[str]]:...
-def hahog(image: numpy.ndarray, peak_threshold: float = 0.003, edge_threshold: float = 10, target_num_features: int = 0) -> tuple:...
+def get_tracing_events() -> str:...
+def hahog(image: numpy.ndarray, peak_threshold: float = 0.003, edge_threshold: float = 10, target_num_features: int = 0, min_peak_threshold: float = 0.0) -> tuple:...
+def is_tracing_enabled() -> bool:...
 def match_using_words(arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: numpy.ndarray, arg3: numpy.ndarray, arg4: float, arg5: int) -> numpy.ndarray:...
+def set_tracing_enabled(arg0: bool) -> None:...
@@ -1,12 +1,52 @@
 #include <features/akaze_bind.h>
 #include <features/hahog.h>
 #include <features/matching.h>
+#include <features/panorama_renderer.h>
 #include <foundation/python_types.h>
+#include <foundation/tracing_bind.h>
 #include <pybind11/eigen.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <cstring>
+
+namespace {
+// OpenCV header over an (height, width[, channels]) image array
+cv::Mat ImageView(const py::array& image) {
+  if (!(image.flags() & py::array::c_style) || image.ndim() < 2 ||
+      image.ndim() > 3) {
+    throw std::runtime_error("Expected a contiguous image array");
+  }
+  const int channels = image.ndim() == 3 ? image.shape(2) : 1;
+  int depth = 0;
+  if (image.dtype().is(py::dtype::of<uint8_t>())) {
+    depth = CV_8U;
+  } else if (image.dtype().is(py::dtype::of<uint16_t>())) {
+    depth = CV_16U;
+  } else if (image.dtype().is(py::dtype::of<float>())) {
+    depth = CV_32F;
+  } else {
+    throw std::runtime_error("Unsupported image type");
+  }
+  return cv::Mat(image.shape(0), image.shape(1), CV_MAKETYPE(depth, channels),
+                 const_cast<void*>(image.data()));
+}
+
+py::array ImageArray(const cv::Mat& image, const py::array& like) {
+  std::vector<py::ssize_t> shape = {image.rows, image.cols};
+  if (like.ndim() == 3) {
+    shape.push_back(image.channels());
+  }
+  py::array array(like.dtype(), shape);
+  std::memcpy(array.mutable_data(), image.data,
+              image.total() * image.elemSize());
+  return array;
+}
+}  // namespace
+
 PYBIND11_MODULE(pyfeatures, m) {
+  foundation::AddTracingBindings(m);
+  py::module::import("opensfm.pygeometry");
   py::enum_<DESCRIPTOR_TYPE>(m, "AkazeDescriptorType")
       .value("SURF_UPRIGHT", SURF_UPRIGHT)
       .value("SURF", SURF)
@@ -55,11 +95,43 @@ PYBIND11_MODULE(pyfeatures, m) {
 
   m.def("hahog", features::hahog, py::arg("image"),
         py::arg("peak_threshold") = 0.003, py::arg("edge_threshold") = 10,
-        py::arg("target_num_features") = 0);
+        py::arg("target_num_features") = 0,
+        py::arg("min_peak_threshold") = 0.0);
 
   m.def("match_using_words", features::match_using_words);
   m.def("compute_vlad_descriptor", features::compute_vlad_descriptor,
         py::call_guard<py::gil_scoped_release>());
   m.def("compute_vlad_distances", features::compute_vlad_distances,
         py::call_guard<py::gil_scoped_release>());
+
+  py::class_<features::PanoramaRenderer>(m, "PanoramaRenderer")
+      .def(py::init<size_t>(), py::arg("max_cached_grids") = 32)
+      .def(
+          "render",
+          [](features::PanoramaRenderer& self, const py::array& image,
+             const geometry::Camera& panorama_camera,
+             const std::vector<geometry::Camera>& cameras,
+             const std::vector<Mat3d>& rotations, int interpolation,
+             int border_mode, int num_threads) {
+            const py::array contiguous =
+                py::array::ensure(image, py::array::c_style);
+            const cv::Mat view = ImageView(contiguous);
+            std::vector<cv::Mat> rendered;
+            {
+              py::gil_scoped_release release;
+              rendered =
+                  self.Render(view, panorama_camera, cameras, rotations,
+                              interpolation, border_mode, num_threads);
+            }
+            py::list views;
+            for (const auto& rendered_view : rendered) {
+              views.append(ImageArray(rendered_view, contiguous));
+            }
+            return views;
+          },
+          py::arg("image"), py::arg("panorama_camera"), py::arg("cameras"),
+          py::arg("rotations"), py::arg("interpolation"),
+          py::arg("border_mode"), py::arg("num_threads") = 1)
+      .def("num_cached_grids", &features::PanoramaRenderer::NumCachedGrids)
+      .def("clear_cache", &features::PanoramaRenderer::ClearCache);
 }
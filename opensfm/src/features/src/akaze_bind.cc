@@ -1,5 +1,6 @@
 #include <features/akaze_bind.h>
 #include <foundation/python_types.h>
+#include <foundation/tracing.h>
 #include <third_party/akaze/lib/AKAZE.h>
 
 #include <opencv2/imgproc/imgproc.hpp>
@@ -8,6 +9,7 @@ namespace features {
 
 py::tuple akaze(foundation::pyarray_uint8 image, AKAZEOptions options) {
   py::gil_scoped_release release;
+  OPENSFM_TRACE_SCOPE("features", "akaze");
 
   const cv::Mat img(image.shape(0), image.shape(1), CV_8U,
                     (void *)image.data());
@@ -23,14 +25,22 @@ py::tuple akaze(foundation::pyarray_uint8 image, AKAZEOptions options) {
   libAKAZE::AKAZE evolution(options);
   std::vector<cv::KeyPoint> kpts;
 
-  evolution.Create_Nonlinear_Scale_Space(img_32);
-  evolution.Feature_Detection(kpts);
+  {
+    OPENSFM_TRACE_SCOPE("features", "AKAZE::Create_Nonlinear_Scale_Space");
+    evolution.Create_Nonlinear_Scale_Space(img_32);
+  }
+  {
+    OPENSFM_TRACE_SCOPE("features", "AKAZE::Feature_Detection");
+    evolution.Feature_Detection(kpts);
+  }
 
   // Compute descriptors.
   cv::Mat desc;
-  evolution.Compute_Descriptors(kpts, desc);
-
-  evolution.Show_Computation_Times();
+  {
+    OPENSFM_TRACE_SCOPE("features", "AKAZE::Compute_Descriptors");
+    evolution.Compute_Descriptors(kpts, desc);
+  }
+  OPENSFM_TRACE_COUNTER("features", "features", kpts.size());
 
   // Convert to numpy.
   cv::Mat keys(kpts.size(), 4, CV_32F);
@@ -1,5 +1,8 @@
 #include <features/hahog.h>
+#include <foundation/tracing.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -69,8 +72,40 @@ vl_size run_non_maxima_suppression(VlCovDet *covdet, vl_size num_features,
   return j;
 }
 
-vl_size run_features_selection(VlCovDet *covdet, vl_size target_num_features) {
-  vl_size numFeaturesKept = vl_covdet_get_num_features(covdet);
+// keep the features above the highest threshold of the sequence
+// 'peak_threshold' * (2/3)^k (clamped to 'min_peak_threshold') that gives at
+// least 'target_num_features', as detecting again at decreasing thresholds
+// would do. Features must have been detected at 'min_peak_threshold'.
+vl_size run_threshold_selection(VlCovDet *covdet, vl_size num_features,
+                                float peak_threshold, float min_peak_threshold,
+                                vl_size target_num_features) {
+  VlCovDetFeature *features = (VlCovDetFeature *)vl_covdet_get_features(covdet);
+  const auto count_above = [&](float threshold) {
+    return (vl_size)std::count_if(
+        features, features + num_features,
+        [threshold](const VlCovDetFeature &feature) {
+          return std::fabs(feature.peakScore) >= threshold;
+        });
+  };
+
+  float threshold = peak_threshold;
+  while (threshold > min_peak_threshold &&
+         count_above(threshold) < target_num_features) {
+    threshold = std::max(threshold * 2 / 3, min_peak_threshold);
+  }
+
+  vl_index i, j = 0;
+  for (i = 0; i < (signed)num_features; ++i) {
+    if (std::fabs(features[i].peakScore) >= threshold) {
+      features[j++] = features[i];
+    }
+  }
+  return j;
+}
+
+vl_size run_features_selection(VlCovDet *covdet, vl_size num_features,
+                               vl_size target_num_features) {
+  vl_size numFeaturesKept = num_features;
 
   // keep only 1.5 x targetNumFeatures for speeding-up duplicate detection
   if (target_num_features != 0) {
@@ -123,7 +158,8 @@ std::vector<VlCovDetFeature> vlfeat_covdet_extract_orientations(
 }
 
 py::tuple hahog(foundation::pyarray_f image, float peak_threshold,
-                float edge_threshold, int target_num_features) {
+                float edge_threshold, int target_num_features,
+                float min_peak_threshold) {
   if (!image.size()) {
     return py::none();
   }
@@ -135,12 +171,18 @@ py::tuple hahog(foundation::pyarray_f image, float peak_threshold,
 
   {
     py::gil_scoped_release release;
+    OPENSFM_TRACE_SCOPE("features", "hahog");
 
     // create a detector object
     VlCovDet *covdet = vl_covdet_new(VL_COVDET_METHOD_HESSIAN);
     // set various parameters (optional)
     vl_covdet_set_first_octave(covdet, 0);
-    vl_covdet_set_peak_threshold(covdet, peak_threshold);
+    // detect once at the lowest threshold, and lower the threshold over the
+    // detected features instead of building the scale space again
+    const bool lower_threshold =
+        min_peak_threshold > 0 && min_peak_threshold < peak_threshold;
+    vl_covdet_set_peak_threshold(
+        covdet, lower_threshold ? min_peak_threshold : peak_threshold);
     vl_covdet_set_edge_threshold(covdet, edge_threshold);
 
     // process the image and run the detector
@@ -148,8 +190,16 @@ py::tuple hahog(foundation::pyarray_f image, float peak_threshold,
     vl_covdet_set_non_extrema_suppression_threshold(covdet, 0);
     vl_covdet_detect(covdet, std::numeric_limits<vl_size>::max());
 
+    numFeatures = vl_covdet_get_num_features(covdet);
+    if (lower_threshold) {
+      numFeatures =
+          run_threshold_selection(covdet, numFeatures, peak_threshold,
+                                  min_peak_threshold, target_num_features);
+    }
+
     // select the best features to keep
-    numFeatures = run_features_selection(covdet, target_num_features);
+    numFeatures =
+        run_features_selection(covdet, numFeatures, target_num_features);
 
     // compute the orientation of the features (optional)
     std::vector<VlCovDetFeature> vecFeatures =
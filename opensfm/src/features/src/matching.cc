@@ -1,5 +1,6 @@
 #include <features/matching.h>
 #include <foundation/optional.h>
+#include <foundation/tracing.h>
 #include <foundation/types.h>
 #include <pybind11/pybind11.h>
 
@@ -33,6 +34,8 @@ float DistanceL2(const float *pa, const float *pb, int n) {
 void MatchUsingWords(const cv::Mat &f1, const cv::Mat &w1, const cv::Mat &f2,
                      const cv::Mat &w2, float lowes_ratio, int max_checks,
                      cv::Mat *matches) {
+  OPENSFM_TRACE_SCOPE("features", "MatchUsingWords");
+  OPENSFM_TRACE_COUNTER("features", "features", f1.rows);
   // Index features on the second image.
   std::multimap<int, int> index2;
   const int *pw2 = &w2.at<int>(0, 0);
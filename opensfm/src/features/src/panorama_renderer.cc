@@ -0,0 +1,112 @@
+#include <features/panorama_renderer.h>
+#include <foundation/tracing.h>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+template <class T>
+void AppendBytes(const T& value, std::string* key) {
+  key->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void AppendCamera(const geometry::Camera& camera, int width, int height,
+                  std::string* key) {
+  AppendBytes(static_cast<int>(camera.GetProjectionType()), key);
+  AppendBytes(width, key);
+  AppendBytes(height, key);
+  const VecXd values = camera.GetParametersValues();
+  for (int i = 0; i < values.size(); ++i) {
+    AppendBytes(values(i), key);
+  }
+}
+}  // namespace
+
+namespace features {
+
+PanoramaRenderer::PanoramaRenderer(size_t max_cached_grids)
+    : max_cached_grids_(max_cached_grids) {}
+
+size_t PanoramaRenderer::NumCachedGrids() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return grids_.size();
+}
+
+void PanoramaRenderer::ClearCache() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  grids_.clear();
+  grids_order_.clear();
+}
+
+std::shared_ptr<const PanoramaRenderer::Grid> PanoramaRenderer::GetGrid(
+    const geometry::Camera& panorama_camera, int panorama_width,
+    int panorama_height, const geometry::Camera& camera,
+    const Mat3d& rotation, int num_threads) {
+  // Rotations are rounded, as the ones of the views of different panoramas
+  // are composed from their rig poses
+  std::string key;
+  AppendCamera(panorama_camera, panorama_width, panorama_height, &key);
+  AppendCamera(camera, camera.width, camera.height, &key);
+  for (int i = 0; i < 9; ++i) {
+    AppendBytes(std::llround(rotation(i) * 1e9), &key);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = grids_.find(key);
+    if (it != grids_.end()) {
+      return it->second;
+    }
+  }
+
+  OPENSFM_TRACE_SCOPE("features", "PanoramaRenderer::ComputeGrid");
+  const auto mapping = geometry::ComputeRotatedCameraMapping(
+      panorama_camera, panorama_width, panorama_height, camera, rotation,
+      num_threads);
+  auto grid = std::make_shared<Grid>();
+  cv::Mat(camera.height, camera.width, CV_32F,
+          const_cast<float*>(mapping.first.data()))
+      .copyTo(grid->x);
+  cv::Mat(camera.height, camera.width, CV_32F,
+          const_cast<float*>(mapping.second.data()))
+      .copyTo(grid->y);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto inserted = grids_.emplace(key, std::move(grid));
+  if (inserted.second) {
+    grids_order_.push_back(key);
+    while (grids_order_.size() > max_cached_grids_) {
+      grids_.erase(grids_order_.front());
+      grids_order_.pop_front();
+    }
+  }
+  return inserted.first->second;
+}
+
+std::vector<cv::Mat> PanoramaRenderer::Render(
+    const cv::Mat& image, const geometry::Camera& panorama_camera,
+    const std::vector<geometry::Camera>& cameras,
+    const std::vector<Mat3d>& rotations, int interpolation, int border_mode,
+    int num_threads) {
+  OPENSFM_TRACE_SCOPE("features", "PanoramaRenderer::Render");
+  if (cameras.size() != rotations.size()) {
+    throw std::runtime_error("Cameras and rotations have different sizes");
+  }
+
+  // Views are rendered in parallel, threads left are used for the grids
+  const int num_views = cameras.size();
+  const int grid_threads = std::max(1, num_threads / std::max(1, num_views));
+  std::vector<cv::Mat> views(num_views);
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+  for (int i = 0; i < num_views; ++i) {
+    const auto grid = GetGrid(panorama_camera, image.cols, image.rows,
+                              cameras[i], rotations[i], grid_threads);
+    cv::remap(image, views[i], grid->x, grid->y, interpolation, border_mode);
+  }
+  return views;
+}
+}  // namespace features
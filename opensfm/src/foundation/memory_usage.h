@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Eigen/Core>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace foundation {
+
+/* Memory usage estimates, in bytes, broken down by component (e.g. 'ids',
+ * 'observations', 'indices'). The 'total' entry sums all the others.
+ *
+ * Estimates follow the libstdc++ layout of the containers : one allocation
+ * per node of node-based containers, plus the buckets array of hash tables,
+ * plus a malloc header per allocation. */
+using MemoryUsage = std::map<std::string, size_t>;
+
+namespace memory {
+constexpr size_t kAllocationOverhead = sizeof(size_t);
+// Red-black tree node : color, parent, left and right
+constexpr size_t kTreeNodeOverhead = 4 * sizeof(void*) + kAllocationOverhead;
+// Hash table node : next pointer and cached hash
+constexpr size_t kHashNodeOverhead =
+    sizeof(void*) + sizeof(size_t) + kAllocationOverhead;
+
+// Heap bytes of a string (none when stored inline)
+inline size_t HeapBytes(const std::string& str) {
+  static const size_t inline_capacity = std::string().capacity();
+  return str.capacity() > inline_capacity
+             ? str.capacity() + 1 + kAllocationOverhead
+             : 0;
+}
+
+// Heap bytes of the elements storage of a vector, not of what they own
+template <class T, class A>
+size_t HeapBytes(const std::vector<T, A>& vector) {
+  return vector.capacity() > 0
+             ? vector.capacity() * sizeof(T) + kAllocationOverhead
+             : 0;
+}
+
+template <class T, int R, int C, int O, int MR, int MC>
+size_t HeapBytes(const Eigen::Matrix<T, R, C, O, MR, MC>& matrix) {
+  if (R != Eigen::Dynamic && C != Eigen::Dynamic) {
+    return 0;
+  }
+  if (MR != Eigen::Dynamic && MC != Eigen::Dynamic) {
+    return 0;
+  }
+  return matrix.size() > 0
+             ? matrix.size() * sizeof(T) + kAllocationOverhead
+             : 0;
+}
+
+// Bytes of the structure of a node-based container, without its elements
+template <class K, class V, class H, class E, class A>
+size_t IndexBytes(const std::unordered_map<K, V, H, E, A>& map) {
+  return map.bucket_count() * sizeof(void*) + kAllocationOverhead +
+         map.size() * kHashNodeOverhead;
+}
+
+template <class K, class V, class C, class A>
+size_t IndexBytes(const std::map<K, V, C, A>& map) {
+  return map.size() * kTreeNodeOverhead;
+}
+
+// Bytes of the elements of a node-based container, not of what they own
+template <class M>
+size_t ElementsBytes(const M& map) {
+  return map.size() * sizeof(typename M::value_type);
+}
+
+// Heap bytes of the string keys of a map
+template <class M>
+size_t KeysBytes(const M& map) {
+  size_t bytes = 0;
+  for (const auto& key_value : map) {
+    bytes += HeapBytes(key_value.first);
+  }
+  return bytes;
+}
+
+inline void Accumulate(const MemoryUsage& usage, MemoryUsage* total) {
+  for (const auto& component : usage) {
+    (*total)[component.first] += component.second;
+  }
+}
+
+inline void UpdateTotal(MemoryUsage* usage) {
+  usage->erase("total");
+  size_t total = 0;
+  for (const auto& component : *usage) {
+    total += component.second;
+  }
+  (*usage)["total"] = total;
+}
+}  // namespace memory
+}  // namespace foundation
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace foundation {
+
+/* Bulk allocator for many small, long-lived objects (e.g. Ceres cost
+ * functions). Objects are constructed contiguously inside large blocks and
+ * are all destroyed at once, in reverse creation order, when the arena is
+ * cleared or destroyed. Objects allocated elsewhere can also be adopted, so
+ * that the arena becomes the single owner of a whole set of objects. */
+class ObjectArena {
+ public:
+  static constexpr size_t kDefaultBlockSize = 1 << 20;
+
+  explicit ObjectArena(size_t block_size = kDefaultBlockSize)
+      : block_size_(block_size) {}
+  ~ObjectArena() { Clear(); }
+
+  ObjectArena(const ObjectArena&) = delete;
+  ObjectArena& operator=(const ObjectArena&) = delete;
+
+  template <class T, class... Args>
+  T* Create(Args&&... args) {
+    void* memory = Allocate(sizeof(T), alignof(T));
+    T* object = new (memory) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value) {
+      destructors_.push_back(
+          {object, [](void* o) { static_cast<T*>(o)->~T(); }});
+    }
+    ++objects_count_;
+    return object;
+  }
+
+  // Take ownership of a heap-allocated object
+  template <class T>
+  T* Adopt(T* object) {
+    if (object) {
+      destructors_.push_back(
+          {object, [](void* o) { delete static_cast<T*>(o); }});
+      ++objects_count_;
+    }
+    return object;
+  }
+
+  void Clear() {
+    for (auto it = destructors_.rbegin(); it != destructors_.rend(); ++it) {
+      it->destroy(it->object);
+    }
+    destructors_.clear();
+    blocks_.clear();
+    current_ = nullptr;
+    remaining_ = 0;
+    objects_count_ = 0;
+    bytes_used_ = 0;
+  }
+
+  size_t ObjectsCount() const { return objects_count_; }
+  size_t BytesUsed() const { return bytes_used_; }
+  size_t BytesReserved() const {
+    size_t total = 0;
+    for (const auto& block : blocks_) {
+      total += block.second;
+    }
+    return total + destructors_.capacity() * sizeof(Destructor);
+  }
+
+ private:
+  struct Destructor {
+    void* object;
+    void (*destroy)(void*);
+  };
+
+  void* Allocate(size_t size, size_t alignment) {
+    auto address = reinterpret_cast<std::uintptr_t>(current_);
+    size_t padding = (alignment - address % alignment) % alignment;
+    if (!current_ || padding + size > remaining_) {
+      const size_t new_block_size = std::max(block_size_, size + alignment);
+      blocks_.emplace_back(std::unique_ptr<char[]>(new char[new_block_size]),
+                           new_block_size);
+      current_ = blocks_.back().first.get();
+      remaining_ = new_block_size;
+      address = reinterpret_cast<std::uintptr_t>(current_);
+      padding = (alignment - address % alignment) % alignment;
+    }
+    char* memory = current_ + padding;
+    current_ = memory + size;
+    remaining_ -= padding + size;
+    bytes_used_ += size;
+    return memory;
+  }
+
+  const size_t block_size_;
+  std::vector<std::pair<std::unique_ptr<char[]>, size_t>> blocks_;
+  std::vector<Destructor> destructors_;
+  char* current_{nullptr};
+  size_t remaining_{0};
+  size_t objects_count_{0};
+  size_t bytes_used_{0};
+};
+}  // namespace foundation
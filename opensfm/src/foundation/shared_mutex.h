@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+
+namespace foundation {
+
+/* Readers/writer mutex preferring the writer : once a writer waits, new
+ * readers are held back until it got the lock and released it, so that a
+ * writer can't be starved by readers re-acquiring the lock in a loop. Read
+ * locks aren't recursive : a thread taking a second read lock while a writer
+ * waits would deadlock. */
+class WriterPreferringMutex {
+ public:
+  void lock();
+  bool try_lock();
+  void unlock();
+
+  void lock_shared();
+  bool try_lock_shared();
+  void unlock_shared();
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable readers_cv_;
+  std::condition_variable writers_cv_;
+  int readers_{0};
+  int waiting_writers_{0};
+  bool writer_{false};
+};
+
+using ReadLock = std::shared_lock<WriterPreferringMutex>;
+using WriteLock = std::unique_lock<WriterPreferringMutex>;
+
+/* Readers/writer mutex to embed in data structures shared between native
+ * threads : any number of readers can hold a ReadLock, while a WriteLock
+ * is exclusive. Copies of the owning object get their own, unlocked, mutex,
+ * so that it stays copyable and movable. */
+class SharedMutex {
+ public:
+  SharedMutex() = default;
+  SharedMutex(const SharedMutex&) {}
+  SharedMutex& operator=(const SharedMutex&) { return *this; }
+
+  ReadLock LockForReading() const { return ReadLock(mutex_); }
+  WriteLock LockForWriting() const { return WriteLock(mutex_); }
+
+ private:
+  mutable WriterPreferringMutex mutex_;
+};
+}  // namespace foundation
@@ -0,0 +1,58 @@
+#include <foundation/shared_mutex.h>
+
+namespace foundation {
+
+void WriterPreferringMutex::lock() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  ++waiting_writers_;
+  writers_cv_.wait(lock, [this]() { return !writer_ && readers_ == 0; });
+  --waiting_writers_;
+  writer_ = true;
+}
+
+bool WriterPreferringMutex::try_lock() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (writer_ || readers_ > 0) {
+    return false;
+  }
+  writer_ = true;
+  return true;
+}
+
+void WriterPreferringMutex::unlock() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writer_ = false;
+  }
+  // Pending writers go first, readers are only let in once none is left
+  writers_cv_.notify_one();
+  readers_cv_.notify_all();
+}
+
+void WriterPreferringMutex::lock_shared() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  readers_cv_.wait(lock,
+                   [this]() { return !writer_ && waiting_writers_ == 0; });
+  ++readers_;
+}
+
+bool WriterPreferringMutex::try_lock_shared() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (writer_ || waiting_writers_ > 0) {
+    return false;
+  }
+  ++readers_;
+  return true;
+}
+
+void WriterPreferringMutex::unlock_shared() {
+  bool last_reader = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_reader = --readers_ == 0 && waiting_writers_ > 0;
+  }
+  if (last_reader) {
+    writers_cv_.notify_one();
+  }
+}
+}  // namespace foundation
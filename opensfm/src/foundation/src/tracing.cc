@@ -0,0 +1,125 @@
+#include <foundation/tracing.h>
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace foundation {
+
+std::atomic<bool> Tracer::enabled_{false};
+
+Tracer& Tracer::Instance() {
+  static Tracer tracer;
+  return tracer;
+}
+
+int64_t Tracer::Now() {
+  // steady_clock is shared by all the modules of the process, so that events
+  // of different modules can be merged in a single trace
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Tracer::ThreadBuffer& Tracer::LocalBuffer() {
+  // The buffer is shared with the tracer, so events of terminated threads
+  // are kept until written
+  thread_local std::shared_ptr<ThreadBuffer> buffer;
+  if (!buffer) {
+    buffer = std::make_shared<ThreadBuffer>();
+    buffer->thread_id =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xffffffff;
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    buffers_.push_back(buffer);
+  }
+  return *buffer;
+}
+
+void Tracer::AddSpan(const char* name, const char* category, int64_t start,
+                     int64_t end) {
+  auto& buffer = LocalBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.events.push_back({name, category, start, end - start, 0.0});
+}
+
+void Tracer::AddCounter(const char* name, const char* category,
+                        double value) {
+  auto& buffer = LocalBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.events.push_back({name, category, Now(), -1, value});
+}
+
+void Tracer::Clear() {
+  std::lock_guard<std::mutex> lock(buffers_mutex_);
+  for (auto& buffer : buffers_) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    buffer->events.clear();
+  }
+}
+
+size_t Tracer::EventsCount() const {
+  std::lock_guard<std::mutex> lock(buffers_mutex_);
+  size_t count = 0;
+  for (const auto& buffer : buffers_) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    count += buffer->events.size();
+  }
+  return count;
+}
+
+namespace {
+void WriteJSONString(const char* str, std::ostream& out) {
+  out << '"';
+  for (const char* c = str; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      out << '\\';
+    }
+    out << *c;
+  }
+  out << '"';
+}
+}  // namespace
+
+std::string Tracer::ChromeTraceEvents() const {
+  std::ostringstream out;
+  bool first = true;
+
+  std::lock_guard<std::mutex> lock(buffers_mutex_);
+  for (const auto& buffer : buffers_) {
+    std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    for (const auto& event : buffer->events) {
+      if (!first) {
+        out << ",\n";
+      }
+      first = false;
+
+      out << "{\"name\":";
+      WriteJSONString(event.name, out);
+      out << ",\"cat\":";
+      WriteJSONString(event.category, out);
+      out << ",\"pid\":1,\"tid\":" << buffer->thread_id
+          << ",\"ts\":" << event.timestamp;
+      if (event.duration >= 0) {
+        out << ",\"ph\":\"X\",\"dur\":" << event.duration << "}";
+      } else {
+        out << ",\"ph\":\"C\",\"args\":{";
+        WriteJSONString(event.name, out);
+        out << ":" << event.value << "}}";
+      }
+    }
+  }
+  return out.str();
+}
+
+void Tracer::WriteChromeTrace(const std::string& filename) const {
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("Can't open " + filename + " for writing.");
+  }
+  file << "{\"traceEvents\":[\n" << ChromeTraceEvents() << "\n]}\n";
+}
+
+}  // namespace foundation
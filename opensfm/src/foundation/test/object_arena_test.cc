@@ -0,0 +1,49 @@
+#include <foundation/object_arena.h>
+#include <foundation/types.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+struct Counted {
+  explicit Counted(int* counter) : counter(counter) { ++(*counter); }
+  ~Counted() { --(*counter); }
+  int* counter;
+};
+}  // namespace
+
+TEST(ObjectArena, DestroysAllObjectsOnClear) {
+  int alive = 0;
+  foundation::ObjectArena arena(64);
+  for (int i = 0; i < 100; ++i) {
+    arena.Create<Counted>(&alive);
+  }
+  arena.Adopt(new Counted(&alive));
+  ASSERT_EQ(101, alive);
+  ASSERT_EQ(101, arena.ObjectsCount());
+
+  arena.Clear();
+  ASSERT_EQ(0, alive);
+  ASSERT_EQ(0, arena.ObjectsCount());
+}
+
+TEST(ObjectArena, DestroysAllObjectsWithArena) {
+  int alive = 0;
+  {
+    foundation::ObjectArena arena;
+    arena.Create<Counted>(&alive);
+    arena.Create<Counted>(&alive);
+    ASSERT_EQ(2, alive);
+  }
+  ASSERT_EQ(0, alive);
+}
+
+TEST(ObjectArena, RespectsAlignment) {
+  foundation::ObjectArena arena(100);
+  for (int i = 0; i < 50; ++i) {
+    arena.Create<char>('a');
+    const auto* v = arena.Create<Vec2d>(1.0, 2.0);
+    ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(v) % alignof(Vec2d));
+    ASSERT_EQ(2.0, (*v)[1]);
+  }
+  ASSERT_EQ(100, arena.ObjectsCount());
+}
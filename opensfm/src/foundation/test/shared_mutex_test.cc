@@ -0,0 +1,62 @@
+#include <foundation/shared_mutex.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST(WriterPreferringMutex, BlocksNewReadersWhileWriterWaits) {
+  foundation::WriterPreferringMutex mutex;
+  mutex.lock_shared();
+
+  std::atomic<bool> written{false};
+  std::thread writer([&]() {
+    mutex.lock();
+    written = true;
+    mutex.unlock();
+  });
+
+  // Readers are let in until the writer waits
+  while (mutex.try_lock_shared()) {
+    mutex.unlock_shared();
+    std::this_thread::yield();
+  }
+  EXPECT_FALSE(written);
+
+  mutex.unlock_shared();
+  writer.join();
+  EXPECT_TRUE(written);
+  ASSERT_TRUE(mutex.try_lock_shared());
+  EXPECT_FALSE(mutex.try_lock());
+  mutex.unlock_shared();
+  ASSERT_TRUE(mutex.try_lock());
+  EXPECT_FALSE(mutex.try_lock_shared());
+  mutex.unlock();
+}
+
+TEST(SharedMutex, WriterCommitsWhileReadersLoop) {
+  foundation::SharedMutex mutex;
+  std::atomic<bool> done{false};
+  int value = 0;
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      for (int read = 0; read < 100000 && !done; ++read) {
+        const auto lock = mutex.LockForReading();
+        EXPECT_GE(value, 0);
+      }
+    });
+  }
+  for (int i = 0; i < 100; ++i) {
+    const auto lock = mutex.LockForWriting();
+    ++value;
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(100, value);
+}
+}  // namespace
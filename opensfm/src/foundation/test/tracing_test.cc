@@ -0,0 +1,56 @@
+#include <foundation/tracing.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+class TracerFixture : public ::testing::Test {
+ public:
+  TracerFixture() { foundation::Tracer::Instance().Clear(); }
+  ~TracerFixture() {
+    foundation::Tracer::SetEnabled(false);
+    foundation::Tracer::Instance().Clear();
+  }
+};
+
+TEST_F(TracerFixture, RecordsNothingWhenDisabled) {
+  foundation::Tracer::SetEnabled(false);
+  { const foundation::ScopedTrace trace("span", "test"); }
+  ASSERT_EQ(0, foundation::Tracer::Instance().EventsCount());
+  ASSERT_TRUE(foundation::Tracer::Instance().ChromeTraceEvents().empty());
+}
+
+TEST_F(TracerFixture, RecordsSpansAndCounters) {
+  foundation::Tracer::SetEnabled(true);
+  { const foundation::ScopedTrace trace("span", "test"); }
+  foundation::Tracer::Instance().AddCounter("count", "test", 42);
+  ASSERT_EQ(2, foundation::Tracer::Instance().EventsCount());
+
+  const auto events = foundation::Tracer::Instance().ChromeTraceEvents();
+  EXPECT_THAT(events, ::testing::HasSubstr("\"name\":\"span\""));
+  EXPECT_THAT(events, ::testing::HasSubstr("\"ph\":\"X\""));
+  EXPECT_THAT(events, ::testing::HasSubstr("\"args\":{\"count\":42}"));
+
+  foundation::Tracer::Instance().Clear();
+  ASSERT_EQ(0, foundation::Tracer::Instance().EventsCount());
+}
+
+TEST_F(TracerFixture, RecordsEventsOfAllThreads) {
+  foundation::Tracer::SetEnabled(true);
+  const int threads_count = 4;
+  const int spans_per_thread = 100;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < threads_count; ++i) {
+    threads.emplace_back([]() {
+      for (int j = 0; j < spans_per_thread; ++j) {
+        const foundation::ScopedTrace trace("span", "test");
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(threads_count * spans_per_thread,
+            foundation::Tracer::Instance().EventsCount());
+}
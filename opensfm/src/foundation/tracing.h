@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace foundation {
+
+/* Lightweight tracing of native code : scoped spans and counters, recorded
+ * per thread and written as Chrome trace (Perfetto compatible) JSON events.
+ *
+ * Recording is switched on/off at runtime, and costs a single atomic load
+ * when off. Building without OPENSFM_ENABLE_TRACING compiles the tracing
+ * macros below to nothing.
+ *
+ * Names and categories must be string literals (or outlive the tracer). */
+class Tracer {
+ public:
+  struct Event {
+    const char* name;
+    const char* category;
+    int64_t timestamp;  // microseconds
+    int64_t duration;   // microseconds, negative for counters
+    double value;
+  };
+
+  static Tracer& Instance();
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+  static void SetEnabled(bool enabled) { enabled_.store(enabled); }
+  static int64_t Now();
+
+  void AddSpan(const char* name, const char* category, int64_t start,
+               int64_t end);
+  void AddCounter(const char* name, const char* category, double value);
+
+  void Clear();
+  size_t EventsCount() const;
+
+  // Comma-separated events, to be put inside a 'traceEvents' JSON array
+  std::string ChromeTraceEvents() const;
+  void WriteChromeTrace(const std::string& filename) const;
+
+ private:
+  struct ThreadBuffer {
+    std::mutex mutex;
+    uint64_t thread_id;
+    std::vector<Event> events;
+  };
+
+  Tracer() = default;
+  ThreadBuffer& LocalBuffer();
+
+  static std::atomic<bool> enabled_;
+  mutable std::mutex buffers_mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+};
+
+class ScopedTrace {
+ public:
+  ScopedTrace(const char* name, const char* category)
+      : name_(name),
+        category_(category),
+        start_(Tracer::IsEnabled() ? Tracer::Now() : -1) {}
+  ~ScopedTrace() {
+    if (start_ >= 0) {
+      Tracer::Instance().AddSpan(name_, category_, start_, Tracer::Now());
+    }
+  }
+
+  ScopedTrace(const ScopedTrace&) = delete;
+  ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+ private:
+  const char* name_;
+  const char* category_;
+  const int64_t start_;
+};
+}  // namespace foundation
+
+#ifdef OPENSFM_ENABLE_TRACING
+#define OPENSFM_TRACE_CONCAT_IMPL(a, b) a##b
+#define OPENSFM_TRACE_CONCAT(a, b) OPENSFM_TRACE_CONCAT_IMPL(a, b)
+#define OPENSFM_TRACE_SCOPE(category, name)       \
+  const ::foundation::ScopedTrace OPENSFM_TRACE_CONCAT( \
+      trace_scope_, __LINE__)(name, category)
+#define OPENSFM_TRACE_COUNTER(category, name, value)                      \
+  do {                                                                    \
+    if (::foundation::Tracer::IsEnabled()) {                              \
+      ::foundation::Tracer::Instance().AddCounter(name, category, value); \
+    }                                                                     \
+  } while (0)
+#else
+#define OPENSFM_TRACE_SCOPE(category, name)
+#define OPENSFM_TRACE_COUNTER(category, name, value) \
+  do {                                               \
+    (void)sizeof(value);                             \
+  } while (0)
+#endif
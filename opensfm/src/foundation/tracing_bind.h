@@ -0,0 +1,17 @@
+#pragma once
+
+#include <foundation/tracing.h>
+#include <pybind11/pybind11.h>
+
+namespace foundation {
+
+/* Every Python module embeds its own copy of the tracer, so they all expose
+ * these functions, and opensfm.tracing drives all of them at once. */
+inline void AddTracingBindings(pybind11::module& m) {
+  m.def("set_tracing_enabled", &Tracer::SetEnabled);
+  m.def("is_tracing_enabled", &Tracer::IsEnabled);
+  m.def("clear_tracing", []() { Tracer::Instance().Clear(); });
+  m.def("get_tracing_events",
+        []() { return Tracer::Instance().ChromeTraceEvents(); });
+}
+}  // namespace foundation
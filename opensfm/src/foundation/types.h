@@ -6,6 +6,8 @@ template <class T>
 using MatX = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
 using MatXf = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>;
 using MatXd = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>;
+using RowMatXf =
+    Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
 
 template <class T>
 using Mat2 = Eigen::Matrix<T, 2, 2>;
@@ -51,6 +53,11 @@ using VecXf = Eigen::Matrix<float, Eigen::Dynamic, 1>;
 using VecXd = Eigen::Matrix<double, Eigen::Dynamic, 1>;
 using VecXi = Eigen::Matrix<int, Eigen::Dynamic, 1>;
 
+// Dynamic-size vectors of at most N entries, stored inline (no allocation)
+template <class T, int N>
+using VecMaxN = Eigen::Matrix<T, Eigen::Dynamic, 1, Eigen::ColMajor, N, 1>;
+using VecMax3d = VecMaxN<double, 3>;
+
 template <class T, int N>
 using VecN = Eigen::Matrix<T, N, 1>;
 template <int N>
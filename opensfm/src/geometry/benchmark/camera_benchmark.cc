@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include <foundation/types.h>
+#include <geometry/camera.h>
+
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+geometry::Camera CreateCamera(const geometry::ProjectionType& type) {
+  const double focal = 0.4;
+  const double aspect_ratio = 1.1;
+  const Vec2d principal_point(0.1, -0.05);
+  VecXd distortion(12);
+  distortion << -0.1, 0.03, 0.001, 0.005, 0.02, 0.001, 0.0007, -0.01, 0.01,
+      -0.007, -0.03, 0.0053;
+
+  switch (type) {
+    case geometry::ProjectionType::PERSPECTIVE:
+      return geometry::Camera::CreatePerspectiveCamera(focal, -0.1, 0.03);
+    case geometry::ProjectionType::BROWN:
+      return geometry::Camera::CreateBrownCamera(
+          focal, aspect_ratio, principal_point, distortion.head<5>());
+    case geometry::ProjectionType::FISHEYE:
+      return geometry::Camera::CreateFisheyeCamera(focal, -0.1, 0.03);
+    case geometry::ProjectionType::FISHEYE_OPENCV:
+      return geometry::Camera::CreateFisheyeOpencvCamera(
+          focal, aspect_ratio, principal_point, distortion.head<4>());
+    case geometry::ProjectionType::FISHEYE62:
+      return geometry::Camera::CreateFisheye62Camera(
+          focal, aspect_ratio, principal_point, distortion.head<8>());
+    case geometry::ProjectionType::FISHEYE624:
+      return geometry::Camera::CreateFisheye624Camera(
+          focal, aspect_ratio, principal_point, distortion);
+    case geometry::ProjectionType::RADIAL:
+      return geometry::Camera::CreateRadialCamera(
+          focal, aspect_ratio, principal_point, distortion.head<2>());
+    case geometry::ProjectionType::SIMPLE_RADIAL:
+      return geometry::Camera::CreateSimpleRadialCamera(
+          focal, aspect_ratio, principal_point, -0.1);
+    case geometry::ProjectionType::DUAL:
+      return geometry::Camera::CreateDualCamera(0.5, focal, -0.1, 0.03);
+    case geometry::ProjectionType::SPHERICAL:
+      return geometry::Camera::CreateSphericalCamera();
+    case geometry::ProjectionType::NONE:
+      break;
+  }
+  throw std::runtime_error("Unknown projection type");
+}
+
+// Points in front of the camera, within its field of view
+MatX3d RandomPoints(int count) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<> rand(-0.3, 0.3);
+  MatX3d points(count, 3);
+  for (int i = 0; i < count; ++i) {
+    points.row(i) << rand(gen), rand(gen), 1.0 + rand(gen);
+  }
+  return points;
+}
+
+void BM_CameraProjectMany(benchmark::State& state,
+                          geometry::ProjectionType type) {
+  const auto camera = CreateCamera(type);
+  const auto points = RandomPoints(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(camera.ProjectMany(points));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_CameraBearingsMany(benchmark::State& state,
+                           geometry::ProjectionType type) {
+  const auto camera = CreateCamera(type);
+  const MatX2d projections = camera.ProjectMany(RandomPoints(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(camera.BearingsMany(projections));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define OPENSFM_CAMERA_BENCHMARKS(TYPE)                                  \
+  BENCHMARK_CAPTURE(BM_CameraProjectMany, TYPE,                          \
+                    geometry::ProjectionType::TYPE)                      \
+      ->Arg(1000)                                                        \
+      ->Arg(100000);                                                     \
+  BENCHMARK_CAPTURE(BM_CameraBearingsMany, TYPE,                         \
+                    geometry::ProjectionType::TYPE)                      \
+      ->Arg(1000)                                                        \
+      ->Arg(100000);
+
+OPENSFM_CAMERA_BENCHMARKS(PERSPECTIVE)
+OPENSFM_CAMERA_BENCHMARKS(BROWN)
+OPENSFM_CAMERA_BENCHMARKS(FISHEYE)
+OPENSFM_CAMERA_BENCHMARKS(FISHEYE_OPENCV)
+OPENSFM_CAMERA_BENCHMARKS(FISHEYE62)
+OPENSFM_CAMERA_BENCHMARKS(FISHEYE624)
+OPENSFM_CAMERA_BENCHMARKS(RADIAL)
+OPENSFM_CAMERA_BENCHMARKS(SIMPLE_RADIAL)
+OPENSFM_CAMERA_BENCHMARKS(DUAL)
+OPENSFM_CAMERA_BENCHMARKS(SPHERICAL)
+#undef OPENSFM_CAMERA_BENCHMARKS
+
+}  // namespace
@@ -121,4 +121,12 @@ class Camera {
 std::pair<MatXf, MatXf> ComputeCameraMapping(const Camera& from,
                                              const Camera& to, int width,
                                              int height);
+
+// Pixel coordinates, in a 'from_width' x 'from_height' image of the 'from'
+// camera, of each pixel of an image of the 'to' camera whose bearings are
+// rotated by 'rotation' into the 'from' camera coordinates. The grids have
+// the size of the 'to' camera image, ready for an image remap.
+std::pair<RowMatXf, RowMatXf> ComputeRotatedCameraMapping(
+    const Camera& from, int from_width, int from_height, const Camera& to,
+    const Mat3d& rotation, int num_threads);
 }  // namespace geometry
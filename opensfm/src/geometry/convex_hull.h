@@ -0,0 +1,19 @@
+#pragma once
+
+#include <foundation/types.h>
+
+#include <vector>
+
+namespace geometry {
+
+// Triangular faces of the convex hull of 3D points, as indices of 'points'
+// oriented counter-clockwise when seen from outside. Points lying inside or
+// on the hull (up to a relative tolerance) aren't used as vertices. Returns
+// no faces when all the points are coplanar.
+std::vector<Vec3i> ConvexHull(const MatX3d& points);
+
+// Delaunay triangulation of 2D points, as indices of 'points'. It is computed
+// as the lower convex hull of the points lifted on a paraboloid. Duplicated
+// points are only used once.
+std::vector<Vec3i> DelaunayTriangulation(const MatX2d& points);
+}  // namespace geometry
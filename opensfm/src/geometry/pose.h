@@ -4,6 +4,8 @@
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 
 namespace geometry {
@@ -25,6 +27,20 @@ class Pose {
     T_cw.block<3, 1>(0, 3) = t;
     SetFromWorldToCamera(T_cw);
   }
+  Pose(const Pose&) = default;
+  Pose& operator=(const Pose& other) {
+    cam_to_world_ = other.cam_to_world_;
+    world_to_cam_ = other.world_to_cam_;
+    r_min_cam_to_world_ = other.r_min_cam_to_world_;
+    r_min_world_to_cam_ = other.r_min_world_to_cam_;
+    generation_ = std::max(generation_, other.generation_) + 1;
+    return *this;
+  }
+
+  // Incremented by every modification of this pose, so that values derived
+  // from it can be cached and invalidated (see map::Shot::GetPose)
+  uint64_t Generation() const { return generation_; }
+
   // Transformation Matrices
   Mat4d WorldToCamera() const { return world_to_cam_; }
   Mat34d WorldToCameraRt() const { return world_to_cam_.block<3, 4>(0, 0); }
@@ -73,6 +89,7 @@ class Pose {
     world_to_cam_.block<3, 1>(0, 3) = t_cw;
     cam_to_world_ = world_to_cam_.inverse();
     UpdateMinRotations();
+    ++generation_;
   }
 
   virtual void SetFromCameraToWorld(const Mat3d& R_wc, const Vec3d& t_wc) {
@@ -81,6 +98,7 @@ class Pose {
     cam_to_world_.block<3, 1>(0, 3) = t_wc;
     world_to_cam_ = cam_to_world_.inverse();
     UpdateMinRotations();
+    ++generation_;
   }
 
   virtual void SetWorldToCamRotation(const Vec3d& r_cw) {
@@ -88,17 +106,20 @@ class Pose {
     world_to_cam_.block<3, 3>(0, 0) = R_cw;
     cam_to_world_.block<3, 3>(0, 0) = R_cw.transpose();
     UpdateMinRotations();
+    ++generation_;
   }
 
   virtual void SetWorldToCamTranslation(const Vec3d& t_cw) {
     world_to_cam_.block<3, 1>(0, 3) = t_cw;
     cam_to_world_.block<3, 1>(0, 3) = world_to_cam_.inverse().block<3, 1>(0, 3);
+    ++generation_;
   }
 
   virtual void SetWorldToCamRotationMatrix(const Mat3d& R_cw) {
     world_to_cam_.block<3, 3>(0, 0) = R_cw;
     cam_to_world_.block<3, 3>(0, 0) = R_cw.transpose();
     UpdateMinRotations();
+    ++generation_;
   }
   virtual void SetFromCameraToWorld(const Vec3d& r_wc, const Vec3d& t_wc) {
     const Mat3d R_wc = geometry::VectorToRotationMatrix(r_wc);
@@ -181,6 +202,7 @@ class Pose {
   Mat4d world_to_cam_;  // [R, t] world to cam
   Vec3d r_min_cam_to_world_;
   Vec3d r_min_world_to_cam_;
+  uint64_t generation_{0};
 
   virtual void UpdateMinRotations() {
     r_min_cam_to_world_ =
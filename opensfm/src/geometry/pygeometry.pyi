@@ -23,6 +23,7 @@ __all__ = [
     "absolute_pose_n_points_known_rotation",
     "absolute_pose_three_points",
     "compute_camera_mapping",
+    "compute_rotated_camera_mapping",
     "epipolar_angle_two_bearings_many",
     "essential_five_points",
     "essential_n_points",
@@ -356,6 +357,14 @@ def absolute_pose_three_points(
 def compute_camera_mapping(
     arg0: Camera, arg1: Camera, arg2: int, arg3: int
 ) -> tuple[numpy.typing.NDArray, numpy.typing.NDArray]: ...
+def compute_rotated_camera_mapping(
+    from_camera: Camera,
+    from_width: int,
+    from_height: int,
+    to_camera: Camera,
+    rotation: numpy.typing.NDArray,
+    num_threads: int,
+) -> tuple[numpy.typing.NDArray, numpy.typing.NDArray]: ...
 def epipolar_angle_two_bearings_many(
     arg0: numpy.typing.NDArray,
     arg1: numpy.typing.NDArray,
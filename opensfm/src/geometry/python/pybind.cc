@@ -285,6 +285,11 @@ PYBIND11_MODULE(pygeometry, m) {
           py::return_value_policy::copy);
   m.def("compute_camera_mapping", geometry::ComputeCameraMapping,
         py::call_guard<py::gil_scoped_release>());
+  m.def("compute_rotated_camera_mapping",
+        geometry::ComputeRotatedCameraMapping, py::arg("from_camera"),
+        py::arg("from_width"), py::arg("from_height"), py::arg("to_camera"),
+        py::arg("rotation"), py::arg("num_threads"),
+        py::call_guard<py::gil_scoped_release>());
   m.def("triangulate_bearings_dlt", geometry::TriangulateBearingsDLT,
         py::call_guard<py::gil_scoped_release>());
   m.def("triangulate_bearings_midpoint", geometry::TriangulateBearingsMidpoint,
@@ -24,6 +24,17 @@ class Similarity {
     return scale_ * RotationMatrix() * point + Translation();
   }
 
+  // Pose of a camera moved along with the points it sees
+  Pose TransformPose(const Pose& pose) const {
+    const Mat3d R_cw =
+        pose.RotationWorldToCamera() * RotationMatrix().transpose();
+    const Vec3d t_cw =
+        scale_ * pose.TranslationWorldToCamera() - R_cw * Translation();
+    Pose transformed;
+    transformed.SetFromWorldToCamera(R_cw, t_cw);
+    return transformed;
+  }
+
   Similarity Inverse() const {
     return Similarity(Rt_.RotationCameraToWorldMin(),
                       1.0 / scale_ * Rt_.GetOrigin(), 1.0 / scale_);
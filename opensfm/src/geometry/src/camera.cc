@@ -343,6 +343,26 @@ std::pair<MatXf, MatXf> ComputeCameraMapping(const Camera& from,
   return std::make_pair(u_from, v_from);
 }
 
+std::pair<RowMatXf, RowMatXf> ComputeRotatedCameraMapping(
+    const Camera& from, int from_width, int from_height, const Camera& to,
+    const Mat3d& rotation, int num_threads) {
+  RowMatXf u_from(to.height, to.width);
+  RowMatXf v_from(to.height, to.width);
+
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (int v = 0; v < to.height; ++v) {
+    for (int u = 0; u < to.width; ++u) {
+      const Vec2d point = Camera::PixelToNormalizedCoordinates(
+          Vec2d(u, v), to.width, to.height);
+      const Vec2d point_from = Camera::NormalizedToPixelCoordinates(
+          from.Project(rotation * to.Bearing(point)), from_width, from_height);
+      u_from(v, u) = point_from(0);
+      v_from(v, u) = point_from(1);
+    }
+  }
+  return std::make_pair(u_from, v_from);
+}
+
 Vec2d Camera::PixelToNormalizedCoordinates(const Vec2d& px_coord) const {
   return PixelToNormalizedCoordinates(px_coord, width, height);
 }
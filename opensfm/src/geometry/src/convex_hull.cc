@@ -0,0 +1,275 @@
+#include <geometry/convex_hull.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+
+/* Incremental convex hull where each point not yet on the hull is assigned
+ * to one of the faces it sees (Quickhull). The farthest point of a face is
+ * added by replacing all the faces it sees, found from the neighbors of the
+ * first one, by a cone of faces joining it to their horizon. */
+class QuickHull {
+ public:
+  explicit QuickHull(const MatX3d& points) : points_(points) {
+    const Vec3d extent = points_.colwise().maxCoeff().transpose() -
+                         points_.colwise().minCoeff().transpose();
+    epsilon_ = 1e-10 * std::max(extent.norm(), 1e-300);
+  }
+
+  std::vector<Vec3i> Compute() {
+    std::vector<Vec3i> result;
+    if (!InitialSimplex()) {
+      return result;
+    }
+    for (size_t i = 0; i < faces_.size(); ++i) {
+      while (faces_[i].alive && !faces_[i].outside.empty()) {
+        AddPoint(i);
+      }
+    }
+    for (const auto& face : faces_) {
+      if (face.alive) {
+        result.emplace_back(face.v[0], face.v[1], face.v[2]);
+      }
+    }
+    return result;
+  }
+
+ private:
+  struct Face {
+    int v[3];
+    Vec3d normal;
+    double offset;
+    std::vector<int> outside;
+    bool alive{true};
+  };
+
+  static uint64_t EdgeKey(int a, int b) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) |
+           static_cast<uint32_t>(b);
+  }
+
+  Vec3d Point(int i) const { return points_.row(i).transpose(); }
+
+  double Distance(const Face& face, int i) const {
+    return face.normal.dot(Point(i)) - face.offset;
+  }
+
+  int AddFace(int a, int b, int c) {
+    Face face;
+    face.v[0] = a;
+    face.v[1] = b;
+    face.v[2] = c;
+    face.normal =
+        (Point(b) - Point(a)).cross(Point(c) - Point(a)).normalized();
+    face.offset = face.normal.dot(Point(a));
+    const int id = faces_.size();
+    for (int k = 0; k < 3; ++k) {
+      edges_[EdgeKey(face.v[k], face.v[(k + 1) % 3])] = id;
+    }
+    faces_.push_back(std::move(face));
+    return id;
+  }
+
+  // Farthest point from a set of already chosen ones, or -1 if they're all
+  // closer than the tolerance
+  template <class DISTANCE>
+  int Farthest(const DISTANCE& distance) const {
+    int best = -1;
+    double best_distance = epsilon_;
+    for (int i = 0; i < points_.rows(); ++i) {
+      const double d = std::abs(distance(Point(i)));
+      if (d > best_distance) {
+        best_distance = d;
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  bool InitialSimplex() {
+    if (points_.rows() < 4) {
+      return false;
+    }
+    int i0 = 0;
+    points_.col(0).minCoeff(&i0);
+    const Vec3d p0 = Point(i0);
+    const int i1 = Farthest([&p0](const Vec3d& p) { return (p - p0).norm(); });
+    if (i1 < 0) {
+      return false;
+    }
+    const Vec3d direction = (Point(i1) - p0).normalized();
+    const int i2 = Farthest([&p0, &direction](const Vec3d& p) {
+      return (p - p0).cross(direction).norm();
+    });
+    if (i2 < 0) {
+      return false;
+    }
+    const Vec3d normal = direction.cross(Point(i2) - p0).normalized();
+    const int i3 = Farthest(
+        [&p0, &normal](const Vec3d& p) { return normal.dot(p - p0); });
+    if (i3 < 0) {
+      return false;
+    }
+
+    // Faces are oriented to see the simplex on their back
+    const int simplex[4] = {i0, i1, i2, i3};
+    const Vec3d center = (p0 + Point(i1) + Point(i2) + Point(i3)) / 4.0;
+    for (int k = 0; k < 4; ++k) {
+      int a = simplex[k], b = simplex[(k + 1) % 4], c = simplex[(k + 2) % 4];
+      const Vec3d n = (Point(b) - Point(a)).cross(Point(c) - Point(a));
+      if (n.dot(center - Point(a)) > 0) {
+        std::swap(b, c);
+      }
+      AddFace(a, b, c);
+    }
+
+    std::vector<int> remaining;
+    for (int i = 0; i < points_.rows(); ++i) {
+      if (i != i0 && i != i1 && i != i2 && i != i3) {
+        remaining.push_back(i);
+      }
+    }
+    AssignOutside(remaining, 0);
+    return true;
+  }
+
+  // Assign the points to the first face, created from 'first_face' onwards,
+  // they are in front of. Others are inside the hull and discarded.
+  void AssignOutside(const std::vector<int>& points, size_t first_face) {
+    for (const int i : points) {
+      for (size_t f = first_face; f < faces_.size(); ++f) {
+        if (Distance(faces_[f], i) > epsilon_) {
+          faces_[f].outside.push_back(i);
+          break;
+        }
+      }
+    }
+  }
+
+  void AddPoint(int start) {
+    const auto& start_outside = faces_[start].outside;
+    const int point = *std::max_element(
+        start_outside.begin(), start_outside.end(), [&](int i, int j) {
+          return Distance(faces_[start], i) < Distance(faces_[start], j);
+        });
+
+    // Faces seen by the point, and the edges of their boundary
+    std::vector<int> visible = {start};
+    std::vector<std::pair<int, int>> horizon;
+    visible_.resize(faces_.size(), false);
+    visible_[start] = true;
+    for (size_t k = 0; k < visible.size(); ++k) {
+      const auto& face = faces_[visible[k]];
+      for (int e = 0; e < 3; ++e) {
+        const int a = face.v[e], b = face.v[(e + 1) % 3];
+        const int neighbor = edges_.at(EdgeKey(b, a));
+        if (visible_[neighbor]) {
+          continue;
+        }
+        if (Distance(faces_[neighbor], point) > epsilon_) {
+          visible_[neighbor] = true;
+          visible.push_back(neighbor);
+        } else {
+          horizon.emplace_back(a, b);
+        }
+      }
+    }
+
+    std::vector<int> orphans;
+    for (const int f : visible) {
+      auto& face = faces_[f];
+      face.alive = false;
+      visible_[f] = false;
+      for (const int i : face.outside) {
+        if (i != point) {
+          orphans.push_back(i);
+        }
+      }
+      face.outside.clear();
+      face.outside.shrink_to_fit();
+      for (int e = 0; e < 3; ++e) {
+        edges_.erase(EdgeKey(face.v[e], face.v[(e + 1) % 3]));
+      }
+    }
+
+    const size_t first_face = faces_.size();
+    for (const auto& edge : horizon) {
+      AddFace(edge.first, edge.second, point);
+    }
+    AssignOutside(orphans, first_face);
+  }
+
+  const MatX3d& points_;
+  double epsilon_;
+  std::vector<Face> faces_;
+  std::unordered_map<uint64_t, int> edges_;
+  std::vector<bool> visible_;
+};
+}  // namespace
+
+namespace geometry {
+
+std::vector<Vec3i> ConvexHull(const MatX3d& points) {
+  return QuickHull(points).Compute();
+}
+
+std::vector<Vec3i> DelaunayTriangulation(const MatX2d& points) {
+  std::vector<Vec3i> triangles;
+  if (points.rows() < 3) {
+    return triangles;
+  }
+
+  // Centered and scaled for the lifted coordinates to be well conditioned
+  const Vec2d center = points.colwise().mean().transpose();
+  const double scale = std::max(
+      (points.rowwise() - center.transpose()).cwiseAbs().maxCoeff(), 1e-300);
+  MatX3d lifted(points.rows(), 3);
+  for (int i = 0; i < points.rows(); ++i) {
+    const Vec2d p = (points.row(i).transpose() - center) / scale;
+    lifted.row(i) << p(0), p(1), p.squaredNorm();
+  }
+
+  const auto hull = ConvexHull(lifted);
+  if (!hull.empty()) {
+    // Lower faces, counter-clockwise from below, thus clockwise in 2D
+    for (const auto& face : hull) {
+      const Vec3d a = lifted.row(face(0));
+      const Vec3d b = lifted.row(face(1));
+      const Vec3d c = lifted.row(face(2));
+      const Vec3d normal = (b - a).cross(c - a);
+      if (normal(2) < -1e-9 * normal.norm()) {
+        triangles.emplace_back(face(0), face(2), face(1));
+      }
+    }
+    return triangles;
+  }
+
+  // All the points are cocircular or collinear : any fan of the distinct
+  // points sorted around their center is a Delaunay triangulation
+  std::vector<int> order(points.rows());
+  std::iota(order.begin(), order.end(), 0);
+  std::vector<double> angles(points.rows());
+  for (int i = 0; i < points.rows(); ++i) {
+    angles[i] = std::atan2(points(i, 1) - center(1), points(i, 0) - center(0));
+  }
+  std::sort(order.begin(), order.end(),
+            [&angles](int i, int j) { return angles[i] < angles[j]; });
+  order.erase(std::unique(order.begin(), order.end(),
+                          [&points](int i, int j) {
+                            return points.row(i) == points.row(j);
+                          }),
+              order.end());
+  for (size_t k = 1; k + 1 < order.size(); ++k) {
+    const Vec2d u = points.row(order[k]) - points.row(order[0]);
+    const Vec2d v = points.row(order[k + 1]) - points.row(order[0]);
+    if (std::abs(u(0) * v(1) - u(1) * v(0)) > 1e-12 * scale * scale) {
+      triangles.emplace_back(order[0], order[k], order[k + 1]);
+    }
+  }
+  return triangles;
+}
+}  // namespace geometry
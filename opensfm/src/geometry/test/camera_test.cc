@@ -600,3 +600,39 @@ TEST(Camera, TestCameraProjectionTypes) {
       geometry::Camera::CreatePerspectiveCamera(0, 0, 0).GetProjectionString(),
       "perspective");
 }
+
+TEST(Camera, ComputeRotatedCameraMapping) {
+  const auto panorama = geometry::Camera::CreateSphericalCamera();
+  constexpr int panorama_width = 400, panorama_height = 200;
+  auto view = geometry::Camera::CreatePerspectiveCamera(0.5, 0.0, 0.0);
+  view.width = 64;
+  view.height = 48;
+  const Mat3d rotation =
+      Eigen::AngleAxisd(0.3, Vec3d(1.0, 2.0, 3.0).normalized())
+          .toRotationMatrix();
+
+  const auto mapping = geometry::ComputeRotatedCameraMapping(
+      panorama, panorama_width, panorama_height, view, rotation, 4);
+  ASSERT_EQ(view.height, mapping.first.rows());
+  ASSERT_EQ(view.width, mapping.first.cols());
+
+  // Panorama pixels see the rotated bearings of the view pixels
+  for (int v = 0; v < view.height; v += 7) {
+    for (int u = 0; u < view.width; u += 5) {
+      const Vec3d expected =
+          rotation * view.Bearing(view.PixelToNormalizedCoordinates(
+                         Vec2d(u, v)));
+      const Vec2d pixel(mapping.first(v, u), mapping.second(v, u));
+      const Vec3d bearing =
+          panorama.Bearing(geometry::Camera::PixelToNormalizedCoordinates(
+              pixel, panorama_width, panorama_height));
+      ASSERT_NEAR(0.0, (bearing - expected).norm(), 1e-5);
+    }
+  }
+
+  // Same result whatever the number of threads
+  const auto single = geometry::ComputeRotatedCameraMapping(
+      panorama, panorama_width, panorama_height, view, rotation, 1);
+  ASSERT_TRUE(single.first == mapping.first);
+  ASSERT_TRUE(single.second == mapping.second);
+}
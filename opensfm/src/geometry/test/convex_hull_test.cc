@@ -0,0 +1,112 @@
+#include <geometry/convex_hull.h>
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+
+double SignedArea(const MatX2d& points, const Vec3i& triangle) {
+  const Vec2d u = points.row(triangle(1)) - points.row(triangle(0));
+  const Vec2d v = points.row(triangle(2)) - points.row(triangle(0));
+  return 0.5 * (u(0) * v(1) - u(1) * v(0));
+}
+
+TEST(ConvexHull, CubeWithInteriorPoints) {
+  MatX3d points(8 + 50, 3);
+  for (int i = 0; i < 8; ++i) {
+    points.row(i) << ((i & 1) ? 1.0 : -1.0), ((i & 2) ? 1.0 : -1.0),
+        ((i & 4) ? 1.0 : -1.0);
+  }
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> uniform(-0.9, 0.9);
+  for (int i = 8; i < points.rows(); ++i) {
+    points.row(i) << uniform(generator), uniform(generator),
+        uniform(generator);
+  }
+
+  const auto faces = geometry::ConvexHull(points);
+  ASSERT_EQ(12, faces.size());
+  for (const auto& face : faces) {
+    const Vec3d a = points.row(face(0));
+    const Vec3d normal = (Vec3d(points.row(face(1))) - a)
+                             .cross(Vec3d(points.row(face(2))) - a);
+    for (int k = 0; k < 3; ++k) {
+      ASSERT_LT(face(k), 8);
+    }
+    // Outward orientation
+    ASSERT_GT(normal.dot(a), 0.0);
+  }
+}
+
+TEST(ConvexHull, PointsOnSphere) {
+  const int num_points = 500;
+  MatX3d points(num_points, 3);
+  std::mt19937 generator(42);
+  std::normal_distribution<double> normal;
+  for (int i = 0; i < num_points; ++i) {
+    points.row(i) =
+        Vec3d(normal(generator), normal(generator), normal(generator))
+            .normalized();
+  }
+
+  // All the points are on the hull, which is a closed triangulated surface
+  const auto faces = geometry::ConvexHull(points);
+  ASSERT_EQ(2 * num_points - 4, faces.size());
+}
+
+TEST(ConvexHull, CoplanarPoints) {
+  MatX3d points(10, 3);
+  for (int i = 0; i < points.rows(); ++i) {
+    points.row(i) << i % 3, i / 3, 1.0;
+  }
+  ASSERT_TRUE(geometry::ConvexHull(points).empty());
+}
+
+TEST(DelaunayTriangulation, HasEmptyCircumcircles) {
+  const int num_points = 300;
+  MatX2d points(num_points, 2);
+  points.topRows<4>() << -1, -1, 1, -1, 1, 1, -1, 1;
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  for (int i = 4; i < num_points; ++i) {
+    points.row(i) << uniform(generator), uniform(generator);
+  }
+
+  const auto triangles = geometry::DelaunayTriangulation(points);
+  double area = 0.0;
+  for (const auto& triangle : triangles) {
+    ASSERT_GT(SignedArea(points, triangle), 0.0);
+    area += SignedArea(points, triangle);
+
+    // Circumcircle center from the perpendicular bisectors
+    const Vec2d a = points.row(triangle(0));
+    const Vec2d b = points.row(triangle(1));
+    const Vec2d c = points.row(triangle(2));
+    Eigen::Matrix2d A;
+    A << (b - a).transpose(), (c - a).transpose();
+    const Vec2d rhs(0.5 * (b - a).squaredNorm(), 0.5 * (c - a).squaredNorm());
+    const Vec2d center = a + A.inverse() * rhs;
+    const double radius = (a - center).norm();
+    for (int i = 0; i < num_points; ++i) {
+      ASSERT_GE((points.row(i).transpose() - center).norm(), radius - 1e-9);
+    }
+  }
+  ASSERT_NEAR(4.0, area, 1e-9);
+}
+
+TEST(DelaunayTriangulation, CocircularPoints) {
+  MatX2d points(5, 2);
+  points << -1, -1, 1, -1, 1, 1, -1, 1, 1, 1;
+  const auto triangles = geometry::DelaunayTriangulation(points);
+  ASSERT_EQ(2, triangles.size());
+  for (const auto& triangle : triangles) {
+    ASSERT_NEAR(2.0, SignedArea(points, triangle), 1e-12);
+  }
+}
+
+TEST(DelaunayTriangulation, CollinearPoints) {
+  MatX2d points(4, 2);
+  points << 0, 0, 1, 1, 2, 2, 3, 3;
+  ASSERT_TRUE(geometry::DelaunayTriangulation(points).empty());
+}
+}  // namespace
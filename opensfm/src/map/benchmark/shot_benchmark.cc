@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include <map/map.h>
+
+namespace {
+
+/* Map with a two-cameras rig : shots poses are composed from their rig
+ * camera and rig instance poses. */
+struct RigMap {
+  RigMap() {
+    auto camera = geometry::Camera::CreatePerspectiveCamera(1.0, 0, 0);
+    camera.id = "camera";
+    map.CreateCamera(camera);
+    map.CreateRigCamera(map::RigCamera(geometry::Pose(), "left"));
+    map.CreateRigCamera(
+        map::RigCamera(geometry::Pose(Vec3d(0.1, 0.2, 0.3), Vec3d(1, 0, 0)),
+                       "right"));
+    map.CreateRigInstance("instance");
+    map.CreateShot("left", camera.id, "left", "instance");
+    map.CreateShot("right", camera.id, "right", "instance");
+    map.GetRigInstance("instance").SetPose(
+        geometry::Pose(Vec3d(0.3, -0.1, 0.2), Vec3d(0, 2, -1)));
+  }
+
+  map::Map map;
+};
+
+void BM_ShotProjectInRig(benchmark::State& state) {
+  const RigMap rig_map;
+  const auto& shot = rig_map.map.GetShot("right");
+  const Vec3d point(0.5, -0.3, 10.0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(shot.Project(point));
+  }
+}
+
+void BM_ShotProjectManyInRig(benchmark::State& state) {
+  const RigMap rig_map;
+  const auto& shot = rig_map.map.GetShot("right");
+  const MatX3d points = MatX3d::Random(state.range(0), 3).rowwise() +
+                        Vec3d(0.0, 0.0, 10.0).transpose();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(shot.ProjectMany(points));
+  }
+  state.SetItemsProcessed(state.iterations() * points.rows());
+}
+
+BENCHMARK(BM_ShotProjectInRig);
+BENCHMARK(BM_ShotProjectManyInRig)->Arg(1000);
+
+}  // namespace
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+#include <map/tracks_manager.h>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+/* Synthetic sequence : each track is seen by a run of consecutive shots,
+ * as when walking along a path. The number of shots scales with the
+ * benchmark argument, and each shot sees 'tracks_per_shot' tracks. */
+map::TracksManager CreateSequenceTracks(int shots_count) {
+  constexpr int tracks_per_shot = 1000;
+  constexpr int track_length = 5;
+
+  map::TracksManager manager;
+  const int tracks_count = shots_count * tracks_per_shot / track_length;
+  for (int t = 0; t < tracks_count; ++t) {
+    const auto track_id = std::to_string(t);
+    const int first_shot = (t * track_length) / tracks_per_shot;
+    for (int s = first_shot; s < first_shot + track_length; ++s) {
+      const double x = (t % 100) * 0.01 - 0.5;
+      const double y = (s % 100) * 0.01 - 0.5;
+      manager.AddObservation("shot_" + std::to_string(s % shots_count),
+                             track_id,
+                             map::Observation(x, y, 0.004, 128, 64, 32, t));
+    }
+  }
+  return manager;
+}
+
+void BM_TracksManagerAsString(benchmark::State& state) {
+  const auto manager = CreateSequenceTracks(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(manager.AsString());
+  }
+}
+
+void BM_TracksManagerFromString(benchmark::State& state) {
+  const auto tracks = CreateSequenceTracks(state.range(0)).AsString();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map::TracksManager::InstanciateFromString(tracks));
+  }
+  state.SetBytesProcessed(state.iterations() * tracks.size());
+}
+
+void BM_TracksManagerBytesRoundTrip(benchmark::State& state) {
+  const auto manager = CreateSequenceTracks(state.range(0));
+  for (auto _ : state) {
+    const auto bytes = manager.AsBytes();
+    benchmark::DoNotOptimize(
+        map::TracksManager::InstanciateFromBytes(bytes.data(), bytes.size()));
+  }
+}
+
+void BM_TracksManagerSaveLoad(benchmark::State& state) {
+  const auto manager = CreateSequenceTracks(state.range(0));
+  const std::string filename = "tracks_manager_benchmark.csv";
+  for (auto _ : state) {
+    manager.WriteToFile(filename);
+    benchmark::DoNotOptimize(map::TracksManager::InstanciateFromFile(filename));
+  }
+  std::remove(filename.c_str());
+}
+
+void BM_TracksManagerAllPairsConnectivity(benchmark::State& state) {
+  const auto manager = CreateSequenceTracks(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(manager.GetAllPairsConnectivity({}, {}));
+  }
+}
+
+BENCHMARK(BM_TracksManagerAsString)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TracksManagerFromString)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TracksManagerBytesRoundTrip)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TracksManagerSaveLoad)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TracksManagerAllPairsConnectivity)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -1,4 +1,5 @@
 #pragma once
+#include <foundation/memory_usage.h>
 #include <map/defines.h>
 
 #include <Eigen/Eigen>
@@ -6,6 +7,7 @@
 #include <map>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 namespace map {
 class Shot;
 
@@ -36,11 +38,26 @@ class Landmark {
   bool operator>(const Landmark& lm) const { return id_ > lm.id_; }
   bool operator>=(const Landmark& lm) const { return id_ >= lm.id_; }
 
-  // Reprojection Errors
+  // Reprojection Errors, only for shots observing the landmark
   void SetReprojectionErrors(
       const std::map<ShotId, Eigen::VectorXd>& reproj_errors);
+  // Replace all the errors at once : errors[i] is the one of shots[i], which
+  // must observe the landmark
+  void SetReprojectionErrors(std::vector<Shot*> shots,
+                             std::vector<VecMax3d> errors);
   std::map<ShotId, Eigen::VectorXd> GetReprojectionErrors() const;
-  void RemoveReprojectionError(const ShotId& shot_id);
+  void SetReprojectionError(Shot* shot, const VecMax3d& error);
+  void RemoveReprojectionError(Shot* shot);
+  void ClearReprojectionErrors();
+  const std::vector<Shot*>& GetReprojectionErrorsShots() const {
+    return reproj_errors_shots_;
+  }
+  const std::vector<VecMax3d>& GetReprojectionErrorsValues() const {
+    return reproj_errors_;
+  }
+
+  // Heap memory owned by the landmark, not counting the landmark itself
+  foundation::MemoryUsage MemoryUsage() const;
 
  public:
   const LandmarkId id_;
@@ -49,6 +66,9 @@ class Landmark {
   Vec3d global_pos_;  // point in global
   std::map<Shot*, FeatureId, KeyCompare> observations_;
   Vec3i color_;
-  std::map<ShotId, Eigen::VectorXd> reproj_errors_;
+  // Errors are stored flat : reproj_errors_[i] is the one of shot
+  // reproj_errors_shots_[i]
+  std::vector<Shot*> reproj_errors_shots_;
+  std::vector<VecMax3d> reproj_errors_;
 };
 }  // namespace map
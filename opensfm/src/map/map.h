@@ -1,5 +1,7 @@
 #pragma once
 
+#include <foundation/memory_usage.h>
+#include <foundation/shared_mutex.h>
 #include <geo/geo.h>
 #include <geometry/camera.h>
 #include <geometry/pose.h>
@@ -16,16 +18,41 @@
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <vector>
 namespace map {
 
+/* Concurrency : the const interface of Map and of its Shot, Landmark,
+ * RigInstance and RigCamera doesn't modify any shared state (see
+ * Shot::GetPose), so any number of threads can read a map at the same time
+ * as long as none modifies it. Native parallel stages thus work on a const
+ * Map, and apply their results afterwards from a single thread.
+ *
+ * When readers and a writer run concurrently (e.g. outside of the GIL),
+ * readers hold LockForReading() and the writer, which should commit its
+ * updates in batches, LockForWriting(). Pointers and references to shots
+ * and landmarks stay valid until these are removed. */
 class Map {
  public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
+  // Readers/writer locking, see above
+  foundation::ReadLock LockForReading() const {
+    return mutex_.LockForReading();
+  }
+  foundation::WriteLock LockForWriting() const {
+    return mutex_.LockForWriting();
+  }
+
   // Deep-Copy
   static std::unique_ptr<Map> DeepCopy(const Map& map,
                                        bool copy_observations = false);
 
+  // Compact binary serialization, observations included
+  // (see map/serialization.h)
+  static std::unique_ptr<Map> InstanciateFromBytes(const char* data,
+                                                   size_t size);
+  std::string AsBytes() const;
+
   // Camera Methods
   geometry::Camera& GetCamera(const CameraId& cam_id);
   const geometry::Camera& GetCamera(const CameraId& cam_id) const;
@@ -156,6 +183,12 @@ class Map {
   void ClearObservationsAndLandmarks();
   void CleanLandmarksBelowMinObservations(const size_t min_observations);
 
+  // Transform
+  // Move the landmarks and rig instances by a similarity, and scale the rig
+  // cameras, so that shots still see the same landmarks
+  void ApplySimilarity(const geometry::Similarity& similarity,
+                       int num_threads = 1);
+
   // Map information and access methods
   size_t NumberOfShots() const { return shots_.size(); }
   size_t NumberOfPanoShots() const { return pano_shots_.size(); }
@@ -163,6 +196,21 @@ class Map {
   size_t NumberOfCameras() const { return cameras_.size(); }
   size_t NumberOfBiases() const { return bias_.size(); }
 
+  // Stored reprojection errors of the landmarks, flattened : row i of
+  // 'errors' is the one of landmark 'landmark_ids[i]' in shot 'shot_ids[i]'.
+  // There are as many columns as in the largest error, others are zero-padded
+  struct FlatReprojectionErrors {
+    std::vector<LandmarkId> landmark_ids;
+    std::vector<ShotId> shot_ids;
+    MatXd errors;
+  };
+  FlatReprojectionErrors GetReprojectionErrors() const;
+  FlatReprojectionErrors GetReprojectionErrors(
+      const std::vector<LandmarkId>& landmark_ids) const;
+
+  // Memory used by the map, broken down by component
+  foundation::MemoryUsage MemoryUsage() const;
+
   // Bias
   BiasView GetBiasView() { return BiasView(*this); }
   geometry::Similarity& GetBias(const CameraId& camera_id);
@@ -210,6 +258,8 @@ class Map {
   std::unordered_map<RigCameraId, RigCamera> rig_cameras_;
 
   geo::TopocentricConverter topo_conv_;
+
+  foundation::SharedMutex mutex_;
 };
 
 }  // namespace map
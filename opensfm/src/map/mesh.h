@@ -0,0 +1,20 @@
+#pragma once
+
+#include <map/defines.h>
+#include <map/map.h>
+#include <map/shot.h>
+#include <map/tracks_manager.h>
+
+namespace map {
+
+// Triangle mesh of the landmarks seen by a shot, with vertices in world
+// coordinates. Landmarks of the shot tracks are triangulated in the image
+// plane for perspective cameras, or on the sphere of bearings for fisheye
+// and spherical ones, along with a few extra vertices bounding the view.
+ShotMesh ComputeShotMesh(const Map& map, const TracksManager& tracks_manager,
+                         const ShotId& shot_id);
+
+// Set the mesh of all the shots of the map seen by the tracks manager
+void ComputeShotMeshes(Map& map, const TracksManager& tracks_manager,
+                       int num_threads);
+}  // namespace map
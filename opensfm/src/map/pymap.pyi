@@ -41,6 +41,11 @@ __all__ = [
     "ShotMesh",
     "ShotView",
     "TracksManager",
+    "clear_tracing",
+    "compute_shot_meshes",
+    "get_tracing_events",
+    "is_tracing_enabled",
+    "set_tracing_enabled",
     "Angular",
     "METRICS_ONLY",
     "Normalized",
@@ -201,7 +206,10 @@ class LandmarkView:
     def values(self) -> Iterator: ...
 
 class Map:
+    def __getstate__(self) -> tuple: ...
     def __init__(self) -> None: ...
+    def __reduce_ex__(self, arg0: int) -> tuple: ...
+    def __setstate__(self, arg0: tuple) -> None: ...
     @overload
     def add_observation(
         self, shot: Shot, landmark: Landmark, observation: Observation
@@ -210,6 +218,13 @@ class Map:
     def add_observation(
         self, shot_Id: str, landmark_id: str, observation: Observation
     ) -> None: ...
+    def apply_similarity(
+        self,
+        s: float,
+        A: numpy.ndarray,
+        b: numpy.ndarray,
+        num_threads: int = 1,
+    ) -> None: ...
     def clean_landmarks_below_min_observations(self, arg0: int) -> None: ...
     def clear_observations_and_landmarks(self) -> None: ...
     def compute_reprojection_errors(
@@ -245,12 +260,21 @@ class Map:
     def get_pano_shot(self, arg0: str) -> Shot: ...
     def get_pano_shots(self) -> PanoShotView: ...
     def get_reference(self) -> opensfm.pygeo.TopocentricConverter: ...
+    @overload
+    def get_reprojection_errors(
+        self,
+    ) -> Tuple[List[str], List[str], numpy.ndarray]: ...
+    @overload
+    def get_reprojection_errors(
+        self, landmark_ids: List[str]
+    ) -> Tuple[List[str], List[str], numpy.ndarray]: ...
     def get_shot(self, arg0: str) -> Shot: ...
     def get_shots(self) -> ShotView: ...
     def get_valid_observations(
         self, arg0: TracksManager
     ) -> Dict[str, Dict[str, Observation]]: ...
     def has_landmark(self, arg0: str) -> bool: ...
+    def memory_usage(self) -> Dict[str, int]: ...
     @overload
     def remove_landmark(self, arg0: Landmark) -> None: ...
     @overload
@@ -559,9 +583,12 @@ class ShotView:
     def values(self) -> Iterator: ...
 
 class TracksManager:
+    def __getstate__(self) -> tuple: ...
     def __init__(self) -> None: ...
+    def __reduce_ex__(self, arg0: int) -> tuple: ...
+    def __setstate__(self, arg0: tuple) -> None: ...
     def add_observation(self, arg0: str, arg1: str, arg2: Observation) -> None: ...
-    def as_string(self) -> str: ...
+    def as_string(self, num_threads: int = 1) -> str: ...
     def construct_sub_tracks_manager(
         self, arg0: List[str], arg1: List[str]
     ) -> TracksManager: ...
@@ -577,18 +604,52 @@ class TracksManager:
     def get_track_ids(self) -> List[str]: ...
     def get_track_observations(self, arg0: str) -> Dict[str, Observation]: ...
     @staticmethod
-    def instanciate_from_file(arg0: str) -> TracksManager: ...
+    def instanciate_from_file(filename: str, num_threads: int = 1) -> TracksManager: ...
     @staticmethod
-    def instanciate_from_string(arg0: str) -> TracksManager: ...
+    def instanciate_from_string(str: str, num_threads: int = 1) -> TracksManager: ...
     @staticmethod
     def merge_tracks_manager(arg0: List[TracksManager]) -> TracksManager: ...
+    def memory_usage(self) -> Dict[str, int]: ...
     def num_shots(self) -> int: ...
     def num_tracks(self) -> int: ...
     def remove_observation(self, arg0: str, arg1: str) -> None: ...
-    def write_to_file(self, arg0: str) -> None: ...
+    def write_to_file(self, filename: str, num_threads: int = 1) -> None: ...
+
+class TracksManagerView:
+    @overload
+    def __init__(
+        self, tracks_manager: TracksManager, tracks: List[str], shots: List[str]
+    ) -> None: ...
+    @overload
+    def __init__(self, tracks_manager: TracksManager, shots: List[str]) -> None: ...
+    def as_string(self, num_threads: int = 1) -> str: ...
+    def get_all_common_observations(
+        self, arg0: str, arg1: str
+    ) -> List[Tuple[str, Observation, Observation]]: ...
+    def get_all_pairs_connectivity(
+        self, shots: List[str] = [], tracks: List[str] = []
+    ) -> Dict[Tuple[str, str], int]: ...
+    def get_observation(self, arg0: str, arg1: str) -> Observation: ...
+    def get_shot_ids(self) -> List[str]: ...
+    def get_shot_observations(self, arg0: str) -> Dict[str, Observation]: ...
+    def get_track_ids(self) -> List[str]: ...
+    def get_track_observations(self, arg0: str) -> Dict[str, Observation]: ...
+    def has_shot_observations(self, arg0: str) -> bool: ...
+    def materialize(self) -> TracksManager: ...
+    def num_shots(self) -> int: ...
+    def num_tracks(self) -> int: ...
+    def write_to_file(self, filename: str, num_threads: int = 1) -> None: ...
 
 Angular: "ErrorType"
 METRICS_ONLY: "GroundControlPointRole"
 Normalized: "ErrorType"
 OPTIMIZATION: "GroundControlPointRole"
 Pixel: "ErrorType"
+
+def clear_tracing() -> None: ...
+def compute_shot_meshes(
+    map: Map, tracks_manager: TracksManager, num_threads: int
+) -> None: ...
+def get_tracing_events() -> str: ...
+def is_tracing_enabled() -> bool: ...
+def set_tracing_enabled(arg0: bool) -> None: ...
@@ -1,4 +1,5 @@
 #include <foundation/optional.h>
+#include <foundation/tracing_bind.h>
 #include <foundation/types.h>
 #include <geometry/camera.h>
 #include <geometry/pose.h>
@@ -7,10 +8,13 @@
 #include <map/ground_control_points.h>
 #include <map/landmark.h>
 #include <map/map.h>
+#include <map/mesh.h>
 #include <map/pybind_utils.h>
 #include <map/rig.h>
 #include <map/shot.h>
+#include <map/tracks_manager_view.h>
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -43,7 +47,48 @@ void DeclareShotMeasurement(py::module &m, const std::string &type_name) {
             return sm;
           }));
 }
+
+// Pickle state of binary serialized data. With protocol 5, the data is
+// wrapped without copy in a PickleBuffer, so that it can be sent out-of-band.
+py::tuple BinaryPickleState(std::string &&bytes, int protocol) {
+  if (protocol < 5) {
+    return py::make_tuple(py::bytes(bytes));
+  }
+  auto owner = new std::string(std::move(bytes));
+  py::capsule free_owner(
+      owner, [](void *data) { delete static_cast<std::string *>(data); });
+  py::array_t<uint8_t> array(owner->size(),
+                             reinterpret_cast<const uint8_t *>(owner->data()),
+                             free_owner);
+  return py::make_tuple(
+      py::module::import("pickle").attr("PickleBuffer")(array));
+}
+
+// Same as the default reduction of objects, but with a protocol dependent
+// state, since __getstate__ doesn't get the protocol
+template <class T>
+py::tuple ReduceBinaryPickle(const py::object &self, int protocol) {
+  const auto &value = self.cast<const T &>();
+  std::string bytes;
+  {
+    py::gil_scoped_release release;
+    bytes = value.AsBytes();
+  }
+  return py::make_tuple(py::module::import("copyreg").attr("__newobj__"),
+                        py::make_tuple(self.attr("__class__")),
+                        BinaryPickleState(std::move(bytes), protocol));
+}
+
+template <class F>
+auto FromBinaryPickleState(const py::tuple &state, F from_bytes) {
+  const auto buffer = state[0].cast<py::buffer>().request();
+  py::gil_scoped_release release;
+  return from_bytes(static_cast<const char *>(buffer.ptr),
+                    buffer.size * buffer.itemsize);
+}
+
 PYBIND11_MODULE(pymap, m) {
+  foundation::AddTracingBindings(m);
   py::module::import("opensfm.pygeometry");
   py::module::import("opensfm.pygeo");
 
@@ -281,10 +326,12 @@ PYBIND11_MODULE(pymap, m) {
   py::class_<map::TracksManager>(m, "TracksManager")
       .def(py::init())
       .def_static("instanciate_from_file",
-                  &map::TracksManager::InstanciateFromFile,
+                  &map::TracksManager::InstanciateFromFile, py::arg("filename"),
+                  py::arg("num_threads") = 1,
                   py::call_guard<py::gil_scoped_release>())
       .def_static("instanciate_from_string",
-                  &map::TracksManager::InstanciateFromString,
+                  &map::TracksManager::InstanciateFromString, py::arg("str"),
+                  py::arg("num_threads") = 1,
                   py::call_guard<py::gil_scoped_release>())
       .def_static("merge_tracks_manager",
                   &map::TracksManager::MergeTracksManager)
@@ -299,8 +346,13 @@ PYBIND11_MODULE(pymap, m) {
       .def("get_track_observations", &map::TracksManager::GetTrackObservations)
       .def("construct_sub_tracks_manager",
            &map::TracksManager::ConstructSubTracksManager)
-      .def("write_to_file", &map::TracksManager::WriteToFile)
-      .def("as_string", &map::TracksManager::AsString)
+      .def("write_to_file", &map::TracksManager::WriteToFile,
+           py::arg("filename"), py::arg("num_threads") = 1,
+           py::call_guard<py::gil_scoped_release>())
+      .def("as_string", &map::TracksManager::AsString,
+           py::arg("num_threads") = 1,
+           py::call_guard<py::gil_scoped_release>())
+      .def("memory_usage", &map::TracksManager::MemoryUsage)
       .def("get_all_common_observations",
            &map::TracksManager::GetAllCommonObservations,
            py::call_guard<py::gil_scoped_release>())
@@ -308,6 +360,57 @@ PYBIND11_MODULE(pymap, m) {
            &map::TracksManager::GetAllPairsConnectivity,
            py::arg("shots") = std::vector<map::ShotId>(),
            py::arg("tracks") = std::vector<map::TrackId>(),
+           py::call_guard<py::gil_scoped_release>())
+      .def(py::pickle(
+          [](const map::TracksManager &tracks_manager) {
+            return py::make_tuple(py::bytes(tracks_manager.AsBytes()));
+          },
+          [](const py::tuple &state) {
+            return FromBinaryPickleState(
+                state, &map::TracksManager::InstanciateFromBytes);
+          }))
+      .def("__reduce_ex__", &ReduceBinaryPickle<map::TracksManager>);
+
+  py::class_<map::TracksManagerView>(m, "TracksManagerView")
+      .def(py::init<const map::TracksManager &,
+                    const std::vector<map::TrackId> &,
+                    const std::vector<map::ShotId> &>(),
+           py::arg("tracks_manager"), py::arg("tracks"), py::arg("shots"),
+           py::keep_alive<1, 2>())  // Keep tracks alive while view is used
+      .def(py::init<const map::TracksManager &,
+                    const std::vector<map::ShotId> &>(),
+           py::arg("tracks_manager"), py::arg("shots"),
+           py::keep_alive<1, 2>())
+      .def("num_shots", &map::TracksManagerView::NumShots)
+      .def("num_tracks", &map::TracksManagerView::NumTracks)
+      .def("get_shot_ids", &map::TracksManagerView::GetShotIds)
+      .def("get_track_ids", &map::TracksManagerView::GetTrackIds)
+      .def("has_shot_observations",
+           &map::TracksManagerView::HasShotObservations)
+      .def("get_observation", &map::TracksManagerView::GetObservation)
+      .def("get_shot_observations",
+           [](const map::TracksManagerView &view, const map::ShotId &shot) {
+             return view.GetShotObservations(shot).Copy();
+           })
+      .def("get_track_observations",
+           [](const map::TracksManagerView &view, const map::TrackId &track) {
+             return view.GetTrackObservations(track).Copy();
+           })
+      .def("get_all_common_observations",
+           &map::TracksManagerView::GetAllCommonObservations,
+           py::call_guard<py::gil_scoped_release>())
+      .def("get_all_pairs_connectivity",
+           &map::TracksManagerView::GetAllPairsConnectivity,
+           py::arg("shots") = std::vector<map::ShotId>(),
+           py::arg("tracks") = std::vector<map::TrackId>(),
+           py::call_guard<py::gil_scoped_release>())
+      .def("materialize", &map::TracksManagerView::Materialize,
+           py::call_guard<py::gil_scoped_release>())
+      .def("write_to_file", &map::TracksManagerView::WriteToFile,
+           py::arg("filename"), py::arg("num_threads") = 1,
+           py::call_guard<py::gil_scoped_release>())
+      .def("as_string", &map::TracksManagerView::AsString,
+           py::arg("num_threads") = 1,
            py::call_guard<py::gil_scoped_release>());
 
   py::class_<map::PanoShotView>(m, "PanoShotView")
@@ -616,6 +719,14 @@ PYBIND11_MODULE(pymap, m) {
            &map::Map::ClearObservationsAndLandmarks)
       .def("clean_landmarks_below_min_observations",
            &map::Map::CleanLandmarksBelowMinObservations)
+      .def(
+          "apply_similarity",
+          [](map::Map &self, double s, const Mat3d &A, const Vec3d &b,
+             int num_threads) {
+            self.ApplySimilarity(geometry::Similarity(A, b, s), num_threads);
+          },
+          py::arg("s"), py::arg("A"), py::arg("b"), py::arg("num_threads") = 1,
+          py::call_guard<py::gil_scoped_release>())
       // Shot
       .def(
           "create_shot",
@@ -668,6 +779,7 @@ PYBIND11_MODULE(pymap, m) {
       .def("get_landmarks", &map::Map::GetLandmarkView)
       .def("get_landmark_view", &map::Map::GetLandmarkView)
       .def("set_reference", &map::Map::SetTopocentricConverter)
+      .def("memory_usage", &map::Map::MemoryUsage)
       // Reference
       .def("get_reference",
            [](const map::Map &map) {
@@ -676,6 +788,34 @@ PYBIND11_MODULE(pymap, m) {
            })
       // Tracks manager x Reconstruction intersection
       .def("compute_reprojection_errors", &map::Map::ComputeReprojectionErrors)
+      .def("get_reprojection_errors",
+           [](const map::Map &map) {
+             auto flat = map.GetReprojectionErrors();
+             return py::make_tuple(flat.landmark_ids, flat.shot_ids,
+                                   flat.errors);
+           })
+      .def(
+          "get_reprojection_errors",
+          [](const map::Map &map,
+             const std::vector<map::LandmarkId> &landmark_ids) {
+            auto flat = map.GetReprojectionErrors(landmark_ids);
+            return py::make_tuple(flat.landmark_ids, flat.shot_ids,
+                                  flat.errors);
+          },
+          py::arg("landmark_ids"))
       .def("get_valid_observations", &map::Map::GetValidObservations)
-      .def("to_tracks_manager", &map::Map::ToTracksManager);
+      .def("to_tracks_manager", &map::Map::ToTracksManager)
+      .def(py::pickle(
+          [](const map::Map &map) {
+            return py::make_tuple(py::bytes(map.AsBytes()));
+          },
+          [](const py::tuple &state) {
+            return FromBinaryPickleState(state,
+                                         &map::Map::InstanciateFromBytes);
+          }))
+      .def("__reduce_ex__", &ReduceBinaryPickle<map::Map>);
+
+  m.def("compute_shot_meshes", &map::ComputeShotMeshes, py::arg("map"),
+        py::arg("tracks_manager"), py::arg("num_threads"),
+        py::call_guard<py::gil_scoped_release>());
 }
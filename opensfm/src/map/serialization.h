@@ -0,0 +1,151 @@
+#pragma once
+
+#include <map/observation.h>
+
+#include <Eigen/Core>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace map {
+
+/* Compact binary serialization used by the TracksManager and Map pickling.
+ * Values are written in native byte order, strings and matrices are
+ * prefixed by their size. It is meant for transfers between processes of
+ * the same machine, not for storage. */
+class BinaryWriter {
+ public:
+  template <class T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable values can be written");
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void WriteString(const std::string& str) {
+    Write<uint32_t>(str.size());
+    buffer_.append(str);
+  }
+
+  // Coefficients of a matrix, without its size
+  template <class M>
+  void WriteData(const Eigen::DenseBase<M>& matrix) {
+    const auto& evaluated = matrix.derived().eval();
+    buffer_.append(reinterpret_cast<const char*>(evaluated.data()),
+                   evaluated.size() * sizeof(typename M::Scalar));
+  }
+
+  template <class M>
+  void WriteMatrix(const Eigen::DenseBase<M>& matrix) {
+    Write<uint32_t>(matrix.rows());
+    Write<uint32_t>(matrix.cols());
+    WriteData(matrix);
+  }
+
+  void WriteObservation(const Observation& observation) {
+    WriteData(observation.point);
+    Write(observation.scale);
+    WriteData(observation.color);
+    Write<int32_t>(observation.feature_id);
+    Write<int32_t>(observation.segmentation_id);
+    Write<int32_t>(observation.instance_id);
+    Write<uint8_t>(observation.depth_prior.has_value());
+    if (observation.depth_prior) {
+      Write(observation.depth_prior->value);
+      Write(observation.depth_prior->std_deviation);
+      Write<uint8_t>(observation.depth_prior->is_radial);
+    }
+  }
+
+  void Reserve(size_t bytes) { buffer_.reserve(bytes); }
+  std::string Release() { return std::move(buffer_); }
+
+ private:
+  std::string buffer_;
+};
+
+class BinaryReader {
+ public:
+  BinaryReader(const char* data, size_t size)
+      : data_(data), end_(data + size) {}
+
+  template <class T>
+  T Read() {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only trivially copyable values can be read");
+    CheckAvailable(sizeof(T));
+    T value;
+    std::memcpy(&value, data_, sizeof(T));
+    data_ += sizeof(T);
+    return value;
+  }
+
+  std::string ReadString() {
+    const auto size = Read<uint32_t>();
+    CheckAvailable(size);
+    std::string str(data_, size);
+    data_ += size;
+    return str;
+  }
+
+  template <class M>
+  void ReadData(Eigen::DenseBase<M>& matrix) {
+    const size_t bytes = matrix.size() * sizeof(typename M::Scalar);
+    CheckAvailable(bytes);
+    std::memcpy(matrix.derived().data(), data_, bytes);
+    data_ += bytes;
+  }
+
+  template <class M>
+  M ReadMatrix() {
+    const int rows = Read<uint32_t>();
+    const int cols = Read<uint32_t>();
+    if ((M::RowsAtCompileTime != Eigen::Dynamic &&
+         M::RowsAtCompileTime != rows) ||
+        (M::ColsAtCompileTime != Eigen::Dynamic &&
+         M::ColsAtCompileTime != cols) ||
+        (M::MaxRowsAtCompileTime != Eigen::Dynamic &&
+         M::MaxRowsAtCompileTime < rows) ||
+        (M::MaxColsAtCompileTime != Eigen::Dynamic &&
+         M::MaxColsAtCompileTime < cols)) {
+      throw std::runtime_error("Invalid matrix size in binary data");
+    }
+    M matrix;
+    matrix.resize(rows, cols);
+    ReadData(matrix);
+    return matrix;
+  }
+
+  Observation ReadObservation() {
+    Observation observation;
+    ReadData(observation.point);
+    observation.scale = Read<double>();
+    ReadData(observation.color);
+    observation.feature_id = Read<int32_t>();
+    observation.segmentation_id = Read<int32_t>();
+    observation.instance_id = Read<int32_t>();
+    if (Read<uint8_t>()) {
+      Depth depth;
+      depth.value = Read<double>();
+      depth.std_deviation = Read<double>();
+      depth.is_radial = Read<uint8_t>();
+      observation.depth_prior = depth;
+    }
+    return observation;
+  }
+
+  bool AtEnd() const { return data_ == end_; }
+
+ private:
+  void CheckAvailable(size_t bytes) const {
+    if (static_cast<size_t>(end_ - data_) < bytes) {
+      throw std::runtime_error("Truncated binary data");
+    }
+  }
+
+  const char* data_;
+  const char* end_;
+};
+}  // namespace map
@@ -1,4 +1,5 @@
 #pragma once
+#include <foundation/memory_usage.h>
 #include <foundation/optional.h>
 #include <geometry/camera.h>
 #include <geometry/pose.h>
@@ -8,7 +9,9 @@
 #include <map/rig.h>
 
 #include <Eigen/Eigen>
+#include <atomic>
 #include <iostream>
+#include <mutex>
 #include <unordered_map>
 
 namespace map {
@@ -70,6 +73,9 @@ class Shot {
   const RigCameraId& GetRigCameraId() const;
 
   // Pose
+  // The pose composed from the rig instance and rig camera poses is cached,
+  // and refreshed (under a lock, so that the const getter can be called
+  // concurrently) when the generation of one of these changed.
   void SetPose(const geometry::Pose& pose);
   const geometry::Pose* const GetPose() const;
   geometry::Pose* const GetPose();
@@ -146,6 +152,9 @@ class Shot {
   MatXd GetCovariance() const { return covariance_.Value(); }
   void SetCovariance(const MatXd& cov) { covariance_.SetValue(cov); }
 
+  // Heap memory owned by the shot, not counting the shot itself
+  foundation::MemoryUsage MemoryUsage() const;
+
  public:
   const ShotId id_;  // the file name
 
@@ -156,9 +165,15 @@ class Shot {
 
  private:
   geometry::Pose GetPoseInRig() const;
+  void UpdatePoseInRig() const;
 
   // Pose
   mutable std::unique_ptr<geometry::Pose> pose_;
+  // Generations of the rig instance and rig camera poses 'pose_' was
+  // composed from, zero when it needs to be composed again
+  mutable std::mutex pose_mutex_;
+  mutable std::atomic<uint64_t> pose_instance_generation_{0};
+  mutable std::atomic<uint64_t> pose_rig_camera_generation_{0};
   foundation::OptionalValue<MatXd> covariance_;
 
   // Rig data (can optionally belong to the shot)
@@ -10,12 +10,56 @@ Landmark::Landmark(const LandmarkId& lm_id, const Vec3d& global_pos)
 
 void Landmark::SetReprojectionErrors(
     const std::map<ShotId, Eigen::VectorXd>& reproj_errors) {
-  reproj_errors_ = reproj_errors;
+  std::vector<Shot*> shots;
+  std::vector<VecMax3d> errors;
+  shots.reserve(reproj_errors.size());
+  errors.reserve(reproj_errors.size());
+  for (const auto& shot_error : reproj_errors) {
+    if (shot_error.second.size() > VecMax3d::MaxRowsAtCompileTime) {
+      throw std::runtime_error("Reprojection errors can't exceed size 3");
+    }
+    auto shot_it = std::find_if(
+        observations_.begin(), observations_.end(),
+        [&](const auto& obs) { return obs.first->id_ == shot_error.first; });
+    if (shot_it == observations_.end()) {
+      throw std::runtime_error("Shot " + shot_error.first +
+                               " doesn't observe landmark " + id_);
+    }
+    shots.push_back(shot_it->first);
+    errors.push_back(shot_error.second);
+  }
+  SetReprojectionErrors(std::move(shots), std::move(errors));
+}
+
+void Landmark::SetReprojectionErrors(std::vector<Shot*> shots,
+                                     std::vector<VecMax3d> errors) {
+  reproj_errors_shots_ = std::move(shots);
+  reproj_errors_ = std::move(errors);
+}
+
+void Landmark::SetReprojectionError(Shot* shot, const VecMax3d& error) {
+  if (observations_.find(shot) == observations_.end()) {
+    throw std::runtime_error("Shot " + shot->id_ +
+                             " doesn't observe landmark " + id_);
+  }
+  auto it = std::find(reproj_errors_shots_.begin(), reproj_errors_shots_.end(),
+                      shot);
+  if (it != reproj_errors_shots_.end()) {
+    reproj_errors_[it - reproj_errors_shots_.begin()] = error;
+  } else {
+    reproj_errors_shots_.push_back(shot);
+    reproj_errors_.push_back(error);
+  }
+}
+
+void Landmark::ClearReprojectionErrors() {
+  reproj_errors_shots_.clear();
+  reproj_errors_.clear();
 }
 
 void Landmark::RemoveObservation(Shot* shot) {
   // Remove reprojection errors if present
-  RemoveReprojectionError(shot->id_);
+  RemoveReprojectionError(shot);
   observations_.erase(shot);
 }
 
@@ -36,15 +80,33 @@ const std::map<Shot*, FeatureId, KeyCompare>& Landmark::GetObservations()
 }
 
 std::map<ShotId, Eigen::VectorXd> Landmark::GetReprojectionErrors() const {
-  return reproj_errors_;
+  std::map<ShotId, Eigen::VectorXd> reproj_errors;
+  for (size_t i = 0; i < reproj_errors_shots_.size(); ++i) {
+    reproj_errors.emplace(reproj_errors_shots_[i]->id_, reproj_errors_[i]);
+  }
+  return reproj_errors;
 }
-void Landmark::RemoveReprojectionError(const ShotId& shot_id) {
-  auto it = reproj_errors_.find(shot_id);
-  if (it != reproj_errors_.end()) {
-    reproj_errors_.erase(it);
+void Landmark::RemoveReprojectionError(Shot* shot) {
+  auto it = std::find(reproj_errors_shots_.begin(), reproj_errors_shots_.end(),
+                      shot);
+  if (it != reproj_errors_shots_.end()) {
+    reproj_errors_.erase(reproj_errors_.begin() +
+                         (it - reproj_errors_shots_.begin()));
+    reproj_errors_shots_.erase(it);
   }
 }
 
 size_t Landmark::NumberOfObservations() const { return observations_.size(); }
 
+foundation::MemoryUsage Landmark::MemoryUsage() const {
+  namespace memory = foundation::memory;
+  foundation::MemoryUsage usage;
+  usage["ids"] = memory::HeapBytes(id_);
+  usage["observations"] =
+      memory::ElementsBytes(observations_) + memory::IndexBytes(observations_);
+  usage["reprojection_errors"] = memory::HeapBytes(reproj_errors_shots_) +
+                                 memory::HeapBytes(reproj_errors_);
+  return usage;
+}
+
 };  // namespace map
@@ -1,3 +1,4 @@
+#include <foundation/tracing.h>
 #include <geometry/pose.h>
 #include <map/defines.h>
 #include <map/landmark.h>
@@ -5,10 +6,12 @@
 #include <map/rig.h>
 #include <map/shot.h>
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <stdexcept>
 #include <unordered_set>
+#include <vector>
 
 namespace {
 void AssignShot(map::Shot& to, const map::Shot& from) {
@@ -17,6 +20,34 @@ void AssignShot(map::Shot& to, const map::Shot& from) {
   to.SetShotMeasurements(from.GetShotMeasurements());
   to.SetCovariance(from.GetCovariance());
 }
+
+map::Map::FlatReprojectionErrors FlattenReprojectionErrors(
+    const std::vector<const map::Landmark*>& landmarks) {
+  size_t count = 0;
+  int columns = 0;
+  for (const auto* landmark : landmarks) {
+    for (const auto& error : landmark->GetReprojectionErrorsValues()) {
+      columns = std::max(columns, static_cast<int>(error.size()));
+    }
+    count += landmark->GetReprojectionErrorsValues().size();
+  }
+
+  map::Map::FlatReprojectionErrors flat;
+  flat.landmark_ids.reserve(count);
+  flat.shot_ids.reserve(count);
+  flat.errors = MatXd::Zero(count, columns);
+  for (const auto* landmark : landmarks) {
+    const auto& shots = landmark->GetReprojectionErrorsShots();
+    const auto& errors = landmark->GetReprojectionErrorsValues();
+    for (size_t i = 0; i < shots.size(); ++i) {
+      flat.errors.row(flat.shot_ids.size()).head(errors[i].size()) =
+          errors[i].transpose();
+      flat.landmark_ids.push_back(landmark->id_);
+      flat.shot_ids.push_back(shots[i]->id_);
+    }
+  }
+  return flat;
+}
 }  // namespace
 namespace map {
 
@@ -162,6 +193,36 @@ void Map::CleanLandmarksBelowMinObservations(const size_t min_observations) {
   }
 }
 
+void Map::ApplySimilarity(const geometry::Similarity& similarity,
+                          int num_threads) {
+  OPENSFM_TRACE_SCOPE("map", "Map::ApplySimilarity");
+  std::vector<Landmark*> landmarks;
+  landmarks.reserve(landmarks_.size());
+  for (auto& landmark : landmarks_) {
+    landmarks.push_back(&landmark.second);
+  }
+  const int num_landmarks = landmarks.size();
+#pragma omp parallel for num_threads(num_threads) schedule(static, 1024)
+  for (int i = 0; i < num_landmarks; ++i) {
+    auto& landmark = *landmarks[i];
+    landmark.SetGlobalPos(similarity.Transform(landmark.GetGlobalPos()));
+  }
+
+  for (auto& rig_instance : rig_instances_) {
+    auto& instance = rig_instance.second;
+    instance.SetPose(similarity.TransformPose(instance.GetPose()));
+  }
+
+  // Rig cameras poses are relative to their instance, so only the scale of
+  // their translation changes
+  geometry::Similarity scaling;
+  scaling.SetScale(similarity.Scale());
+  for (auto& rig_camera : rig_cameras_) {
+    auto& pose = rig_camera.second.pose;
+    pose = scaling.TransformPose(pose);
+  }
+}
+
 /**
  * Creates a shot and returns a reference to it
  *
@@ -584,4 +645,67 @@ TracksManager Map::ToTracksManager() const {
   return manager;
 }
 
+
+Map::FlatReprojectionErrors Map::GetReprojectionErrors() const {
+  std::vector<const Landmark*> landmarks;
+  landmarks.reserve(landmarks_.size());
+  for (const auto& landmark : landmarks_) {
+    landmarks.push_back(&landmark.second);
+  }
+  return FlattenReprojectionErrors(landmarks);
+}
+
+Map::FlatReprojectionErrors Map::GetReprojectionErrors(
+    const std::vector<LandmarkId>& landmark_ids) const {
+  std::vector<const Landmark*> landmarks;
+  landmarks.reserve(landmark_ids.size());
+  for (const auto& landmark_id : landmark_ids) {
+    landmarks.push_back(&GetLandmark(landmark_id));
+  }
+  return FlattenReprojectionErrors(landmarks);
+}
+
+foundation::MemoryUsage Map::MemoryUsage() const {
+  namespace memory = foundation::memory;
+  foundation::MemoryUsage usage;
+  usage["ids"] =
+      memory::KeysBytes(cameras_) + memory::KeysBytes(bias_) +
+      memory::KeysBytes(shots_) + memory::KeysBytes(pano_shots_) +
+      memory::KeysBytes(landmarks_) + memory::KeysBytes(rig_instances_) +
+      memory::KeysBytes(rig_cameras_);
+  usage["indices"] =
+      memory::IndexBytes(cameras_) + memory::IndexBytes(bias_) +
+      memory::IndexBytes(shots_) + memory::IndexBytes(pano_shots_) +
+      memory::IndexBytes(landmarks_) + memory::IndexBytes(rig_instances_) +
+      memory::IndexBytes(rig_cameras_);
+
+  usage["cameras"] =
+      memory::ElementsBytes(cameras_) + memory::ElementsBytes(bias_);
+  usage["shots"] =
+      memory::ElementsBytes(shots_) + memory::ElementsBytes(pano_shots_);
+  for (const auto& shot : shots_) {
+    memory::Accumulate(shot.second.MemoryUsage(), &usage);
+  }
+  for (const auto& shot : pano_shots_) {
+    memory::Accumulate(shot.second.MemoryUsage(), &usage);
+  }
+  usage["landmarks"] = memory::ElementsBytes(landmarks_);
+  for (const auto& landmark : landmarks_) {
+    memory::Accumulate(landmark.second.MemoryUsage(), &usage);
+  }
+
+  usage["rigs"] = memory::ElementsBytes(rig_instances_) +
+                  memory::ElementsBytes(rig_cameras_);
+  for (const auto& instance : rig_instances_) {
+    const auto& shots = instance.second.GetShots();
+    const auto& rig_cameras = instance.second.GetRigCameras();
+    usage["rigs"] += memory::ElementsBytes(shots) + memory::IndexBytes(shots) +
+                     memory::ElementsBytes(rig_cameras) +
+                     memory::IndexBytes(rig_cameras);
+    usage["ids"] += memory::KeysBytes(shots) + memory::KeysBytes(rig_cameras);
+  }
+
+  memory::UpdateTotal(&usage);
+  return usage;
+}
 };  // namespace map
@@ -0,0 +1,231 @@
+#include <geometry/convex_hull.h>
+#include <map/mesh.h>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+
+namespace {
+
+// Bearings, in camera coordinates, of the landmarks of the shot tracks
+void AddLandmarkBearings(const map::Map& map,
+                         const map::TracksManager& tracks_manager,
+                         const map::Shot& shot, std::vector<Vec3d>& vertices,
+                         std::vector<Vec3d>& bearings) {
+  const auto& pose = *shot.GetPose();
+  for (const auto& observation :
+       tracks_manager.GetShotObservations(shot.GetId())) {
+    if (!map.HasLandmark(observation.first)) {
+      continue;
+    }
+    const Vec3d point = map.GetLandmark(observation.first).GetGlobalPos();
+    const Vec3d bearing = pose.TransformWorldToCamera(point).normalized();
+    if (bearing.allFinite()) {
+      vertices.push_back(point);
+      bearings.push_back(bearing);
+    }
+  }
+}
+
+map::ShotMesh MakeMesh(const std::vector<Vec3d>& vertices,
+                       const std::vector<Vec3i>& faces) {
+  MatXd vertices_matrix(vertices.size(), 3);
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    vertices_matrix.row(i) = vertices[i];
+  }
+  MatXd faces_matrix(faces.size(), 3);
+  for (size_t i = 0; i < faces.size(); ++i) {
+    faces_matrix.row(i) = faces[i].cast<double>();
+  }
+  map::ShotMesh mesh;
+  mesh.SetVertices(vertices_matrix);
+  mesh.SetFaces(faces_matrix);
+  return mesh;
+}
+
+MatX3d ToMatrix(const std::vector<Vec3d>& rows) {
+  MatX3d matrix(rows.size(), 3);
+  for (size_t i = 0; i < rows.size(); ++i) {
+    matrix.row(i) = rows[i];
+  }
+  return matrix;
+}
+
+map::ShotMesh ComputeShotMeshPerspective(
+    const map::Map& map, const map::TracksManager& tracks_manager,
+    const map::Shot& shot) {
+  const auto& camera = *shot.GetCamera();
+  const auto& pose = *shot.GetPose();
+  const double size = std::max(camera.width, camera.height);
+  const double dx = camera.width / 2.0 / size;
+  const double dy = camera.height / 2.0 / size;
+
+  // Image corners come first, their vertices are set afterwards
+  std::vector<Vec2d> pixels = {{-dx, -dy}, {-dx, dy}, {dx, dy}, {dx, -dy}};
+  std::vector<Vec3d> vertices(4);
+  for (const auto& observation :
+       tracks_manager.GetShotObservations(shot.GetId())) {
+    if (!map.HasLandmark(observation.first)) {
+      continue;
+    }
+    // Landmarks behind the camera would otherwise project in the image
+    const Vec3d point = map.GetLandmark(observation.first).GetGlobalPos();
+    if (!(pose.TransformWorldToCamera(point)(2) > 0.0)) {
+      continue;
+    }
+    const Vec2d pixel = shot.Project(point);
+    if (pixel.allFinite() && -dx <= pixel(0) && pixel(0) <= dx &&
+        -dy <= pixel(1) && pixel(1) <= dy) {
+      vertices.push_back(point);
+      pixels.push_back(pixel);
+    }
+  }
+
+  MatX2d pixels_matrix(pixels.size(), 2);
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    pixels_matrix.row(i) = pixels[i];
+  }
+  const auto faces = geometry::DelaunayTriangulation(pixels_matrix);
+
+  // Corners are at the mean depth of the landmarks of their triangles, and
+  // are back-projected ignoring the distortion
+  double depths[4] = {0.0, 0.0, 0.0, 0.0};
+  int counts[4] = {0, 0, 0, 0};
+  for (const auto& face : faces) {
+    for (int i = 0; i < 4; ++i) {
+      if ((face.array() != i).all()) {
+        continue;
+      }
+      for (int k = 0; k < 3; ++k) {
+        if (face(k) >= 4) {
+          depths[i] += pose.TransformWorldToCamera(vertices[face(k)])(2);
+          ++counts[i];
+        }
+      }
+    }
+  }
+  const Mat3d K_inverse = camera.GetProjectionMatrix().inverse();
+  for (int i = 0; i < 4; ++i) {
+    const double depth = counts[i] > 0 ? depths[i] / counts[i] : 50.0;
+    Vec3d point = K_inverse * pixels[i].homogeneous();
+    point *= depth / point(2);
+    vertices[i] = pose.TransformCameraToWorld(point);
+  }
+  return MakeMesh(vertices, faces);
+}
+
+map::ShotMesh ComputeShotMeshFisheye(const map::Map& map,
+                                     const map::TracksManager& tracks_manager,
+                                     const map::Shot& shot) {
+  const auto& pose = *shot.GetPose();
+  std::vector<Vec3d> vertices;
+  std::vector<Vec3d> bearings;
+
+  // Boundary vertices on a circle around the camera
+  const int num_circle_points = 20;
+  for (int i = 0; i < num_circle_points; ++i) {
+    const double angle = 2.0 * M_PI * i / num_circle_points;
+    const Vec3d bearing(std::cos(angle), std::sin(angle), 0.0);
+    vertices.push_back(pose.TransformCameraToWorld(30.0 * bearing));
+    bearings.push_back(bearing);
+  }
+
+  // A single vertex in front of the camera
+  vertices.push_back(pose.TransformCameraToWorld(Vec3d(0.0, 0.0, 30.0)));
+  bearings.emplace_back(0.0, 0.0, 0.3);
+
+  AddLandmarkBearings(map, tracks_manager, shot, vertices, bearings);
+  auto faces = geometry::ConvexHull(ToMatrix(bearings));
+
+  // Remove faces having only boundary vertices
+  faces.erase(std::remove_if(faces.begin(), faces.end(),
+                             [](const Vec3i& face) {
+                               return face.maxCoeff() < num_circle_points;
+                             }),
+              faces.end());
+  return MakeMesh(vertices, faces);
+}
+
+map::ShotMesh ComputeShotMeshSpherical(
+    const map::Map& map, const map::TracksManager& tracks_manager,
+    const map::Shot& shot) {
+  const auto& pose = *shot.GetPose();
+  std::vector<Vec3d> vertices;
+  std::vector<Vec3d> bearings;
+
+  // Vertices of a cube ensuring that the camera is inside the hull
+  for (int i = 0; i < 8; ++i) {
+    const Vec3d corner((i & 4) ? 1.0 : -1.0, (i & 2) ? 1.0 : -1.0,
+                       (i & 1) ? 1.0 : -1.0);
+    const Vec3d bearing = 0.3 * corner.normalized();
+    vertices.push_back(pose.TransformCameraToWorld(bearing));
+    bearings.push_back(bearing);
+  }
+
+  AddLandmarkBearings(map, tracks_manager, shot, vertices, bearings);
+  return MakeMesh(vertices, geometry::ConvexHull(ToMatrix(bearings)));
+}
+}  // namespace
+
+namespace map {
+
+ShotMesh ComputeShotMesh(const Map& map, const TracksManager& tracks_manager,
+                         const ShotId& shot_id) {
+  const auto& shot = map.GetShot(shot_id);
+  if (!tracks_manager.HasShotObservations(shot_id)) {
+    return ShotMesh();
+  }
+
+  const auto type = shot.GetCamera()->GetProjectionType();
+  switch (type) {
+    case geometry::ProjectionType::PERSPECTIVE:
+    case geometry::ProjectionType::BROWN:
+    case geometry::ProjectionType::RADIAL:
+    case geometry::ProjectionType::SIMPLE_RADIAL:
+      return ComputeShotMeshPerspective(map, tracks_manager, shot);
+    case geometry::ProjectionType::FISHEYE:
+    case geometry::ProjectionType::FISHEYE_OPENCV:
+    case geometry::ProjectionType::FISHEYE62:
+    case geometry::ProjectionType::FISHEYE624:
+    case geometry::ProjectionType::DUAL:
+      return ComputeShotMeshFisheye(map, tracks_manager, shot);
+    case geometry::ProjectionType::SPHERICAL:
+      return ComputeShotMeshSpherical(map, tracks_manager, shot);
+    default:
+      throw std::runtime_error(
+          "Shot mesh not implemented for projection type " +
+          geometry::Camera::GetProjectionString(type));
+  }
+}
+
+void ComputeShotMeshes(Map& map, const TracksManager& tracks_manager,
+                       int num_threads) {
+  std::vector<Shot*> shots;
+  for (auto& shot : map.GetShots()) {
+    if (tracks_manager.HasShotObservations(shot.first)) {
+      shots.push_back(&shot.second);
+    }
+  }
+
+  // Errors can't leave the parallel region, they're rethrown afterwards
+  std::vector<ShotMesh> meshes(shots.size());
+  std::exception_ptr error;
+  const int num_shots = shots.size();
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+  for (int i = 0; i < num_shots; ++i) {
+    try {
+      meshes[i] = ComputeShotMesh(map, tracks_manager, shots[i]->GetId());
+    } catch (...) {
+#pragma omp critical
+      error = std::current_exception();
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  for (size_t i = 0; i < shots.size(); ++i) {
+    shots[i]->mesh = std::move(meshes[i]);
+  }
+}
+}  // namespace map
@@ -0,0 +1,351 @@
+#include <foundation/tracing.h>
+#include <map/map.h>
+#include <map/serialization.h>
+
+#include <tuple>
+
+namespace {
+
+const std::string kMapBinaryHeader = "OPENSFM_MAP_BINARY";
+constexpr uint32_t kMapBinaryVersion = 1;
+
+void WriteValue(map::BinaryWriter& writer, double value) {
+  writer.Write(value);
+}
+void WriteValue(map::BinaryWriter& writer, int value) {
+  writer.Write<int32_t>(value);
+}
+void WriteValue(map::BinaryWriter& writer, const Vec3d& value) {
+  writer.WriteData(value);
+}
+void WriteValue(map::BinaryWriter& writer, const std::string& value) {
+  writer.WriteString(value);
+}
+
+void ReadValue(map::BinaryReader& reader, double* value) {
+  *value = reader.Read<double>();
+}
+void ReadValue(map::BinaryReader& reader, int* value) {
+  *value = reader.Read<int32_t>();
+}
+void ReadValue(map::BinaryReader& reader, Vec3d* value) {
+  reader.ReadData(*value);
+}
+void ReadValue(map::BinaryReader& reader, std::string* value) {
+  *value = reader.ReadString();
+}
+
+template <class T>
+void WriteOptional(map::BinaryWriter& writer,
+                   const foundation::OptionalValue<T>& optional) {
+  writer.Write<uint8_t>(optional.HasValue());
+  if (optional.HasValue()) {
+    WriteValue(writer, optional.Value());
+  }
+}
+
+template <class T>
+void ReadOptional(map::BinaryReader& reader,
+                  foundation::OptionalValue<T>* optional) {
+  if (reader.Read<uint8_t>()) {
+    T value;
+    ReadValue(reader, &value);
+    optional->SetValue(value);
+  }
+}
+
+void WritePose(map::BinaryWriter& writer, const geometry::Pose& pose) {
+  writer.WriteData(pose.WorldToCamera());
+}
+
+geometry::Pose ReadPose(map::BinaryReader& reader) {
+  Mat4d world_to_camera;
+  reader.ReadData(world_to_camera);
+  geometry::Pose pose;
+  pose.SetFromWorldToCamera(world_to_camera);
+  return pose;
+}
+
+void WriteShot(map::BinaryWriter& writer, const map::Shot& shot) {
+  writer.WriteString(shot.id_);
+  writer.WriteString(shot.GetCamera()->id);
+  writer.WriteString(shot.GetRigCameraId());
+  writer.WriteString(shot.GetRigInstanceId());
+  writer.Write<int64_t>(shot.merge_cc);
+  writer.Write(shot.scale);
+
+  const auto& measurements = shot.GetShotMeasurements();
+  WriteOptional(writer, measurements.capture_time_);
+  WriteOptional(writer, measurements.gps_position_);
+  WriteOptional(writer, measurements.gps_accuracy_);
+  WriteOptional(writer, measurements.compass_accuracy_);
+  WriteOptional(writer, measurements.compass_angle_);
+  WriteOptional(writer, measurements.gravity_down_);
+  WriteOptional(writer, measurements.opk_accuracy_);
+  WriteOptional(writer, measurements.opk_angles_);
+  WriteOptional(writer, measurements.orientation_);
+  WriteOptional(writer, measurements.sequence_key_);
+  writer.Write<uint32_t>(measurements.GetAttributes().size());
+  for (const auto& attribute : measurements.GetAttributes()) {
+    writer.WriteString(attribute.first);
+    writer.WriteString(attribute.second);
+  }
+
+  writer.WriteMatrix(shot.GetCovariance());
+  writer.WriteMatrix(shot.mesh.vertices_);
+  writer.WriteMatrix(shot.mesh.faces_);
+}
+
+map::Shot& ReadShot(map::BinaryReader& reader, bool is_panoshot,
+                    map::Map* map) {
+  const auto shot_id = reader.ReadString();
+  const auto camera_id = reader.ReadString();
+  const auto rig_camera_id = reader.ReadString();
+  const auto instance_id = reader.ReadString();
+
+  // Instances poses are set once all their shots are created
+  auto& shot = is_panoshot
+                   ? map->CreatePanoShot(shot_id, camera_id, rig_camera_id,
+                                         instance_id, geometry::Pose())
+                   : map->CreateShot(shot_id, camera_id, rig_camera_id,
+                                     instance_id);
+  shot.merge_cc = reader.Read<int64_t>();
+  shot.scale = reader.Read<double>();
+
+  auto& measurements = shot.GetShotMeasurements();
+  ReadOptional(reader, &measurements.capture_time_);
+  ReadOptional(reader, &measurements.gps_position_);
+  ReadOptional(reader, &measurements.gps_accuracy_);
+  ReadOptional(reader, &measurements.compass_accuracy_);
+  ReadOptional(reader, &measurements.compass_angle_);
+  ReadOptional(reader, &measurements.gravity_down_);
+  ReadOptional(reader, &measurements.opk_accuracy_);
+  ReadOptional(reader, &measurements.opk_angles_);
+  ReadOptional(reader, &measurements.orientation_);
+  ReadOptional(reader, &measurements.sequence_key_);
+  const auto num_attributes = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < num_attributes; ++i) {
+    auto key = reader.ReadString();
+    measurements.GetMutableAttributes()[key] = reader.ReadString();
+  }
+
+  const auto covariance = reader.ReadMatrix<MatXd>();
+  if (covariance.size() > 0) {
+    shot.SetCovariance(covariance);
+  }
+  shot.mesh.vertices_ = reader.ReadMatrix<MatXd>();
+  shot.mesh.faces_ = reader.ReadMatrix<MatXd>();
+  return shot;
+}
+}  // namespace
+
+namespace map {
+
+std::string Map::AsBytes() const {
+  OPENSFM_TRACE_SCOPE("map", "Map::AsBytes");
+  BinaryWriter writer;
+  writer.WriteString(kMapBinaryHeader);
+  writer.Write(kMapBinaryVersion);
+
+  writer.Write(topo_conv_.lat_);
+  writer.Write(topo_conv_.long_);
+  writer.Write(topo_conv_.alt_);
+
+  writer.Write<uint32_t>(cameras_.size());
+  for (const auto& camera : cameras_) {
+    writer.WriteString(camera.first);
+    writer.Write<int32_t>(static_cast<int>(camera.second.GetProjectionType()));
+    writer.Write<int32_t>(camera.second.width);
+    writer.Write<int32_t>(camera.second.height);
+    const auto types = camera.second.GetParametersTypes();
+    writer.Write<uint32_t>(types.size());
+    for (const auto type : types) {
+      writer.Write<int32_t>(static_cast<int>(type));
+    }
+    writer.WriteData(camera.second.GetParametersValues());
+  }
+
+  writer.Write<uint32_t>(bias_.size());
+  for (const auto& bias : bias_) {
+    writer.WriteString(bias.first);
+    writer.WriteData(bias.second.Rotation());
+    writer.WriteData(bias.second.Translation());
+    writer.Write(bias.second.Scale());
+  }
+
+  writer.Write<uint32_t>(rig_cameras_.size());
+  for (const auto& rig_camera : rig_cameras_) {
+    writer.WriteString(rig_camera.first);
+    writer.Write<int32_t>(rig_camera.second.relative_type);
+    WritePose(writer, rig_camera.second.pose);
+  }
+
+  writer.Write<uint32_t>(rig_instances_.size());
+  for (const auto& rig_instance : rig_instances_) {
+    writer.WriteString(rig_instance.first);
+    WritePose(writer, rig_instance.second.GetPose());
+  }
+
+  // Shots and landmarks are then referred to by their index
+  std::unordered_map<const Shot*, uint32_t> shot_indexes;
+  writer.Write<uint32_t>(shots_.size());
+  for (const auto& shot : shots_) {
+    shot_indexes.emplace(&shot.second, shot_indexes.size());
+    WriteShot(writer, shot.second);
+  }
+  writer.Write<uint32_t>(pano_shots_.size());
+  for (const auto& pano_shot : pano_shots_) {
+    WriteShot(writer, pano_shot.second);
+  }
+
+  std::unordered_map<const Landmark*, uint32_t> landmark_indexes;
+  writer.Write<uint32_t>(landmarks_.size());
+  for (const auto& landmark : landmarks_) {
+    landmark_indexes.emplace(&landmark.second, landmark_indexes.size());
+    writer.WriteString(landmark.first);
+    writer.WriteData(landmark.second.GetGlobalPos());
+    writer.WriteData(landmark.second.GetColor());
+
+    const auto& errors_shots = landmark.second.GetReprojectionErrorsShots();
+    const auto& errors = landmark.second.GetReprojectionErrorsValues();
+    writer.Write<uint32_t>(errors_shots.size());
+    for (size_t i = 0; i < errors_shots.size(); ++i) {
+      writer.WriteString(errors_shots[i]->id_);
+      writer.WriteMatrix(errors[i]);
+    }
+  }
+
+  uint64_t num_observations = 0;
+  for (const auto& shot : shots_) {
+    num_observations += shot.second.GetLandmarkObservations().size();
+  }
+  writer.Write(num_observations);
+  for (const auto& shot : shots_) {
+    const auto shot_index = shot_indexes.at(&shot.second);
+    for (const auto& observation : shot.second.GetLandmarkObservations()) {
+      writer.Write(shot_index);
+      writer.Write(landmark_indexes.at(observation.first));
+      writer.WriteObservation(observation.second);
+    }
+  }
+  return writer.Release();
+}
+
+std::unique_ptr<Map> Map::InstanciateFromBytes(const char* data,
+                                               size_t size) {
+  OPENSFM_TRACE_SCOPE("map", "Map::InstanciateFromBytes");
+  BinaryReader reader(data, size);
+  if (reader.ReadString() != kMapBinaryHeader ||
+      reader.Read<uint32_t>() != kMapBinaryVersion) {
+    throw std::runtime_error("Invalid binary map data");
+  }
+
+  auto map = std::make_unique<Map>();
+  const auto latitude = reader.Read<double>();
+  const auto longitude = reader.Read<double>();
+  const auto altitude = reader.Read<double>();
+  map->SetTopocentricConverter(latitude, longitude, altitude);
+
+  const auto num_cameras = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < num_cameras; ++i) {
+    const auto camera_id = reader.ReadString();
+    const auto projection_type =
+        static_cast<geometry::ProjectionType>(reader.Read<int32_t>());
+    const auto width = reader.Read<int32_t>();
+    const auto height = reader.Read<int32_t>();
+    std::vector<geometry::Camera::Parameters> types(reader.Read<uint32_t>());
+    for (auto& type : types) {
+      type = static_cast<geometry::Camera::Parameters>(reader.Read<int32_t>());
+    }
+    VecXd values(types.size());
+    reader.ReadData(values);
+
+    geometry::Camera camera(projection_type, types, values);
+    camera.width = width;
+    camera.height = height;
+    camera.id = camera_id;
+    map->CreateCamera(camera);
+  }
+
+  const auto num_biases = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < num_biases; ++i) {
+    const auto camera_id = reader.ReadString();
+    Vec3d rotation;
+    Vec3d translation;
+    reader.ReadData(rotation);
+    reader.ReadData(translation);
+    const auto scale = reader.Read<double>();
+    map->SetBias(camera_id, geometry::Similarity(rotation, translation, scale));
+  }
+
+  const auto num_rig_cameras = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < num_rig_cameras; ++i) {
+    const auto rig_camera_id = reader.ReadString();
+    const auto relative_type =
+        static_cast<RigCamera::RelativeType>(reader.Read<int32_t>());
+    auto& rig_camera =
+        map->CreateRigCamera(RigCamera(ReadPose(reader), rig_camera_id));
+    rig_camera.relative_type = relative_type;
+  }
+
+  const auto num_rig_instances = reader.Read<uint32_t>();
+  std::vector<std::pair<RigInstance*, geometry::Pose>> instances_poses;
+  instances_poses.reserve(num_rig_instances);
+  for (uint32_t i = 0; i < num_rig_instances; ++i) {
+    auto& rig_instance = map->CreateRigInstance(reader.ReadString());
+    instances_poses.emplace_back(&rig_instance, ReadPose(reader));
+  }
+
+  const auto num_shots = reader.Read<uint32_t>();
+  std::vector<Shot*> shots;
+  shots.reserve(num_shots);
+  for (uint32_t i = 0; i < num_shots; ++i) {
+    shots.push_back(&ReadShot(reader, false, map.get()));
+  }
+  const auto num_pano_shots = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < num_pano_shots; ++i) {
+    ReadShot(reader, true, map.get());
+  }
+  for (const auto& instance_pose : instances_poses) {
+    instance_pose.first->SetPose(instance_pose.second);
+  }
+
+  const auto num_landmarks = reader.Read<uint32_t>();
+  std::vector<Landmark*> landmarks;
+  landmarks.reserve(num_landmarks);
+  std::vector<std::tuple<Landmark*, Shot*, VecMax3d>> errors;
+  for (uint32_t i = 0; i < num_landmarks; ++i) {
+    const auto landmark_id = reader.ReadString();
+    Vec3d position;
+    Vec3i color;
+    reader.ReadData(position);
+    reader.ReadData(color);
+    auto& landmark = map->CreateLandmark(landmark_id, position);
+    landmark.SetColor(color);
+
+    // Errors can only be set once the observations are known
+    const auto num_errors = reader.Read<uint32_t>();
+    for (uint32_t j = 0; j < num_errors; ++j) {
+      auto& shot = map->GetShot(reader.ReadString());
+      errors.emplace_back(&landmark, &shot, reader.ReadMatrix<VecMax3d>());
+    }
+    landmarks.push_back(&landmark);
+  }
+
+  const auto num_observations = reader.Read<uint64_t>();
+  for (uint64_t i = 0; i < num_observations; ++i) {
+    const auto shot_index = reader.Read<uint32_t>();
+    const auto landmark_index = reader.Read<uint32_t>();
+    if (shot_index >= num_shots || landmark_index >= num_landmarks) {
+      throw std::runtime_error("Invalid observation in binary map data");
+    }
+    map->AddObservation(shots[shot_index], landmarks[landmark_index],
+                        reader.ReadObservation());
+  }
+  for (const auto& error : errors) {
+    std::get<0>(error)->SetReprojectionError(std::get<1>(error),
+                                             std::get<2>(error));
+  }
+  return map;
+}
+}  // namespace map
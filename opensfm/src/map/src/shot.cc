@@ -2,6 +2,8 @@
 #include <map/rig.h>
 #include <map/shot.h>
 
+#include <foundation/stl_extensions.h>
+
 #include <algorithm>
 #include <numeric>
 #include <stdexcept>
@@ -59,6 +61,7 @@ void Shot::SetRig(RigInstance* rig_instance, RigCamera* rig_camera) {
   rig_instance_ = rig_instance;
   rig_camera_ = rig_camera;
   pose_ = std::make_unique<geometry::PoseImmutable>(*pose_);
+  pose_instance_generation_ = 0;
 }
 
 const RigInstanceId& Shot::GetRigInstanceId() const {
@@ -143,40 +146,69 @@ void Shot::SetPose(const geometry::Pose& pose) {
     rig_instance_->SetPose(pose);
   }
   *pose_ = pose;
+  pose_instance_generation_ = 0;
 }
 
 geometry::Pose Shot::GetPoseInRig() const {
   // pose(shot) = pose(rig_camera)*pose(instance)
-  const auto& pose_instance = rig_instance_->GetPose();
+  const auto& pose_instance = foundation::as_const(*rig_instance_).GetPose();
   const auto& rig_camera_pose = rig_camera_->pose;
   return rig_camera_pose.Compose(pose_instance);
 }
 
-const geometry::Pose* const Shot::GetPose() const {
+void Shot::UpdatePoseInRig() const {
+  // The pose is only written when the rig moved, so that concurrent readers
+  // of an unchanged shot never see it written.
+  const auto instance_generation =
+      foundation::as_const(*rig_instance_).GetPose().Generation();
+  const auto rig_camera_generation = rig_camera_->pose.Generation();
+  if (pose_instance_generation_.load(std::memory_order_acquire) ==
+          instance_generation &&
+      pose_rig_camera_generation_.load(std::memory_order_acquire) ==
+          rig_camera_generation) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(pose_mutex_);
+  if (pose_instance_generation_.load(std::memory_order_relaxed) ==
+          instance_generation &&
+      pose_rig_camera_generation_.load(std::memory_order_relaxed) ==
+          rig_camera_generation) {
+    return;
+  }
   *pose_ = GetPoseInRig();
+  pose_rig_camera_generation_.store(rig_camera_generation,
+                                    std::memory_order_release);
+  pose_instance_generation_.store(instance_generation,
+                                  std::memory_order_release);
+}
+
+const geometry::Pose* const Shot::GetPose() const {
   if (IsSingleShotRig(rig_instance_, rig_camera_)) {
-    return &rig_instance_->GetPose();
+    return &foundation::as_const(*rig_instance_).GetPose();
   }
+  UpdatePoseInRig();
   return pose_.get();
 }
 
 geometry::Pose* const Shot::GetPose() {
-  *pose_ = GetPoseInRig();
   if (IsSingleShotRig(rig_instance_, rig_camera_)) {
     return &rig_instance_->GetPose();
   }
+  UpdatePoseInRig();
   return pose_.get();
 }
 
 Vec2d Shot::Project(const Vec3d& global_pos) const {
-  return shot_camera_->Project(GetPose()->RotationWorldToCamera() * global_pos +
-                               GetPose()->TranslationWorldToCamera());
+  return shot_camera_->Project(GetPose()->TransformWorldToCamera(global_pos));
 }
 
 MatX2d Shot::ProjectMany(const MatX3d& points) const {
+  const auto* const pose = GetPose();
   MatX2d projected(points.rows(), 2);
   for (int i = 0; i < points.rows(); ++i) {
-    projected.row(i) = Project(points.row(i));
+    projected.row(i) =
+        shot_camera_->Project(pose->TransformWorldToCamera(points.row(i)));
   }
   return projected;
 }
@@ -186,10 +218,40 @@ Vec3d Shot::Bearing(const Vec2d& point) const {
 }
 
 MatX3d Shot::BearingMany(const MatX2d& points) const {
+  const Mat3d rotation = GetPose()->RotationCameraToWorld();
   MatX3d bearings(points.rows(), 3);
   for (int i = 0; i < points.rows(); ++i) {
-    bearings.row(i) = Bearing(points.row(i));
+    bearings.row(i) = rotation * shot_camera_->Bearing(points.row(i));
   }
   return bearings;
 }
+
+foundation::MemoryUsage Shot::MemoryUsage() const {
+  namespace memory = foundation::memory;
+  foundation::MemoryUsage usage;
+  usage["ids"] = memory::HeapBytes(id_);
+  usage["observations"] = memory::ElementsBytes(landmark_observations_) +
+                          memory::IndexBytes(landmark_observations_) +
+                          memory::ElementsBytes(landmark_id_) +
+                          memory::IndexBytes(landmark_id_);
+  usage["poses"] = sizeof(geometry::Pose) + memory::kAllocationOverhead;
+  if (covariance_.HasValue()) {
+    usage["poses"] += memory::HeapBytes(covariance_.Value());
+  }
+  usage["meshes"] =
+      memory::HeapBytes(mesh.vertices_) + memory::HeapBytes(mesh.faces_);
+
+  const auto& attributes = shot_measurements_.attributes_;
+  usage["metadata"] =
+      memory::ElementsBytes(attributes) + memory::IndexBytes(attributes);
+  for (const auto& attribute : attributes) {
+    usage["metadata"] += memory::HeapBytes(attribute.first) +
+                         memory::HeapBytes(attribute.second);
+  }
+  if (shot_measurements_.sequence_key_.HasValue()) {
+    usage["metadata"] +=
+        memory::HeapBytes(shot_measurements_.sequence_key_.Value());
+  }
+  return usage;
+}
 }  // namespace map
@@ -1,184 +1,295 @@
+#include <foundation/tracing.h>
 #include <foundation/union_find.h>
+#include <map/serialization.h>
 #include <map/tracks_manager.h>
-
+#include <map/tracks_manager_view.h>
+
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <optional>
 #include <sstream>
+#include <string_view>
 #include <unordered_set>
 
 namespace {
 
-template <class S>
-int GetTracksFileVersion(S& fstream) {
-  const auto current_position = fstream.tellg();
+/* Text codec of the tracks files. Each line is an observation, made of tab
+ * separated fields : shot, track, feature, x, y, scale (from v1), r, g, b,
+ * segmentation and instance (from v2). Reading splits the text in chunks of
+ * whole lines parsed in parallel, and writing formats the shots in parallel
+ * in the same way as an std::ostream does, to keep files byte-compatible.
+ * Floating-point std::from_chars/to_chars need GCC 11, so doubles go through
+ * strtod and snprintf. */
+constexpr size_t kTracksChunkSize = 1 << 20;
+constexpr size_t kMaxNumberSize = 64;
+
+struct ParsedObservation {
+  std::string_view shot_id;
+  std::string_view track_id;
+  map::Observation observation;
+};
+
+class TracksLineParser {
+ public:
+  TracksLineParser(const char* begin, const char* end)
+      : line_(begin), current_(begin), end_(end) {}
+
+  std::string_view String() {
+    const char* field_end = FieldEnd();
+    const std::string_view field(current_, field_end - current_);
+    Next(field_end);
+    return field;
+  }
 
-  std::string line;
-  std::getline(fstream, line);
+  int Integer() {
+    const char* field_end = FieldEnd();
+    int value;
+    const auto result = std::from_chars(current_, field_end, value);
+    if (result.ec != std::errc() || result.ptr != field_end) {
+      throw std::runtime_error("Invalid number in tracks line: " + Line());
+    }
+    Next(field_end);
+    return value;
+  }
 
-  int version = 0;
-  if (line.find(map::TracksManager::TRACKS_HEADER) == 0) {
-    version = std::atoi(
-        line.substr(map::TracksManager::TRACKS_HEADER.length() + 2).c_str());
-  } else {
-    fstream.seekg(current_position);
+  double Double() {
+    const char* field_end = FieldEnd();
+    // strtod needs a null-terminated string, and would skip leading spaces
+    const size_t size = field_end - current_;
+    if (size == 0 || size >= kMaxNumberSize ||
+        std::isspace(static_cast<unsigned char>(*current_))) {
+      throw std::runtime_error("Invalid number in tracks line: " + Line());
+    }
+    char chars[kMaxNumberSize];
+    std::memcpy(chars, current_, size);
+    chars[size] = '\0';
+    char* number_end = nullptr;
+    const double value = std::strtod(chars, &number_end);
+    if (number_end != chars + size) {
+      throw std::runtime_error("Invalid number in tracks line: " + Line());
+    }
+    Next(field_end);
+    return value;
   }
-  return version;
-}
 
-template <class S>
-void WriteToStreamCurrentVersion(S& ostream,
-                                 const map::TracksManager& manager) {
-  ostream << manager.TRACKS_HEADER << "_v" << manager.TRACKS_VERSION
-          << std::endl;
-  const auto shotsIDs = manager.GetShotIds();
-  for (const auto& shotID : shotsIDs) {
-    const auto observations = manager.GetShotObservations(shotID);
-    for (const auto& observation : observations) {
-      ostream << shotID << "\t" << observation.first << "\t"
-              << observation.second.feature_id << "\t"
-              << observation.second.point(0) << "\t"
-              << observation.second.point(1) << "\t" << observation.second.scale
-              << "\t" << observation.second.color(0) << "\t"
-              << observation.second.color(1) << "\t"
-              << observation.second.color(2) << "\t"
-              << observation.second.segmentation_id << "\t"
-              << observation.second.instance_id << std::endl;
+  bool AtEnd() const { return current_ == nullptr; }
+  std::string Line() const { return std::string(line_, end_); }
+
+ private:
+  const char* FieldEnd() const {
+    if (AtEnd()) {
+      throw std::runtime_error("Missing values in tracks line: " + Line());
     }
+    const char* tab =
+        static_cast<const char*>(std::memchr(current_, '\t', end_ - current_));
+    return tab ? tab : end_;
   }
-}
 
-map::Observation InstanciateObservation(
-    double x, double y, double scale, int id, int r, int g, int b,
-    int segm = map::Observation::NO_SEMANTIC_VALUE,
-    int inst = map::Observation::NO_SEMANTIC_VALUE) {
-  map::Observation observation;
-  observation.point << x, y;
-  observation.scale = scale;
-  observation.feature_id = id;
-  observation.color << r, g, b;
-  observation.segmentation_id = segm;
-  observation.instance_id = inst;
-  return observation;
-}
+  void Next(const char* field_end) {
+    current_ = field_end == end_ ? nullptr : field_end + 1;
+  }
 
-void SeparateLineByTabs(const std::string& line,
-                        std::vector<std::string>& elems) {
-  elems.clear();
-  std::stringstream stst(line);
-  std::string elem;
-  while (std::getline(stst, elem, '\t'))  // separate by tabs
-  {
-    elems.push_back(elem);
+  const char* line_;
+  const char* current_;
+  const char* end_;
+};
+
+// Parse the lines between 'begin' and 'end', which are line boundaries
+std::vector<ParsedObservation> ParseTracksChunk(const char* begin,
+                                                const char* end,
+                                                int version) {
+  std::vector<ParsedObservation> parsed;
+  while (begin < end) {
+    const char* newline =
+        static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    const char* line_end = newline ? newline : end;
+    const char* next = newline ? newline + 1 : end;
+    if (line_end > begin && line_end[-1] == '\r') {
+      --line_end;
+    }
+    if (line_end == begin) {
+      begin = next;
+      continue;
+    }
+
+    TracksLineParser line(begin, line_end);
+    ParsedObservation entry;
+    auto& observation = entry.observation;
+    entry.shot_id = line.String();
+    entry.track_id = line.String();
+    observation.feature_id = line.Integer();
+    observation.point(0) = line.Double();
+    observation.point(1) = line.Double();
+    observation.scale = version >= 1 ? line.Double() : 0.0;
+    observation.color(0) = line.Integer();
+    observation.color(1) = line.Integer();
+    observation.color(2) = line.Integer();
+    if (version >= 2) {
+      observation.segmentation_id = line.Integer();
+      observation.instance_id = line.Integer();
+    } else {
+      observation.segmentation_id = map::Observation::NO_SEMANTIC_VALUE;
+      observation.instance_id = map::Observation::NO_SEMANTIC_VALUE;
+    }
+    if (!line.AtEnd()) {
+      throw std::runtime_error("Too many values in tracks line: " +
+                               line.Line());
+    }
+    parsed.push_back(entry);
+    begin = next;
   }
+  return parsed;
 }
 
-template <class S>
-map::TracksManager InstanciateFromStreamV0(S& fstream) {
-  map::TracksManager manager;
-  std::string line;
-  std::vector<std::string> elems;
-  constexpr auto N_ENTRIES{8};
-  elems.reserve(N_ENTRIES);
-  while (std::getline(fstream, line)) {
-    SeparateLineByTabs(line, elems);
-    if (elems.size() != N_ENTRIES)  // process only valid lines
-    {
-      std::runtime_error(
-          "Encountered invalid line. A line must contain exactly " +
-          std::to_string(N_ENTRIES) + " values!");
+map::TracksManager ParseTracks(std::string_view text, int num_threads) {
+  // Files without header are v0
+  int version = 0;
+  const auto& header = map::TracksManager::TRACKS_HEADER;
+  if (text.substr(0, header.size()) == header) {
+    const auto line_end = text.find('\n');
+    version = std::atoi(std::string(text.substr(0, line_end))
+                            .substr(header.size() + 2)
+                            .c_str());
+    text.remove_prefix(line_end == std::string_view::npos ? text.size()
+                                                          : line_end + 1);
+  }
+  if (version < 0 || version > 2) {
+    throw std::runtime_error("Unknown tracks manager file version");
+  }
+
+  // Chunks end after the first line end past their nominal size
+  std::vector<std::pair<const char*, const char*>> chunks;
+  const char* end = text.data() + text.size();
+  for (const char* begin = text.data(); begin < end;) {
+    const char* chunk_end = begin + std::min(kTracksChunkSize,
+                                             static_cast<size_t>(end - begin));
+    const char* newline = static_cast<const char*>(
+        std::memchr(chunk_end, '\n', end - chunk_end));
+    chunk_end = newline ? newline + 1 : end;
+    chunks.emplace_back(begin, chunk_end);
+    begin = chunk_end;
+  }
+
+  std::vector<std::vector<ParsedObservation>> parsed(chunks.size());
+  std::exception_ptr error;
+  const int num_chunks = chunks.size();
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+  for (int i = 0; i < num_chunks; ++i) {
+    try {
+      parsed[i] = ParseTracksChunk(chunks[i].first, chunks[i].second, version);
+    } catch (...) {
+#pragma omp critical
+      error = std::current_exception();
     }
-    const map::ShotId image = elems[0];
-    const map::TrackId trackID = elems[1];
-    const int featureID = std::stoi(elems[2]);
-    const double x = std::stod(elems[3]);
-    const double y = std::stod(elems[4]);
-    const double scale = 0.0;
-    const int r = std::stoi(elems[5]);
-    const int g = std::stoi(elems[6]);
-    const int b = std::stoi(elems[7]);
-    auto observation = InstanciateObservation(x, y, scale, featureID, r, g, b);
-    manager.AddObservation(image, trackID, observation);
   }
-  return manager;
-}
+  if (error) {
+    std::rethrow_exception(error);
+  }
 
-template <class S>
-map::TracksManager InstanciateFromStreamV1(S& fstream) {
   map::TracksManager manager;
-  std::string line;
-  std::vector<std::string> elems;
-  constexpr auto N_ENTRIES{9};
-  elems.reserve(N_ENTRIES);
-  while (std::getline(fstream, line)) {
-    SeparateLineByTabs(line, elems);
-    if (elems.size() != N_ENTRIES)  // process only valid lines
-    {
-      std::runtime_error(
-          "Encountered invalid line. A line must contain exactly " +
-          std::to_string(N_ENTRIES) + " values!");
+  std::string shot_id, track_id;
+  for (const auto& chunk : parsed) {
+    for (const auto& entry : chunk) {
+      shot_id.assign(entry.shot_id);
+      track_id.assign(entry.track_id);
+      manager.AddObservation(shot_id, track_id, entry.observation);
     }
-    const map::ShotId image = elems[0];
-    const map::TrackId trackID = elems[1];
-    const int featureID = std::stoi(elems[2]);
-    const double x = std::stod(elems[3]);
-    const double y = std::stod(elems[4]);
-    const double scale = std::stod(elems[5]);
-    const int r = std::stoi(elems[6]);
-    const int g = std::stoi(elems[7]);
-    const int b = std::stoi(elems[8]);
-    auto observation = InstanciateObservation(x, y, scale, featureID, r, g, b);
-    manager.AddObservation(image, trackID, observation);
   }
   return manager;
 }
 
-template <class S>
-map::TracksManager InstanciateFromStreamV2(S& fstream) {
-  map::TracksManager manager;
-  std::string line;
-  std::vector<std::string> elems;
-  constexpr auto N_ENTRIES{11};
-  elems.reserve(N_ENTRIES);
-  while (std::getline(fstream, line)) {
-    SeparateLineByTabs(line, elems);
-    if (elems.size() != N_ENTRIES)  // process only valid lines
-    {
-      std::runtime_error(
-          "Encountered invalid line. A line must contain exactly " +
-          std::to_string(N_ENTRIES) + " values!");
+void AppendNumber(int value, std::string* buffer) {
+  char chars[kMaxNumberSize];
+  const auto result = std::to_chars(chars, chars + sizeof(chars), value);
+  buffer->append(chars, result.ptr);
+}
+
+void AppendNumber(double value, std::string* buffer) {
+  // Same as the default std::ostream formatting
+  char chars[kMaxNumberSize];
+  const int size = std::snprintf(chars, sizeof(chars), "%g", value);
+  buffer->append(chars, size);
+}
+
+// Lines of each shot, in the order of the shots of 'shot_ids', of a
+// TracksManager or a TracksManagerView
+template <class Manager>
+std::vector<std::string> FormatTracks(const Manager& manager,
+                                      const std::vector<map::ShotId>& shot_ids,
+                                      int num_threads) {
+  const int num_shots = shot_ids.size();
+  std::vector<std::string> buffers(num_shots);
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+  for (int i = 0; i < num_shots; ++i) {
+    const auto& shot_id = shot_ids[i];
+    const auto& observations = manager.GetShotObservations(shot_id);
+    auto& buffer = buffers[i];
+    buffer.reserve(observations.size() * (shot_id.size() + 64));
+    for (const auto& track_observation : observations) {
+      const auto& observation = track_observation.second;
+      buffer.append(shot_id);
+      buffer.push_back('\t');
+      buffer.append(track_observation.first);
+      buffer.push_back('\t');
+      AppendNumber(observation.feature_id, &buffer);
+      buffer.push_back('\t');
+      AppendNumber(observation.point(0), &buffer);
+      buffer.push_back('\t');
+      AppendNumber(observation.point(1), &buffer);
+      buffer.push_back('\t');
+      AppendNumber(observation.scale, &buffer);
+      for (int c = 0; c < 3; ++c) {
+        buffer.push_back('\t');
+        AppendNumber(observation.color(c), &buffer);
+      }
+      buffer.push_back('\t');
+      AppendNumber(observation.segmentation_id, &buffer);
+      buffer.push_back('\t');
+      AppendNumber(observation.instance_id, &buffer);
+      buffer.push_back('\n');
     }
-    const map::ShotId image = elems[0];
-    const map::TrackId trackID = elems[1];
-    const int featureID = std::stoi(elems[2]);
-    const double x = std::stod(elems[3]);
-    const double y = std::stod(elems[4]);
-    const double scale = std::stod(elems[5]);
-    const int r = std::stoi(elems[6]);
-    const int g = std::stoi(elems[7]);
-    const int b = std::stoi(elems[8]);
-    const int segm = std::stoi(elems[9]);
-    const int inst = std::stoi(elems[10]);
-    auto observation =
-        InstanciateObservation(x, y, scale, featureID, r, g, b, segm, inst);
-    manager.AddObservation(image, trackID, observation);
   }
-  return manager;
+  return buffers;
 }
 
-template <class S>
-map::TracksManager InstanciateFromStreamT(S& fstream) {
-  const auto version = GetTracksFileVersion(fstream);
-  switch (version) {
-    case 0:
-      return InstanciateFromStreamV0(fstream);
-    case 1:
-      return InstanciateFromStreamV1(fstream);
-    case 2:
-      return InstanciateFromStreamV2(fstream);
-    default:
-      throw std::runtime_error("Unknown tracks manager file version");
+std::string TracksHeaderLine() {
+  return map::TracksManager::TRACKS_HEADER + "_v" +
+         std::to_string(map::TracksManager::TRACKS_VERSION) + "\n";
+}
+
+template <class Manager>
+void WriteTracksToFile(const Manager& manager, const std::string& filename,
+                       int num_threads) {
+  std::ofstream ostream(filename, std::ios::binary);
+  if (!ostream.is_open()) {
+    throw std::runtime_error("Can't write tracks manager file");
+  }
+  ostream << TracksHeaderLine();
+  for (const auto& buffer :
+       FormatTracks(manager, manager.GetShotIds(), num_threads)) {
+    ostream.write(buffer.data(), buffer.size());
   }
 }
 
+template <class Manager>
+std::string TracksAsString(const Manager& manager, int num_threads) {
+  const auto buffers =
+      FormatTracks(manager, manager.GetShotIds(), num_threads);
+  std::string str = TracksHeaderLine();
+  size_t size = str.size();
+  for (const auto& buffer : buffers) {
+    size += buffer.size();
+  }
+  str.reserve(size);
+  for (const auto& buffer : buffers) {
+    str.append(buffer);
+  }
+  return str;
+}
 }  // namespace
 
 namespace map {
@@ -263,26 +374,8 @@ TracksManager::GetTrackObservations(const TrackId& track) const {
 TracksManager TracksManager::ConstructSubTracksManager(
     const std::vector<TrackId>& tracks,
     const std::vector<ShotId>& shots) const {
-  std::unordered_set<TrackId> shotsTmp;
-  for (const auto& id : shots) {
-    shotsTmp.insert(id);
-  }
-
-  TracksManager subset;
-  for (const auto& track_id : tracks) {
-    const auto find_track = shots_per_track_.find(track_id);
-    if (find_track == shots_per_track_.end()) {
-      continue;
-    }
-    for (const auto& obs : find_track->second) {
-      const auto& shot_id = obs.first;
-      if (shotsTmp.find(shot_id) == shotsTmp.end()) {
-        continue;
-      }
-      subset.AddObservation(shot_id, track_id, obs.second);
-    }
-  }
-  return subset;
+  OPENSFM_TRACE_SCOPE("map", "TracksManager::ConstructSubTracksManager");
+  return TracksManagerView(*this, tracks, shots).Materialize();
 }
 
 std::vector<TracksManager::KeyPointTuple>
@@ -309,6 +402,7 @@ std::unordered_map<TracksManager::ShotPair, int, HashPair>
 TracksManager::GetAllPairsConnectivity(
     const std::vector<ShotId>& shots,
     const std::vector<TrackId>& tracks) const {
+  OPENSFM_TRACE_SCOPE("map", "TracksManager::GetAllPairsConnectivity");
   std::unordered_map<ShotPair, int, HashPair> common_per_pair;
 
   std::vector<TrackId> tracks_to_use;
@@ -355,6 +449,7 @@ TracksManager::GetAllPairsConnectivity(
 
 TracksManager TracksManager::MergeTracksManager(
     const std::vector<const TracksManager*>& tracks_managers) {
+  OPENSFM_TRACE_SCOPE("map", "TracksManager::MergeTracksManager");
   // Some typedefs claryfying the aggregations
   using FeatureId_2 = std::pair<ShotId, int>;
   using SingleTrackId = std::pair<TrackId, int>;
@@ -419,35 +514,169 @@ TracksManager TracksManager::MergeTracksManager(
   return merged;
 }
 
-TracksManager TracksManager::InstanciateFromFile(const std::string& filename) {
-  std::ifstream istream(filename);
-  if (istream.is_open()) {
-    return InstanciateFromStreamT(istream);
-  } else {
+TracksManager TracksManager::InstanciateFromFile(const std::string& filename,
+                                                int num_threads) {
+  OPENSFM_TRACE_SCOPE("map", "TracksManager::InstanciateFromFile");
+  std::ifstream istream(filename, std::ios::binary);
+  if (!istream.is_open()) {
     throw std::runtime_error("Can't read tracks manager file");
   }
+  istream.seekg(0, std::ios::end);
+  std::string content(static_cast<size_t>(istream.tellg()), '\0');
+  istream.seekg(0, std::ios::beg);
+  istream.read(&content[0], content.size());
+  return ParseTracks(content, num_threads);
 }
 
-void TracksManager::WriteToFile(const std::string& filename) const {
-  std::ofstream ostream(filename);
-  if (ostream.is_open()) {
-    WriteToStreamCurrentVersion(ostream, *this);
-  } else {
-    throw std::runtime_error("Can't write tracks manager file");
-  }
+void TracksManager::WriteToFile(const std::string& filename,
+                               int num_threads) const {
+  OPENSFM_TRACE_SCOPE("map", "TracksManager::WriteToFile");
+  WriteTracksToFile(*this, filename, num_threads);
 }
 
-TracksManager TracksManager::InstanciateFromString(const std::string& str) {
-  std::stringstream sstream(str);
-  return InstanciateFromStreamT(sstream);
+void TracksManagerView::WriteToFile(const std::string& filename,
+                                    int num_threads) const {
+  OPENSFM_TRACE_SCOPE("map", "TracksManagerView::WriteToFile");
+  WriteTracksToFile(*this, filename, num_threads);
 }
 
-std::string TracksManager::AsString() const {
-  std::stringstream sstream;
-  WriteToStreamCurrentVersion(sstream, *this);
-  return sstream.str();
+TracksManager TracksManager::InstanciateFromString(const std::string& str,
+                                                  int num_threads) {
+  OPENSFM_TRACE_SCOPE("map", "TracksManager::InstanciateFromString");
+  return ParseTracks(str, num_threads);
+}
+
+std::string TracksManager::AsString(int num_threads) const {
+  OPENSFM_TRACE_SCOPE("map", "TracksManager::AsString");
+  return TracksAsString(*this, num_threads);
+}
+
+std::string TracksManagerView::AsString(int num_threads) const {
+  OPENSFM_TRACE_SCOPE("map", "TracksManagerView::AsString");
+  return TracksAsString(*this, num_threads);
+}
+
+TracksManager TracksManager::InstanciateFromBytes(const char* data,
+                                                 size_t size) {
+  OPENSFM_TRACE_SCOPE("map", "TracksManager::InstanciateFromBytes");
+  BinaryReader reader(data, size);
+  if (reader.ReadString() != TRACKS_BINARY_HEADER ||
+      reader.Read<uint32_t>() != static_cast<uint32_t>(TRACKS_BINARY_VERSION)) {
+    throw std::runtime_error("Invalid binary tracks data");
+  }
+
+  // Shots and tracks are then referred to by their index
+  TracksManager manager;
+  const auto num_shots = reader.Read<uint32_t>();
+  std::vector<decltype(manager.tracks_per_shot_)::iterator> shots;
+  std::vector<uint32_t> shots_sizes;
+  shots.reserve(num_shots);
+  shots_sizes.reserve(num_shots);
+  manager.tracks_per_shot_.reserve(num_shots);
+  for (uint32_t i = 0; i < num_shots; ++i) {
+    shots.push_back(
+        manager.tracks_per_shot_.emplace(reader.ReadString(), 0).first);
+    shots_sizes.push_back(reader.Read<uint32_t>());
+    shots.back()->second.reserve(shots_sizes.back());
+  }
+
+  const auto num_tracks = reader.Read<uint32_t>();
+  std::vector<decltype(manager.shots_per_track_)::iterator> tracks;
+  tracks.reserve(num_tracks);
+  manager.shots_per_track_.reserve(num_tracks);
+  for (uint32_t i = 0; i < num_tracks; ++i) {
+    tracks.push_back(
+        manager.shots_per_track_.emplace(reader.ReadString(), 0).first);
+    tracks.back()->second.reserve(reader.Read<uint32_t>());
+  }
+
+  for (uint32_t i = 0; i < num_shots; ++i) {
+    auto& shot = *shots[i];
+    for (uint32_t j = 0; j < shots_sizes[i]; ++j) {
+      const auto track_index = reader.Read<uint32_t>();
+      if (track_index >= num_tracks) {
+        throw std::runtime_error("Invalid track index in binary tracks data");
+      }
+      auto& track = *tracks[track_index];
+      const auto observation = reader.ReadObservation();
+      shot.second.emplace(track.first, observation);
+      track.second.emplace(shot.first, observation);
+    }
+  }
+  return manager;
+}
+
+std::string TracksManager::AsBytes() const {
+  OPENSFM_TRACE_SCOPE("map", "TracksManager::AsBytes");
+  std::unordered_map<TrackId, uint32_t> track_indexes;
+  track_indexes.reserve(shots_per_track_.size());
+  size_t num_observations = 0;
+  for (const auto& track : shots_per_track_) {
+    track_indexes.emplace(track.first, track_indexes.size());
+    num_observations += track.second.size();
+  }
+
+  // Observations take at most 64 bytes, and ids are usually short
+  constexpr size_t kObservationBytes = 64;
+  constexpr size_t kIdBytes = 32;
+  BinaryWriter writer;
+  writer.Reserve(num_observations * kObservationBytes +
+                 (tracks_per_shot_.size() + shots_per_track_.size()) *
+                     kIdBytes);
+  writer.WriteString(TRACKS_BINARY_HEADER);
+  writer.Write<uint32_t>(TRACKS_BINARY_VERSION);
+
+  writer.Write<uint32_t>(tracks_per_shot_.size());
+  for (const auto& shot : tracks_per_shot_) {
+    writer.WriteString(shot.first);
+    writer.Write<uint32_t>(shot.second.size());
+  }
+  writer.Write<uint32_t>(shots_per_track_.size());
+  for (const auto& track : shots_per_track_) {
+    writer.WriteString(track.first);
+    writer.Write<uint32_t>(track.second.size());
+  }
+
+  for (const auto& shot : tracks_per_shot_) {
+    for (const auto& observation : shot.second) {
+      writer.Write<uint32_t>(track_indexes.at(observation.first));
+      writer.WriteObservation(observation.second);
+    }
+  }
+  return writer.Release();
 }
 
 std::string TracksManager::TRACKS_HEADER = "OPENSFM_TRACKS_VERSION";
 int TracksManager::TRACKS_VERSION = 2;
+std::string TracksManager::TRACKS_BINARY_HEADER = "OPENSFM_TRACKS_BINARY";
+int TracksManager::TRACKS_BINARY_VERSION = 1;
+
+foundation::MemoryUsage TracksManager::MemoryUsage() const {
+  namespace memory = foundation::memory;
+  foundation::MemoryUsage usage;
+  usage["ids"] =
+      memory::KeysBytes(tracks_per_shot_) + memory::KeysBytes(shots_per_track_);
+  usage["indices"] = memory::IndexBytes(tracks_per_shot_) +
+                     memory::IndexBytes(shots_per_track_) +
+                     memory::ElementsBytes(tracks_per_shot_) +
+                     memory::ElementsBytes(shots_per_track_);
+  usage["observations"] = 0;
+
+  // Each observation is stored twice : once per shot and once per track
+  for (const auto& shot_tracks : tracks_per_shot_) {
+    const auto& observations = shot_tracks.second;
+    usage["ids"] += memory::KeysBytes(observations);
+    usage["indices"] += memory::IndexBytes(observations);
+    usage["observations"] += memory::ElementsBytes(observations);
+  }
+  for (const auto& track_shots : shots_per_track_) {
+    const auto& observations = track_shots.second;
+    usage["ids"] += memory::KeysBytes(observations);
+    usage["indices"] += memory::IndexBytes(observations);
+    usage["observations"] += memory::ElementsBytes(observations);
+  }
+
+  memory::UpdateTotal(&usage);
+  return usage;
+}
 }  // namespace map
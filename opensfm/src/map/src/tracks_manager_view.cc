@@ -0,0 +1,213 @@
+#include <foundation/tracing.h>
+#include <map/tracks_manager_view.h>
+
+#include <stdexcept>
+#include <unordered_set>
+
+namespace map {
+
+const Observation& FilteredObservations::at(const std::string& key) const {
+  const auto find = entries_.find(key);
+  if (find == entries_.end() || !filter_.count(key)) {
+    throw std::out_of_range("Accessing invalid ID " + key);
+  }
+  return find->second;
+}
+
+TracksManagerView::TracksManagerView(const TracksManager& parent,
+                                     const std::vector<TrackId>& tracks,
+                                     const std::vector<ShotId>& shots) {
+  OPENSFM_TRACE_SCOPE("map", "TracksManagerView::TracksManagerView");
+  const std::unordered_set<std::string_view> selected_shots(shots.begin(),
+                                                            shots.end());
+  for (const auto& track_id : tracks) {
+    const auto find_track = parent.shots_per_track_.find(track_id);
+    if (find_track == parent.shots_per_track_.end() ||
+        tracks_.count(find_track->first)) {
+      continue;
+    }
+    bool has_observations = false;
+    for (const auto& obs : find_track->second) {
+      const auto& shot_id = obs.first;
+      if (!selected_shots.count(shot_id)) {
+        continue;
+      }
+      has_observations = true;
+      if (!shots_.count(shot_id)) {
+        const auto find_shot = parent.tracks_per_shot_.find(shot_id);
+        shots_.emplace(find_shot->first, &find_shot->second);
+      }
+    }
+    if (has_observations) {
+      tracks_.emplace(find_track->first, &find_track->second);
+    }
+  }
+}
+
+TracksManagerView::TracksManagerView(const TracksManager& parent,
+                                     const std::vector<ShotId>& shots) {
+  OPENSFM_TRACE_SCOPE("map", "TracksManagerView::TracksManagerView");
+  for (const auto& shot_id : shots) {
+    const auto find_shot = parent.tracks_per_shot_.find(shot_id);
+    if (find_shot == parent.tracks_per_shot_.end() ||
+        find_shot->second.empty()) {
+      continue;
+    }
+    shots_.emplace(find_shot->first, &find_shot->second);
+    for (const auto& obs : find_shot->second) {
+      if (!tracks_.count(obs.first)) {
+        const auto find_track = parent.shots_per_track_.find(obs.first);
+        tracks_.emplace(find_track->first, &find_track->second);
+      }
+    }
+  }
+}
+
+int TracksManagerView::NumShots() const { return shots_.size(); }
+
+int TracksManagerView::NumTracks() const { return tracks_.size(); }
+
+std::vector<ShotId> TracksManagerView::GetShotIds() const {
+  std::vector<ShotId> shots;
+  shots.reserve(shots_.size());
+  for (const auto& it : shots_) {
+    shots.emplace_back(it.first);
+  }
+  return shots;
+}
+
+std::vector<TrackId> TracksManagerView::GetTrackIds() const {
+  std::vector<TrackId> tracks;
+  tracks.reserve(tracks_.size());
+  for (const auto& it : tracks_) {
+    tracks.emplace_back(it.first);
+  }
+  return tracks;
+}
+
+bool TracksManagerView::HasShotObservations(const ShotId& shot) const {
+  return shots_.count(shot) > 0;
+}
+
+bool TracksManagerView::HasTrackObservations(const TrackId& track) const {
+  return tracks_.count(track) > 0;
+}
+
+const TracksManagerView::ShotObservations& TracksManagerView::FindShot(
+    const ShotId& shot) const {
+  const auto find_shot = shots_.find(shot);
+  if (find_shot == shots_.end()) {
+    throw std::runtime_error("Accessing invalid shot ID");
+  }
+  return *find_shot->second;
+}
+
+const TracksManagerView::TrackObservations& TracksManagerView::FindTrack(
+    const TrackId& track) const {
+  const auto find_track = tracks_.find(track);
+  if (find_track == tracks_.end()) {
+    throw std::runtime_error("Accessing invalid track ID");
+  }
+  return *find_track->second;
+}
+
+Observation TracksManagerView::GetObservation(const ShotId& shot,
+                                              const TrackId& track) const {
+  const auto observations = GetShotObservations(shot);
+  if (!observations.count(track)) {
+    throw std::runtime_error("Accessing invalid track ID");
+  }
+  return observations.at(track);
+}
+
+FilteredObservations TracksManagerView::GetShotObservations(
+    const ShotId& shot) const {
+  return FilteredObservations(FindShot(shot), tracks_);
+}
+
+FilteredObservations TracksManagerView::GetTrackObservations(
+    const TrackId& track) const {
+  return FilteredObservations(FindTrack(track), shots_);
+}
+
+std::vector<TracksManager::KeyPointTuple>
+TracksManagerView::GetAllCommonObservations(const ShotId& shot1,
+                                            const ShotId& shot2) const {
+  const auto& observations1 = FindShot(shot1);
+  const auto& observations2 = FindShot(shot2);
+
+  std::vector<TracksManager::KeyPointTuple> tuples;
+  for (const auto& p : observations1) {
+    const auto find = observations2.find(p.first);
+    if (find != observations2.end() && tracks_.count(p.first)) {
+      tuples.emplace_back(p.first, p.second, find->second);
+    }
+  }
+  return tuples;
+}
+
+std::unordered_map<TracksManager::ShotPair, int, HashPair>
+TracksManagerView::GetAllPairsConnectivity(
+    const std::vector<ShotId>& shots,
+    const std::vector<TrackId>& tracks) const {
+  OPENSFM_TRACE_SCOPE("map", "TracksManagerView::GetAllPairsConnectivity");
+  std::unordered_map<TracksManager::ShotPair, int, HashPair> common_per_pair;
+
+  std::vector<const TrackObservations*> tracks_to_use;
+  if (tracks.empty()) {
+    for (const auto& track : tracks_) {
+      tracks_to_use.push_back(track.second);
+    }
+  } else {
+    for (const auto& track_id : tracks) {
+      const auto find_track = tracks_.find(track_id);
+      if (find_track != tracks_.end()) {
+        tracks_to_use.push_back(find_track->second);
+      }
+    }
+  }
+
+  std::unordered_set<std::string_view> shots_to_use;
+  if (shots.empty()) {
+    for (const auto& shot : shots_) {
+      shots_to_use.insert(shot.first);
+    }
+  } else {
+    for (const auto& shot : shots) {
+      if (shots_.count(shot)) {
+        shots_to_use.insert(shot);
+      }
+    }
+  }
+
+  for (const auto track : tracks_to_use) {
+    for (const auto& it1 : *track) {
+      const auto& shot_id1 = it1.first;
+      if (!shots_to_use.count(shot_id1)) {
+        continue;
+      }
+      for (const auto& it2 : *track) {
+        const auto& shot_id2 = it2.first;
+        if (shot_id1 < shot_id2 && shots_to_use.count(shot_id2)) {
+          ++common_per_pair[std::make_pair(shot_id1, shot_id2)];
+        }
+      }
+    }
+  }
+  return common_per_pair;
+}
+
+TracksManager TracksManagerView::Materialize() const {
+  OPENSFM_TRACE_SCOPE("map", "TracksManagerView::Materialize");
+  TracksManager materialized;
+  for (const auto& track : tracks_) {
+    const TrackId track_id(track.first);
+    for (const auto& obs : *track.second) {
+      if (shots_.count(obs.first)) {
+        materialized.AddObservation(obs.first, track_id, obs.second);
+      }
+    }
+  }
+  return materialized;
+}
+}  // namespace map
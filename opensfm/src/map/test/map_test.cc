@@ -5,6 +5,9 @@
 #include <map/map.h>
 #include <map/observation.h>
 
+#include <atomic>
+#include <thread>
+
 namespace {
 
 class BaseMapFixture : public ::testing::Test {
@@ -158,6 +161,184 @@ TEST_F(ToyMapFixture, RemoveLandmark) {
   ASSERT_EQ(map.NumberOfLandmarks(), num_points - 1);
 }
 
+TEST_F(ToyMapFixture, SetsLandmarkReprojectionErrors) {
+  auto& landmark = map.GetLandmark("0");
+  auto* shot0 = &map.GetShot("0");
+  auto* shot1 = &map.GetShot("1");
+  map.AddObservation("0", "0", map::Observation(100, 200, 0.5, 1, 2, 3, 42));
+  map.AddObservation("1", "0", map::Observation(300, 400, 0.5, 1, 2, 3, 43));
+  landmark.SetReprojectionError(shot0, Vec2d(1.0, 2.0));
+  landmark.SetReprojectionError(shot1, Vec3d(1.0, 2.0, 3.0));
+  landmark.SetReprojectionError(shot0, Vec2d(3.0, 4.0));
+  ASSERT_THROW(
+      landmark.SetReprojectionError(&map.GetShot("2"), Vec2d(1.0, 2.0)),
+      std::runtime_error);
+
+  const auto errors = landmark.GetReprojectionErrors();
+  ASSERT_EQ(errors.size(), 2);
+  ASSERT_EQ(errors.at("0"), Vec2d(3.0, 4.0));
+  ASSERT_EQ(errors.at("1"), Vec3d(1.0, 2.0, 3.0));
+
+  landmark.RemoveReprojectionError(shot0);
+  ASSERT_EQ(landmark.GetReprojectionErrorsShots().size(), 1);
+  ASSERT_EQ(landmark.GetReprojectionErrorsValues()[0], Vec3d(1.0, 2.0, 3.0));
+
+  // Removing an observation removes its error
+  map.RemoveObservation("1", "0");
+  ASSERT_TRUE(landmark.GetReprojectionErrors().empty());
+
+  landmark.SetReprojectionErrors({{"0", Vec2d(5.0, 6.0)}});
+  ASSERT_EQ(landmark.GetReprojectionErrors().at("0"), Vec2d(5.0, 6.0));
+  landmark.ClearReprojectionErrors();
+  ASSERT_TRUE(landmark.GetReprojectionErrors().empty());
+}
+
+TEST_F(ToyMapFixture, FlattensReprojectionErrors) {
+  map.AddObservation("0", "0", map::Observation(100, 200, 0.5, 1, 2, 3, 42));
+  map.AddObservation("1", "0", map::Observation(300, 400, 0.5, 1, 2, 3, 43));
+  map.AddObservation("1", "1", map::Observation(500, 600, 0.5, 1, 2, 3, 44));
+  map.GetLandmark("0").SetReprojectionErrors(
+      {{"0", Vec2d(1.0, 2.0)}, {"1", Vec3d(3.0, 4.0, 5.0)}});
+  map.GetLandmark("1").SetReprojectionErrors({{"1", Vec2d(6.0, 7.0)}});
+
+  const auto all = map.GetReprojectionErrors();
+  ASSERT_EQ(all.errors.rows(), 3);
+  ASSERT_EQ(all.errors.cols(), 3);
+  ASSERT_EQ(all.landmark_ids.size(), 3);
+  ASSERT_EQ(all.shot_ids.size(), 3);
+
+  const auto some = map.GetReprojectionErrors({"1"});
+  ASSERT_EQ(some.landmark_ids, std::vector<map::LandmarkId>{"1"});
+  ASSERT_EQ(some.shot_ids, std::vector<map::ShotId>{"1"});
+  ASSERT_EQ(some.errors.cols(), 2);
+  ASSERT_EQ(Vec2d(some.errors.row(0).transpose()), Vec2d(6.0, 7.0));
+}
+
+TEST_F(ToyMapFixture, ReportsMemoryUsage) {
+  const auto usage = map.MemoryUsage();
+  size_t total = 0;
+  for (const auto& component : usage) {
+    if (component.first != "total") {
+      total += component.second;
+    }
+  }
+  ASSERT_EQ(usage.at("total"), total);
+  ASSERT_GT(usage.at("shots"), 0);
+  ASSERT_GT(usage.at("landmarks"), 0);
+  ASSERT_GT(usage.at("observations"), 0);
+
+  map.ClearObservationsAndLandmarks();
+  ASSERT_LT(map.MemoryUsage().at("total"), usage.at("total"));
+}
+
+TEST_F(ToyMapFixture, HasIOBytesConsistency) {
+  map.SetTopocentricConverter(1.0, 2.0, 3.0);
+  map.SetBias("1", geometry::Similarity(Vec3d(0.1, 0.2, 0.3),
+                                        Vec3d(1.0, 2.0, 3.0), 2.0));
+  auto& shot = map.GetShot("2");
+  shot.GetRigInstance()->SetPose(
+      geometry::Pose(Vec3d(0.1, -0.2, 0.3), Vec3d(4.0, 5.0, 6.0)));
+  shot.GetShotMeasurements().gps_position_.SetValue(Vec3d(1.0, 2.0, 3.0));
+  shot.GetShotMeasurements().sequence_key_.SetValue("sequence");
+  shot.GetShotMeasurements().GetMutableAttributes()["key"] = "value";
+  shot.SetCovariance(MatXd::Identity(6, 6));
+  shot.merge_cc = 7;
+  auto& landmark = map.GetLandmark("3");
+  landmark.SetColor(Vec3i(10, 20, 30));
+  map.AddObservation("2", "3", map::Observation(100, 200, 0.5, 1, 2, 3, 42));
+  map.AddObservation("4", "3", map::Observation(300, 400, 0.5, 1, 2, 3, 43));
+  landmark.SetReprojectionError(&shot, Vec2d(1.0, 2.0));
+
+  const auto bytes = map.AsBytes();
+  const auto map_new =
+      map::Map::InstanciateFromBytes(bytes.data(), bytes.size());
+
+  ASSERT_EQ(map_new->NumberOfShots(), map.NumberOfShots());
+  ASSERT_EQ(map_new->NumberOfLandmarks(), map.NumberOfLandmarks());
+  ASSERT_EQ(map_new->NumberOfCameras(), map.NumberOfCameras());
+  ASSERT_EQ(map_new->NumberOfRigInstances(), map.NumberOfRigInstances());
+  ASSERT_EQ(map_new->GetTopocentricConverter().GetLlaRef(), Vec3d(1, 2, 3));
+  ASSERT_NEAR(map_new->GetBias("1").Scale(), 2.0, 1e-12);
+  ASSERT_TRUE(map_new->GetCamera("0").GetParametersValues() ==
+              map.GetCamera("0").GetParametersValues());
+
+  const auto& shot_new = map_new->GetShot("2");
+  ASSERT_NEAR(0.0,
+              (shot_new.GetPose()->WorldToCamera() -
+               shot.GetPose()->WorldToCamera())
+                  .norm(),
+              1e-12);
+  ASSERT_EQ(shot_new.GetShotMeasurements().gps_position_.Value(),
+            Vec3d(1.0, 2.0, 3.0));
+  ASSERT_EQ(shot_new.GetShotMeasurements().sequence_key_.Value(), "sequence");
+  ASSERT_EQ(shot_new.GetShotMeasurements().GetAttributes().at("key"), "value");
+  ASSERT_FALSE(shot_new.GetShotMeasurements().capture_time_.HasValue());
+  ASSERT_TRUE(shot_new.GetCovariance().isIdentity());
+  ASSERT_EQ(shot_new.merge_cc, 7);
+
+  const auto& landmark_new = map_new->GetLandmark("3");
+  ASSERT_EQ(landmark_new.GetGlobalPos(), landmark.GetGlobalPos());
+  ASSERT_EQ(landmark_new.GetColor(), Vec3i(10, 20, 30));
+  ASSERT_EQ(landmark_new.GetReprojectionErrors(),
+            landmark.GetReprojectionErrors());
+  ASSERT_EQ(landmark_new.NumberOfObservations(), 2);
+  ASSERT_EQ(shot_new.GetObservation(42),
+            map::Observation(100, 200, 0.5, 1, 2, 3, 42));
+}
+
+TEST_F(ToyMapFixture, ReadsConsistentlyWhileWriterCommits) {
+  // The writer shifts all landmarks at once, readers must never see a
+  // partially applied shift
+  std::unordered_map<map::LandmarkId, Vec3d> initial;
+  for (const auto& landmark : map.GetLandmarks()) {
+    initial[landmark.first] = landmark.second.GetGlobalPos();
+  }
+
+  // Readers stop once the writer is done, or after a fixed number of reads
+  // so that the test stays bounded
+  constexpr int max_reads = 20000;
+  std::atomic<bool> done{false};
+  std::atomic<int> inconsistent{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      const auto& const_map = map;
+      for (int read = 0; read < max_reads && !done; ++read) {
+        const auto lock = const_map.LockForReading();
+        std::vector<double> shifts;
+        for (const auto& landmark : const_map.GetLandmarks()) {
+          shifts.push_back(landmark.second.GetGlobalPos()[0] -
+                           initial.at(landmark.first)[0]);
+        }
+        for (const double shift : shifts) {
+          if (std::abs(shift - shifts[0]) > 1e-9) {
+            ++inconsistent;
+          }
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < 200; ++i) {
+    const auto lock = map.LockForWriting();
+    for (auto& landmark : map.GetLandmarks()) {
+      landmark.second.SetGlobalPos(landmark.second.GetGlobalPos() +
+                                   Vec3d(1.0, 0.0, 0.0));
+    }
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  ASSERT_EQ(0, inconsistent);
+  for (const auto& landmark : map.GetLandmarks()) {
+    ASSERT_NEAR(200.0,
+                landmark.second.GetGlobalPos()[0] -
+                    initial.at(landmark.first)[0],
+                1e-9);
+  }
+}
+
 TEST_F(ToyMapFixture, ThrowsWhenRemovingLandmarkTwice) {
   map.RemoveLandmark("1");
   ASSERT_THROW(map.RemoveLandmark("1"), std::runtime_error);
@@ -358,4 +539,50 @@ TEST_F(ToyMapFixture, ToTracksManager) {
   }
 }
 
+TEST_F(EmptyMapFixture, ApplySimilarityKeepsProjections) {
+  camera.id = "camera";
+  map.CreateCamera(camera);
+  geometry::Pose side_pose(Vec3d(0.0, 0.3, 0.0), Vec3d(0.5, 0.0, 0.1));
+  map.CreateRigCamera(map::RigCamera(geometry::Pose(), "main"));
+  map.CreateRigCamera(map::RigCamera(side_pose, "side"));
+  map.CreateRigInstance("instance");
+  map.CreateShot("main", camera.id, "main", "instance");
+  map.CreateShot("side", camera.id, "side", "instance");
+  map.GetRigInstance("instance").SetPose(
+      geometry::Pose(Vec3d(0.1, -0.2, 0.05), Vec3d(1.0, 2.0, 3.0)));
+  for (int i = 0; i < 100; ++i) {
+    map.CreateLandmark(std::to_string(i),
+                       Vec3d(0.1 * (i % 10), 0.1 * (i / 10), 5.0));
+  }
+
+  std::map<std::pair<map::ShotId, map::LandmarkId>, Vec2d> projections;
+  for (const auto& shot : map.GetShots()) {
+    for (const auto& landmark : map.GetLandmarks()) {
+      projections[{shot.first, landmark.first}] =
+          shot.second.Project(landmark.second.GetGlobalPos());
+    }
+  }
+
+  const double s = 2.0;
+  const geometry::Similarity similarity(Vec3d(0.3, 0.1, -0.2),
+                                        Vec3d(-1.0, 0.5, 2.0), s);
+  const Vec3d point = map.GetLandmark("42").GetGlobalPos();
+  map.ApplySimilarity(similarity, 2);
+
+  ASSERT_TRUE(map.GetLandmark("42").GetGlobalPos().isApprox(
+      similarity.Transform(point)));
+  ASSERT_TRUE(map.GetRigCamera("side").pose.TranslationWorldToCamera().isApprox(
+      s * side_pose.TranslationWorldToCamera()));
+  for (const auto& shot : map.GetShots()) {
+    for (const auto& landmark : map.GetLandmarks()) {
+      const Vec2d projection =
+          shot.second.Project(landmark.second.GetGlobalPos());
+      ASSERT_NEAR(
+          0.0,
+          (projection - projections.at({shot.first, landmark.first})).norm(),
+          1e-12);
+    }
+  }
+}
+
 }  // namespace
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <map/map.h>
+#include <map/mesh.h>
+#include <map/tracks_manager.h>
+
+#include <random>
+
+namespace {
+
+class ShotMeshFixture : public ::testing::Test {
+ public:
+  ShotMeshFixture() {
+    auto perspective = geometry::Camera::CreatePerspectiveCamera(1.0, 0, 0);
+    perspective.id = "perspective";
+    perspective.width = 640;
+    perspective.height = 480;
+    map.CreateCamera(perspective);
+    auto fisheye = geometry::Camera::CreateFisheyeCamera(0.5, 0, 0);
+    fisheye.id = "fisheye";
+    map.CreateCamera(fisheye);
+    auto spherical = geometry::Camera::CreateSphericalCamera();
+    spherical.id = "spherical";
+    map.CreateCamera(spherical);
+
+    map::RigCamera rig_camera;
+    rig_camera.id = "rig_camera";
+    map.CreateRigCamera(rig_camera);
+    for (const auto& camera_id : {"perspective", "fisheye", "spherical"}) {
+      map.CreateRigInstance(camera_id);
+      map.CreateShot(camera_id, camera_id, "rig_camera", camera_id,
+                     geometry::Pose());
+    }
+
+    // Points all around the shots, seen by all of them
+    std::mt19937 generator(42);
+    std::normal_distribution<double> normal;
+    for (int i = 0; i < num_points; ++i) {
+      const auto id = std::to_string(i);
+      const Vec3d direction =
+          Vec3d(normal(generator), normal(generator), normal(generator));
+      map.CreateLandmark(id, (10.0 + i % 3) * direction.normalized());
+      for (const auto& shot_id : {"perspective", "fisheye", "spherical"}) {
+        tracks_manager.AddObservation(shot_id, id,
+                                      map::Observation(0, 0, 1, 0, 0, 0, i));
+      }
+    }
+  }
+
+  static constexpr int num_points = 400;
+  map::Map map;
+  map::TracksManager tracks_manager;
+};
+
+TEST_F(ShotMeshFixture, PerspectiveMeshCoversImage) {
+  const auto mesh =
+      map::ComputeShotMesh(map, tracks_manager, "perspective");
+  const auto& vertices = mesh.vertices_;
+  const auto& faces = mesh.faces_;
+  ASSERT_GT(vertices.rows(), 4);
+  ASSERT_GT(faces.rows(), 0);
+
+  // Landmarks in front of the camera and inside the image, after corners
+  const auto& shot = map.GetShot("perspective");
+  for (int i = 4; i < vertices.rows(); ++i) {
+    const Vec2d pixel = shot.Project(vertices.row(i));
+    ASSERT_GT(vertices(i, 2), 0.0);
+    ASSERT_LE(std::abs(pixel(0)), 0.5);
+    ASSERT_LE(std::abs(pixel(1)), 0.375);
+  }
+
+  // Corners are back-projected in the image corners at the landmarks depth
+  for (int i = 0; i < 4; ++i) {
+    const Vec2d pixel = shot.Project(vertices.row(i));
+    ASSERT_NEAR(0.5, std::abs(pixel(0)), 1e-9);
+    ASSERT_NEAR(0.375, std::abs(pixel(1)), 1e-9);
+    ASSERT_GE(vertices(i, 2), 5.0);
+    ASSERT_LE(vertices(i, 2), 12.0);
+  }
+}
+
+TEST_F(ShotMeshFixture, FisheyeMeshHasNoBoundaryFaces) {
+  const auto mesh = map::ComputeShotMesh(map, tracks_manager, "fisheye");
+  ASSERT_EQ(20 + 1 + num_points, mesh.vertices_.rows());
+  ASSERT_GT(mesh.faces_.rows(), 0);
+  for (int i = 0; i < mesh.faces_.rows(); ++i) {
+    ASSERT_GE(mesh.faces_.row(i).maxCoeff(), 20);
+  }
+}
+
+TEST_F(ShotMeshFixture, SphericalMeshIsClosed) {
+  const auto mesh = map::ComputeShotMesh(map, tracks_manager, "spherical");
+  ASSERT_EQ(8 + num_points, mesh.vertices_.rows());
+
+  // All landmarks bearings are on the hull, while the cube is inside
+  ASSERT_EQ(2 * num_points - 4, mesh.faces_.rows());
+  ASSERT_GE(mesh.faces_.minCoeff(), 8);
+}
+
+TEST_F(ShotMeshFixture, ComputesMeshesOfAllShots) {
+  map::ComputeShotMeshes(map, tracks_manager, 4);
+  for (const auto& shot_id : {"perspective", "fisheye", "spherical"}) {
+    const auto expected = map::ComputeShotMesh(map, tracks_manager, shot_id);
+    const auto& mesh = map.GetShot(shot_id).mesh;
+    ASSERT_TRUE(mesh.vertices_ == expected.vertices_);
+    ASSERT_TRUE(mesh.faces_ == expected.faces_);
+  }
+}
+}  // namespace
@@ -4,6 +4,8 @@
 #include <map/rig.h>
 #include <map/shot.h>
 
+#include <thread>
+
 class RigCameraFixture : public ::testing::Test {
  public:
   RigCameraFixture() : rig_camera_id("rig_camera") {
@@ -157,3 +159,48 @@ TEST_F(SharedRigInstanceWithShotsFixture,
   ComparePoses(*foundation::as_const(shot_instance2).GetPose(),
                *foundation::as_const(shot_instance1).GetPose());
 }
+
+TEST_F(SharedRigInstanceWithShotsFixture,
+       UpdatesShotPoseWhenModifyingPosesInPlace) {
+  const auto& shot = foundation::as_const(shot_instance1);
+  ComparePoses(rig_camera_pose.Compose(instance_pose1), *shot.GetPose());
+
+  // Poses changed through references rather than setters
+  instance1.GetPose().SetOrigin(Vec3d::Random());
+  const geometry::Pose new_pose = foundation::as_const(instance1).GetPose();
+  ComparePoses(rig_camera_pose.Compose(new_pose), *shot.GetPose());
+
+  geometry::Pose new_rig_camera_pose;
+  new_rig_camera_pose.SetWorldToCamRotation(Vec3d::Random());
+  rig_camera.pose = new_rig_camera_pose;
+  ComparePoses(new_rig_camera_pose.Compose(new_pose), *shot.GetPose());
+
+  // Assigning an older pose is still a modification
+  rig_camera.pose = rig_camera_pose;
+  ComparePoses(rig_camera_pose.Compose(new_pose), *shot.GetPose());
+}
+
+TEST_F(SharedRigInstanceWithShotsFixture, ReadsShotPoseConcurrently) {
+  geometry::Pose new_pose;
+  new_pose.SetOrigin(Vec3d::Random());
+  instance1.SetPose(new_pose);
+  const Vec3d expected = rig_camera_pose.Compose(new_pose).GetOrigin();
+
+  const int num_threads = 8;
+  std::vector<int> mismatches(num_threads, 0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i]() {
+      const auto& shot = foundation::as_const(shot_instance1);
+      for (int j = 0; j < 1000; ++j) {
+        if ((shot.GetPose()->GetOrigin() - expected).norm() > 1e-10) {
+          ++mismatches[i];
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_THAT(mismatches, ::testing::Each(0));
+}
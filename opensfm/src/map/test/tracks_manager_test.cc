@@ -1,6 +1,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <map/tracks_manager.h>
+#include <map/tracks_manager_view.h>
+
+#include <sstream>
 
 namespace {
 
@@ -99,6 +102,73 @@ TEST_F(TracksManagerTest, ConstructSubTracksManager) {
   EXPECT_EQ(subtrack, subset.GetTrackObservations("1"));
 }
 
+TEST_F(TracksManagerTest, FiltersTracksManagerView) {
+  manager.AddObservation("1", "2", map::Observation(4, 4, 4, 4, 4, 4, 4));
+  manager.AddObservation("2", "2", map::Observation(5, 5, 5, 5, 5, 5, 5));
+  manager.AddObservation("4", "2", map::Observation(6, 6, 6, 6, 6, 6, 6));
+  manager.AddObservation("4", "3", map::Observation(7, 7, 7, 7, 7, 7, 7));
+
+  // Track "3" and shot "3" have no observations in the subset
+  const map::TracksManagerView view(manager, {"1", "2", "3", "unknown"},
+                                    {"1", "2", "4"});
+  EXPECT_THAT(view.GetShotIds(),
+              ::testing::WhenSorted(::testing::ElementsAre("1", "2", "4")));
+  EXPECT_THAT(view.GetTrackIds(),
+              ::testing::WhenSorted(::testing::ElementsAre("1", "2", "3")));
+  EXPECT_FALSE(view.HasShotObservations("3"));
+  EXPECT_THROW(view.GetShotObservations("3"), std::runtime_error);
+  EXPECT_THROW(view.GetObservation("1", "3"), std::runtime_error);
+
+  std::unordered_map<map::ShotId, map::Observation> subtrack = track;
+  subtrack.erase("3");
+  EXPECT_EQ(subtrack, view.GetTrackObservations("1").Copy());
+  EXPECT_EQ(2, view.GetTrackObservations("1").size());
+  EXPECT_EQ(1, view.GetShotObservations("4").count("3"));
+  EXPECT_EQ(2, view.GetAllCommonObservations("1", "2").size());
+
+  const auto connectivity = view.GetAllPairsConnectivity({}, {});
+  EXPECT_EQ(3, connectivity.size());
+  EXPECT_EQ(2, connectivity.at(std::make_pair("1", "2")));
+  EXPECT_EQ(1, connectivity.at(std::make_pair("2", "4")));
+  EXPECT_EQ(1, view.GetAllPairsConnectivity({"1", "2", "3"}, {"2"}).size());
+
+  const auto materialized = view.Materialize();
+  for (const auto& shot_id : view.GetShotIds()) {
+    EXPECT_EQ(view.GetShotObservations(shot_id).Copy(),
+              materialized.GetShotObservations(shot_id));
+  }
+  EXPECT_EQ(view.NumShots(), materialized.NumShots());
+  EXPECT_EQ(view.NumTracks(), materialized.NumTracks());
+
+  const auto parsed = map::TracksManager::InstanciateFromString(view.AsString());
+  for (const auto& shot_id : view.GetShotIds()) {
+    EXPECT_EQ(materialized.GetShotObservations(shot_id),
+              parsed.GetShotObservations(shot_id));
+  }
+  EXPECT_EQ(view.NumTracks(), parsed.NumTracks());
+}
+
+TEST_F(TracksManagerTest, ViewsAllTracksOfShots) {
+  manager.AddObservation("4", "2", map::Observation(6, 6, 6, 6, 6, 6, 6));
+
+  // Same as all the tracks, restricted to the shots
+  const map::TracksManagerView view(manager, {"1", "4", "unknown"});
+  const auto expected =
+      manager.ConstructSubTracksManager(manager.GetTrackIds(), {"1", "4"});
+  EXPECT_THAT(view.GetShotIds(),
+              ::testing::WhenSorted(::testing::ElementsAre("1", "4")));
+  EXPECT_THAT(view.GetTrackIds(),
+              ::testing::WhenSorted(::testing::ElementsAre("1", "2")));
+  for (const auto& track_id : view.GetTrackIds()) {
+    EXPECT_EQ(expected.GetTrackObservations(track_id),
+              view.GetTrackObservations(track_id).Copy());
+  }
+  for (const auto& observation : view.GetTrackObservations("1")) {
+    EXPECT_EQ(&manager.GetTrackObservations("1").at(observation.first),
+              &observation.second);
+  }
+}
+
 TEST_F(TracksManagerTest, MergeThreeTracksManager) {
   map::TracksManager manager1;
   const auto o0 = map::Observation(1.0, 1.0, 1.0, 1, 1, 1, 0);
@@ -155,6 +225,17 @@ TEST_F(TracksManagerTest, MergeThreeTracksManager) {
   EXPECT_EQ(merged.GetTrackObservations("3"), track0);
 }
 
+TEST_F(TracksManagerTest, ReportsMemoryUsage) {
+  const auto usage = manager.MemoryUsage();
+  ASSERT_EQ(usage.at("observations"), 6 * sizeof(std::pair<const map::ShotId,
+                                                           map::Observation>));
+  ASSERT_EQ(usage.at("total"),
+            usage.at("ids") + usage.at("indices") + usage.at("observations"));
+
+  manager.AddObservation("4", "1", map::Observation(4.0, 4.0, 4.0, 4, 4, 4, 4));
+  ASSERT_GT(manager.MemoryUsage().at("total"), usage.at("total"));
+}
+
 TEST_F(TracksManagerTest, HasIOFileConsistency) {
   manager.WriteToFile(tmpfile.Name());
   const map::TracksManager manager_new =
@@ -179,4 +260,85 @@ TEST_F(TracksManagerTest, HasIOStringConsistency) {
   EXPECT_EQ(track, manager_new.GetTrackObservations("1"));
 }
 
+TEST_F(TracksManagerTest, WritesStreamFormattedValues) {
+  manager.AddObservation(
+      "4", "2", map::Observation(0.1234567, -1e-7, 1234567.0, 4, 5, 6, 7));
+  std::ostringstream expected;
+  expected << "OPENSFM_TRACKS_VERSION_v2\n";
+  for (const auto& shot_id : manager.GetShotIds()) {
+    for (const auto& item : manager.GetShotObservations(shot_id)) {
+      const auto& o = item.second;
+      expected << shot_id << "\t" << item.first << "\t" << o.feature_id
+               << "\t" << o.point(0) << "\t" << o.point(1) << "\t" << o.scale
+               << "\t" << o.color(0) << "\t" << o.color(1) << "\t"
+               << o.color(2) << "\t" << o.segmentation_id << "\t"
+               << o.instance_id << "\n";
+    }
+  }
+  EXPECT_EQ(expected.str(), manager.AsString());
+}
+
+TEST_F(TracksManagerTest, ReadsPreviousVersions) {
+  const auto v0 = map::TracksManager::InstanciateFromString(
+      "1\t1\t1\t0.5\t-0.5\t1\t2\t3\n\n");
+  const auto& o0 = v0.GetObservation("1", "1");
+  EXPECT_EQ(Vec2d(0.5, -0.5), o0.point);
+  EXPECT_EQ(0.0, o0.scale);
+  EXPECT_EQ(Vec3i(1, 2, 3), o0.color);
+  EXPECT_EQ(map::Observation::NO_SEMANTIC_VALUE, o0.segmentation_id);
+
+  const auto v1 = map::TracksManager::InstanciateFromString(
+      "OPENSFM_TRACKS_VERSION_v1\r\n1\t1\t1\t0.5\t-0.5\t2\t1\t2\t3\r\n");
+  const auto& o1 = v1.GetObservation("1", "1");
+  EXPECT_EQ(2.0, o1.scale);
+  EXPECT_EQ(Vec3i(1, 2, 3), o1.color);
+  EXPECT_EQ(map::Observation::NO_SEMANTIC_VALUE, o1.instance_id);
+}
+
+TEST_F(TracksManagerTest, ThrowsOnInvalidLines) {
+  const std::string header = "OPENSFM_TRACKS_VERSION_v2\n";
+  EXPECT_THROW(map::TracksManager::InstanciateFromString(
+                   header + "1\t1\t1\t0.5\t0.5\t1\t2\t3\n"),
+               std::runtime_error);
+  EXPECT_THROW(map::TracksManager::InstanciateFromString(
+                   header + "1\t1\t1\tx\t0.5\t1\t1\t2\t3\t4\t5\n"),
+               std::runtime_error);
+  EXPECT_THROW(map::TracksManager::InstanciateFromString(
+                   header + "1\t1\t1\t0.5\t0.5\t1\t1\t2\t3\t4\t5\t6\n"),
+               std::runtime_error);
+  EXPECT_THROW(map::TracksManager::InstanciateFromString(
+                   "OPENSFM_TRACKS_VERSION_v9\n"),
+               std::runtime_error);
+}
+
+TEST_F(TracksManagerTest, HasIOBytesConsistency) {
+  auto with_depth = map::Observation(4.0, 4.0, 4.0, 4, 4, 4, 4);
+  with_depth.depth_prior = map::Depth(10.0, true, 0.5);
+  manager.AddObservation("4", "2", with_depth);
+
+  const auto serialized = manager.AsBytes();
+  const map::TracksManager manager_new =
+      map::TracksManager::InstanciateFromBytes(serialized.data(),
+                                               serialized.size());
+
+  EXPECT_THAT(manager_new.GetShotIds(),
+              ::testing::WhenSorted(
+                  ::testing::ElementsAre("1", "2", "3", "4")));
+  EXPECT_THAT(manager_new.GetTrackIds(),
+              ::testing::WhenSorted(::testing::ElementsAre("1", "2")));
+  EXPECT_EQ(track, manager_new.GetTrackObservations("1"));
+  EXPECT_EQ(manager_new.GetShotObservations("3"),
+            manager.GetShotObservations("3"));
+
+  const auto depth = manager_new.GetObservation("4", "2").depth_prior;
+  ASSERT_TRUE(depth.has_value());
+  EXPECT_EQ(10.0, depth->value);
+  EXPECT_TRUE(depth->is_radial);
+  EXPECT_EQ(0.5, depth->std_deviation);
+
+  EXPECT_THROW(map::TracksManager::InstanciateFromBytes(
+                   serialized.data(), serialized.size() - 1),
+               std::runtime_error);
+}
+
 }  // namespace
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <foundation/memory_usage.h>
+#include <foundation/shared_mutex.h>
 #include <map/defines.h>
 #include <map/observation.h>
 
@@ -9,8 +11,19 @@
 #include <vector>
 
 namespace map {
+
+/* Const methods can be called concurrently from any number of threads, as
+ * long as no thread modifies the tracks. Readers and a writer running
+ * concurrently synchronize with LockForReading() and LockForWriting(). */
 class TracksManager {
  public:
+  foundation::ReadLock LockForReading() const {
+    return mutex_.LockForReading();
+  }
+  foundation::WriteLock LockForWriting() const {
+    return mutex_.LockForWriting();
+  }
+
   void AddObservation(const ShotId& shot_id, const TrackId& track_id,
                       const Observation& observation);
   void RemoveObservation(const ShotId& shot_id, const TrackId& track_id);
@@ -39,24 +52,40 @@ class TracksManager {
       const std::vector<ShotId>& shots,
       const std::vector<TrackId>& tracks) const;
 
-  static TracksManager InstanciateFromFile(const std::string& filename);
-  void WriteToFile(const std::string& filename) const;
+  // Text serialization, parsed and formatted with 'num_threads' threads
+  static TracksManager InstanciateFromFile(const std::string& filename,
+                                           int num_threads = 1);
+  void WriteToFile(const std::string& filename, int num_threads = 1) const;
+
+  static TracksManager InstanciateFromString(const std::string& str,
+                                             int num_threads = 1);
+  std::string AsString(int num_threads = 1) const;
 
-  static TracksManager InstanciateFromString(const std::string& str);
-  std::string AsString() const;
+  // Compact binary serialization (see map/serialization.h)
+  static TracksManager InstanciateFromBytes(const char* data, size_t size);
+  std::string AsBytes() const;
 
   static TracksManager MergeTracksManager(
       const std::vector<const TracksManager*>& tracks_manager);
 
   bool HasShotObservations(const ShotId& shot) const;
 
+  // Memory used by the tracks, broken down by component
+  foundation::MemoryUsage MemoryUsage() const;
+
   static std::string TRACKS_HEADER;
   static int TRACKS_VERSION;
+  static std::string TRACKS_BINARY_HEADER;
+  static int TRACKS_BINARY_VERSION;
 
  private:
+  friend class TracksManagerView;
+
   std::unordered_map<ShotId, std::unordered_map<TrackId, Observation>>
       tracks_per_shot_;
   std::unordered_map<TrackId, std::unordered_map<ShotId, Observation>>
       shots_per_track_;
+
+  foundation::SharedMutex mutex_;
 };
 }  // namespace map
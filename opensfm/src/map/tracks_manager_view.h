@@ -0,0 +1,134 @@
+#pragma once
+
+#include <map/tracks_manager.h>
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+namespace map {
+
+/* Observations of a shot, or of a track, of a TracksManager restricted to
+ * the tracks, or shots, of a filter. Iterating over it visits the entries of
+ * the TracksManager in place, skipping the ones outside of the filter. */
+class FilteredObservations {
+ public:
+  using Entries = std::unordered_map<std::string, Observation>;
+  using Filter = std::unordered_map<std::string_view, const Entries*>;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Entries::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    const_iterator(Entries::const_iterator it, Entries::const_iterator end,
+                   const Filter* filter)
+        : it_(it), end_(end), filter_(filter) {
+      SkipFiltered();
+    }
+    reference operator*() const { return *it_; }
+    pointer operator->() const { return &*it_; }
+    const_iterator& operator++() {
+      ++it_;
+      SkipFiltered();
+      return *this;
+    }
+    bool operator==(const const_iterator& other) const {
+      return it_ == other.it_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return it_ != other.it_;
+    }
+
+   private:
+    void SkipFiltered() {
+      while (it_ != end_ && !filter_->count(it_->first)) {
+        ++it_;
+      }
+    }
+
+    Entries::const_iterator it_;
+    Entries::const_iterator end_;
+    const Filter* filter_;
+  };
+
+  FilteredObservations(const Entries& entries, const Filter& filter)
+      : entries_(entries), filter_(filter) {}
+
+  const_iterator begin() const {
+    return const_iterator(entries_.begin(), entries_.end(), &filter_);
+  }
+  const_iterator end() const {
+    return const_iterator(entries_.end(), entries_.end(), &filter_);
+  }
+  // Number of entries in the filter, which visits all of them
+  size_t size() const { return std::distance(begin(), end()); }
+  size_t count(const std::string& key) const {
+    return filter_.count(key) && entries_.count(key) ? 1 : 0;
+  }
+  const Observation& at(const std::string& key) const;
+
+  // Copy of the entries
+  Entries Copy() const { return Entries(begin(), end()); }
+
+ private:
+  const Entries& entries_;
+  const Filter& filter_;
+};
+
+/* Read-only subset of a TracksManager, restricted to some tracks and shots,
+ * that references the observations of its parent instead of copying them.
+ * It has the same content as ConstructSubTracksManager : only the selected
+ * shots and tracks with at least one observation in the subset are part of
+ * it. The parent must outlive the view and must not be modified while the
+ * view is used. Observations are read in place from the parent, they're
+ * only copied by Materialize() or when writing the view. */
+class TracksManagerView {
+ public:
+  TracksManagerView(const TracksManager& parent,
+                    const std::vector<TrackId>& tracks,
+                    const std::vector<ShotId>& shots);
+  // All the tracks observed by 'shots'
+  TracksManagerView(const TracksManager& parent,
+                    const std::vector<ShotId>& shots);
+
+  int NumShots() const;
+  int NumTracks() const;
+  std::vector<ShotId> GetShotIds() const;
+  std::vector<TrackId> GetTrackIds() const;
+  bool HasShotObservations(const ShotId& shot) const;
+  bool HasTrackObservations(const TrackId& track) const;
+
+  Observation GetObservation(const ShotId& shot, const TrackId& track) const;
+  FilteredObservations GetShotObservations(const ShotId& shot) const;
+  FilteredObservations GetTrackObservations(const TrackId& track) const;
+
+  std::vector<TracksManager::KeyPointTuple> GetAllCommonObservations(
+      const ShotId& shot1, const ShotId& shot2) const;
+  std::unordered_map<TracksManager::ShotPair, int, HashPair>
+  GetAllPairsConnectivity(const std::vector<ShotId>& shots,
+                          const std::vector<TrackId>& tracks) const;
+
+  // Copy of the observations of the view into a standalone TracksManager
+  TracksManager Materialize() const;
+
+  // Same text serialization as TracksManager, written from the parent's
+  // observations
+  void WriteToFile(const std::string& filename, int num_threads = 1) const;
+  std::string AsString(int num_threads = 1) const;
+
+ private:
+  using ShotObservations = FilteredObservations::Entries;
+  using TrackObservations = FilteredObservations::Entries;
+
+  const ShotObservations& FindShot(const ShotId& shot) const;
+  const TrackObservations& FindTrack(const TrackId& track) const;
+
+  // Observations of the parent, keyed by the parent's own ids
+  FilteredObservations::Filter shots_;
+  FilteredObservations::Filter tracks_;
+};
+}  // namespace map
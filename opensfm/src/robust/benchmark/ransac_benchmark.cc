@@ -0,0 +1,166 @@
+#include <benchmark/benchmark.h>
+#include <robust/instanciations.h>
+
+#include <random>
+
+namespace {
+
+constexpr double kOutliersRatio = 0.3;
+
+/* Synthetic two-views scene : random points in front of two cameras, seen as
+ * bearings, with a fraction of the correspondences being random outliers. */
+struct TwoViewsScene {
+  explicit TwoViewsScene(int count)
+      : points(count, 3), bearings1(count, 3), bearings2(count, 3) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<> rand(-1.0, 1.0);
+
+    rotation = Eigen::AngleAxisd(0.1, Vec3d(0.2, 1.0, 0.1).normalized());
+    translation = Vec3d(1.0, 0.1, 0.2);
+    for (int i = 0; i < count; ++i) {
+      const Vec3d point(rand(gen), rand(gen), 5.0 + rand(gen));
+      points.row(i) = point;
+      bearings1.row(i) = point.normalized();
+      bearings2.row(i) = (rotation * point + translation).normalized();
+      if (i < kOutliersRatio * count) {
+        bearings2.row(i) =
+            Vec3d(rand(gen), rand(gen), 1.0 + rand(gen)).normalized();
+      }
+    }
+  }
+
+  Mat3d rotation;
+  Vec3d translation;
+  MatX3d points;
+  MatX3d bearings1;
+  MatX3d bearings2;
+};
+
+RobustEstimatorParams Parameters() {
+  RobustEstimatorParams parameters;
+  parameters.iterations = 1000;
+  return parameters;
+}
+
+void BM_RANSACLine(benchmark::State& state) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<> rand(-1.0, 1.0);
+  MatX2d points(state.range(0), 2);
+  for (int i = 0; i < points.rows(); ++i) {
+    const double x = rand(gen);
+    points.row(i) << x, 0.5 * x + 0.1;
+    if (i < kOutliersRatio * points.rows()) {
+      points(i, 1) = rand(gen);
+    }
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(robust::RANSACLine(points, 0.01, Parameters(),
+                                                RansacType::RANSAC));
+  }
+}
+
+void BM_RANSACEssential(benchmark::State& state) {
+  const TwoViewsScene scene(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        robust::RANSACEssential(scene.bearings1, scene.bearings2, 0.01,
+                                Parameters(), RansacType::RANSAC));
+  }
+}
+
+void BM_RANSACRelativePose(benchmark::State& state) {
+  const TwoViewsScene scene(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        robust::RANSACRelativePose(scene.bearings1, scene.bearings2, 0.01,
+                                   Parameters(), RansacType::RANSAC));
+  }
+}
+
+void BM_RANSACRelativeRotation(benchmark::State& state) {
+  TwoViewsScene scene(state.range(0));
+  // Pure rotation : the second view only sees rotated bearings
+  for (int i = 0; i < scene.bearings1.rows(); ++i) {
+    if (i >= kOutliersRatio * scene.bearings1.rows()) {
+      scene.bearings2.row(i) =
+          scene.rotation * scene.bearings1.row(i).transpose();
+    }
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(robust::RANSACRelativeRotation(
+        scene.bearings1, scene.bearings2, 0.01, Parameters(),
+        RansacType::RANSAC));
+  }
+}
+
+void BM_RANSACAbsolutePose(benchmark::State& state) {
+  const TwoViewsScene scene(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        robust::RANSACAbsolutePose(scene.bearings2, scene.points, 0.01,
+                                   Parameters(), RansacType::RANSAC));
+  }
+}
+
+void BM_RANSACAbsolutePoseKnownRotation(benchmark::State& state) {
+  TwoViewsScene scene(state.range(0));
+  // Bearings are expected to be already rotated in the world frame
+  for (int i = 0; i < scene.bearings2.rows(); ++i) {
+    scene.bearings2.row(i) =
+        scene.rotation.transpose() * scene.bearings2.row(i).transpose();
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(robust::RANSACAbsolutePoseKnownRotation(
+        scene.bearings2, scene.points, 0.01, Parameters(),
+        RansacType::RANSAC));
+  }
+}
+
+void BM_RANSACSimilarity(benchmark::State& state) {
+  const TwoViewsScene scene(state.range(0));
+  MatX3d transformed(scene.points.rows(), 3);
+  for (int i = 0; i < scene.points.rows(); ++i) {
+    transformed.row(i) =
+        2.0 * scene.rotation * scene.points.row(i).transpose() +
+        scene.translation;
+    if (i < kOutliersRatio * scene.points.rows()) {
+      transformed.row(i) = 10.0 * scene.bearings2.row(i);
+    }
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        robust::RANSACSimilarity(scene.points, transformed, 0.1, Parameters(),
+                                 RansacType::RANSAC));
+  }
+}
+
+BENCHMARK(BM_RANSACLine)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RANSACEssential)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RANSACRelativePose)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RANSACRelativeRotation)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RANSACAbsolutePose)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RANSACAbsolutePoseKnownRotation)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RANSACSimilarity)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -2,6 +2,7 @@
 #include "absolute_pose_model.h"
 #include "essential_model.h"
 #include "line_model.h"
+#include "plane_model.h"
 #include "relative_pose_model.h"
 #include "relative_rotation_model.h"
 #include "robust_estimator.h"
@@ -44,4 +45,13 @@ ScoreInfo<Similarity::Type> RANSACSimilarity(
     const Eigen::Matrix<double, -1, 3>& points1,
     const Eigen::Matrix<double, -1, 3>& points2, double threshold,
     const RobustEstimatorParams& parameters, const RansacType& ransac_type);
+
+// Fit a plane to points, and to directions lying on it. Points are inliers
+// below 'threshold' and directions below 'direction_threshold' degrees.
+// Inliers indices of the directions come after the points ones.
+ScoreInfo<Plane::Type> RANSACPlane(
+    const Eigen::Matrix<double, -1, 3>& points,
+    const Eigen::Matrix<double, -1, 3>& directions, double threshold,
+    double direction_threshold, const RobustEstimatorParams& parameters,
+    const RansacType& ransac_type);
 }  // namespace robust
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <foundation/numeric.h>
+
+#include <Eigen/Eigenvalues>
+#include <cmath>
+
+#include "model.h"
+
+// A sample lying on the plane : either a point, or a direction parallel to
+// the plane whose angular error (in degrees) is brought to the points error
+// scale with 'angle_scale'
+struct PlaneSample {
+  Eigen::Vector3d value;
+  bool is_direction{false};
+  double angle_scale{1.0};
+};
+
+class Plane : public Model<Plane, 1, 1> {
+ public:
+  using Error = typename Model<Plane, 1, 1>::Error;
+  // [n, d] with n the unit normal, such as n . x + d = 0
+  using Type = Eigen::Vector4d;
+  using Data = PlaneSample;
+  static const int MINIMAL_SAMPLES = 3;
+
+  template <class IT>
+  static int Estimate(IT begin, IT end, Type* models) {
+    std::vector<Eigen::Vector3d> points, directions;
+    for (IT it = begin; it != end; ++it) {
+      (it->is_direction ? directions : points).push_back(it->value);
+    }
+    // The plane needs to be anchored on at least one point
+    Eigen::Vector3d normal;
+    if (points.size() == 3) {
+      normal = (points[1] - points[0]).cross(points[2] - points[0]);
+    } else if (points.size() == 2) {
+      normal = (points[1] - points[0]).cross(directions[0]);
+    } else if (points.size() == 1) {
+      normal = directions[0].cross(directions[1]);
+    } else {
+      return 0;
+    }
+    return MakePlane(normal, points[0], models);
+  }
+
+  template <class IT>
+  static int EstimateNonMinimal(IT begin, IT end, Type* models) {
+    Eigen::Vector3d centroid = Eigen::Vector3d::Zero();
+    int num_points = 0;
+    for (IT it = begin; it != end; ++it) {
+      if (!it->is_direction) {
+        centroid += it->value;
+        ++num_points;
+      }
+    }
+    if (num_points == 0) {
+      return 0;
+    }
+    centroid /= num_points;
+
+    // The normal is the direction of least variance of the centered points
+    // and of the directions
+    Eigen::Matrix3d scatter = Eigen::Matrix3d::Zero();
+    for (IT it = begin; it != end; ++it) {
+      const Eigen::Vector3d v =
+          it->is_direction ? it->value : Eigen::Vector3d(it->value - centroid);
+      scatter += v * v.transpose();
+    }
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(scatter);
+    return MakePlane(solver.eigenvectors().col(0), centroid, models);
+  }
+
+  static Error Evaluate(const Type& model, const Data& d) {
+    const Eigen::Vector3d normal = model.segment<3>(0);
+    Error e;
+    if (d.is_direction) {
+      const double sine = std::min(1.0, std::abs(normal.dot(d.value)));
+      e[0] = d.angle_scale * std::asin(sine) * 180.0 / M_PI;
+    } else {
+      e[0] = normal.dot(d.value) + model[3];
+    }
+    return e;
+  }
+
+ private:
+  static int MakePlane(const Eigen::Vector3d& normal,
+                       const Eigen::Vector3d& point, Type* models) {
+    const double norm = normal.norm();
+    if (!(norm > 1e-12)) {
+      return 0;
+    }
+    models[0].segment<3>(0) = normal / norm;
+    models[0][3] = -models[0].segment<3>(0).dot(point);
+    return 1;
+  }
+};
@@ -20,13 +20,19 @@ __all__  = [
 "ScoreInfoMatrix3d",
 "ScoreInfoMatrix4d",
 "ScoreInfoVector3d",
+"ScoreInfoVector4d",
+"clear_tracing",
+"get_tracing_events",
+"is_tracing_enabled",
 "ransac_absolute_pose",
 "ransac_absolute_pose_known_rotation",
 "ransac_essential",
 "ransac_line",
+"ransac_plane",
 "ransac_relative_pose",
 "ransac_relative_rotation",
 "ransac_similarity",
+"set_tracing_enabled",
 "LMedS",
 "MSAC",
 "RANSAC"
@@ -146,13 +152,36 @@ class ScoreInfoVector3d:
     def score(self) -> float:...
     @score.setter
     def score(self, arg0: float) -> None:...
+class ScoreInfoVector4d:
+    def __init__(self) -> None: ...
+    @property
+    def inliers_indices(self) -> List[int]:...
+    @inliers_indices.setter
+    def inliers_indices(self, arg0: List[int]) -> None:...
+    @property
+    def lo_model(self) -> numpy.ndarray:...
+    @lo_model.setter
+    def lo_model(self, arg0: numpy.ndarray) -> None:...
+    @property
+    def model(self) -> numpy.ndarray:...
+    @model.setter
+    def model(self, arg0: numpy.ndarray) -> None:...
+    @property
+    def score(self) -> float:...
+    @score.setter
+    def score(self, arg0: float) -> None:...
+def clear_tracing() -> None:...
+def get_tracing_events() -> str:...
+def is_tracing_enabled() -> bool:...
 def ransac_absolute_pose(arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: float, arg3: RobustEstimatorParams, arg4: RansacType) -> ScoreInfoMatrix34d:...
 def ransac_absolute_pose_known_rotation(arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: float, arg3: RobustEstimatorParams, arg4: RansacType) -> ScoreInfoVector3d:...
 def ransac_essential(arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: float, arg3: RobustEstimatorParams, arg4: RansacType) -> ScoreInfoMatrix3d:...
 def ransac_line(arg0: numpy.ndarray, arg1: float, arg2: RobustEstimatorParams, arg3: RansacType) -> ScoreInfoLine:...
+def ransac_plane(arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: float, arg3: float, arg4: RobustEstimatorParams, arg5: RansacType) -> ScoreInfoVector4d:...
 def ransac_relative_pose(arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: float, arg3: RobustEstimatorParams, arg4: RansacType) -> ScoreInfoMatrix34d:...
 def ransac_relative_rotation(arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: float, arg3: RobustEstimatorParams, arg4: RansacType) -> ScoreInfoMatrix3d:...
 def ransac_similarity(arg0: numpy.ndarray, arg1: numpy.ndarray, arg2: float, arg3: RobustEstimatorParams, arg4: RansacType) -> ScoreInfoMatrix4d:...
+def set_tracing_enabled(arg0: bool) -> None:...
 LMedS = ...
 MSAC = ...
 RANSAC = ...
\ No newline at end of file
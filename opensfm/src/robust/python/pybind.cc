@@ -1,4 +1,5 @@
 #include <foundation/python_types.h>
+#include <foundation/tracing_bind.h>
 #include <pybind11/eigen.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
@@ -17,11 +18,13 @@ void AddScoreType(py::module& m, const std::string& name) {
 }
 
 PYBIND11_MODULE(pyrobust, m) {
+  foundation::AddTracingBindings(m);
   AddScoreType<Line::Type>(m, "Line");
   AddScoreType<Eigen::Matrix3d>(m, "Matrix3d");
   AddScoreType<Eigen::Matrix4d>(m, "Matrix4d");
   AddScoreType<Eigen::Matrix<double, 3, 4>>(m, "Matrix34d");
   AddScoreType<Eigen::Vector3d>(m, "Vector3d");
+  AddScoreType<Eigen::Vector4d>(m, "Vector4d");
 
   py::class_<RobustEstimatorParams>(m, "RobustEstimatorParams")
       .def(py::init())
@@ -47,6 +50,8 @@ PYBIND11_MODULE(pyrobust, m) {
         py::call_guard<py::gil_scoped_release>());
   m.def("ransac_similarity", robust::RANSACSimilarity,
         py::call_guard<py::gil_scoped_release>());
+  m.def("ransac_plane", robust::RANSACPlane,
+        py::call_guard<py::gil_scoped_release>());
 
   py::enum_<RansacType>(m, "RansacType")
       .value("RANSAC", RansacType::RANSAC)
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <foundation/tracing.h>
+
 #include <Eigen/Eigen>
 #include <algorithm>
 #include <random>
@@ -38,11 +40,13 @@ template <class SCORING, class MODEL>
 ScoreInfo<typename MODEL::Type> Estimate(
     const std::vector<typename MODEL::Data>& samples, const SCORING& scorer,
     const RobustEstimatorParams& params) {
+  OPENSFM_TRACE_SCOPE("robust", "Estimate");
   // For now, we use this default one, we could be extended to PROSAC sampling
   RandomSamplesGenerator<std::mt19937> random_generator;
 
   ScoreInfo<typename MODEL::Type> best_score;
   bool should_stop = false;
+  int hypotheses = 0;
   for (int i = 0; i < params.iterations && !should_stop; ++i) {
     // Generate and compute some models
     const auto random_samples = random_generator.GetRandomSamples<MODEL>(
@@ -53,6 +57,7 @@ ScoreInfo<typename MODEL::Type> Estimate(
 
     // Compute model's errors for each generated model
     for (int j = 0; j < models_count && !should_stop; ++j) {
+      ++hypotheses;
       auto errors =
           MODEL::EvaluateModel(models[j], samples.begin(), samples.end());
 
@@ -113,6 +118,8 @@ ScoreInfo<typename MODEL::Type> Estimate(
       should_stop = ShouldStop<MODEL>(params, best_score, samples.size(), i);
     }
   }
+  OPENSFM_TRACE_COUNTER("robust", "samples", samples.size());
+  OPENSFM_TRACE_COUNTER("robust", "hypotheses", hypotheses);
   return best_score;
 }
 
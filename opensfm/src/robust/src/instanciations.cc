@@ -117,4 +117,27 @@ ScoreInfo<Similarity::Type> RANSACSimilarity(
   return RunEstimation<Similarity>(samples, threshold, parameters, ransac_type);
 }
 
+ScoreInfo<Plane::Type> RANSACPlane(
+    const Eigen::Matrix<double, -1, 3>& points,
+    const Eigen::Matrix<double, -1, 3>& directions, double threshold,
+    double direction_threshold, const RobustEstimatorParams& parameters,
+    const RansacType& ransac_type) {
+  if (!(direction_threshold > 0.0)) {
+    throw std::runtime_error("Direction threshold must be positive.");
+  }
+
+  std::vector<Plane::Data> samples(points.rows() + directions.rows());
+  for (int i = 0; i < points.rows(); ++i) {
+    samples[i].value = points.row(i);
+  }
+  const double angle_scale = threshold / direction_threshold;
+  for (int i = 0; i < directions.rows(); ++i) {
+    auto& sample = samples[points.rows() + i];
+    sample.value = directions.row(i).normalized();
+    sample.is_direction = true;
+    sample.angle_scale = angle_scale;
+  }
+  return RunEstimation<Plane>(samples, threshold, parameters, ransac_type);
+}
+
 }  // namespace robust
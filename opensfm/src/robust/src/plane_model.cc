@@ -0,0 +1,3 @@
+#include "robust/plane_model.h"
+
+const int Plane::MINIMAL_SAMPLES;
@@ -6,6 +6,7 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace py = pybind11;
 namespace sfm {
@@ -65,6 +66,11 @@ class BAHelpers {
       const map::GroundControlPoint& point,
       const std::unordered_map<map::ShotId, map::Shot>& shots,
       Vec3d& coordinates);
+  // Replace the reprojection errors of the bundled landmarks by the ones
+  // computed by the bundle adjustment
+  static void ReprojectionErrorsToMap(
+      const bundle::BundleAdjuster& bundle_adjuster,
+      const std::vector<map::Landmark*>& landmarks, map::Map& output_map);
 
   static void AlignmentConstraints(
       const map::Map& map, const py::dict& config,
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <foundation/types.h>
+#include <map/defines.h>
+#include <map/map.h>
+#include <map/tracks_manager.h>
+#include <pybind11/pybind11.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace sfm::global_sfm {
+
+/* Relative motion between two shots : a point X in the frame of the first
+ * shot is R * X + t in the frame of the second one. The translation only
+ * gives the direction of the baseline, and is of unit norm. */
+struct RelativePose {
+  map::ShotId shot_id1;
+  map::ShotId shot_id2;
+  Mat3d rotation;
+  Vec3d translation;
+  int inliers{0};
+};
+
+struct Parameters {
+  // Relative poses estimation
+  double relative_pose_threshold{0.004};
+  int relative_pose_iterations{1000};
+  int min_inliers{20};
+
+  // Rotation and translation averaging
+  int averaging_iterations{20};
+
+  // Tracks triangulation
+  double triangulation_threshold{0.006};
+  double triangulation_min_angle{1.0 * M_PI / 180.0};
+  double triangulation_min_depth{0.001};
+
+  int num_threads{1};
+};
+
+// RANSAC relative poses of the given pairs of shots of the map, computed in
+// parallel. Pairs with less than 'min_inliers' inliers are dropped.
+std::vector<RelativePose> ComputeRelativePoses(
+    const map::Map& map, const map::TracksManager& tracks_manager,
+    const std::vector<std::pair<map::ShotId, map::ShotId>>& pairs,
+    const Parameters& parameters);
+
+// World to camera rotations of the shots of the largest connected component
+// of the view graph, by L1 iteratively reweighted least squares. Rotations
+// are initialized from the maximum spanning tree of the graph (weighted by
+// the number of inliers), whose most connected shot gets the identity.
+std::unordered_map<map::ShotId, Mat3d> AverageRotations(
+    const std::vector<RelativePose>& relative_poses, int iterations);
+
+// Optical centers of the shots of the largest connected component of the
+// view graph having a rotation, by L1 iteratively reweighted least squares
+// of the baselines errors, with baselines of length at least one (as in
+// Least Unsquared Deviations). The most connected shot is at the origin, and
+// baselines are then rescaled to unit length on average.
+std::unordered_map<map::ShotId, Vec3d> AverageTranslations(
+    const std::vector<RelativePose>& relative_poses,
+    const std::unordered_map<map::ShotId, Mat3d>& rotations, int iterations);
+
+// Triangulate the tracks seen by at least two shots of the map as landmarks,
+// in parallel. Returns the number of landmarks created.
+int TriangulateTracks(map::Map& map, const map::TracksManager& tracks_manager,
+                      const Parameters& parameters);
+
+// Read the parameters from an OpenSfM config dictionary
+Parameters ParametersFromConfig(const py::dict& config);
+
+struct Report {
+  int num_pairs{0};
+  int num_relative_poses{0};
+  int num_landmarks{0};
+  std::vector<map::ShotId> removed_shots;
+
+  // Seconds spent in each step
+  double relative_poses_time{0.0};
+  double rotation_averaging_time{0.0};
+  double translation_averaging_time{0.0};
+  double triangulation_time{0.0};
+};
+
+// Global SfM : set the poses of all the shots of the map at once from
+// the relative poses of the given pairs (or of all pairs of shots sharing
+// enough tracks if none are given), then triangulate the tracks. Shots
+// that can't be reached from the view graph are removed from the map.
+Report GlobalReconstruction(
+    map::Map& map, const map::TracksManager& tracks_manager,
+    const std::vector<std::pair<map::ShotId, map::ShotId>>& pairs,
+    const Parameters& parameters);
+}  // namespace sfm::global_sfm
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <geometry/similarity.h>
+#include <map/map.h>
+
+#include <vector>
+
+namespace sfm::merging {
+
+struct Parameters {
+  // RANSAC threshold on the distance between the common landmarks, once
+  // aligned (in the units of the reference map)
+  double threshold{1.0};
+  int ransac_iterations{100};
+
+  // Minimum number of common landmarks to try an alignment, and of inliers
+  // of the similarity to merge
+  int min_common_landmarks{7};
+  int min_inliers{10};
+
+  // A shot whose rig instance is already in the reference map only gets
+  // merged if both maps agree on the instance pose : within 'threshold' for
+  // its position, and within this angle (radians) for its orientation
+  double max_instance_angle{0.05};
+
+  int num_threads{1};
+};
+
+struct Alignment {
+  bool success{false};
+  int num_common_landmarks{0};
+  int num_inliers{0};
+
+  // Brings the aligned map in the reference map frame
+  geometry::Similarity similarity;
+};
+
+// Robustly estimate the similarity that brings 'to_align' onto 'reference',
+// from their landmarks having the same ID
+Alignment AlignMaps(const map::Map& reference, const map::Map& to_align,
+                    const Parameters& parameters);
+
+// Move 'to_merge' in the frame of 'reference' with a similarity, and copy the
+// cameras, rigs, shots and landmarks 'reference' doesn't have, along with the
+// observations of the copied shots. Shots of rig instances 'reference'
+// already has are attached to them, keeping their pose, or skipped if the
+// maps disagree on it. Returns the number of skipped shots.
+int MergeMap(const geometry::Similarity& similarity, map::Map& to_merge,
+             map::Map& reference, const Parameters& parameters);
+
+// Merge 'to_merge' into 'reference' if they can be aligned. Returns whether
+// the merge happened, 'to_merge' being untouched otherwise.
+bool MergeTwoMaps(map::Map& to_merge, map::Map& reference,
+                  const Parameters& parameters);
+
+/* Greedily merge maps sharing landmarks. Each map is taken in turn as a
+ * reference, and the following maps that can be aligned to it are merged
+ * into it, until no more can be. Alignments against a reference are computed
+ * in parallel. Returns groups of indices of merged maps, the first one being
+ * the map that received the others. */
+std::vector<std::vector<int>> MergeMaps(const std::vector<map::Map*>& maps,
+                                        const Parameters& parameters);
+}  // namespace sfm::merging
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <foundation/types.h>
+#include <map/defines.h>
+#include <map/map.h>
+#include <map/tracks_manager.h>
+#include <pybind11/pybind11.h>
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace sfm::online_sfm {
+
+struct Parameters {
+  // Number of most recent frames optimized together by the windowed bundle
+  // adjustment. Matches to older frames are ignored.
+  int window_size{10};
+
+  // Two-view initialization
+  double relative_pose_threshold{0.004};
+  int bootstrap_min_inliers{20};
+
+  // Resection of the frames against the landmarks
+  double resection_threshold{0.004};
+  int resection_min_inliers{10};
+
+  // Tracks triangulation
+  double triangulation_threshold{0.006};
+  double triangulation_min_angle{1.0 * M_PI / 180.0};
+  double triangulation_min_depth{0.001};
+
+  // Windowed bundle adjustment
+  int bundle_iterations{10};
+  std::string loss_function{"SoftLOneLoss"};
+  double loss_function_threshold{1.0};
+  bool bundle_analytic_derivatives{true};
+
+  int num_threads{1};
+};
+
+// Read the parameters from an OpenSfM config dictionary
+Parameters ParametersFromConfig(const py::dict& config);
+
+struct FrameReport {
+  map::ShotId shot_id;
+  bool reconstructed{false};
+  int num_tracks{0};
+  int num_resection_points{0};
+  int num_resection_inliers{0};
+  int num_new_landmarks{0};
+  int num_window_shots{0};
+
+  // Set when no reconstructed frame is left in the window. The following
+  // frames are initialized again, as a new segment.
+  bool tracking_lost{false};
+  // Segment of the frame, also stored as the 'merge_cc' of its shot
+  int segment{0};
+
+  // Seconds spent in each step
+  double tracks_time{0.0};
+  double resection_time{0.0};
+  double triangulation_time{0.0};
+  double bundle_time{0.0};
+};
+
+/* Sequential reconstruction of video-like captures, one frame at a time.
+ *
+ * Each new frame gets its matches to the previous frames chained into tracks
+ * of the tracks manager. The first frames are used to initialize the map from
+ * a relative pose, once it has enough parallax. Following frames are then
+ * resected against the landmarks, their new tracks triangulated, and the
+ * last 'window_size' frames are optimized by a bundle adjustment where the
+ * older frames seeing the same landmarks are fixed.
+ *
+ * Only the last 'window_size' frames are kept besides the map and the tracks
+ * manager, so that memory and time per frame are bounded. Frames that can't
+ * be reconstructed are removed from the map when leaving the window.
+ *
+ * When tracking is lost, that is when no reconstructed frame is left in the
+ * window, the remaining frames are detached from the existing landmarks and
+ * the map is initialized again from them. Each initialization starts a new
+ * segment, with its own unrelated gauge, identified by the 'merge_cc' of its
+ * shots. */
+class OnlineReconstruction {
+ public:
+  OnlineReconstruction(map::Map& map, map::TracksManager& tracks_manager,
+                       const Parameters& parameters);
+
+  // Add the next frame. Its shot must be in the map, with a camera and a rig
+  // instance. 'features' are its (x, y, scale) normalized keypoints and
+  // 'colors' their colors. 'matches' are, per previous frame, the pairs of
+  // (previous frame feature, this frame feature) indices.
+  FrameReport AddFrame(const map::ShotId& shot_id, const MatX3d& features,
+                       const MatX3i& colors,
+                       const std::unordered_map<map::ShotId, MatX2i>& matches);
+
+  bool IsInitialized() const { return initialized_; }
+
+  // Segment of the next reconstructed frames
+  int GetSegment() const { return segment_; }
+
+  // Reconstructed frames optimized by the windowed bundle, oldest first
+  std::vector<map::ShotId> GetWindow() const;
+
+ private:
+  struct Frame {
+    map::ShotId shot_id;
+    MatX3d features;
+    MatX3i colors;
+    std::vector<map::TrackId> tracks;  // empty when not tracked
+    bool reconstructed{false};
+  };
+
+  int AddTracks(Frame& frame,
+                const std::unordered_map<map::ShotId, MatX2i>& matches);
+  bool Bootstrap(Frame& frame, FrameReport& report);
+  bool Resect(Frame& frame, FrameReport& report);
+  int Triangulate(const Frame& frame);
+  void BundleWindow();
+  void RemoveFrame(const Frame& frame);
+  void StartSegment();
+
+  map::Observation FrameObservation(const Frame& frame, int feature) const;
+  Frame* FindFrame(const map::ShotId& shot_id);
+
+  map::Map& map_;
+  map::TracksManager& tracks_manager_;
+  const Parameters parameters_;
+
+  bool initialized_{false};
+  int segment_{0};
+  int next_track_id_{0};
+  std::deque<Frame> frames_;
+};
+}  // namespace sfm::online_sfm
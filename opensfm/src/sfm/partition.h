@@ -0,0 +1,65 @@
+#pragma once
+
+#include <map/defines.h>
+#include <map/tracks_manager.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace sfm::partition {
+
+/* Undirected weighted graph in compressed sparse row format : the neighbors
+ * of vertex i are adjacency[offsets[i]] ... adjacency[offsets[i + 1] - 1]. */
+struct Graph {
+  std::vector<int> offsets{0};
+  std::vector<int> adjacency;
+  std::vector<int> edge_weights;
+  std::vector<int> vertex_weights;
+
+  int NumVertices() const { return vertex_weights.size(); }
+  int TotalWeight() const;
+};
+
+struct Parameters {
+  // Maximum number of shots of a cluster, overlap included
+  int max_cluster_size{80};
+  // Number of shots added to each cluster from its neighbors, as a fraction
+  // of the cluster size
+  double overlap{0.3};
+  // Shots sharing less tracks than this aren't connected
+  int min_common_tracks{20};
+
+  int num_threads{1};
+};
+
+struct Partition {
+  // Cluster of each shot, without overlap
+  std::unordered_map<map::ShotId, int> labels;
+  // Shots of each cluster, overlap included
+  std::vector<std::vector<map::ShotId>> clusters;
+};
+
+// Graph of the given shots, weighted by their number of common tracks
+Graph BuildCovisibilityGraph(const map::TracksManager& tracks_manager,
+                             const std::vector<map::ShotId>& shots,
+                             int min_common_tracks);
+
+// Split the vertices of the graph into 'num_parts' parts of balanced weight
+// minimizing the weight of the cut edges, by multilevel recursive bisection
+// (heavy edge matching coarsening, greedy growing and boundary refinement).
+// Returns the part of each vertex.
+std::vector<int> PartitionGraph(const Graph& graph, int num_parts);
+
+// Grow a part with the 'count' vertices the most connected to it, one at a
+// time, so that the overlap follows the connectivity of the graph. Returns
+// the added vertices.
+std::vector<int> GrowPart(const Graph& graph, const std::vector<int>& part,
+                          int count);
+
+// Split the shots (all the shots of the tracks manager if none are given)
+// into clusters of covisible shots, so that clusters with their overlap have
+// at most 'max_cluster_size' shots.
+Partition PartitionShots(const map::TracksManager& tracks_manager,
+                         const std::vector<map::ShotId>& shots,
+                         const Parameters& parameters);
+}  // namespace sfm::partition
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <map/map.h>
+#include <pybind11/pybind11.h>
+
+#include <string>
+#include <unordered_set>
+
+namespace py = pybind11;
+
+namespace sfm::pose_refinement {
+
+struct Parameters {
+  int max_iterations{10};
+
+  // Robust loss of the projection and depth residuals
+  std::string loss_function{"SoftLOneLoss"};
+  double loss_function_threshold{1.0};
+
+  // Add a prior on the position of the instances, from the average GPS of
+  // their shots
+  bool use_gps{false};
+
+  // An instance has converged once its step is smaller than this fraction of
+  // its translation norm (plus one)
+  double step_tolerance{1e-10};
+
+  // An instance has also converged once the largest component of the
+  // gradient of its cost is below this tolerance
+  double gradient_tolerance{1e-10};
+
+  int num_threads{1};
+};
+
+// Read the parameters from an OpenSfM config dictionary
+Parameters ParametersFromConfig(const py::dict& config);
+
+struct Statistics {
+  int num_instances{0};
+  int num_converged{0};
+
+  // Instances with less than three observations, or a degenerate geometry,
+  // which are left untouched
+  int num_skipped{0};
+
+  // Total number of iterations over all the instances
+  int num_iterations{0};
+
+  // Sum over the refined instances of their cost
+  double initial_cost{0.0};
+  double final_cost{0.0};
+};
+
+/* Refine the pose of the rig instances of some shots, with the landmarks,
+ * cameras and rig cameras fixed. Each instance is solved independently (and
+ * in parallel) by a Levenberg-Marquardt over its 6 degrees of freedom, using
+ * the observations of all its shots. Residuals are the same as the bundle
+ * adjustment ones : projection errors (or bearing errors for spherical
+ * cameras) scaled by the observation scale, depth priors of the observations
+ * and optionally GPS priors. The robust loss is applied by reweighting. */
+Statistics RefineShotPoses(map::Map& map,
+                           const std::unordered_set<map::ShotId>& shot_ids,
+                           const Parameters& parameters);
+}  // namespace sfm::pose_refinement
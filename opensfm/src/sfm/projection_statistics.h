@@ -0,0 +1,74 @@
+#pragma once
+
+#include <map/map.h>
+#include <map/tracks_manager.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace sfm::projection_statistics {
+
+struct Parameters {
+  // Observations with a larger error (in pixels) are outliers and are ignored
+  double pixel_cutoff{4.0};
+
+  int histogram_bins{30};
+
+  // Number of residual grid buckets along each image axis (twice as many
+  // horizontally for spherical cameras)
+  int grid_buckets{40};
+
+  int num_threads{1};
+};
+
+// Same as numpy.histogram : equal bins over the range of the values, the last
+// one including its upper edge
+struct Histogram {
+  std::vector<int> counts;
+  std::vector<double> edges;
+};
+Histogram ComputeHistogram(const std::vector<double>& values, int bins);
+
+struct CameraStatistics {
+  // Average errors over the inlier observations of the camera shots
+  int count{0};
+  double mean_normalized{0.0};
+  double mean_pixels{0.0};
+  double mean_angular{0.0};
+
+  // Sum and count of the scale-normalized errors of the inlier observations
+  // falling in each bucket of the image (row-major, 'grid_width' columns).
+  // Observations with an undefined angular error are counted here too.
+  int grid_width{0};
+  int grid_height{0};
+  std::vector<Vec2d> grid_errors;
+  std::vector<int> grid_counts;
+};
+
+struct Statistics {
+  // Average errors over all the inlier observations, or -1 if there's none
+  int count{0};
+  double mean_normalized{-1.0};
+  double mean_pixels{-1.0};
+  double mean_angular{-1.0};
+
+  // Empty if there's no inlier observation
+  Histogram histogram_normalized;
+  Histogram histogram_pixels;
+  Histogram histogram_angular;
+
+  std::unordered_map<map::CameraId, CameraStatistics> cameras;
+};
+
+/* Reprojection statistics of the landmarks of several maps, seen by the
+ * observations of a tracks manager, in a single pass over the observations
+ * (in parallel over the shots). Errors are computed as in
+ * Map::ComputeReprojectionErrors : 'normalized' is the error divided by the
+ * observation scale, 'pixels' is the error scaled by the image size, and
+ * 'angular' the angle between the bearing and the landmark direction.
+ * Observations above the pixel cutoff, or with an undefined angular error,
+ * are outliers. */
+Statistics ComputeProjectionStatistics(
+    const std::vector<const map::Map*>& maps,
+    const map::TracksManager& tracks_manager, const Parameters& parameters);
+}  // namespace sfm::projection_statistics
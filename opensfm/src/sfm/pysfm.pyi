@@ -10,16 +10,29 @@
 # Ignore errors for [5] global variable types and [24] untyped generics.
 # pyre-ignore-all-errors[5,24]
 
+import numpy
 import opensfm.pybundle
 import opensfm.pygeometry
 import opensfm.pymap
 from typing import *
 __all__  = [
 "BAHelpers",
+"OnlineReconstruction",
 "add_connections",
+"clear_tracing",
+"compute_projection_statistics",
 "count_tracks_per_shot",
+"get_tracing_events",
+"global_reconstruction",
+"is_tracing_enabled",
+"merge_maps",
+"merge_two_maps",
+"partition_shots",
 "realign_maps",
-"remove_connections"
+"refine_landmarks",
+"refine_shot_poses",
+"remove_connections",
+"set_tracing_enabled"
 ]
 class BAHelpers:
     @staticmethod
@@ -36,7 +49,24 @@ class BAHelpers:
     def detect_alignment_constraints(arg0: opensfm.pymap.Map, arg1: dict, arg2: List[opensfm.pymap.GroundControlPoint]) -> str: ...
     @staticmethod
     def shot_neighborhood_ids(arg0: opensfm.pymap.Map, arg1: str, arg2: int, arg3: int, arg4: int) -> Tuple[Set[str], Set[str]]: ...
+class OnlineReconstruction:
+    def __init__(self, map: opensfm.pymap.Map, tracks_manager: opensfm.pymap.TracksManager, config: dict) -> None: ...
+    def add_frame(self, shot_id: str, features: numpy.ndarray, colors: numpy.ndarray, matches: Dict[str, numpy.ndarray]) -> dict: ...
+    def get_segment(self) -> int: ...
+    def get_window(self) -> List[str]: ...
+    def is_initialized(self) -> bool: ...
 def add_connections(arg0: opensfm.pymap.TracksManager, arg1: str, arg2: List[str]) -> None:...
+def clear_tracing() -> None:...
+def compute_projection_statistics(maps: List[opensfm.pymap.Map], tracks_manager: opensfm.pymap.TracksManager, pixel_cutoff: float = 4.0, histogram_bins: int = 30, grid_buckets: int = 40, num_threads: int = 1) -> dict:...
 def count_tracks_per_shot(arg0: opensfm.pymap.TracksManager, arg1: List[str], arg2: List[str]) -> Dict[str, int]:...
-def realign_maps(arg0: opensfm.pymap.Map, arg1: opensfm.pymap.Map, arg2: bool) -> None:...
+def get_tracing_events() -> str:...
+def global_reconstruction(map: opensfm.pymap.Map, tracks_manager: opensfm.pymap.TracksManager, pairs: List[Tuple[str, str]], config: dict) -> dict:...
+def is_tracing_enabled() -> bool:...
+def merge_maps(maps: List[opensfm.pymap.Map], threshold: float = 1.0, num_threads: int = 1) -> List[List[int]]:...
+def merge_two_maps(to_merge: opensfm.pymap.Map, reference: opensfm.pymap.Map, threshold: float = 1.0, num_threads: int = 1) -> bool:...
+def partition_shots(tracks_manager: opensfm.pymap.TracksManager, shots: List[str], max_cluster_size: int, overlap: float, min_common_tracks: int, num_threads: int) -> Tuple[Dict[str, int], List[List[str]]]:...
+def realign_maps(reference: opensfm.pymap.Map, to_align: opensfm.pymap.Map, update_points: bool, num_threads: int = 1) -> None:...
+def refine_landmarks(map: opensfm.pymap.Map, config: dict) -> dict:...
+def refine_shot_poses(map: opensfm.pymap.Map, shot_ids: Set[str], config: dict) -> dict:...
 def remove_connections(arg0: opensfm.pymap.TracksManager, arg1: str, arg2: List[str]) -> None:...
+def set_tracing_enabled(arg0: bool) -> None:...
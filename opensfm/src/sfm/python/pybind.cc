@@ -1,16 +1,25 @@
 #include <foundation/python_types.h>
+#include <foundation/tracing_bind.h>
 #include <map/observation.h>
 #include <map/tracks_manager.h>
 #include <pybind11/eigen.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <sfm/ba_helpers.h>
+#include <sfm/global_sfm.h>
+#include <sfm/merging.h>
+#include <sfm/online_sfm.h>
+#include <sfm/partition.h>
+#include <sfm/pose_refinement.h>
+#include <sfm/projection_statistics.h>
 #include <sfm/retriangulation.h>
+#include <sfm/structure_refinement.h>
 #include <sfm/tracks_helpers.h>
 
 #include <optional>
 
 PYBIND11_MODULE(pysfm, m) {
+  foundation::AddTracingBindings(m);
   py::module::import("opensfm.pymap");
   py::module::import("opensfm.pygeometry");
   py::module::import("opensfm.pybundle");
@@ -32,5 +41,229 @@ PYBIND11_MODULE(pysfm, m) {
       .def_static("add_gcp_to_bundle", &sfm::BAHelpers::AddGCPToBundle);
 
   m.def("realign_maps", &sfm::retriangulation::RealignMaps,
-        py::call_guard<py::gil_scoped_release>());
+        py::arg("reference"), py::arg("to_align"), py::arg("update_points"),
+        py::arg("num_threads") = 1, py::call_guard<py::gil_scoped_release>());
+
+  m.def(
+      "merge_two_maps",
+      [](map::Map& to_merge, map::Map& reference, double threshold,
+         int num_threads) {
+        sfm::merging::Parameters parameters;
+        parameters.threshold = threshold;
+        parameters.num_threads = num_threads;
+        return sfm::merging::MergeTwoMaps(to_merge, reference, parameters);
+      },
+      py::arg("to_merge"), py::arg("reference"), py::arg("threshold") = 1.0,
+      py::arg("num_threads") = 1, py::call_guard<py::gil_scoped_release>());
+  m.def(
+      "merge_maps",
+      [](const std::vector<map::Map*>& maps, double threshold,
+         int num_threads) {
+        sfm::merging::Parameters parameters;
+        parameters.threshold = threshold;
+        parameters.num_threads = num_threads;
+        return sfm::merging::MergeMaps(maps, parameters);
+      },
+      py::arg("maps"), py::arg("threshold") = 1.0, py::arg("num_threads") = 1,
+      py::call_guard<py::gil_scoped_release>());
+
+  m.def(
+      "refine_landmarks",
+      [](map::Map& map, const py::dict& config) {
+        const auto parameters =
+            sfm::structure_refinement::ParametersFromConfig(config);
+        sfm::structure_refinement::Statistics statistics;
+        {
+          py::gil_scoped_release release;
+          statistics =
+              sfm::structure_refinement::RefineLandmarks(map, parameters);
+        }
+        py::dict report;
+        report["num_points"] = statistics.num_points;
+        report["num_converged"] = statistics.num_converged;
+        report["num_skipped"] = statistics.num_skipped;
+        report["num_iterations"] = statistics.num_iterations;
+        report["initial_cost"] = statistics.initial_cost;
+        report["final_cost"] = statistics.final_cost;
+        return report;
+      },
+      py::arg("map"), py::arg("config"));
+
+  m.def(
+      "refine_shot_poses",
+      [](map::Map& map, const std::unordered_set<map::ShotId>& shot_ids,
+         const py::dict& config) {
+        const auto parameters =
+            sfm::pose_refinement::ParametersFromConfig(config);
+        sfm::pose_refinement::Statistics statistics;
+        {
+          py::gil_scoped_release release;
+          statistics =
+              sfm::pose_refinement::RefineShotPoses(map, shot_ids, parameters);
+        }
+        py::dict report;
+        report["num_instances"] = statistics.num_instances;
+        report["num_converged"] = statistics.num_converged;
+        report["num_skipped"] = statistics.num_skipped;
+        report["num_iterations"] = statistics.num_iterations;
+        report["initial_cost"] = statistics.initial_cost;
+        report["final_cost"] = statistics.final_cost;
+        return report;
+      },
+      py::arg("map"), py::arg("shot_ids"), py::arg("config"));
+
+  m.def(
+      "compute_projection_statistics",
+      [](const std::vector<const map::Map*>& maps,
+         const map::TracksManager& tracks_manager, double pixel_cutoff,
+         int histogram_bins, int grid_buckets, int num_threads) {
+        sfm::projection_statistics::Parameters parameters;
+        parameters.pixel_cutoff = pixel_cutoff;
+        parameters.histogram_bins = histogram_bins;
+        parameters.grid_buckets = grid_buckets;
+        parameters.num_threads = num_threads;
+        sfm::projection_statistics::Statistics statistics;
+        {
+          py::gil_scoped_release release;
+          statistics = sfm::projection_statistics::ComputeProjectionStatistics(
+              maps, tracks_manager, parameters);
+        }
+
+        // Histograms as returned by numpy.histogram
+        const auto histogram =
+            [](const sfm::projection_statistics::Histogram& histogram) {
+              return py::make_tuple(
+                  foundation::py_array_from_data(histogram.counts.data(),
+                                                 histogram.counts.size()),
+                  foundation::py_array_from_data(histogram.edges.data(),
+                                                 histogram.edges.size()));
+            };
+        py::dict report;
+        report["count"] = statistics.count;
+        report["mean_normalized"] = statistics.mean_normalized;
+        report["mean_pixels"] = statistics.mean_pixels;
+        report["mean_angular"] = statistics.mean_angular;
+        report["histogram_normalized"] =
+            histogram(statistics.histogram_normalized);
+        report["histogram_pixels"] = histogram(statistics.histogram_pixels);
+        report["histogram_angular"] = histogram(statistics.histogram_angular);
+
+        py::dict cameras;
+        for (const auto& camera_it : statistics.cameras) {
+          const auto& camera = camera_it.second;
+          py::dict camera_report;
+          camera_report["count"] = camera.count;
+          camera_report["mean_normalized"] = camera.mean_normalized;
+          camera_report["mean_pixels"] = camera.mean_pixels;
+          camera_report["mean_angular"] = camera.mean_angular;
+          camera_report["grid_errors"] = foundation::py_array_from_data(
+              camera.grid_errors.data()->data(), camera.grid_height,
+              camera.grid_width, 2);
+          camera_report["grid_counts"] = foundation::py_array_from_data(
+              camera.grid_counts.data(), camera.grid_height,
+              camera.grid_width);
+          cameras[py::str(camera_it.first)] = camera_report;
+        }
+        report["cameras"] = cameras;
+        return report;
+      },
+      py::arg("maps"), py::arg("tracks_manager"), py::arg("pixel_cutoff") = 4.0,
+      py::arg("histogram_bins") = 30, py::arg("grid_buckets") = 40,
+      py::arg("num_threads") = 1);
+
+  m.def(
+      "global_reconstruction",
+      [](map::Map& map, const map::TracksManager& tracks_manager,
+         const std::vector<std::pair<map::ShotId, map::ShotId>>& pairs,
+         const py::dict& config) {
+        const auto parameters =
+            sfm::global_sfm::ParametersFromConfig(config);
+        sfm::global_sfm::Report reconstruction;
+        {
+          py::gil_scoped_release release;
+          reconstruction = sfm::global_sfm::GlobalReconstruction(
+              map, tracks_manager, pairs, parameters);
+        }
+        py::dict report;
+        report["wall_times"] = py::dict();
+        report["wall_times"]["relative_poses"] =
+            reconstruction.relative_poses_time;
+        report["wall_times"]["rotation_averaging"] =
+            reconstruction.rotation_averaging_time;
+        report["wall_times"]["translation_averaging"] =
+            reconstruction.translation_averaging_time;
+        report["wall_times"]["triangulation"] =
+            reconstruction.triangulation_time;
+        report["num_pairs"] = reconstruction.num_pairs;
+        report["num_relative_poses"] = reconstruction.num_relative_poses;
+        report["num_shots"] = map.NumberOfShots();
+        report["removed_shots"] = reconstruction.removed_shots;
+        report["num_landmarks"] = reconstruction.num_landmarks;
+        return report;
+      },
+      py::arg("map"), py::arg("tracks_manager"), py::arg("pairs"),
+      py::arg("config"));
+
+  m.def(
+      "partition_shots",
+      [](const map::TracksManager& tracks_manager,
+         const std::vector<map::ShotId>& shots, int max_cluster_size,
+         double overlap, int min_common_tracks, int num_threads) {
+        sfm::partition::Parameters parameters;
+        parameters.max_cluster_size = max_cluster_size;
+        parameters.overlap = overlap;
+        parameters.min_common_tracks = min_common_tracks;
+        parameters.num_threads = num_threads;
+        const auto partition = sfm::partition::PartitionShots(
+            tracks_manager, shots, parameters);
+        return std::make_pair(partition.labels, partition.clusters);
+      },
+      py::arg("tracks_manager"), py::arg("shots"),
+      py::arg("max_cluster_size"), py::arg("overlap"),
+      py::arg("min_common_tracks"), py::arg("num_threads"),
+      py::call_guard<py::gil_scoped_release>());
+
+  py::class_<sfm::online_sfm::OnlineReconstruction>(m, "OnlineReconstruction")
+      .def(py::init([](map::Map& map, map::TracksManager& tracks_manager,
+                       const py::dict& config) {
+             return std::make_unique<sfm::online_sfm::OnlineReconstruction>(
+                 map, tracks_manager,
+                 sfm::online_sfm::ParametersFromConfig(config));
+           }),
+           py::arg("map"), py::arg("tracks_manager"), py::arg("config"),
+           py::keep_alive<1, 2>(), py::keep_alive<1, 3>())
+      .def(
+          "add_frame",
+          [](sfm::online_sfm::OnlineReconstruction& self,
+             const map::ShotId& shot_id, const MatX3d& features,
+             const MatX3i& colors,
+             const std::unordered_map<map::ShotId, MatX2i>& matches) {
+            sfm::online_sfm::FrameReport frame;
+            {
+              py::gil_scoped_release release;
+              frame = self.AddFrame(shot_id, features, colors, matches);
+            }
+            py::dict report;
+            report["shot_id"] = frame.shot_id;
+            report["reconstructed"] = frame.reconstructed;
+            report["num_tracks"] = frame.num_tracks;
+            report["num_resection_points"] = frame.num_resection_points;
+            report["num_resection_inliers"] = frame.num_resection_inliers;
+            report["num_new_landmarks"] = frame.num_new_landmarks;
+            report["num_window_shots"] = frame.num_window_shots;
+            report["tracking_lost"] = frame.tracking_lost;
+            report["segment"] = frame.segment;
+            report["wall_times"] = py::dict();
+            report["wall_times"]["tracks"] = frame.tracks_time;
+            report["wall_times"]["resection"] = frame.resection_time;
+            report["wall_times"]["triangulation"] = frame.triangulation_time;
+            report["wall_times"]["bundle"] = frame.bundle_time;
+            return report;
+          },
+          py::arg("shot_id"), py::arg("features"), py::arg("colors"),
+          py::arg("matches"))
+      .def("is_initialized",
+           &sfm::online_sfm::OnlineReconstruction::IsInitialized)
+      .def("get_segment", &sfm::online_sfm::OnlineReconstruction::GetSegment)
+      .def("get_window", &sfm::online_sfm::OnlineReconstruction::GetWindow);
 }
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <foundation/types.h>
+#include <geometry/camera.h>
+
+namespace sfm::refinement_helpers {
+
+// Observed point, or its bearing for spherical cameras, which is what the
+// bundle adjustment compares to the projection
+Vec3d ObservedTarget(const geometry::Camera& camera, const Vec2d& point);
+
+/* Unscaled residual of an observation of a point given in the camera
+ * coordinates, and its jacobian with respect to these coordinates. They're
+ * the same as the bundle adjustment ones : 2D projection errors with a zero
+ * third coordinate, or 3D bearing errors for spherical cameras. */
+void CameraResidual(geometry::ProjectionType projection_type,
+                    const VecXd& camera_parameters, const Vec3d& observed,
+                    const Vec3d& camera_point, Vec3d* residual,
+                    Mat3d* jacobian);
+
+// Size of the residuals of a projection type
+int ResidualSize(geometry::ProjectionType projection_type);
+}  // namespace sfm::refinement_helpers
@@ -3,6 +3,10 @@
 #include <map/tracks_manager.h>
 
 namespace sfm::retriangulation {
+
+// Bring the shots, rig instances and cameras of 'to_align' in the frame of
+// 'reference', removing the shots 'reference' doesn't have. Landmarks are
+// optionally moved with the closest of their shots which is in 'reference'.
 void RealignMaps(const map::Map& reference, map::Map& to_align,
-                 bool update_points);
+                 bool update_points, int num_threads = 1);
 }  // namespace sfm::retriangulation
@@ -1,14 +1,19 @@
 #include <bundle/bundle_adjuster.h>
+#include <foundation/tracing.h>
 #include <foundation/types.h>
 #include <geometry/triangulation.h>
 #include <map/ground_control_points.h>
 #include <map/map.h>
+#include <pybind11/stl.h>
 #include <sfm/ba_helpers.h>
 
 #include <chrono>
 #include <cmath>
+#include <numeric>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "geo/geo.h"
 #include "map/defines.h"
@@ -120,6 +125,7 @@ py::tuple BAHelpers::BundleLocal(
         rig_camera_priors,
     const AlignedVector<map::GroundControlPoint>& gcp,
     const map::ShotId& central_shot_id, const py::dict& config) {
+  OPENSFM_TRACE_SCOPE("sfm", "BAHelpers::BundleLocal");
   py::dict report;
   const auto start = std::chrono::high_resolution_clock::now();
   auto neighborhood = ShotNeighborhood(
@@ -285,8 +291,9 @@ py::tuple BAHelpers::BundleLocal(
   for (auto* point : points) {
     const auto& pt = ba.GetPoint(point->id_);
     point->SetGlobalPos(pt.GetValue());
-    point->SetReprojectionErrors(pt.reprojection_errors);
   }
+  ReprojectionErrorsToMap(
+      ba, std::vector<map::Landmark*>(points.begin(), points.end()), map);
   const auto timer_teardown = std::chrono::high_resolution_clock::now();
   report["brief_report"] = ba.BriefReport();
   report["wall_times"] = py::dict();
@@ -304,6 +311,9 @@ py::tuple BAHelpers::BundleLocal(
                                                             timer_run)
           .count() /
       1000000.0;
+  report["wall_times"]["problem_setup"] = ba.GetProblemSetupTime();
+  report["wall_times"]["problem_teardown"] = ba.GetProblemTeardownTime();
+  report["memory_usage"] = ba.MemoryUsage();
   report["num_images"] = interior.size();
   report["num_interior_images"] = interior.size();
   report["num_boundary_images"] = boundary.size();
@@ -415,6 +425,7 @@ py::dict BAHelpers::BundleShotPoses(
     const std::unordered_map<map::RigCameraId, map::RigCamera>&
         rig_camera_priors,
     const py::dict& config) {
+  OPENSFM_TRACE_SCOPE("sfm", "BAHelpers::BundleShotPoses");
   py::dict report;
 
   constexpr auto fix_cameras = true;
@@ -581,6 +592,9 @@ py::dict BAHelpers::BundleShotPoses(
                                                             timer_run)
           .count() /
       1000000.0;
+  report["wall_times"]["problem_setup"] = ba.GetProblemSetupTime();
+  report["wall_times"]["problem_teardown"] = ba.GetProblemTeardownTime();
+  report["memory_usage"] = ba.MemoryUsage();
   return report;
 }
 
@@ -590,6 +604,7 @@ py::dict BAHelpers::Bundle(
     const std::unordered_map<map::RigCameraId, map::RigCamera>&
         rig_camera_priors,
     const AlignedVector<map::GroundControlPoint>& gcp, const py::dict& config) {
+  OPENSFM_TRACE_SCOPE("sfm", "BAHelpers::Bundle");
   py::dict report;
 
   auto ba = bundle::BundleAdjuster();
@@ -769,6 +784,9 @@ py::dict BAHelpers::Bundle(
                                                             timer_run)
           .count() /
       1000000.0;
+  report["wall_times"]["problem_setup"] = ba.GetProblemSetupTime();
+  report["wall_times"]["problem_teardown"] = ba.GetProblemTeardownTime();
+  report["memory_usage"] = ba.MemoryUsage();
   report["num_images"] = map.GetShots().size();
   report["num_points"] = map.GetLandmarks().size();
   report["num_reprojections"] = added_reprojections;
@@ -777,6 +795,7 @@ py::dict BAHelpers::Bundle(
 
 void BAHelpers::BundleToMap(const bundle::BundleAdjuster& bundle_adjuster,
                             map::Map& output_map, bool update_cameras) {
+  OPENSFM_TRACE_SCOPE("sfm", "BAHelpers::BundleToMap");
   // update cameras
   if (update_cameras) {
     for (auto& cam : output_map.GetCameras()) {
@@ -820,6 +839,8 @@ void BAHelpers::BundleToMap(const bundle::BundleAdjuster& bundle_adjuster,
   }
 
   // Update points
+  std::vector<map::Landmark*> landmarks;
+  landmarks.reserve(output_map.NumberOfLandmarks());
   for (auto& point : output_map.GetLandmarks()) {
     const auto& pt = bundle_adjuster.GetPoint(point.first);
     if (!pt.GetValue().allFinite()) {
@@ -827,7 +848,82 @@ void BAHelpers::BundleToMap(const bundle::BundleAdjuster& bundle_adjuster,
                                " has either NaN or INF values.");
     }
     point.second.SetGlobalPos(pt.GetValue());
-    point.second.SetReprojectionErrors(pt.reprojection_errors);
+    landmarks.push_back(&point.second);
+  }
+  ReprojectionErrorsToMap(bundle_adjuster, landmarks, output_map);
+}
+
+void BAHelpers::ReprojectionErrorsToMap(
+    const bundle::BundleAdjuster& bundle_adjuster,
+    const std::vector<map::Landmark*>& landmarks, map::Map& output_map) {
+  OPENSFM_TRACE_SCOPE("sfm", "BAHelpers::ReprojectionErrorsToMap");
+  std::unordered_map<const map::Landmark*, int> landmark_indexes;
+  landmark_indexes.reserve(landmarks.size());
+  for (const auto* landmark : landmarks) {
+    landmark_indexes.emplace(landmark, landmark_indexes.size());
+  }
+
+  // Resolve the landmark and the shot of each observation, looking each
+  // bundle point and shot up only once. There are no errors if they weren't
+  // computed, and the landmarks are only cleared then.
+  const auto& observations = bundle_adjuster.GetPointProjectionObservations();
+  const auto& errors = bundle_adjuster.GetReprojectionErrors();
+  std::unordered_map<const bundle::Point*, int> points_indexes;
+  std::unordered_map<const bundle::Shot*, map::Shot*> shots;
+  std::vector<int> observations_landmarks(errors.size());
+  std::vector<map::Shot*> observations_shots(errors.size());
+  std::vector<size_t> offsets(landmarks.size() + 1, 0);
+  for (size_t i = 0; i < errors.size(); ++i) {
+    const auto& observation = observations[i];
+    auto point_it = points_indexes.find(observation.point);
+    if (point_it == points_indexes.end()) {
+      const auto landmark_it = landmark_indexes.find(
+          &output_map.GetLandmark(observation.point->GetID()));
+      const int index = landmark_it == landmark_indexes.end()
+                            ? -1
+                            : landmark_it->second;
+      point_it = points_indexes.emplace(observation.point, index).first;
+    }
+    auto shot_it = shots.find(observation.shot);
+    if (shot_it == shots.end()) {
+      shot_it = shots
+                    .emplace(observation.shot,
+                             &output_map.GetShot(observation.shot->GetID()))
+                    .first;
+    }
+    observations_landmarks[i] = point_it->second;
+    observations_shots[i] = shot_it->second;
+    if (point_it->second >= 0) {
+      ++offsets[point_it->second + 1];
+    }
+  }
+
+  // Group the observations by landmark : the ones of landmarks[i] are
+  // grouped[offsets[i]] to grouped[offsets[i + 1] - 1]
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<size_t> grouped(offsets.back());
+  std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < errors.size(); ++i) {
+    if (observations_landmarks[i] >= 0) {
+      grouped[cursors[observations_landmarks[i]]++] = i;
+    }
+  }
+
+  // Each landmark is then written once, replacing its previous errors
+  const int num_landmarks = landmarks.size();
+#pragma omp parallel for num_threads(bundle_adjuster.GetNumThreads()) \
+    schedule(static, 1024)
+  for (int i = 0; i < num_landmarks; ++i) {
+    std::vector<map::Shot*> landmark_shots;
+    std::vector<VecMax3d> landmark_errors;
+    landmark_shots.reserve(offsets[i + 1] - offsets[i]);
+    landmark_errors.reserve(offsets[i + 1] - offsets[i]);
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j) {
+      landmark_shots.push_back(observations_shots[grouped[j]]);
+      landmark_errors.push_back(errors[grouped[j]]);
+    }
+    landmarks[i]->SetReprojectionErrors(std::move(landmark_shots),
+                                        std::move(landmark_errors));
   }
 }
 
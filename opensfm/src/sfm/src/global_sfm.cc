@@ -0,0 +1,565 @@
+#include <foundation/tracing.h>
+#include <geometry/triangulation.h>
+#include <pybind11/stl.h>
+#include <robust/instanciations.h>
+#include <sfm/global_sfm.h>
+
+#include <Eigen/Geometry>
+#include <Eigen/SparseCholesky>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <queue>
+#include <unordered_set>
+
+namespace {
+using RelativePose = sfm::global_sfm::RelativePose;
+
+// View graph restricted to its largest connected component, with shots
+// indexed from 0 and the most connected shot (by inliers) as root
+struct ViewGraph {
+  struct Edge {
+    int i;
+    int j;
+    const RelativePose* relative_pose;
+  };
+  std::vector<map::ShotId> shots;
+  std::vector<Edge> edges;
+  int root{0};
+};
+
+ViewGraph BuildViewGraph(const std::vector<RelativePose>& relative_poses,
+                         const std::unordered_set<map::ShotId>* allowed) {
+  std::unordered_map<map::ShotId, int> indexes;
+  std::vector<map::ShotId> shots;
+  std::vector<std::vector<std::pair<int, int>>> adjacency;
+  const auto index = [&](const map::ShotId& shot_id) {
+    const auto it = indexes.emplace(shot_id, shots.size());
+    if (it.second) {
+      shots.push_back(shot_id);
+      adjacency.emplace_back();
+    }
+    return it.first->second;
+  };
+  const int num_relative_poses = relative_poses.size();
+  for (int k = 0; k < num_relative_poses; ++k) {
+    const auto& relative_pose = relative_poses[k];
+    if (allowed && (!allowed->count(relative_pose.shot_id1) ||
+                    !allowed->count(relative_pose.shot_id2))) {
+      continue;
+    }
+    const int i = index(relative_pose.shot_id1);
+    const int j = index(relative_pose.shot_id2);
+    adjacency[i].emplace_back(j, k);
+    adjacency[j].emplace_back(i, k);
+  }
+
+  // Largest connected component
+  const int num_shots = shots.size();
+  std::vector<int> component(num_shots, -1);
+  int best_component = -1;
+  int best_size = 0;
+  for (int start = 0; start < num_shots; ++start) {
+    if (component[start] >= 0) {
+      continue;
+    }
+    int size = 0;
+    std::vector<int> stack = {start};
+    component[start] = start;
+    while (!stack.empty()) {
+      const int current = stack.back();
+      stack.pop_back();
+      ++size;
+      for (const auto& neighbor : adjacency[current]) {
+        if (component[neighbor.first] < 0) {
+          component[neighbor.first] = start;
+          stack.push_back(neighbor.first);
+        }
+      }
+    }
+    if (size > best_size) {
+      best_size = size;
+      best_component = start;
+    }
+  }
+
+  ViewGraph graph;
+  std::vector<int> new_indexes(shots.size(), -1);
+  for (int i = 0; i < num_shots; ++i) {
+    if (component[i] == best_component) {
+      new_indexes[i] = graph.shots.size();
+      graph.shots.push_back(shots[i]);
+    }
+  }
+  std::vector<int> connectivity(graph.shots.size(), 0);
+  for (int i = 0; i < num_shots; ++i) {
+    if (new_indexes[i] < 0) {
+      continue;
+    }
+    for (const auto& neighbor : adjacency[i]) {
+      const auto& relative_pose = relative_poses[neighbor.second];
+      connectivity[new_indexes[i]] += relative_pose.inliers;
+      if (relative_pose.shot_id1 == shots[i]) {
+        graph.edges.push_back(
+            {new_indexes[i], new_indexes[neighbor.first], &relative_pose});
+      }
+    }
+  }
+  if (!connectivity.empty()) {
+    graph.root = std::max_element(connectivity.begin(), connectivity.end()) -
+                 connectivity.begin();
+  }
+  return graph;
+}
+
+/* Solve min sum_e (x_i - x_j - b_e)^T W_e (x_i - x_j - b_e) over 3-vectors
+ * x, with x_root = 0 and W_e symmetric positive semi-definite weights. The
+ * normal equations are a block-weighted graph laplacian. */
+std::vector<Vec3d> SolveLaplacian(const ViewGraph& graph,
+                                  const std::vector<Mat3d>& weights,
+                                  const std::vector<Vec3d>& b) {
+  const int n = graph.shots.size();
+  const auto unknown = [&graph](int i) {
+    return 3 * (i < graph.root ? i : i - 1);
+  };
+
+  std::vector<Eigen::Triplet<double>> triplets;
+  triplets.reserve(36 * graph.edges.size());
+  const auto add_block = [&triplets](int row, int col, const Mat3d& block) {
+    for (int r = 0; r < 3; ++r) {
+      for (int c = 0; c < 3; ++c) {
+        triplets.emplace_back(row + r, col + c, block(r, c));
+      }
+    }
+  };
+  VecXd rhs = VecXd::Zero(3 * (n - 1));
+  const int num_edges = graph.edges.size();
+  for (int e = 0; e < num_edges; ++e) {
+    const auto& edge = graph.edges[e];
+    const Mat3d& w = weights[e];
+    if (edge.i != graph.root) {
+      add_block(unknown(edge.i), unknown(edge.i), w);
+      rhs.segment<3>(unknown(edge.i)) += w * b[e];
+    }
+    if (edge.j != graph.root) {
+      add_block(unknown(edge.j), unknown(edge.j), w);
+      rhs.segment<3>(unknown(edge.j)) -= w * b[e];
+    }
+    if (edge.i != graph.root && edge.j != graph.root) {
+      add_block(unknown(edge.i), unknown(edge.j), -w);
+      add_block(unknown(edge.j), unknown(edge.i), -w);
+    }
+  }
+  Eigen::SparseMatrix<double> laplacian(3 * (n - 1), 3 * (n - 1));
+  laplacian.setFromTriplets(triplets.begin(), triplets.end());
+
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver(laplacian);
+  std::vector<Vec3d> x(n, Vec3d::Zero());
+  if (solver.info() != Eigen::Success) {
+    return x;
+  }
+  const VecXd solution = solver.solve(rhs);
+  for (int i = 0; i < n; ++i) {
+    if (i != graph.root) {
+      x[i] = solution.segment<3>(unknown(i));
+    }
+  }
+  return x;
+}
+
+Vec3d RotationLog(const Mat3d& rotation) {
+  const Eigen::AngleAxisd angle_axis(rotation);
+  return angle_axis.angle() * angle_axis.axis();
+}
+
+Mat3d RotationExp(const Vec3d& vector) {
+  const double angle = vector.norm();
+  if (angle == 0.) {
+    return Mat3d::Identity();
+  }
+  return Eigen::AngleAxisd(angle, vector / angle).toRotationMatrix();
+}
+
+// L1 weight of a residual, bounded for small ones
+double L1Weight(double residual) {
+  constexpr double kMinResidual = 1e-4;
+  return 1.0 / std::max(residual, kMinResidual);
+}
+}  // namespace
+
+namespace sfm::global_sfm {
+
+std::vector<RelativePose> ComputeRelativePoses(
+    const map::Map& map, const map::TracksManager& tracks_manager,
+    const std::vector<std::pair<map::ShotId, map::ShotId>>& pairs,
+    const Parameters& parameters) {
+  OPENSFM_TRACE_SCOPE("sfm", "ComputeRelativePoses");
+  RobustEstimatorParams ransac_parameters;
+  ransac_parameters.iterations = parameters.relative_pose_iterations;
+
+  // Negative minimums don't reject anything
+  const size_t min_inliers = std::max(parameters.min_inliers, 0);
+  const int num_pairs = pairs.size();
+  std::vector<RelativePose> relative_poses(num_pairs);
+  std::vector<char> valid(num_pairs, false);
+#pragma omp parallel for num_threads(parameters.num_threads) schedule(dynamic)
+  for (int k = 0; k < num_pairs; ++k) {
+    const auto& pair = pairs[k];
+    if (!map.HasShot(pair.first) || !map.HasShot(pair.second) ||
+        !tracks_manager.HasShotObservations(pair.first) ||
+        !tracks_manager.HasShotObservations(pair.second)) {
+      continue;
+    }
+    const auto common =
+        tracks_manager.GetAllCommonObservations(pair.first, pair.second);
+    if (common.size() < min_inliers) {
+      continue;
+    }
+
+    const auto& camera1 = *map.GetShot(pair.first).GetCamera();
+    const auto& camera2 = *map.GetShot(pair.second).GetCamera();
+    Eigen::Matrix<double, -1, 3> bearings1(common.size(), 3);
+    Eigen::Matrix<double, -1, 3> bearings2(common.size(), 3);
+    for (size_t i = 0; i < common.size(); ++i) {
+      bearings1.row(i) = camera1.Bearing(std::get<1>(common[i]).point);
+      bearings2.row(i) = camera2.Bearing(std::get<2>(common[i]).point);
+    }
+
+    const auto result = robust::RANSACRelativePose(
+        bearings1, bearings2, parameters.relative_pose_threshold,
+        ransac_parameters, RansacType::RANSAC);
+    if (result.inliers_indices.size() < min_inliers) {
+      continue;
+    }
+
+    auto& relative_pose = relative_poses[k];
+    relative_pose.shot_id1 = pair.first;
+    relative_pose.shot_id2 = pair.second;
+    relative_pose.rotation = result.lo_model.block<3, 3>(0, 0);
+    relative_pose.translation =
+        result.lo_model.block<3, 1>(0, 3).normalized();
+    relative_pose.inliers = result.inliers_indices.size();
+    valid[k] = true;
+  }
+
+  std::vector<RelativePose> valid_relative_poses;
+  for (int k = 0; k < num_pairs; ++k) {
+    if (valid[k]) {
+      valid_relative_poses.push_back(std::move(relative_poses[k]));
+    }
+  }
+  return valid_relative_poses;
+}
+
+std::unordered_map<map::ShotId, Mat3d> AverageRotations(
+    const std::vector<RelativePose>& relative_poses, int iterations) {
+  OPENSFM_TRACE_SCOPE("sfm", "AverageRotations");
+  const auto graph = BuildViewGraph(relative_poses, nullptr);
+  const int n = graph.shots.size();
+  std::vector<Mat3d> rotations(n, Mat3d::Identity());
+
+  // Initialization by the maximum spanning tree
+  const int num_edges = graph.edges.size();
+  std::vector<std::vector<int>> edges_per_shot(n);
+  for (int e = 0; e < num_edges; ++e) {
+    edges_per_shot[graph.edges[e].i].push_back(e);
+    edges_per_shot[graph.edges[e].j].push_back(e);
+  }
+  std::vector<bool> reached(n, false);
+  std::priority_queue<std::pair<int, int>> queue;
+  const auto reach = [&](int i) {
+    reached[i] = true;
+    for (const int e : edges_per_shot[i]) {
+      queue.emplace(graph.edges[e].relative_pose->inliers, e);
+    }
+  };
+  if (n > 0) {
+    reach(graph.root);
+  }
+  while (!queue.empty()) {
+    const auto& edge = graph.edges[queue.top().second];
+    queue.pop();
+    const Mat3d& rotation = edge.relative_pose->rotation;
+    if (!reached[edge.j]) {
+      rotations[edge.j] = rotation * rotations[edge.i];
+      reach(edge.j);
+    } else if (!reached[edge.i]) {
+      rotations[edge.i] = rotation.transpose() * rotations[edge.j];
+      reach(edge.i);
+    }
+  }
+
+  // Refinement : with R_k <- R_k * exp(w_k), the residual log(R_ij * R_i *
+  // R_j^T) of each edge becomes, to first order, its current value plus
+  // R_j * (w_i - w_j)
+  std::vector<Mat3d> weights(graph.edges.size());
+  std::vector<Vec3d> b(graph.edges.size());
+  for (int iteration = 0; iteration < iterations && n > 1; ++iteration) {
+    for (int e = 0; e < num_edges; ++e) {
+      const auto& edge = graph.edges[e];
+      const Vec3d residual =
+          RotationLog(edge.relative_pose->rotation * rotations[edge.i] *
+                      rotations[edge.j].transpose());
+      weights[e] = L1Weight(residual.norm()) * Mat3d::Identity();
+      b[e] = -rotations[edge.j].transpose() * residual;
+    }
+    const auto updates = SolveLaplacian(graph, weights, b);
+
+    double max_update = 0.;
+    for (int i = 0; i < n; ++i) {
+      rotations[i] = rotations[i] * RotationExp(updates[i]);
+      max_update = std::max(max_update, updates[i].norm());
+    }
+    constexpr double kMinUpdate = 1e-9;
+    if (max_update < kMinUpdate) {
+      break;
+    }
+  }
+
+  std::unordered_map<map::ShotId, Mat3d> result;
+  for (int i = 0; i < n; ++i) {
+    result[graph.shots[i]] = rotations[i];
+  }
+  return result;
+}
+
+std::unordered_map<map::ShotId, Vec3d> AverageTranslations(
+    const std::vector<RelativePose>& relative_poses,
+    const std::unordered_map<map::ShotId, Mat3d>& rotations, int iterations) {
+  OPENSFM_TRACE_SCOPE("sfm", "AverageTranslations");
+  std::unordered_set<map::ShotId> allowed;
+  for (const auto& rotation : rotations) {
+    allowed.insert(rotation.first);
+  }
+  const auto graph = BuildViewGraph(relative_poses, &allowed);
+  const int n = graph.shots.size();
+  const int edges_count = graph.edges.size();
+
+  // With X_j = R_j * (X - c_j), the relative translation t_ij is R_j * (c_i -
+  // c_j), so that the baseline direction of each edge in world is R_j^T t_ij
+  std::vector<Vec3d> directions(edges_count);
+  for (int e = 0; e < edges_count; ++e) {
+    const auto& edge = graph.edges[e];
+    directions[e] = (rotations.at(graph.shots[edge.j]).transpose() *
+                     edge.relative_pose->translation)
+                        .normalized();
+  }
+
+  // Baselines lengths are at least one (which fixes the scale and prevents
+  // the centers from collapsing), and are eliminated by only penalizing the
+  // components of c_i - c_j orthogonal to their direction. Edges whose
+  // length would be shorter are set to unit length instead.
+  std::vector<double> weights(edges_count, 1.0);
+  std::vector<char> free_length(edges_count, false);
+  std::vector<Mat3d> blocks(edges_count);
+  std::vector<Vec3d> b(edges_count);
+  std::vector<Vec3d> centers(n, Vec3d::Zero());
+  for (int iteration = 0; iteration < std::max(iterations, 1) && n > 1;
+       ++iteration) {
+    for (int e = 0; e < edges_count; ++e) {
+      if (free_length[e]) {
+        blocks[e] = weights[e] * (Mat3d::Identity() -
+                                  directions[e] * directions[e].transpose());
+        b[e].setZero();
+      } else {
+        blocks[e] = weights[e] * Mat3d::Identity();
+        b[e] = directions[e];
+      }
+    }
+    centers = SolveLaplacian(graph, blocks, b);
+
+    for (int e = 0; e < edges_count; ++e) {
+      const auto& edge = graph.edges[e];
+      const Vec3d baseline = centers[edge.i] - centers[edge.j];
+      const double length = baseline.dot(directions[e]);
+      free_length[e] = length > 1.0;
+      weights[e] = L1Weight(
+          (baseline - std::max(length, 1.0) * directions[e]).norm());
+    }
+  }
+
+  // Baselines are of unit length on average
+  double lengths_sum = 0.;
+  for (const auto& edge : graph.edges) {
+    lengths_sum += (centers[edge.i] - centers[edge.j]).norm();
+  }
+  if (lengths_sum > 0.) {
+    for (auto& center : centers) {
+      center *= edges_count / lengths_sum;
+    }
+  }
+
+  std::unordered_map<map::ShotId, Vec3d> result;
+  for (int i = 0; i < n; ++i) {
+    result[graph.shots[i]] = centers[i];
+  }
+  return result;
+}
+
+int TriangulateTracks(map::Map& map, const map::TracksManager& tracks_manager,
+                      const Parameters& parameters) {
+  OPENSFM_TRACE_SCOPE("sfm", "TriangulateTracks");
+
+  // Poses are gathered beforehand, so that the rotations of the shots aren't
+  // recomputed for each of their tracks
+  struct ShotData {
+    Mat3d rotation;
+    Vec3d center;
+    const geometry::Camera* camera;
+  };
+  std::unordered_map<map::ShotId, ShotData> shots;
+  for (const auto& shot : map.GetShots()) {
+    const auto& pose = *shot.second.GetPose();
+    shots[shot.first] = {pose.RotationCameraToWorld(), pose.GetOrigin(),
+                         shot.second.GetCamera()};
+  }
+
+  const auto track_ids = tracks_manager.GetTrackIds();
+  const int num_tracks = track_ids.size();
+  std::vector<std::pair<bool, Vec3d>> points(num_tracks);
+#pragma omp parallel for num_threads(parameters.num_threads) schedule(dynamic)
+  for (int k = 0; k < num_tracks; ++k) {
+    points[k].first = false;
+    if (map.HasLandmark(track_ids[k])) {
+      continue;
+    }
+    const auto& observations =
+        tracks_manager.GetTrackObservations(track_ids[k]);
+    std::vector<Vec3d> centers;
+    std::vector<Vec3d> bearings;
+    for (const auto& observation : observations) {
+      const auto shot = shots.find(observation.first);
+      if (shot == shots.end()) {
+        continue;
+      }
+      const auto& data = shot->second;
+      bearings.push_back(data.rotation *
+                         data.camera->Bearing(observation.second.point));
+      centers.push_back(data.center);
+    }
+    if (centers.size() < 2) {
+      continue;
+    }
+
+    MatX3d centers_matrix(centers.size(), 3);
+    MatX3d bearings_matrix(bearings.size(), 3);
+    for (size_t i = 0; i < centers.size(); ++i) {
+      centers_matrix.row(i) = centers[i];
+      bearings_matrix.row(i) = bearings[i];
+    }
+    const std::vector<double> thresholds(centers.size(),
+                                         parameters.triangulation_threshold);
+    points[k] = geometry::TriangulateBearingsMidpoint(
+        centers_matrix, bearings_matrix, thresholds,
+        parameters.triangulation_min_angle,
+        parameters.triangulation_min_depth);
+  }
+
+  int count = 0;
+  for (int k = 0; k < num_tracks; ++k) {
+    if (!points[k].first) {
+      continue;
+    }
+    map.CreateLandmark(track_ids[k], points[k].second);
+    for (const auto& observation :
+         tracks_manager.GetTrackObservations(track_ids[k])) {
+      if (shots.count(observation.first)) {
+        map.AddObservation(observation.first, track_ids[k],
+                           observation.second);
+      }
+    }
+    ++count;
+  }
+  return count;
+}
+
+Parameters ParametersFromConfig(const py::dict& config) {
+  Parameters parameters;
+  parameters.relative_pose_threshold =
+      config["five_point_algo_threshold"].cast<double>();
+  parameters.min_inliers = config["five_point_algo_min_inliers"].cast<int>();
+  parameters.triangulation_threshold =
+      config["triangulation_threshold"].cast<double>();
+  parameters.triangulation_min_angle =
+      config["triangulation_min_ray_angle"].cast<double>() * M_PI / 180.0;
+  parameters.triangulation_min_depth =
+      config["triangulation_min_depth"].cast<double>();
+  parameters.num_threads = config["processes"].cast<int>();
+  return parameters;
+}
+
+Report GlobalReconstruction(
+    map::Map& map, const map::TracksManager& tracks_manager,
+    const std::vector<std::pair<map::ShotId, map::ShotId>>& pairs,
+    const Parameters& parameters) {
+  OPENSFM_TRACE_SCOPE("sfm", "GlobalReconstruction");
+  Report report;
+  // Seconds since the previous call
+  auto timer = std::chrono::high_resolution_clock::now();
+  const auto lap = [&timer]() {
+    const auto now = std::chrono::high_resolution_clock::now();
+    const double elapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(now - timer)
+            .count() /
+        1000000.0;
+    timer = now;
+    return elapsed;
+  };
+
+  std::vector<std::pair<map::ShotId, map::ShotId>> all_pairs = pairs;
+  if (all_pairs.empty()) {
+    std::vector<map::ShotId> shot_ids;
+    for (const auto& shot : map.GetShots()) {
+      shot_ids.push_back(shot.first);
+    }
+    for (const auto& connectivity :
+         tracks_manager.GetAllPairsConnectivity(shot_ids, {})) {
+      if (connectivity.second >= parameters.min_inliers) {
+        all_pairs.push_back(connectivity.first);
+      }
+    }
+  }
+  report.num_pairs = all_pairs.size();
+
+  const auto relative_poses =
+      ComputeRelativePoses(map, tracks_manager, all_pairs, parameters);
+  report.num_relative_poses = relative_poses.size();
+  report.relative_poses_time = lap();
+  const auto rotations =
+      AverageRotations(relative_poses, parameters.averaging_iterations);
+  report.rotation_averaging_time = lap();
+  const auto centers = AverageTranslations(relative_poses, rotations,
+                                           parameters.averaging_iterations);
+  report.translation_averaging_time = lap();
+
+  // Set the poses, once per rig instance
+  std::unordered_set<map::RigInstanceId> posed_instances;
+  for (const auto& center : centers) {
+    auto& shot = map.GetShot(center.first);
+    auto* instance = shot.GetRigInstance();
+    if (posed_instances.count(instance->id)) {
+      continue;
+    }
+    geometry::Pose pose(rotations.at(center.first));
+    pose.SetOrigin(center.second);
+    instance->UpdateInstancePoseWithShot(center.first, pose);
+    posed_instances.insert(instance->id);
+  }
+  for (const auto& shot : map.GetShots()) {
+    if (!posed_instances.count(shot.second.GetRigInstanceId())) {
+      report.removed_shots.push_back(shot.first);
+    }
+  }
+  for (const auto& shot_id : report.removed_shots) {
+    const auto instance_id = map.GetShot(shot_id).GetRigInstanceId();
+    map.RemoveShot(shot_id);
+    if (map.GetRigInstance(instance_id).NumberOfShots() == 0) {
+      map.RemoveRigInstance(instance_id);
+    }
+  }
+
+  report.num_landmarks = TriangulateTracks(map, tracks_manager, parameters);
+  report.triangulation_time = lap();
+  return report;
+}
+}  // namespace sfm::global_sfm
@@ -0,0 +1,248 @@
+#include <foundation/tracing.h>
+#include <robust/instanciations.h>
+#include <sfm/merging.h>
+
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Least squares refit of the similarity needs more inliers than the minimal
+// sample, as the Python alignment did (dimension + 3)
+constexpr int kMinRefitInliers = 6;
+
+bool SameInstancePose(const geometry::Pose& reference,
+                      const geometry::Pose& other,
+                      const sfm::merging::Parameters& parameters) {
+  const double distance = (reference.GetOrigin() - other.GetOrigin()).norm();
+  const double angle =
+      Eigen::AngleAxisd(reference.RotationWorldToCamera() *
+                        other.RotationCameraToWorld())
+          .angle();
+  return distance <= parameters.threshold &&
+         angle <= parameters.max_instance_angle;
+}
+}  // namespace
+
+namespace sfm::merging {
+
+Alignment AlignMaps(const map::Map& reference, const map::Map& to_align,
+                    const Parameters& parameters) {
+  // Look up the landmarks of the smallest map in the largest one
+  const auto& reference_landmarks = reference.GetLandmarks();
+  const auto& to_align_landmarks = to_align.GetLandmarks();
+  const bool reference_is_smaller =
+      reference_landmarks.size() < to_align_landmarks.size();
+  const auto& smaller =
+      reference_is_smaller ? reference_landmarks : to_align_landmarks;
+  const auto& larger =
+      reference_is_smaller ? to_align_landmarks : reference_landmarks;
+  std::vector<map::LandmarkId> common_ids;
+  for (const auto& landmark_it : smaller) {
+    if (larger.find(landmark_it.first) != larger.end()) {
+      common_ids.push_back(landmark_it.first);
+    }
+  }
+  // Sorted, so that the RANSAC samples don't depend on the hashing
+  std::sort(common_ids.begin(), common_ids.end());
+
+  Alignment alignment;
+  alignment.num_common_landmarks = common_ids.size();
+  if (alignment.num_common_landmarks < parameters.min_common_landmarks) {
+    return alignment;
+  }
+
+  Eigen::Matrix<double, -1, 3> points_to_align(common_ids.size(), 3);
+  Eigen::Matrix<double, -1, 3> points_reference(common_ids.size(), 3);
+  for (int i = 0; i < alignment.num_common_landmarks; ++i) {
+    points_to_align.row(i) =
+        to_align_landmarks.at(common_ids[i]).GetGlobalPos();
+    points_reference.row(i) =
+        reference_landmarks.at(common_ids[i]).GetGlobalPos();
+  }
+
+  RobustEstimatorParams ransac_parameters;
+  ransac_parameters.iterations = parameters.ransac_iterations;
+  const auto result = robust::RANSACSimilarity(
+      points_to_align, points_reference, parameters.threshold,
+      ransac_parameters, RansacType::RANSAC);
+
+  // The RANSAC model only fits a few points : refit it by least squares on
+  // all its inliers, and count the inliers of the refitted model
+  Mat4d model = result.lo_model;
+  std::vector<int> inliers = result.inliers_indices;
+  if (static_cast<int>(inliers.size()) > kMinRefitInliers) {
+    Eigen::Matrix<double, 3, -1> inliers_to_align(3, inliers.size());
+    Eigen::Matrix<double, 3, -1> inliers_reference(3, inliers.size());
+    for (int i = 0; i < static_cast<int>(inliers.size()); ++i) {
+      inliers_to_align.col(i) = points_to_align.row(inliers[i]).transpose();
+      inliers_reference.col(i) = points_reference.row(inliers[i]).transpose();
+    }
+    model = Eigen::umeyama(inliers_to_align, inliers_reference, true);
+
+    inliers.clear();
+    for (int i = 0; i < alignment.num_common_landmarks; ++i) {
+      const Vec3d aligned = model.block<3, 3>(0, 0) *
+                                points_to_align.row(i).transpose() +
+                            model.block<3, 1>(0, 3);
+      if ((aligned - points_reference.row(i).transpose()).norm() <
+          parameters.threshold) {
+        inliers.push_back(i);
+      }
+    }
+  }
+  alignment.num_inliers = inliers.size();
+  if (alignment.num_inliers < parameters.min_inliers) {
+    return alignment;
+  }
+
+  // [s * R | t] with s the cubic root of the determinant
+  const Mat3d scaled_rotation = model.block<3, 3>(0, 0);
+  const Vec3d translation = model.block<3, 1>(0, 3);
+  const double scale = std::cbrt(scaled_rotation.determinant());
+  if (!(scale > 0.0)) {
+    return alignment;
+  }
+  const Mat3d rotation = scaled_rotation / scale;
+  alignment.similarity = geometry::Similarity(rotation, translation, scale);
+  alignment.success = alignment.similarity.IsValid();
+  return alignment;
+}
+
+int MergeMap(const geometry::Similarity& similarity, map::Map& to_merge,
+             map::Map& reference, const Parameters& parameters) {
+  OPENSFM_TRACE_SCOPE("sfm", "MergeMap");
+  to_merge.ApplySimilarity(similarity, parameters.num_threads);
+
+  for (const auto& landmark_it : to_merge.GetLandmarks()) {
+    if (reference.HasLandmark(landmark_it.first)) {
+      continue;
+    }
+    const auto& landmark = landmark_it.second;
+    auto& new_landmark =
+        reference.CreateLandmark(landmark_it.first, landmark.GetGlobalPos());
+    new_landmark.SetColor(landmark.GetColor());
+  }
+
+  // Copying a shot of a new rig instance brings its other shots too, so list
+  // the new shots beforehand to copy their observations afterwards
+  std::vector<const map::Shot*> new_shots;
+  for (const auto& shot_it : to_merge.GetShots()) {
+    if (!reference.HasShot(shot_it.first)) {
+      new_shots.push_back(&shot_it.second);
+    }
+  }
+
+  int num_skipped = 0;
+  std::vector<const map::Shot*> merged_shots;
+  for (const auto* shot : new_shots) {
+    if (reference.HasShot(shot->GetId())) {
+      merged_shots.push_back(shot);
+      continue;
+    }
+
+    // The reference shots of an existing instance already place it
+    const auto& instance_id = shot->GetRigInstanceId();
+    const bool has_instance = reference.HasRigInstance(instance_id);
+    if (has_instance &&
+        !SameInstancePose(reference.GetRigInstance(instance_id).GetPose(),
+                          shot->GetRigInstance()->GetPose(), parameters)) {
+      ++num_skipped;
+      continue;
+    }
+
+    const auto* camera = shot->GetCamera();
+    if (!reference.HasCamera(camera->id)) {
+      reference.CreateCamera(*camera);
+    }
+    if (!reference.HasRigCamera(shot->GetRigCameraId())) {
+      reference.CreateRigCamera(*shot->GetRigCamera());
+    }
+    if (has_instance) {
+      auto& new_shot = reference.CreateShot(shot->GetId(), camera->id,
+                                            shot->GetRigCameraId(),
+                                            instance_id);
+      new_shot.merge_cc = shot->merge_cc;
+      new_shot.scale = shot->scale;
+      new_shot.SetShotMeasurements(shot->GetShotMeasurements());
+      new_shot.SetCovariance(shot->GetCovariance());
+    } else {
+      reference.CreateRigInstance(instance_id);
+      reference.CreateShot(shot->GetId(), camera->id, shot->GetRigCameraId(),
+                           instance_id, *shot->GetPose());
+      reference.UpdateShot(*shot);
+    }
+    merged_shots.push_back(shot);
+  }
+
+  for (const auto* shot : merged_shots) {
+    auto& new_shot = reference.GetShot(shot->GetId());
+    for (const auto& observation : shot->GetLandmarkObservations()) {
+      reference.AddObservation(
+          &new_shot, &reference.GetLandmark(observation.first->id_),
+          observation.second);
+    }
+  }
+  return num_skipped;
+}
+
+bool MergeTwoMaps(map::Map& to_merge, map::Map& reference,
+                  const Parameters& parameters) {
+  const auto alignment = AlignMaps(reference, to_merge, parameters);
+  if (!alignment.success) {
+    return false;
+  }
+  MergeMap(alignment.similarity, to_merge, reference, parameters);
+  return true;
+}
+
+std::vector<std::vector<int>> MergeMaps(const std::vector<map::Map*>& maps,
+                                        const Parameters& parameters) {
+  OPENSFM_TRACE_SCOPE("sfm", "MergeMaps");
+  const int num_maps = maps.size();
+  std::vector<bool> merged(num_maps, false);
+  std::vector<std::vector<int>> groups;
+  for (int i = 0; i < num_maps; ++i) {
+    if (merged[i]) {
+      continue;
+    }
+    std::vector<int> group = {i};
+
+    // Merging brings new landmarks in the reference, so maps that couldn't be
+    // aligned might be at the next pass
+    bool has_merged = true;
+    while (has_merged) {
+      has_merged = false;
+      std::vector<int> candidates;
+      for (int j = i + 1; j < num_maps; ++j) {
+        if (!merged[j]) {
+          candidates.push_back(j);
+        }
+      }
+
+      const int num_candidates = candidates.size();
+      std::vector<Alignment> alignments(num_candidates);
+#pragma omp parallel for num_threads(parameters.num_threads) \
+    schedule(dynamic, 1)
+      for (int k = 0; k < num_candidates; ++k) {
+        alignments[k] = AlignMaps(*maps[i], *maps[candidates[k]], parameters);
+      }
+
+      // Landmarks are only added to the reference, so the alignments stay
+      // valid as we merge
+      for (int k = 0; k < num_candidates; ++k) {
+        if (!alignments[k].success) {
+          continue;
+        }
+        const int j = candidates[k];
+        MergeMap(alignments[k].similarity, *maps[j], *maps[i], parameters);
+        merged[j] = true;
+        group.push_back(j);
+        has_merged = true;
+      }
+    }
+    groups.push_back(group);
+  }
+  return groups;
+}
+}  // namespace sfm::merging
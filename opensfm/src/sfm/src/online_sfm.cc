@@ -0,0 +1,530 @@
+#include <bundle/bundle_adjuster.h>
+#include <foundation/tracing.h>
+#include <geometry/triangulation.h>
+#include <robust/instanciations.h>
+#include <sfm/global_sfm.h>
+#include <sfm/online_sfm.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+double SecondsSince(
+    const std::chrono::high_resolution_clock::time_point& start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::high_resolution_clock::now() - start)
+             .count() /
+         1000000.0;
+}
+}  // namespace
+
+namespace sfm::online_sfm {
+
+Parameters ParametersFromConfig(const py::dict& config) {
+  Parameters parameters;
+  parameters.window_size = config["online_window_size"].cast<int>();
+  parameters.relative_pose_threshold =
+      config["five_point_algo_threshold"].cast<double>();
+  parameters.bootstrap_min_inliers =
+      config["five_point_algo_min_inliers"].cast<int>();
+  parameters.resection_threshold =
+      config["resection_threshold"].cast<double>();
+  parameters.resection_min_inliers =
+      config["resection_min_inliers"].cast<int>();
+  parameters.triangulation_threshold =
+      config["triangulation_threshold"].cast<double>();
+  parameters.triangulation_min_angle =
+      config["triangulation_min_ray_angle"].cast<double>() * M_PI / 180.0;
+  parameters.triangulation_min_depth =
+      config["triangulation_min_depth"].cast<double>();
+  parameters.loss_function = config["loss_function"].cast<std::string>();
+  parameters.loss_function_threshold =
+      config["loss_function_threshold"].cast<double>();
+  parameters.bundle_analytic_derivatives =
+      config["bundle_analytic_derivatives"].cast<bool>();
+  parameters.num_threads = config["processes"].cast<int>();
+  return parameters;
+}
+
+OnlineReconstruction::OnlineReconstruction(map::Map& map,
+                                           map::TracksManager& tracks_manager,
+                                           const Parameters& parameters)
+    : map_(map),
+      tracks_manager_(tracks_manager),
+      parameters_(parameters),
+      next_track_id_(tracks_manager.NumTracks()) {
+  if (parameters_.window_size < 2) {
+    throw std::runtime_error("The window must have at least two frames");
+  }
+}
+
+std::vector<map::ShotId> OnlineReconstruction::GetWindow() const {
+  std::vector<map::ShotId> window;
+  for (const auto& frame : frames_) {
+    if (frame.reconstructed) {
+      window.push_back(frame.shot_id);
+    }
+  }
+  return window;
+}
+
+FrameReport OnlineReconstruction::AddFrame(
+    const map::ShotId& shot_id, const MatX3d& features, const MatX3i& colors,
+    const std::unordered_map<map::ShotId, MatX2i>& matches) {
+  OPENSFM_TRACE_SCOPE("sfm", "OnlineReconstruction::AddFrame");
+  if (!map_.HasShot(shot_id)) {
+    throw std::runtime_error("Shot " + shot_id + " isn't in the map");
+  }
+  if (features.rows() != colors.rows()) {
+    throw std::runtime_error("Features and colors have different sizes");
+  }
+  if (FindFrame(shot_id)) {
+    throw std::runtime_error("Frame " + shot_id + " was already added");
+  }
+
+  FrameReport report;
+  report.shot_id = shot_id;
+
+  auto start = std::chrono::high_resolution_clock::now();
+  frames_.emplace_back();
+  auto& frame = frames_.back();
+  frame.shot_id = shot_id;
+  frame.features = features;
+  frame.colors = colors;
+  frame.tracks.resize(features.rows());
+  report.num_tracks = AddTracks(frame, matches);
+  report.tracks_time = SecondsSince(start);
+
+  if (!initialized_) {
+    initialized_ = Bootstrap(frame, report);
+  } else if (Resect(frame, report)) {
+    start = std::chrono::high_resolution_clock::now();
+    report.num_new_landmarks = Triangulate(frame);
+    report.triangulation_time = SecondsSince(start);
+  }
+  report.reconstructed = frame.reconstructed;
+
+  if (frame.reconstructed) {
+    start = std::chrono::high_resolution_clock::now();
+    BundleWindow();
+    report.bundle_time = SecondsSince(start);
+  }
+
+  // Frames leaving the window are only kept in the map, if reconstructed
+  while (static_cast<int>(frames_.size()) > parameters_.window_size) {
+    if (!frames_.front().reconstructed) {
+      RemoveFrame(frames_.front());
+    }
+    frames_.pop_front();
+  }
+  report.num_window_shots = GetWindow().size();
+
+  // Nothing is left to resect the next frames against
+  if (initialized_ && report.num_window_shots == 0) {
+    StartSegment();
+    report.tracking_lost = true;
+  }
+  report.segment = segment_;
+  return report;
+}
+
+map::Observation OnlineReconstruction::FrameObservation(const Frame& frame,
+                                                        int feature) const {
+  const auto& point = frame.features.row(feature);
+  const auto& color = frame.colors.row(feature);
+  return map::Observation(point(0), point(1), point(2), color(0), color(1),
+                          color(2), feature);
+}
+
+OnlineReconstruction::Frame* OnlineReconstruction::FindFrame(
+    const map::ShotId& shot_id) {
+  for (auto& frame : frames_) {
+    if (frame.shot_id == shot_id) {
+      return &frame;
+    }
+  }
+  return nullptr;
+}
+
+int OnlineReconstruction::AddTracks(
+    Frame& frame, const std::unordered_map<map::ShotId, MatX2i>& matches) {
+  std::unordered_set<map::TrackId> frame_tracks;
+  for (const auto& frame_matches : matches) {
+    auto* previous = FindFrame(frame_matches.first);
+    if (!previous || previous == &frame) {
+      continue;
+    }
+    const auto& pairs = frame_matches.second;
+    for (int i = 0; i < pairs.rows(); ++i) {
+      const int previous_feature = pairs(i, 0);
+      const int feature = pairs(i, 1);
+      if (previous_feature < 0 ||
+          previous_feature >= static_cast<int>(previous->tracks.size()) ||
+          feature < 0 || feature >= static_cast<int>(frame.tracks.size())) {
+        throw std::runtime_error("Invalid feature index in matches with " +
+                                 frame_matches.first);
+      }
+
+      // Features already tracked, or tracks already seen by this frame
+      // through another feature, aren't tracked again
+      auto& track_id = frame.tracks[feature];
+      auto& previous_track_id = previous->tracks[previous_feature];
+      if (!track_id.empty() || frame_tracks.count(previous_track_id)) {
+        continue;
+      }
+      if (previous_track_id.empty()) {
+        previous_track_id = std::to_string(next_track_id_++);
+        tracks_manager_.AddObservation(
+            previous->shot_id, previous_track_id,
+            FrameObservation(*previous, previous_feature));
+      }
+      track_id = previous_track_id;
+      frame_tracks.insert(track_id);
+      tracks_manager_.AddObservation(frame.shot_id, track_id,
+                                     FrameObservation(frame, feature));
+    }
+  }
+  return frame_tracks.size();
+}
+
+bool OnlineReconstruction::Bootstrap(Frame& frame, FrameReport& report) {
+  OPENSFM_TRACE_SCOPE("sfm", "OnlineReconstruction::Bootstrap");
+  // The oldest frame of the window is the reference
+  auto& reference = frames_.front();
+  if (&reference == &frame ||
+      !tracks_manager_.HasShotObservations(frame.shot_id)) {
+    return false;
+  }
+
+  global_sfm::Parameters relative_parameters;
+  relative_parameters.relative_pose_threshold =
+      parameters_.relative_pose_threshold;
+  relative_parameters.min_inliers = parameters_.bootstrap_min_inliers;
+  const auto relative_poses = global_sfm::ComputeRelativePoses(
+      map_, tracks_manager_, {{reference.shot_id, frame.shot_id}},
+      relative_parameters);
+  if (relative_poses.empty()) {
+    return false;
+  }
+
+  const auto& relative_pose = relative_poses[0];
+  auto& reference_shot = map_.GetShot(reference.shot_id);
+  auto& shot = map_.GetShot(frame.shot_id);
+  reference_shot.GetRigInstance()->UpdateInstancePoseWithShot(
+      reference.shot_id, geometry::Pose());
+  shot.GetRigInstance()->UpdateInstancePoseWithShot(
+      frame.shot_id,
+      geometry::Pose(relative_pose.rotation, relative_pose.translation));
+  reference.reconstructed = true;
+  frame.reconstructed = true;
+
+  // Enough tracks must be seen with parallax
+  const int landmarks_count = Triangulate(frame);
+  if (landmarks_count < parameters_.bootstrap_min_inliers) {
+    for (const auto& track_id : frame.tracks) {
+      if (!track_id.empty() && map_.HasLandmark(track_id)) {
+        map_.RemoveLandmark(track_id);
+      }
+    }
+    reference.reconstructed = false;
+    frame.reconstructed = false;
+    return false;
+  }
+  report.num_new_landmarks = landmarks_count;
+  reference_shot.merge_cc = segment_;
+  shot.merge_cc = segment_;
+
+  // Frames in-between the two initial ones are resected afterwards
+  for (auto& other : frames_) {
+    if (other.reconstructed) {
+      continue;
+    }
+    FrameReport other_report;
+    if (Resect(other, other_report)) {
+      Triangulate(other);
+    }
+  }
+  return true;
+}
+
+bool OnlineReconstruction::Resect(Frame& frame, FrameReport& report) {
+  OPENSFM_TRACE_SCOPE("sfm", "OnlineReconstruction::Resect");
+  const auto start = std::chrono::high_resolution_clock::now();
+  const auto& camera = *map_.GetShot(frame.shot_id).GetCamera();
+
+  std::vector<int> features;
+  for (size_t i = 0; i < frame.tracks.size(); ++i) {
+    if (!frame.tracks[i].empty() && map_.HasLandmark(frame.tracks[i])) {
+      features.push_back(i);
+    }
+  }
+  report.num_resection_points = features.size();
+  if (static_cast<int>(features.size()) <
+      std::max(parameters_.resection_min_inliers, 3)) {
+    report.resection_time = SecondsSince(start);
+    return false;
+  }
+
+  Eigen::Matrix<double, -1, 3> bearings(features.size(), 3);
+  Eigen::Matrix<double, -1, 3> points(features.size(), 3);
+  for (size_t i = 0; i < features.size(); ++i) {
+    const Vec2d point = frame.features.row(features[i]).head<2>();
+    bearings.row(i) = camera.Bearing(point);
+    points.row(i) = map_.GetLandmark(frame.tracks[features[i]]).GetGlobalPos();
+  }
+  RobustEstimatorParams ransac_parameters;
+  ransac_parameters.iterations = 1000;
+  const auto result =
+      robust::RANSACAbsolutePose(bearings, points,
+                                 parameters_.resection_threshold,
+                                 ransac_parameters, RansacType::RANSAC);
+
+  const Mat3d rotation = result.lo_model.block<3, 3>(0, 0);
+  const Vec3d translation = result.lo_model.block<3, 1>(0, 3);
+  std::vector<int> inliers;
+  for (size_t i = 0; i < features.size(); ++i) {
+    const Vec3d projected = rotation * points.row(i).transpose() + translation;
+    const double error =
+        (projected.normalized() - bearings.row(i).transpose().normalized())
+            .norm();
+    if (projected.allFinite() && error < parameters_.resection_threshold) {
+      inliers.push_back(features[i]);
+    }
+  }
+  report.num_resection_inliers = inliers.size();
+  if (static_cast<int>(inliers.size()) < parameters_.resection_min_inliers) {
+    report.resection_time = SecondsSince(start);
+    return false;
+  }
+
+  auto& shot = map_.GetShot(frame.shot_id);
+  shot.GetRigInstance()->UpdateInstancePoseWithShot(
+      frame.shot_id, geometry::Pose(rotation, translation));
+  for (const int feature : inliers) {
+    map_.AddObservation(frame.shot_id, frame.tracks[feature],
+                        FrameObservation(frame, feature));
+  }
+  shot.merge_cc = segment_;
+  frame.reconstructed = true;
+  report.resection_time = SecondsSince(start);
+  return true;
+}
+
+int OnlineReconstruction::Triangulate(const Frame& frame) {
+  OPENSFM_TRACE_SCOPE("sfm", "OnlineReconstruction::Triangulate");
+  // Only the reconstructed frames of the window are used
+  struct ShotData {
+    Mat3d rotation;
+    Vec3d center;
+    const geometry::Camera* camera;
+  };
+  std::unordered_map<map::ShotId, ShotData> shots;
+  for (const auto& other : frames_) {
+    if (!other.reconstructed) {
+      continue;
+    }
+    const auto& shot = map_.GetShot(other.shot_id);
+    const auto& pose = *shot.GetPose();
+    shots[other.shot_id] = {pose.RotationCameraToWorld(), pose.GetOrigin(),
+                            shot.GetCamera()};
+  }
+
+  std::vector<int> features;
+  for (size_t i = 0; i < frame.tracks.size(); ++i) {
+    if (!frame.tracks[i].empty() && !map_.HasLandmark(frame.tracks[i])) {
+      features.push_back(i);
+    }
+  }
+
+  std::vector<std::pair<bool, Vec3d>> points(features.size());
+#pragma omp parallel for num_threads(parameters_.num_threads) schedule(dynamic)
+  for (size_t k = 0; k < features.size(); ++k) {
+    points[k].first = false;
+    std::vector<Vec3d> centers;
+    std::vector<Vec3d> bearings;
+    for (const auto& observation :
+         tracks_manager_.GetTrackObservations(frame.tracks[features[k]])) {
+      const auto shot = shots.find(observation.first);
+      if (shot == shots.end()) {
+        continue;
+      }
+      const auto& data = shot->second;
+      bearings.push_back(data.rotation *
+                         data.camera->Bearing(observation.second.point));
+      centers.push_back(data.center);
+    }
+    if (centers.size() < 2) {
+      continue;
+    }
+
+    MatX3d centers_matrix(centers.size(), 3);
+    MatX3d bearings_matrix(bearings.size(), 3);
+    for (size_t i = 0; i < centers.size(); ++i) {
+      centers_matrix.row(i) = centers[i];
+      bearings_matrix.row(i) = bearings[i];
+    }
+    const std::vector<double> thresholds(centers.size(),
+                                         parameters_.triangulation_threshold);
+    points[k] = geometry::TriangulateBearingsMidpoint(
+        centers_matrix, bearings_matrix, thresholds,
+        parameters_.triangulation_min_angle,
+        parameters_.triangulation_min_depth);
+  }
+
+  int count = 0;
+  for (size_t k = 0; k < features.size(); ++k) {
+    if (!points[k].first) {
+      continue;
+    }
+    const auto& track_id = frame.tracks[features[k]];
+    auto& landmark = map_.CreateLandmark(track_id, points[k].second);
+    landmark.SetColor(frame.colors.row(features[k]));
+    for (const auto& observation :
+         tracks_manager_.GetTrackObservations(track_id)) {
+      if (shots.count(observation.first)) {
+        map_.AddObservation(observation.first, track_id, observation.second);
+      }
+    }
+    ++count;
+  }
+  return count;
+}
+
+void OnlineReconstruction::BundleWindow() {
+  OPENSFM_TRACE_SCOPE("sfm", "OnlineReconstruction::BundleWindow");
+  std::unordered_set<map::Shot*> interior;
+  for (const auto& frame : frames_) {
+    if (frame.reconstructed) {
+      interior.insert(&map_.GetShot(frame.shot_id));
+    }
+  }
+
+  // Landmarks of the window, and older shots seeing them
+  std::unordered_set<map::Landmark*> landmarks;
+  std::unordered_set<map::Shot*> boundary;
+  for (auto* shot : interior) {
+    for (const auto& landmark_observation : shot->GetLandmarkObservations()) {
+      auto* landmark = landmark_observation.first;
+      if (!landmarks.insert(landmark).second) {
+        continue;
+      }
+      for (const auto& observation : landmark->GetObservations()) {
+        if (!interior.count(observation.first)) {
+          boundary.insert(observation.first);
+        }
+      }
+    }
+  }
+
+  // Without older shots, the oldest one of the window sets the gauge
+  if (boundary.empty()) {
+    for (const auto& frame : frames_) {
+      if (frame.reconstructed) {
+        auto* oldest = &map_.GetShot(frame.shot_id);
+        interior.erase(oldest);
+        boundary.insert(oldest);
+        break;
+      }
+    }
+  }
+
+  bundle::BundleAdjuster ba;
+  ba.SetUseAnalyticDerivatives(parameters_.bundle_analytic_derivatives);
+
+  std::unordered_set<map::CameraId> camera_ids;
+  std::unordered_set<map::RigCameraId> rig_camera_ids;
+  std::unordered_map<map::RigInstanceId, bool> rig_instances_fixed;
+  for (const auto* shots : {&interior, &boundary}) {
+    const bool fixed = shots == &boundary;
+    for (auto* shot : *shots) {
+      camera_ids.insert(shot->GetCamera()->id);
+      rig_camera_ids.insert(shot->GetRigCameraId());
+      rig_instances_fixed[shot->GetRigInstanceId()] |= fixed;
+    }
+  }
+  for (const auto& camera_id : camera_ids) {
+    const auto& camera = map_.GetCamera(camera_id);
+    ba.AddCamera(camera_id, camera, camera, true);
+  }
+  for (const auto& rig_camera_id : rig_camera_ids) {
+    const auto& rig_camera = map_.GetRigCamera(rig_camera_id);
+    ba.AddRigCamera(rig_camera_id, rig_camera.pose, rig_camera.pose, true);
+  }
+  for (const auto& rig_instance_fixed : rig_instances_fixed) {
+    const auto& instance = map_.GetRigInstance(rig_instance_fixed.first);
+    std::unordered_map<std::string, std::string> shot_cameras,
+        shot_rig_cameras;
+    for (const auto& shot_rig_camera : instance.GetRigCameras()) {
+      const auto& shot = map_.GetShot(shot_rig_camera.first);
+      shot_cameras[shot.id_] = shot.GetCamera()->id;
+      shot_rig_cameras[shot.id_] = shot_rig_camera.second->id;
+    }
+    ba.AddRigInstance(rig_instance_fixed.first, instance.GetPose(),
+                      shot_cameras, shot_rig_cameras,
+                      rig_instance_fixed.second);
+  }
+
+  for (auto* landmark : landmarks) {
+    ba.AddPoint(landmark->id_, landmark->GetGlobalPos(), false);
+  }
+  for (const auto* shots : {&interior, &boundary}) {
+    for (auto* shot : *shots) {
+      for (const auto& landmark_observation :
+           shot->GetLandmarkObservations()) {
+        if (!landmarks.count(landmark_observation.first)) {
+          continue;
+        }
+        const auto& observation = landmark_observation.second;
+        ba.AddPointProjectionObservation(
+            shot->id_, landmark_observation.first->id_, observation.point,
+            observation.scale, observation.depth_prior);
+      }
+    }
+  }
+
+  ba.SetPointProjectionLossFunction(parameters_.loss_function,
+                                    parameters_.loss_function_threshold);
+  ba.SetNumThreads(parameters_.num_threads);
+  ba.SetMaxNumIterations(parameters_.bundle_iterations);
+  ba.SetLinearSolverType("DENSE_SCHUR");
+  ba.Run();
+
+  for (const auto& rig_instance_fixed : rig_instances_fixed) {
+    if (!rig_instance_fixed.second) {
+      map_.GetRigInstance(rig_instance_fixed.first)
+          .SetPose(ba.GetRigInstance(rig_instance_fixed.first).GetValue());
+    }
+  }
+  for (auto* landmark : landmarks) {
+    landmark->SetGlobalPos(ba.GetPoint(landmark->id_).GetValue());
+  }
+}
+
+void OnlineReconstruction::RemoveFrame(const Frame& frame) {
+  if (!map_.HasShot(frame.shot_id)) {
+    return;
+  }
+  const auto instance_id = map_.GetShot(frame.shot_id).GetRigInstanceId();
+  map_.RemoveShot(frame.shot_id);
+  if (map_.GetRigInstance(instance_id).NumberOfShots() == 0) {
+    map_.RemoveRigInstance(instance_id);
+  }
+}
+
+void OnlineReconstruction::StartSegment() {
+  // The landmarks are in the gauge of the previous segment, so the frames
+  // left in the window start new tracks instead of extending theirs
+  for (auto& frame : frames_) {
+    for (auto& track_id : frame.tracks) {
+      if (!track_id.empty() && map_.HasLandmark(track_id)) {
+        tracks_manager_.RemoveObservation(frame.shot_id, track_id);
+        track_id.clear();
+      }
+    }
+  }
+  initialized_ = false;
+  ++segment_;
+}
+}  // namespace sfm::online_sfm
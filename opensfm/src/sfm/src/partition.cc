@@ -0,0 +1,528 @@
+#include <foundation/tracing.h>
+#include <sfm/partition.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+using Graph = sfm::partition::Graph;
+
+// Tolerated imbalance of a bisection, relative to the weight of the graph
+constexpr double kImbalance = 0.03;
+// Coarsening stops at this number of vertices, or when it stalls
+constexpr int kCoarsestSize = 64;
+constexpr double kMinCoarseningRatio = 0.9;
+// Number of seeds tried for the initial bisection of the coarsest graph
+constexpr int kInitialSeeds = 8;
+constexpr int kRefinementPasses = 8;
+
+// Subgraph induced by the given vertices, indexed in their order
+Graph InducedSubgraph(const Graph& graph, const std::vector<int>& vertices) {
+  std::vector<int> local(graph.NumVertices(), -1);
+  for (int i = 0; i < static_cast<int>(vertices.size()); ++i) {
+    local[vertices[i]] = i;
+  }
+
+  Graph subgraph;
+  subgraph.vertex_weights.reserve(vertices.size());
+  for (const int v : vertices) {
+    for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+      const int u = local[graph.adjacency[e]];
+      if (u >= 0) {
+        subgraph.adjacency.push_back(u);
+        subgraph.edge_weights.push_back(graph.edge_weights[e]);
+      }
+    }
+    subgraph.offsets.push_back(subgraph.adjacency.size());
+    subgraph.vertex_weights.push_back(graph.vertex_weights[v]);
+  }
+  return subgraph;
+}
+
+// Collapse a heavy edge matching of the graph : each vertex is matched with
+// its unmatched neighbor of heaviest edge. Returns the coarse graph and the
+// coarse vertex of each vertex.
+std::pair<Graph, std::vector<int>> Coarsen(const Graph& graph,
+                                           int max_vertex_weight) {
+  const int n = graph.NumVertices();
+
+  // Visit light vertices first so that they get matched
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return graph.vertex_weights[a] < graph.vertex_weights[b];
+  });
+
+  std::vector<int> coarse(n, -1);
+  std::vector<std::vector<int>> members;
+  for (const int v : order) {
+    if (coarse[v] >= 0) {
+      continue;
+    }
+    int match = -1;
+    int match_weight = 0;
+    for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+      const int u = graph.adjacency[e];
+      if (coarse[u] >= 0 || u == v ||
+          graph.vertex_weights[u] + graph.vertex_weights[v] >
+              max_vertex_weight) {
+        continue;
+      }
+      if (graph.edge_weights[e] > match_weight) {
+        match = u;
+        match_weight = graph.edge_weights[e];
+      }
+    }
+    coarse[v] = members.size();
+    members.push_back({v});
+    if (match >= 0) {
+      coarse[match] = coarse[v];
+      members.back().push_back(match);
+    }
+  }
+
+  // Merge the edges of the matched vertices. 'slot' is the position of the
+  // edge towards each coarse vertex, valid if after the current vertex start
+  Graph coarse_graph;
+  std::vector<int> slot(members.size(), -1);
+  for (int c = 0; c < static_cast<int>(members.size()); ++c) {
+    const int start = coarse_graph.adjacency.size();
+    int weight = 0;
+    for (const int v : members[c]) {
+      weight += graph.vertex_weights[v];
+      for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+        const int u = coarse[graph.adjacency[e]];
+        if (u == c) {
+          continue;
+        }
+        if (slot[u] < start) {
+          slot[u] = coarse_graph.adjacency.size();
+          coarse_graph.adjacency.push_back(u);
+          coarse_graph.edge_weights.push_back(graph.edge_weights[e]);
+        } else {
+          coarse_graph.edge_weights[slot[u]] += graph.edge_weights[e];
+        }
+      }
+    }
+    coarse_graph.offsets.push_back(coarse_graph.adjacency.size());
+    coarse_graph.vertex_weights.push_back(weight);
+  }
+  return std::make_pair(std::move(coarse_graph), std::move(coarse));
+}
+
+int64_t CutWeight(const Graph& graph, const std::vector<int>& part) {
+  int64_t cut = 0;
+  for (int v = 0; v < graph.NumVertices(); ++v) {
+    for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+      if (part[v] != part[graph.adjacency[e]]) {
+        cut += graph.edge_weights[e];
+      }
+    }
+  }
+  return cut / 2;
+}
+
+// Weight of the edges of v to the other part minus to its own part
+int64_t MoveGain(const Graph& graph, const std::vector<int>& part, int v) {
+  int64_t gain = 0;
+  for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+    gain += part[graph.adjacency[e]] != part[v] ? graph.edge_weights[e]
+                                                : -graph.edge_weights[e];
+  }
+  return gain;
+}
+
+// Bisection growing part 0 from the seed, by adding the vertex the most
+// connected to it until its weight is the closest to the target one
+std::vector<int> GrowBisection(const Graph& graph, int seed, int target) {
+  const int n = graph.NumVertices();
+  std::vector<int> part(n, 1);
+  std::vector<int64_t> connection(n, 0);
+
+  int weight = 0;
+  int next = seed;
+  while (next >= 0 &&
+         std::abs(weight + graph.vertex_weights[next] - target) <
+             std::abs(weight - target)) {
+    part[next] = 0;
+    weight += graph.vertex_weights[next];
+    for (int e = graph.offsets[next]; e < graph.offsets[next + 1]; ++e) {
+      connection[graph.adjacency[e]] += graph.edge_weights[e];
+    }
+
+    // Unconnected vertices are taken once the component is exhausted
+    next = -1;
+    for (int v = 0; v < n; ++v) {
+      if (part[v] == 1 && (next < 0 || connection[v] > connection[next])) {
+        next = v;
+      }
+    }
+  }
+  return part;
+}
+
+// Move vertices from the heavier part to the other one, best gains first,
+// until part 0 weight is within the tolerance of the target one. Then move
+// boundary vertices while it reduces the cut and keeps the balance.
+//
+// As in Fiduccia-Mattheyses refinement, the gains are computed once and then
+// updated after each move for the neighbors of the moved vertex only. Each
+// part keeps its vertices in a priority queue by gain, whose stale entries
+// are skipped when they reach the top.
+void RefineBisection(const Graph& graph, int target, int tolerance,
+                     std::vector<int>* part) {
+  const int n = graph.NumVertices();
+  auto& sides = *part;
+  int weight = 0;
+  std::vector<int64_t> gains(n);
+  std::priority_queue<std::pair<int64_t, int>> queues[2];
+  for (int v = 0; v < n; ++v) {
+    weight += sides[v] == 0 ? graph.vertex_weights[v] : 0;
+    gains[v] = MoveGain(graph, sides, v);
+    queues[sides[v]].emplace(gains[v], -v);
+  }
+
+  // Vertices set aside since their move was rejected, until the balance
+  // changes enough for them to be considered again
+  std::vector<char> held(n, false);
+  std::vector<int> held_vertices;
+  const auto release_held = [&]() {
+    for (const int v : held_vertices) {
+      held[v] = false;
+      queues[sides[v]].emplace(gains[v], -v);
+    }
+    held_vertices.clear();
+  };
+  const auto hold = [&](int v) {
+    held[v] = true;
+    held_vertices.push_back(v);
+  };
+
+  // Best vertex of a part, or -1 if there's none
+  const auto top = [&](int side) {
+    auto& queue = queues[side];
+    while (!queue.empty()) {
+      const auto entry = queue.top();
+      const int v = -entry.second;
+      if (sides[v] == side && !held[v] && entry.first == gains[v]) {
+        return v;
+      }
+      queue.pop();
+    }
+    return -1;
+  };
+
+  const auto move = [&](int v) {
+    const int from = sides[v];
+    sides[v] = 1 - from;
+    weight += from == 0 ? -graph.vertex_weights[v] : graph.vertex_weights[v];
+    gains[v] = -gains[v];
+    queues[sides[v]].emplace(gains[v], -v);
+    for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+      const int u = graph.adjacency[e];
+      if (u == v) {
+        continue;
+      }
+      // The edge gets cut if u is in the part v left, and uncut otherwise
+      gains[u] += sides[u] == from ? 2 * graph.edge_weights[e]
+                                   : -2 * graph.edge_weights[e];
+      if (!held[u]) {
+        queues[sides[u]].emplace(gains[u], -u);
+      }
+    }
+  };
+
+  // Balancing : the excess only decreases, so a vertex too heavy to move
+  // stays so until the heavier part changes
+  int from = weight > target ? 0 : 1;
+  while (std::abs(weight - target) > tolerance) {
+    const int heavier = weight > target ? 0 : 1;
+    if (heavier != from) {
+      release_held();
+      from = heavier;
+    }
+    const int excess = std::abs(weight - target);
+    const int v = top(from);
+    if (v < 0) {
+      break;
+    }
+    queues[from].pop();
+    if (graph.vertex_weights[v] >= 2 * excess) {
+      hold(v);
+      continue;
+    }
+    move(v);
+  }
+  release_held();
+
+  // Refinement : take the best move of either part as long as it reduces the
+  // cut, or keeps it and improves the balance. Moves rejected for the balance
+  // are retried in the next pass if anything moved.
+  for (int pass = 0; pass < kRefinementPasses; ++pass) {
+    bool moved = false;
+    while (true) {
+      const int v0 = top(0);
+      const int v1 = top(1);
+      if (v0 < 0 && v1 < 0) {
+        break;
+      }
+      const int v = v1 < 0 || (v0 >= 0 && gains[v0] >= gains[v1]) ? v0 : v1;
+      if (gains[v] < 0) {
+        break;
+      }
+      queues[sides[v]].pop();
+
+      const int moved_weight = sides[v] == 0 ? weight - graph.vertex_weights[v]
+                                             : weight + graph.vertex_weights[v];
+      const int moved_imbalance = std::abs(moved_weight - target);
+      const bool balanced = moved_imbalance <= tolerance;
+      const bool improves =
+          gains[v] > 0 || moved_imbalance < std::abs(weight - target);
+      if (balanced && improves) {
+        move(v);
+        moved = true;
+      } else {
+        hold(v);
+      }
+    }
+    release_held();
+    if (!moved) {
+      break;
+    }
+  }
+}
+
+// Multilevel bisection with part 0 of the given target weight
+std::vector<int> Bisect(const Graph& graph, int target) {
+  const int total = graph.TotalWeight();
+  const int tolerance = std::max(
+      1, static_cast<int>(kImbalance * std::min(target, total - target)));
+  const int max_vertex_weight =
+      std::max(1, static_cast<int>(1.5 * total / kCoarsestSize));
+
+  std::vector<Graph> coarse_graphs;
+  std::vector<std::vector<int>> coarse_vertices;
+  const auto level = [&](int l) -> const Graph& {
+    return l == 0 ? graph : coarse_graphs[l - 1];
+  };
+  while (level(coarse_graphs.size()).NumVertices() > kCoarsestSize) {
+    const Graph& finer = level(coarse_graphs.size());
+    auto coarsened = Coarsen(finer, max_vertex_weight);
+    if (coarsened.first.NumVertices() >
+        kMinCoarseningRatio * finer.NumVertices()) {
+      break;
+    }
+    coarse_graphs.emplace_back(std::move(coarsened.first));
+    coarse_vertices.emplace_back(std::move(coarsened.second));
+  }
+
+  // Initial bisection of the coarsest graph : best cut of a few seeds
+  const Graph& coarsest = level(coarse_graphs.size());
+  const int coarsest_tolerance =
+      std::max(tolerance, *std::max_element(coarsest.vertex_weights.begin(),
+                                            coarsest.vertex_weights.end()));
+  std::vector<int> part;
+  int64_t best_cut = 0;
+  const int num_seeds = std::min(kInitialSeeds, coarsest.NumVertices());
+  for (int i = 0; i < num_seeds; ++i) {
+    const int seed = i * coarsest.NumVertices() / num_seeds;
+    auto candidate = GrowBisection(coarsest, seed, target);
+    RefineBisection(coarsest, target, coarsest_tolerance, &candidate);
+    const int64_t cut = CutWeight(coarsest, candidate);
+    if (part.empty() || cut < best_cut) {
+      part = std::move(candidate);
+      best_cut = cut;
+    }
+  }
+
+  // Project back to the finer graphs and refine
+  for (int l = coarse_graphs.size(); l > 0; --l) {
+    const auto& coarse = coarse_vertices[l - 1];
+    std::vector<int> finer_part(coarse.size());
+    for (int v = 0; v < static_cast<int>(coarse.size()); ++v) {
+      finer_part[v] = part[coarse[v]];
+    }
+    part = std::move(finer_part);
+    RefineBisection(level(l - 1), target, tolerance, &part);
+  }
+  return part;
+}
+
+// Assign the vertices (of the original graph) of the given graph to the
+// parts [first_part, first_part + num_parts) by recursive bisection
+void RecursiveBisection(const Graph& graph, const std::vector<int>& vertices,
+                        int first_part, int num_parts,
+                        std::vector<int>* parts) {
+  if (num_parts == 1 || graph.NumVertices() == 0) {
+    for (const int v : vertices) {
+      (*parts)[v] = first_part;
+    }
+    return;
+  }
+
+  const int num_parts0 = num_parts / 2;
+  const int target = static_cast<int64_t>(graph.TotalWeight()) * num_parts0 /
+                     num_parts;
+  const auto bisection = Bisect(graph, target);
+
+  std::vector<int> local[2];
+  std::vector<int> original[2];
+  for (int v = 0; v < graph.NumVertices(); ++v) {
+    local[bisection[v]].push_back(v);
+    original[bisection[v]].push_back(vertices[v]);
+  }
+  RecursiveBisection(InducedSubgraph(graph, local[0]), original[0], first_part,
+                     num_parts0, parts);
+  RecursiveBisection(InducedSubgraph(graph, local[1]), original[1],
+                     first_part + num_parts0, num_parts - num_parts0, parts);
+}
+}  // namespace
+
+namespace sfm::partition {
+
+int Graph::TotalWeight() const {
+  return std::accumulate(vertex_weights.begin(), vertex_weights.end(), 0);
+}
+
+Graph BuildCovisibilityGraph(const map::TracksManager& tracks_manager,
+                             const std::vector<map::ShotId>& shots,
+                             int min_common_tracks) {
+  OPENSFM_TRACE_SCOPE("sfm", "BuildCovisibilityGraph");
+  std::unordered_map<map::ShotId, int> indexes;
+  for (int i = 0; i < static_cast<int>(shots.size()); ++i) {
+    indexes[shots[i]] = i;
+  }
+
+  std::vector<std::vector<std::pair<int, int>>> neighbors(shots.size());
+  for (const auto& pair : tracks_manager.GetAllPairsConnectivity(shots, {})) {
+    if (pair.second < min_common_tracks) {
+      continue;
+    }
+    const int i = indexes.at(pair.first.first);
+    const int j = indexes.at(pair.first.second);
+    neighbors[i].emplace_back(j, pair.second);
+    neighbors[j].emplace_back(i, pair.second);
+  }
+
+  Graph graph;
+  graph.vertex_weights.assign(shots.size(), 1);
+  for (auto& vertex_neighbors : neighbors) {
+    std::sort(vertex_neighbors.begin(), vertex_neighbors.end());
+    for (const auto& neighbor : vertex_neighbors) {
+      graph.adjacency.push_back(neighbor.first);
+      graph.edge_weights.push_back(neighbor.second);
+    }
+    graph.offsets.push_back(graph.adjacency.size());
+  }
+  return graph;
+}
+
+std::vector<int> PartitionGraph(const Graph& graph, int num_parts) {
+  OPENSFM_TRACE_SCOPE("sfm", "PartitionGraph");
+  if (num_parts < 1) {
+    throw std::runtime_error("Number of parts must be positive");
+  }
+  std::vector<int> vertices(graph.NumVertices());
+  std::iota(vertices.begin(), vertices.end(), 0);
+  std::vector<int> parts(graph.NumVertices(), 0);
+  RecursiveBisection(graph, vertices, 0, num_parts, &parts);
+  return parts;
+}
+
+std::vector<int> GrowPart(const Graph& graph, const std::vector<int>& part,
+                          int count) {
+  std::vector<char> in_part(graph.NumVertices(), false);
+  for (const int v : part) {
+    in_part[v] = true;
+  }
+
+  // Connection of the vertices to the part, lazily updated in the queue
+  std::vector<int64_t> connection(graph.NumVertices(), 0);
+  std::priority_queue<std::pair<int64_t, int>> queue;
+  const auto add = [&](int v) {
+    for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+      const int u = graph.adjacency[e];
+      if (!in_part[u]) {
+        connection[u] += graph.edge_weights[e];
+        queue.emplace(connection[u], -u);
+      }
+    }
+  };
+  for (const int v : part) {
+    add(v);
+  }
+
+  std::vector<int> grown;
+  while (static_cast<int>(grown.size()) < count && !queue.empty()) {
+    const auto top = queue.top();
+    queue.pop();
+    const int v = -top.second;
+    if (in_part[v] || top.first != connection[v]) {
+      continue;
+    }
+    in_part[v] = true;
+    grown.push_back(v);
+    add(v);
+  }
+  return grown;
+}
+
+Partition PartitionShots(const map::TracksManager& tracks_manager,
+                         const std::vector<map::ShotId>& shots,
+                         const Parameters& parameters) {
+  OPENSFM_TRACE_SCOPE("sfm", "PartitionShots");
+  if (parameters.max_cluster_size < 1) {
+    throw std::runtime_error("Cluster size must be positive");
+  }
+  const auto shot_ids = shots.empty() ? tracks_manager.GetShotIds() : shots;
+  const auto graph = BuildCovisibilityGraph(tracks_manager, shot_ids,
+                                            parameters.min_common_tracks);
+
+  // Clusters are made smaller than the maximum size to leave room for their
+  // overlap and for the imbalance of the partition
+  const int n = shot_ids.size();
+  const double capacity = std::max(
+      1.0, parameters.max_cluster_size / (1.0 + parameters.overlap));
+  const int num_parts = std::max(
+      1, static_cast<int>(std::ceil(n * (1.0 + kImbalance) / capacity)));
+  const auto parts = PartitionGraph(graph, std::min(num_parts, std::max(n, 1)));
+
+  // Drop empty parts
+  std::vector<std::vector<int>> members;
+  std::vector<int> labels(n);
+  std::unordered_map<int, int> part_labels;
+  for (int v = 0; v < n; ++v) {
+    const auto it = part_labels.emplace(parts[v], members.size());
+    if (it.second) {
+      members.emplace_back();
+    }
+    labels[v] = it.first->second;
+    members[labels[v]].push_back(v);
+  }
+
+  Partition partition;
+  for (int v = 0; v < n; ++v) {
+    partition.labels[shot_ids[v]] = labels[v];
+  }
+  partition.clusters.resize(members.size());
+#pragma omp parallel for num_threads(parameters.num_threads) schedule(dynamic)
+  for (int c = 0; c < static_cast<int>(members.size()); ++c) {
+    const int size = members[c].size();
+    const int overlap =
+        std::min(static_cast<int>(std::round(parameters.overlap * size)),
+                 parameters.max_cluster_size - size);
+    auto& cluster = partition.clusters[c];
+    for (const int v : members[c]) {
+      cluster.push_back(shot_ids[v]);
+    }
+    for (const int v : GrowPart(graph, members[c], std::max(overlap, 0))) {
+      cluster.push_back(shot_ids[v]);
+    }
+  }
+  return partition;
+}
+}  // namespace sfm::partition
@@ -0,0 +1,305 @@
+#include <bundle/bundle_adjuster.h>
+#include <foundation/numeric.h>
+#include <foundation/tracing.h>
+#include <sfm/pose_refinement.h>
+#include <sfm/refinement_helpers.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Levenberg-Marquardt damping of the normal equations diagonal
+constexpr double kInitialLambda = 1e-4;
+constexpr double kMinLambda = 1e-10;
+constexpr double kMaxLambda = 1e10;
+
+using Vec6d = VecNd<6>;
+using Mat6d = Eigen::Matrix<double, 6, 6>;
+
+struct ObservationData {
+  Vec3d point;
+  Mat3d rig_rotation;  // Instance to camera
+  Vec3d rig_translation;
+  geometry::ProjectionType projection_type;
+  const VecXd* camera_parameters;
+  // Observed point, or bearing for spherical cameras
+  Vec3d observed;
+  double inverse_scale;
+  std::optional<map::Depth> depth_prior;
+};
+
+struct InstanceData {
+  map::RigInstance* instance;
+  bool has_position_prior{false};
+  Vec3d position_prior;
+  double position_inverse_std{0.0};
+};
+
+// Linearization of the cost of an instance, with respect to a perturbation
+// (rotation, then translation) applied on the left of its pose
+struct System {
+  double cost{0.0};
+  Mat6d hessian{Mat6d::Zero()};
+  Vec6d gradient{Vec6d::Zero()};
+};
+
+struct InstanceResult {
+  double initial_cost{0.0};
+  double final_cost{0.0};
+  int iterations{0};
+  bool converged{false};
+  bool skipped{false};
+};
+
+// Reweighting by the loss derivative gives the robustified normal equations
+// (without the second order correction of ceres)
+template <int N>
+void AddResidual(const ceres::LossFunction* loss, const VecNd<N>& residual,
+                 const Eigen::Matrix<double, N, 6>& jacobian,
+                 System* system) {
+  double rho[3] = {residual.squaredNorm(), 1.0, 0.0};
+  if (loss) {
+    loss->Evaluate(residual.squaredNorm(), rho);
+  }
+  system->cost += 0.5 * rho[0];
+  system->hessian += rho[1] * jacobian.transpose() * jacobian;
+  system->gradient += rho[1] * jacobian.transpose() * residual;
+}
+
+System Linearize(const InstanceData& instance,
+                 const ObservationData* observations, int count,
+                 const ceres::LossFunction* loss, const Mat3d& rotation,
+                 const Vec3d& translation) {
+  System system;
+  Vec3d residual;
+  Mat3d camera_jacobian;
+  Eigen::Matrix<double, 3, 6> point_jacobian;
+  for (int i = 0; i < count; ++i) {
+    const auto& observation = observations[i];
+    const Vec3d rotated = rotation * observation.point;
+    const Vec3d camera_point =
+        observation.rig_rotation * (rotated + translation) +
+        observation.rig_translation;
+    point_jacobian << -observation.rig_rotation *
+                          foundation::SkewMatrix(rotated),
+        observation.rig_rotation;
+
+    sfm::refinement_helpers::CameraResidual(
+        observation.projection_type, *observation.camera_parameters,
+        observation.observed, camera_point, &residual, &camera_jacobian);
+    const Eigen::Matrix<double, 3, 6> jacobian =
+        observation.inverse_scale * camera_jacobian * point_jacobian;
+    AddResidual<3>(loss, observation.inverse_scale * residual, jacobian,
+                   &system);
+
+    if (observation.depth_prior) {
+      const auto& depth = *observation.depth_prior;
+      const double norm = camera_point.norm();
+      const Eigen::RowVector3d depth_jacobian =
+          depth.is_radial ? Eigen::RowVector3d(camera_point / norm)
+                          : Eigen::RowVector3d(0.0, 0.0, 1.0);
+      const double predicted = depth.is_radial ? norm : camera_point(2);
+      AddResidual<1>(
+          loss, VecNd<1>((predicted - depth.value) / depth.std_deviation),
+          depth_jacobian * point_jacobian / depth.std_deviation, &system);
+    }
+  }
+
+  // The prior isn't robustified, as in the bundle adjustment
+  if (instance.has_position_prior) {
+    const Mat3d rotation_t = rotation.transpose();
+    const Vec3d origin = -rotation_t * translation;
+    Eigen::Matrix<double, 3, 6> prior_jacobian;
+    prior_jacobian << -rotation_t * foundation::SkewMatrix(translation),
+        -rotation_t;
+    AddResidual<3>(
+        nullptr,
+        instance.position_inverse_std * (origin - instance.position_prior),
+        instance.position_inverse_std * prior_jacobian, &system);
+  }
+  return system;
+}
+
+InstanceResult RefineInstance(
+    const InstanceData& instance, const ObservationData* observations,
+    int count, const ceres::LossFunction* loss,
+    const sfm::pose_refinement::Parameters& parameters, Mat3d* rotation,
+    Vec3d* translation) {
+  InstanceResult result;
+  if (count < 3) {
+    result.skipped = true;
+    return result;
+  }
+
+  auto system =
+      Linearize(instance, observations, count, loss, *rotation, *translation);
+  result.initial_cost = system.cost;
+  double lambda = kInitialLambda;
+  while (result.iterations < parameters.max_iterations) {
+    if (system.gradient.lpNorm<Eigen::Infinity>() <=
+        parameters.gradient_tolerance) {
+      result.converged = true;
+      break;
+    }
+    Mat6d damped = system.hessian;
+    damped.diagonal() *= 1.0 + lambda;
+    const Eigen::LDLT<Mat6d> ldlt(damped);
+    if (ldlt.info() != Eigen::Success || !ldlt.isPositive() ||
+        !(ldlt.rcond() > 1e-14)) {
+      result.skipped = result.iterations == 0;
+      break;
+    }
+    const Vec6d step = -ldlt.solve(system.gradient);
+    if (!step.allFinite()) {
+      result.skipped = result.iterations == 0;
+      break;
+    }
+    ++result.iterations;
+
+    // While the damping is low, the step is close to the Gauss-Newton one and
+    // measures the distance to the minimum
+    const double tolerance =
+        parameters.step_tolerance * (translation->norm() + 1.0);
+    if (lambda <= kInitialLambda && step.norm() <= tolerance) {
+      result.converged = true;
+      break;
+    }
+
+    // Steps increasing the cost are retried with more damping, which brings
+    // them towards a shorter gradient descent step. Giving up isn't
+    // converging.
+    const Mat3d candidate_rotation =
+        geometry::VectorToRotationMatrix(step.head<3>()) * *rotation;
+    const Vec3d candidate_translation = *translation + step.tail<3>();
+    const auto candidate_system =
+        Linearize(instance, observations, count, loss, candidate_rotation,
+                  candidate_translation);
+    if (!(candidate_system.cost <= system.cost)) {
+      lambda *= 10.0;
+      if (lambda > kMaxLambda) {
+        break;
+      }
+      continue;
+    }
+    *rotation = candidate_rotation;
+    *translation = candidate_translation;
+    system = candidate_system;
+    lambda = std::max(0.1 * lambda, kMinLambda);
+  }
+  result.final_cost = system.cost;
+  return result;
+}
+}  // namespace
+
+namespace sfm::pose_refinement {
+
+Parameters ParametersFromConfig(const py::dict& config) {
+  Parameters parameters;
+  parameters.loss_function = config["loss_function"].cast<std::string>();
+  parameters.loss_function_threshold =
+      config["loss_function_threshold"].cast<double>();
+  parameters.use_gps = config["bundle_use_gps"].cast<bool>();
+  parameters.num_threads = config["processes"].cast<int>();
+  return parameters;
+}
+
+Statistics RefineShotPoses(map::Map& map,
+                           const std::unordered_set<map::ShotId>& shot_ids,
+                           const Parameters& parameters) {
+  OPENSFM_TRACE_SCOPE("sfm", "RefineShotPoses");
+  const std::unique_ptr<ceres::LossFunction> loss(bundle::CreateLossFunction(
+      parameters.loss_function, parameters.loss_function_threshold));
+
+  std::unordered_set<map::RigInstance*> visited;
+  std::vector<InstanceData> instances;
+  for (const auto& shot_id : shot_ids) {
+    auto* instance = map.GetShot(shot_id).GetRigInstance();
+    if (visited.insert(instance).second) {
+      instances.push_back({instance});
+    }
+  }
+
+  // The observations of all the shots of each instance, flat and contiguous
+  // per instance, with the fixed rig cameras poses and cameras
+  std::unordered_map<const geometry::Camera*, VecXd> camera_parameters;
+  std::vector<int> offsets = {0};
+  std::vector<ObservationData> observations;
+  offsets.reserve(instances.size() + 1);
+  for (auto& instance : instances) {
+    Vec3d average_position = Vec3d::Zero();
+    double average_std = 0.0;
+    int gps_count = 0;
+    for (const auto& shot_it : instance.instance->GetShots()) {
+      const auto& shot = *shot_it.second;
+      const auto* camera = shot.GetCamera();
+      auto find_camera = camera_parameters.find(camera);
+      if (find_camera == camera_parameters.end()) {
+        find_camera =
+            camera_parameters.emplace(camera, camera->GetParametersValues())
+                .first;
+      }
+      const auto& rig_camera_pose = shot.GetRigCamera()->pose;
+      const Mat3d rig_rotation = rig_camera_pose.RotationWorldToCamera();
+      const Vec3d rig_translation = rig_camera_pose.TranslationWorldToCamera();
+      for (const auto& landmark_observation : shot.GetLandmarkObservations()) {
+        const auto& observation = landmark_observation.second;
+        observations.push_back(
+            {landmark_observation.first->GetGlobalPos(), rig_rotation,
+             rig_translation, camera->GetProjectionType(),
+             &find_camera->second,
+             refinement_helpers::ObservedTarget(*camera, observation.point),
+             1.0 / observation.scale, observation.depth_prior});
+      }
+
+      const auto& measurements = shot.GetShotMeasurements();
+      if (parameters.use_gps && measurements.gps_position_.HasValue() &&
+          measurements.gps_accuracy_.HasValue()) {
+        average_position += measurements.gps_position_.Value();
+        average_std += measurements.gps_accuracy_.Value();
+        ++gps_count;
+      }
+    }
+    offsets.push_back(observations.size());
+
+    if (gps_count > 0) {
+      instance.has_position_prior = true;
+      instance.position_prior = average_position / gps_count;
+      instance.position_inverse_std = gps_count / average_std;
+    }
+  }
+
+  const int num_instances = instances.size();
+  std::vector<InstanceResult> results(num_instances);
+#pragma omp parallel for num_threads(parameters.num_threads) \
+    schedule(dynamic, 4)
+  for (int i = 0; i < num_instances; ++i) {
+    auto& pose = instances[i].instance->GetPose();
+    Mat3d rotation = pose.RotationWorldToCamera();
+    Vec3d translation = pose.TranslationWorldToCamera();
+    results[i] = RefineInstance(instances[i], observations.data() + offsets[i],
+                                offsets[i + 1] - offsets[i], loss.get(),
+                                parameters, &rotation, &translation);
+    if (!results[i].skipped) {
+      pose.SetFromWorldToCamera(rotation, translation);
+    }
+  }
+
+  Statistics statistics;
+  statistics.num_instances = num_instances;
+  for (const auto& result : results) {
+    if (result.skipped) {
+      ++statistics.num_skipped;
+      continue;
+    }
+    statistics.num_converged += result.converged;
+    statistics.num_iterations += result.iterations;
+    statistics.initial_cost += result.initial_cost;
+    statistics.final_cost += result.final_cost;
+  }
+  return statistics;
+}
+}  // namespace sfm::pose_refinement
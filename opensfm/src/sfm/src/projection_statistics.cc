@@ -0,0 +1,215 @@
+#include <foundation/tracing.h>
+#include <sfm/projection_statistics.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct ObservationError {
+  double normalized;
+  double pixels;
+  double angular;
+  Vec2d normalized_error;
+  int bucket;
+};
+
+struct ShotErrors {
+  const map::Shot* shot;
+  std::vector<ObservationError> errors;
+};
+
+std::pair<int, int> GridSize(const geometry::Camera& camera, int buckets) {
+  if (camera.GetProjectionType() == geometry::ProjectionType::SPHERICAL) {
+    return std::make_pair(2 * buckets, buckets);
+  }
+  return std::make_pair(buckets, buckets);
+}
+
+void ComputeShotErrors(
+    const map::Map& map, const map::TracksManager& tracks_manager,
+    const sfm::projection_statistics::Parameters& parameters,
+    ShotErrors* shot_errors) {
+  const auto& shot = *shot_errors->shot;
+  const auto& camera = *shot.GetCamera();
+  const auto& pose = *shot.GetPose();
+  const auto& landmarks = map.GetLandmarks();
+
+  const double width = camera.width;
+  const double height = camera.height;
+  const double normalizer = std::max(width, height);
+  const Vec2d center(width / 2.0, height / 2.0);
+  const auto grid_size = GridSize(camera, parameters.grid_buckets);
+  const double bucket_x = grid_size.first / width;
+  const double bucket_y = grid_size.second / height;
+
+  const auto& observations = tracks_manager.GetShotObservations(shot.GetId());
+  shot_errors->errors.reserve(observations.size());
+  for (const auto& track_n_obs : observations) {
+    const auto find_landmark = landmarks.find(track_n_obs.first);
+    if (find_landmark == landmarks.end()) {
+      continue;
+    }
+    const auto& observation = track_n_obs.second;
+    const Vec3d& position = find_landmark->second.GetGlobalPos();
+
+    const Vec2d error =
+        observation.point -
+        camera.Project(pose.TransformWorldToCamera(position));
+    ObservationError result;
+    result.pixels = error.norm() * normalizer;
+    if (!(result.pixels <= parameters.pixel_cutoff)) {
+      continue;
+    }
+    result.normalized_error = error / observation.scale;
+    result.normalized = result.normalized_error.norm();
+
+    const Vec3d direction = (position - pose.GetOrigin()).normalized();
+    const Vec3d bearing =
+        (pose.RotationCameraToWorld() * camera.Bearing(observation.point))
+            .normalized();
+    result.angular = std::acos(direction.dot(bearing));
+
+    const Vec2d bucket = observation.point * normalizer + center;
+    const int x = std::clamp(static_cast<int>(bucket(0) * bucket_x), 0,
+                             grid_size.first - 1);
+    const int y = std::clamp(static_cast<int>(bucket(1) * bucket_y), 0,
+                             grid_size.second - 1);
+    result.bucket = y * grid_size.first + x;
+    shot_errors->errors.push_back(result);
+  }
+}
+}  // namespace
+
+namespace sfm::projection_statistics {
+
+Histogram ComputeHistogram(const std::vector<double>& values, int bins) {
+  Histogram histogram;
+  if (values.empty() || bins < 1) {
+    return histogram;
+  }
+  const auto min_max = std::minmax_element(values.begin(), values.end());
+  double first = *min_max.first;
+  double last = *min_max.second;
+  if (first == last) {
+    first -= 0.5;
+    last += 0.5;
+  }
+
+  histogram.edges.resize(bins + 1);
+  const double step = (last - first) / bins;
+  for (int i = 0; i < bins; ++i) {
+    histogram.edges[i] = first + i * step;
+  }
+  histogram.edges[bins] = last;
+
+  // Bin from the values position, corrected against the edges for rounding
+  histogram.counts.assign(bins, 0);
+  const double norm = bins / (last - first);
+  for (const double value : values) {
+    int index = std::min(static_cast<int>((value - first) * norm), bins - 1);
+    if (value < histogram.edges[index]) {
+      --index;
+    } else if (index != bins - 1 && value >= histogram.edges[index + 1]) {
+      ++index;
+    }
+    ++histogram.counts[index];
+  }
+  return histogram;
+}
+
+Statistics ComputeProjectionStatistics(
+    const std::vector<const map::Map*>& maps,
+    const map::TracksManager& tracks_manager, const Parameters& parameters) {
+  OPENSFM_TRACE_SCOPE("sfm", "ComputeProjectionStatistics");
+
+  std::vector<const map::Map*> shot_maps;
+  std::vector<ShotErrors> shots_errors;
+  for (const auto* map : maps) {
+    const auto& shots = map->GetShots();
+    for (const auto& shot_id : tracks_manager.GetShotIds()) {
+      const auto find_shot = shots.find(shot_id);
+      if (find_shot == shots.end()) {
+        continue;
+      }
+      shot_maps.push_back(map);
+      shots_errors.push_back({&find_shot->second, {}});
+    }
+  }
+
+  const int num_shots = shots_errors.size();
+#pragma omp parallel for num_threads(parameters.num_threads) \
+    schedule(dynamic, 4)
+  for (int i = 0; i < num_shots; ++i) {
+    ComputeShotErrors(*shot_maps[i], tracks_manager, parameters,
+                      &shots_errors[i]);
+  }
+
+  Statistics statistics;
+  std::vector<double> all_normalized, all_pixels, all_angular;
+  for (const auto& shot_errors : shots_errors) {
+    const auto& camera = *shot_errors.shot->GetCamera();
+    auto find_camera = statistics.cameras.find(camera.id);
+    if (find_camera == statistics.cameras.end()) {
+      CameraStatistics camera_statistics;
+      const auto grid_size = GridSize(camera, parameters.grid_buckets);
+      camera_statistics.grid_width = grid_size.first;
+      camera_statistics.grid_height = grid_size.second;
+      camera_statistics.grid_errors.assign(grid_size.first * grid_size.second,
+                                           Vec2d::Zero());
+      camera_statistics.grid_counts.assign(grid_size.first * grid_size.second,
+                                           0);
+      find_camera =
+          statistics.cameras.emplace(camera.id, std::move(camera_statistics))
+              .first;
+    }
+    auto& camera_statistics = find_camera->second;
+
+    for (const auto& error : shot_errors.errors) {
+      camera_statistics.grid_errors[error.bucket] += error.normalized_error;
+      ++camera_statistics.grid_counts[error.bucket];
+      if (std::isnan(error.angular)) {
+        continue;
+      }
+      ++camera_statistics.count;
+      camera_statistics.mean_normalized += error.normalized;
+      camera_statistics.mean_pixels += error.pixels;
+      camera_statistics.mean_angular += error.angular;
+      all_normalized.push_back(error.normalized);
+      all_pixels.push_back(error.pixels);
+      all_angular.push_back(error.angular);
+    }
+  }
+
+  for (auto& camera_it : statistics.cameras) {
+    auto& camera_statistics = camera_it.second;
+    if (camera_statistics.count > 0) {
+      camera_statistics.mean_normalized /= camera_statistics.count;
+      camera_statistics.mean_pixels /= camera_statistics.count;
+      camera_statistics.mean_angular /= camera_statistics.count;
+    }
+  }
+
+  statistics.count = all_normalized.size();
+  if (statistics.count == 0) {
+    return statistics;
+  }
+  const auto mean = [](const std::vector<double>& values) {
+    double sum = 0.0;
+    for (const double value : values) {
+      sum += value;
+    }
+    return sum / values.size();
+  };
+  statistics.mean_normalized = mean(all_normalized);
+  statistics.mean_pixels = mean(all_pixels);
+  statistics.mean_angular = mean(all_angular);
+  statistics.histogram_normalized =
+      ComputeHistogram(all_normalized, parameters.histogram_bins);
+  statistics.histogram_pixels =
+      ComputeHistogram(all_pixels, parameters.histogram_bins);
+  statistics.histogram_angular =
+      ComputeHistogram(all_angular, parameters.histogram_bins);
+  return statistics;
+}
+}  // namespace sfm::projection_statistics
@@ -0,0 +1,50 @@
+#include <geometry/camera_instances.h>
+#include <sfm/refinement_helpers.h>
+
+namespace {
+// Projection of a point in camera coordinates, and its 2x3 jacobian
+struct ProjectPointDerivatives {
+  template <class TYPE, class T>
+  static void Apply(const T* point, const T* parameters, T* projected,
+                    T* jacobian) {
+    TYPE::template ForwardDerivatives<T, false>(point, parameters, projected,
+                                                jacobian);
+  }
+};
+}  // namespace
+
+namespace sfm::refinement_helpers {
+
+Vec3d ObservedTarget(const geometry::Camera& camera, const Vec2d& point) {
+  if (camera.GetProjectionType() == geometry::ProjectionType::SPHERICAL) {
+    return camera.Bearing(point);
+  }
+  return Vec3d(point(0), point(1), 0.0);
+}
+
+void CameraResidual(geometry::ProjectionType projection_type,
+                    const VecXd& camera_parameters, const Vec3d& observed,
+                    const Vec3d& camera_point, Vec3d* residual,
+                    Mat3d* jacobian) {
+  if (projection_type == geometry::ProjectionType::SPHERICAL) {
+    const double norm = camera_point.norm();
+    const Vec3d bearing = camera_point / norm;
+    *residual = bearing - observed;
+    *jacobian = (Mat3d::Identity() - bearing * bearing.transpose()) / norm;
+    return;
+  }
+
+  Vec2d projected;
+  Eigen::Matrix<double, 2, 3, Eigen::RowMajor> projection_jacobian;
+  geometry::Dispatch<ProjectPointDerivatives>(
+      projection_type, camera_point.data(), camera_parameters.data(),
+      projected.data(), projection_jacobian.data());
+  *residual << projected - observed.head<2>(), 0.0;
+  jacobian->topRows<2>() = projection_jacobian;
+  jacobian->row(2).setZero();
+}
+
+int ResidualSize(geometry::ProjectionType projection_type) {
+  return projection_type == geometry::ProjectionType::SPHERICAL ? 3 : 2;
+}
+}  // namespace sfm::refinement_helpers
@@ -1,28 +1,45 @@
+#include <foundation/tracing.h>
 #include <map/defines.h>
 #include <map/tracks_manager.h>
 #include <sfm/retriangulation.h>
 
 #include <limits>
-#include <unordered_set>
+#include <vector>
 
 namespace sfm::retriangulation {
 void RealignMaps(const map::Map& map_from, map::Map& map_to,
-                 bool update_points) {
+                 bool update_points, int num_threads) {
+  OPENSFM_TRACE_SCOPE("sfm", "RealignMaps");
   const auto& map_from_shots = map_from.GetShots();
 
   const auto& from_ref = map_from.GetTopocentricConverter();
   const auto& to_ref = map_to.GetTopocentricConverter();
   const auto& from_to_offset = to_ref.ToTopocentric(from_ref.GetLlaRef());
 
-  // first, record transforms that remap points of 'to'
-  std::unordered_map<map::ShotId, geometry::Similarity> from_to_transforms;
+  // first, record the shots of 'to' and the transforms that remap their
+  // points, in flat arrays indexed by shot
+  std::unordered_map<const map::Shot*, int> shot_indices;
+  std::vector<char> has_transform;
+  std::vector<Vec3d> shot_origins;
+  std::vector<geometry::Similarity> from_to_transforms;
+  const auto num_shots = map_to.GetShots().size();
+  shot_indices.reserve(num_shots);
+  has_transform.reserve(num_shots);
+  shot_origins.reserve(num_shots);
+  from_to_transforms.reserve(num_shots);
   for (const auto& shot_to : map_to.GetShots()) {
-    if (!map_from.HasShot(shot_to.first)) {
+    const auto shot_to_pose = *shot_to.second.GetPose();
+    shot_indices[&shot_to.second] = shot_origins.size();
+    shot_origins.push_back(shot_to_pose.GetOrigin());
+
+    const auto find_shot_from = map_from_shots.find(shot_to.first);
+    if (find_shot_from == map_from_shots.end()) {
+      has_transform.push_back(false);
+      from_to_transforms.emplace_back();
       continue;
     }
-    const auto& shot_from = map_from.GetShot(shot_to.first);
+    const auto& shot_from = find_shot_from->second;
     auto shot_from_pose = *shot_from.GetPose();
-    const auto shot_to_pose = *shot_to.second.GetPose();
 
     // put 'from' in LLA of 'to'
     shot_from_pose.SetOrigin(shot_from_pose.GetOrigin() + from_to_offset);
@@ -39,71 +56,76 @@ void RealignMaps(const map::Map& map_from, map::Map& map_to,
     const Vec3d t_from_to = -scale * R_to_from * shot_to_pose.GetOrigin() +
                             shot_from_pose.GetOrigin();
 
-    from_to_transforms[shot_to.first] =
-        geometry::Similarity(R_to_from, t_from_to, scale);
+    has_transform.push_back(true);
+    from_to_transforms.emplace_back(R_to_from, t_from_to, scale);
   }
 
-  // remap points of 'to' using the computed transforms if needed
+  // remap points of 'to' using the transform of their closest shot which is
+  // also in 'from', if needed. Landmarks are independent of each other.
   if (update_points) {
-    constexpr auto max_dbl = std::numeric_limits<double>::max();
+    std::vector<map::Landmark*> landmarks;
+    landmarks.reserve(map_to.GetLandmarks().size());
     for (auto& lm : map_to.GetLandmarks()) {
-      const auto point = lm.second.GetGlobalPos();
-      std::pair<double, map::ShotId> best_shot = std::make_pair(max_dbl, "");
-      for (const auto& shot_n_obs : lm.second.GetObservations()) {
-        const auto shot = shot_n_obs.first;
-        if (map_from_shots.find(shot->GetId()) == map_from_shots.end()) {
+      landmarks.push_back(&lm.second);
+    }
+
+    const int num_landmarks = landmarks.size();
+#pragma omp parallel for num_threads(num_threads) schedule(static, 1024)
+    for (int i = 0; i < num_landmarks; ++i) {
+      auto& lm = *landmarks[i];
+      const Vec3d point = lm.GetGlobalPos();
+      double best_dist2 = std::numeric_limits<double>::max();
+      int best_shot = -1;
+      for (const auto& shot_n_obs : lm.GetObservations()) {
+        const auto find_shot = shot_indices.find(shot_n_obs.first);
+        if (find_shot == shot_indices.end() ||
+            !has_transform[find_shot->second]) {
           continue;
         }
-        const Vec3d ray = point - shot->GetPose()->GetOrigin();
-        const double dist2 = ray.squaredNorm();
-        if (dist2 < best_shot.first) {
-          best_shot = std::make_pair(dist2, shot->GetId());
+        const int shot = find_shot->second;
+        const double dist2 = (point - shot_origins[shot]).squaredNorm();
+        if (dist2 < best_dist2) {
+          best_dist2 = dist2;
+          best_shot = shot;
         }
       }
-
-      if (best_shot.first == max_dbl) {
-        continue;
+      if (best_shot >= 0) {
+        lm.SetGlobalPos(from_to_transforms[best_shot].Transform(point));
       }
-      const auto reference_shot = best_shot.second;
-      if (from_to_transforms.find(reference_shot) == from_to_transforms.end()) {
-        continue;
-      }
-      const auto transform = from_to_transforms.at(reference_shot);
-      lm.second.SetGlobalPos(transform.Transform(lm.second.GetGlobalPos()));
-    }
-  }
-
-  // finally, map shots and instances
-  std::unordered_set<map::ShotId> to_delete;
-  for (auto& shot_to : map_to.GetShots()) {
-    // remember any shot not in 'from' but in 'to' for further deletion
-    if (!map_from.HasShot(shot_to.first)) {
-      to_delete.insert(shot_to.first);
-      continue;
     }
-
-    // copy cameras and some metadata
-    const auto& shot_from = map_from.GetShot(shot_to.first);
-    auto& camera_to = map_to.GetCamera(shot_to.second.GetCamera()->id);
-    camera_to.SetParametersValues(shot_from.GetCamera()->GetParametersValues());
-
-    shot_to.second.scale = shot_from.scale;
-    shot_to.second.merge_cc = shot_from.merge_cc;
   }
 
-  // only map rig instances (assuming rig camera didn't change)
+  // finally, map shots and rig instances (assuming rig camera didn't change)
+  std::vector<map::ShotId> to_delete;
   for (auto& rig_instance_to : map_to.GetRigInstances()) {
-    for (const auto& any_shot : rig_instance_to.second.GetShots()) {
-      if (map_from_shots.find(any_shot.first) != map_from_shots.end()) {
-        const auto& any_shot_from = map_from_shots.at(any_shot.first);
-        auto& to_pose = rig_instance_to.second.GetPose();
+    bool has_pose = false;
+    for (const auto& shot : rig_instance_to.second.GetShots()) {
+      if (!shot_indices.count(shot.second)) {
+        continue;  // pano shots
+      }
 
-        // assign 'from' pose
-        to_pose = any_shot_from.GetRigInstance()->GetPose();
+      // remember any shot not in 'from' but in 'to' for further deletion
+      const auto find_shot_from = map_from_shots.find(shot.first);
+      if (find_shot_from == map_from_shots.end()) {
+        to_delete.push_back(shot.first);
+        continue;
+      }
 
-        // put 'from' to 'to' LLA
+      // copy cameras and some metadata
+      const auto& shot_from = find_shot_from->second;
+      auto& shot_to = *shot.second;
+      auto& camera_to = map_to.GetCamera(shot_to.GetCamera()->id);
+      camera_to.SetParametersValues(
+          shot_from.GetCamera()->GetParametersValues());
+      shot_to.scale = shot_from.scale;
+      shot_to.merge_cc = shot_from.merge_cc;
+
+      if (!has_pose) {
+        // assign 'from' pose, put in 'to' LLA
+        auto& to_pose = rig_instance_to.second.GetPose();
+        to_pose = shot_from.GetRigInstance()->GetPose();
         to_pose.SetOrigin(to_pose.GetOrigin() + from_to_offset);
-        break;
+        has_pose = true;
       }
     }
   }
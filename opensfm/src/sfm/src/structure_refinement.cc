@@ -0,0 +1,255 @@
+#include <bundle/bundle_adjuster.h>
+#include <foundation/tracing.h>
+#include <sfm/refinement_helpers.h>
+#include <sfm/structure_refinement.h>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Levenberg-Marquardt damping of the normal equations diagonal
+constexpr double kInitialLambda = 1e-4;
+constexpr double kMinLambda = 1e-10;
+constexpr double kMaxLambda = 1e10;
+
+struct ShotData {
+  map::Shot* shot;
+  Mat3d rotation;  // World to camera
+  Vec3d translation;
+  geometry::ProjectionType projection_type;
+  const VecXd* camera_parameters;
+};
+
+struct ObservationData {
+  const ShotData* shot;
+  // Observed point, or bearing for spherical cameras
+  Vec3d observed;
+  double inverse_scale;
+};
+
+// Linearization of the robustified cost of a point
+struct System {
+  double cost{0.0};
+  Mat3d hessian{Mat3d::Zero()};
+  Vec3d gradient{Vec3d::Zero()};
+};
+
+struct PointResult {
+  double initial_cost{0.0};
+  double final_cost{0.0};
+  int iterations{0};
+  bool converged{false};
+  bool skipped{false};
+};
+
+/* Unscaled residual of an observation and its jacobian with respect to the
+ * point. Projection residuals have a zero third coordinate. */
+void EvaluateResidual(const ObservationData& observation, const Vec3d& point,
+                      Vec3d* residual, Mat3d* jacobian) {
+  const auto& shot = *observation.shot;
+  const Vec3d camera_point = shot.rotation * point + shot.translation;
+  Mat3d camera_jacobian;
+  sfm::refinement_helpers::CameraResidual(
+      shot.projection_type, *shot.camera_parameters, observation.observed,
+      camera_point, residual, &camera_jacobian);
+  *jacobian = camera_jacobian * shot.rotation;
+}
+
+System Linearize(const ObservationData* observations, int count,
+                 const ceres::LossFunction* loss, const Vec3d& point) {
+  System system;
+  Vec3d residual;
+  Mat3d jacobian;
+  for (int i = 0; i < count; ++i) {
+    const auto& observation = observations[i];
+    EvaluateResidual(observation, point, &residual, &jacobian);
+    residual *= observation.inverse_scale;
+    jacobian *= observation.inverse_scale;
+
+    // Reweighting by the loss derivative gives the robustified normal
+    // equations (without the second order correction of ceres). A null
+    // loss is the trivial one, as in ceres.
+    const double squared_norm = residual.squaredNorm();
+    double rho[3] = {squared_norm, 1.0, 0.0};
+    if (loss) {
+      loss->Evaluate(squared_norm, rho);
+    }
+    system.cost += 0.5 * rho[0];
+    system.hessian += rho[1] * jacobian.transpose() * jacobian;
+    system.gradient += rho[1] * jacobian.transpose() * residual;
+  }
+  return system;
+}
+
+PointResult RefinePoint(const ObservationData* observations, int count,
+                        const ceres::LossFunction* loss,
+                        const sfm::structure_refinement::Parameters& parameters,
+                        Vec3d* point) {
+  PointResult result;
+  if (count < 2) {
+    result.skipped = true;
+    return result;
+  }
+
+  auto system = Linearize(observations, count, loss, *point);
+  result.initial_cost = system.cost;
+  double lambda = kInitialLambda;
+  while (result.iterations < parameters.max_iterations) {
+    if (system.gradient.lpNorm<Eigen::Infinity>() <=
+        parameters.gradient_tolerance) {
+      result.converged = true;
+      break;
+    }
+    Mat3d damped = system.hessian;
+    damped.diagonal() *= 1.0 + lambda;
+    const Eigen::LDLT<Mat3d> ldlt(damped);
+    if (ldlt.info() != Eigen::Success || !ldlt.isPositive() ||
+        !(ldlt.rcond() > 1e-14)) {
+      result.skipped = result.iterations == 0;
+      break;
+    }
+    const Vec3d step = -ldlt.solve(system.gradient);
+    if (!step.allFinite()) {
+      result.skipped = result.iterations == 0;
+      break;
+    }
+    ++result.iterations;
+
+    // While the damping is low, the step is close to the Gauss-Newton one and
+    // measures the distance to the minimum
+    const double tolerance =
+        parameters.step_tolerance * (point->norm() + 1.0);
+    if (lambda <= kInitialLambda && step.norm() <= tolerance) {
+      result.converged = true;
+      break;
+    }
+
+    // Steps increasing the cost are retried with more damping, which brings
+    // them towards a shorter gradient descent step
+    const Vec3d candidate = *point + step;
+    const auto candidate_system =
+        Linearize(observations, count, loss, candidate);
+    if (!(candidate_system.cost <= system.cost)) {
+      lambda *= 10.0;
+      if (lambda > kMaxLambda) {
+        break;
+      }
+      continue;
+    }
+    *point = candidate;
+    system = candidate_system;
+    lambda = std::max(0.1 * lambda, kMinLambda);
+  }
+  result.final_cost = system.cost;
+  return result;
+}
+}  // namespace
+
+namespace sfm::structure_refinement {
+
+Parameters ParametersFromConfig(const py::dict& config) {
+  Parameters parameters;
+  parameters.loss_function = config["loss_function"].cast<std::string>();
+  parameters.loss_function_threshold =
+      config["loss_function_threshold"].cast<double>();
+  parameters.num_threads = config["processes"].cast<int>();
+  return parameters;
+}
+
+Statistics RefineLandmarks(map::Map& map, const Parameters& parameters) {
+  OPENSFM_TRACE_SCOPE("sfm", "RefineLandmarks");
+  const std::unique_ptr<ceres::LossFunction> loss(bundle::CreateLossFunction(
+      parameters.loss_function, parameters.loss_function_threshold));
+
+  // Poses and cameras are gathered once, as shots are shared by many points
+  std::unordered_map<const geometry::Camera*, VecXd> camera_parameters;
+  std::unordered_map<const map::Shot*, int> shot_indices;
+  std::vector<ShotData> shots;
+  shots.reserve(map.GetShots().size());
+  for (auto& shot_it : map.GetShots()) {
+    auto& shot = shot_it.second;
+    const auto* camera = shot.GetCamera();
+    auto find_camera = camera_parameters.find(camera);
+    if (find_camera == camera_parameters.end()) {
+      find_camera =
+          camera_parameters.emplace(camera, camera->GetParametersValues())
+              .first;
+    }
+    const auto* pose = shot.GetPose();
+    shot_indices[&shot] = shots.size();
+    shots.push_back({&shot, pose->RotationWorldToCamera(),
+                     pose->TranslationWorldToCamera(),
+                     camera->GetProjectionType(), &find_camera->second});
+  }
+
+  // Then the observations, flat and contiguous per landmark
+  std::vector<map::Landmark*> landmarks;
+  std::vector<int> offsets = {0};
+  std::vector<ObservationData> observations;
+  landmarks.reserve(map.GetLandmarks().size());
+  offsets.reserve(map.GetLandmarks().size() + 1);
+  for (auto& landmark_it : map.GetLandmarks()) {
+    auto& landmark = landmark_it.second;
+    for (const auto& observation_it : landmark.GetObservations()) {
+      auto* shot = observation_it.first;
+      const auto& shot_data = shots[shot_indices.at(shot)];
+      const auto& observation = *shot->GetLandmarkObservation(&landmark);
+      const Vec3d observed = refinement_helpers::ObservedTarget(
+          *shot->GetCamera(), observation.point);
+      observations.push_back(
+          {&shot_data, observed, 1.0 / observation.scale});
+    }
+    landmarks.push_back(&landmark);
+    offsets.push_back(observations.size());
+  }
+
+  const int num_landmarks = landmarks.size();
+  std::vector<PointResult> results(num_landmarks);
+#pragma omp parallel for num_threads(parameters.num_threads) \
+    schedule(dynamic, 256)
+  for (int i = 0; i < num_landmarks; ++i) {
+    auto& landmark = *landmarks[i];
+    const auto* point_observations = observations.data() + offsets[i];
+    const int count = offsets[i + 1] - offsets[i];
+    Vec3d point = landmark.GetGlobalPos();
+    results[i] =
+        RefinePoint(point_observations, count, loss.get(), parameters, &point);
+    if (results[i].skipped) {
+      continue;
+    }
+
+    // Errors are stored unscaled, as the bundle adjustment does
+    landmark.SetGlobalPos(point);
+    std::vector<map::Shot*> errors_shots(count);
+    std::vector<VecMax3d> errors(count);
+    Vec3d residual;
+    Mat3d jacobian;
+    for (int j = 0; j < count; ++j) {
+      const auto& observation = point_observations[j];
+      EvaluateResidual(observation, point, &residual, &jacobian);
+      const int size = refinement_helpers::ResidualSize(
+          observation.shot->projection_type);
+      errors_shots[j] = observation.shot->shot;
+      errors[j] = residual.head(size);
+    }
+    landmark.SetReprojectionErrors(std::move(errors_shots), std::move(errors));
+  }
+
+  Statistics statistics;
+  statistics.num_points = num_landmarks;
+  for (const auto& result : results) {
+    if (result.skipped) {
+      ++statistics.num_skipped;
+      continue;
+    }
+    statistics.num_converged += result.converged;
+    statistics.num_iterations += result.iterations;
+    statistics.initial_cost += result.initial_cost;
+    statistics.final_cost += result.final_cost;
+  }
+  return statistics;
+}
+}  // namespace sfm::structure_refinement
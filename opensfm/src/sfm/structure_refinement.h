@@ -0,0 +1,57 @@
+#pragma once
+
+#include <map/map.h>
+#include <pybind11/pybind11.h>
+
+#include <string>
+
+namespace py = pybind11;
+
+namespace sfm::structure_refinement {
+
+struct Parameters {
+  int max_iterations{10};
+
+  // Robust loss of the residuals, with the same names as the bundle's one
+  std::string loss_function{"SoftLOneLoss"};
+  double loss_function_threshold{1.0};
+
+  // A point has converged once its step is smaller than this fraction of
+  // its distance to the origin (plus one, for points near the origin)
+  double step_tolerance{1e-10};
+
+  // A point has also converged once the largest component of the gradient
+  // of its cost is below this tolerance
+  double gradient_tolerance{1e-10};
+
+  int num_threads{1};
+};
+
+// Read the parameters from an OpenSfM config dictionary
+Parameters ParametersFromConfig(const py::dict& config);
+
+struct Statistics {
+  int num_points{0};
+  int num_converged{0};
+
+  // Points seen by less than two shots, or with a degenerate geometry, which
+  // are left untouched
+  int num_skipped{0};
+
+  // Total number of iterations over all the points
+  int num_iterations{0};
+
+  // Sum over the refined points of their robustified cost
+  double initial_cost{0.0};
+  double final_cost{0.0};
+};
+
+/* Refine the position of all the landmarks of the map, with the shots and
+ * cameras fixed. Each landmark is solved independently (and in parallel) by
+ * a Levenberg-Marquardt with iteratively reweighted residuals for the robust
+ * loss.
+ * Residuals are the same as the bundle adjustment ones : projection errors
+ * scaled by the observation scale, or bearing errors for spherical cameras.
+ * The reprojection errors of the landmarks are updated too. */
+Statistics RefineLandmarks(map::Map& map, const Parameters& parameters);
+}  // namespace sfm::structure_refinement
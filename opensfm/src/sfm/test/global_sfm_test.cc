@@ -0,0 +1,271 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <sfm/global_sfm.h>
+
+#include <Eigen/Geometry>
+#include <random>
+
+namespace {
+
+class GlobalSfMTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Shots around a circle, looking at its center
+    for (int i = 0; i < num_shots; ++i) {
+      const double angle = 2.0 * M_PI * i / num_shots;
+      const double radius = 10.0 + 0.5 * std::sin(3.0 * i);
+      const Vec3d center(radius * std::cos(angle), radius * std::sin(angle),
+                         0.1 * i);
+      const Vec3d z = -center.normalized();
+      const Vec3d x = z.cross(Vec3d::UnitZ()).normalized();
+      Mat3d rotation;
+      rotation.row(0) = x;
+      rotation.row(1) = z.cross(x);
+      rotation.row(2) = z;
+      rotations[std::to_string(i)] = rotation;
+      centers[std::to_string(i)] = center;
+    }
+
+    // Each shot is connected to its three next neighbors
+    for (int i = 0; i < num_shots; ++i) {
+      for (int k = 1; k <= 3; ++k) {
+        const auto id1 = std::to_string(i);
+        const auto id2 = std::to_string((i + k) % num_shots);
+        sfm::global_sfm::RelativePose relative_pose;
+        relative_pose.shot_id1 = id1;
+        relative_pose.shot_id2 = id2;
+        relative_pose.rotation =
+            rotations[id2] * rotations[id1].transpose();
+        relative_pose.translation =
+            (rotations[id2] * (centers[id1] - centers[id2])).normalized();
+        relative_pose.inliers = 100;
+        relative_poses.push_back(relative_pose);
+      }
+    }
+  }
+
+  // Rotation from the world of the ground truth to the one of the estimates
+  Mat3d Gauge(const std::unordered_map<map::ShotId, Mat3d>& estimated) const {
+    return estimated.at("0").transpose() * rotations.at("0");
+  }
+
+  // Map of the shots, at their true pose if 'posed' and at the origin
+  // otherwise, and tracks of points around the center of the circle, seen
+  // by all the shots
+  void MakeScene(bool posed) {
+    auto camera = geometry::Camera::CreatePerspectiveCamera(1.0, 0, 0);
+    camera.id = "camera";
+    map.CreateCamera(camera);
+    map::RigCamera rig_camera;
+    rig_camera.id = "rig_camera";
+    map.CreateRigCamera(rig_camera);
+    for (const auto& rotation : rotations) {
+      geometry::Pose pose;
+      if (posed) {
+        pose.SetFromWorldToCamera(
+            rotation.second, -rotation.second * centers.at(rotation.first));
+      }
+      map.CreateRigInstance(rotation.first);
+      map.CreateShot(rotation.first, "camera", "rig_camera", rotation.first,
+                     pose);
+    }
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> uniform(-2.0, 2.0);
+    for (int i = 0; i < num_points; ++i) {
+      const auto track_id = std::to_string(i);
+      const Vec3d point(uniform(generator), uniform(generator),
+                        uniform(generator));
+      points[track_id] = point;
+      for (const auto& rotation : rotations) {
+        const Vec3d camera_point =
+            rotation.second * (point - centers.at(rotation.first));
+        const map::Observation observation(
+            camera_point(0) / camera_point(2),
+            camera_point(1) / camera_point(2), 0.004, 0, 0, 0, i);
+        tracks_manager.AddObservation(rotation.first, track_id, observation);
+      }
+    }
+  }
+
+  static constexpr int num_shots = 20;
+  static constexpr int num_points = 200;
+  std::unordered_map<map::ShotId, Mat3d> rotations;
+  std::unordered_map<map::ShotId, Vec3d> centers;
+  std::vector<sfm::global_sfm::RelativePose> relative_poses;
+  std::unordered_map<map::TrackId, Vec3d> points;
+  map::Map map;
+  map::TracksManager tracks_manager;
+};
+
+TEST_F(GlobalSfMTest, AverageRotations) {
+  const auto estimated =
+      sfm::global_sfm::AverageRotations(relative_poses, 20);
+  ASSERT_EQ(num_shots, estimated.size());
+
+  const Mat3d gauge = Gauge(estimated);
+  for (const auto& rotation : rotations) {
+    const Mat3d expected = rotation.second * gauge.transpose();
+    EXPECT_NEAR(0.0, (estimated.at(rotation.first) - expected).norm(), 1e-6);
+  }
+}
+
+TEST_F(GlobalSfMTest, AverageRotationsWithOutlier) {
+  relative_poses[5].rotation =
+      Eigen::AngleAxisd(1.0, Vec3d::UnitX()).toRotationMatrix() *
+      relative_poses[5].rotation;
+  const auto estimated =
+      sfm::global_sfm::AverageRotations(relative_poses, 50);
+
+  const Mat3d gauge = Gauge(estimated);
+  for (const auto& rotation : rotations) {
+    const Mat3d expected = rotation.second * gauge.transpose();
+    EXPECT_NEAR(0.0, (estimated.at(rotation.first) - expected).norm(), 1e-3);
+  }
+}
+
+TEST_F(GlobalSfMTest, AverageTranslations) {
+  const auto estimated_rotations =
+      sfm::global_sfm::AverageRotations(relative_poses, 20);
+  const auto estimated = sfm::global_sfm::AverageTranslations(
+      relative_poses, estimated_rotations, 20);
+  ASSERT_EQ(num_shots, estimated.size());
+
+  // Equal to the ground truth, up to a similarity
+  const Mat3d gauge = Gauge(estimated_rotations);
+  const double scale = (estimated.at("1") - estimated.at("0")).norm() /
+                       (centers.at("1") - centers.at("0")).norm();
+  for (const auto& center : centers) {
+    const Vec3d expected =
+        scale * gauge * (center.second - centers.at("0")) + estimated.at("0");
+    EXPECT_NEAR(0.0, (estimated.at(center.first) - expected).norm(), 1e-3);
+  }
+}
+
+TEST_F(GlobalSfMTest, AverageTranslationsWithOutlier) {
+  relative_poses[7].translation = Vec3d(1.0, 2.0, 3.0).normalized();
+  const auto estimated_rotations =
+      sfm::global_sfm::AverageRotations(relative_poses, 20);
+  const auto estimated = sfm::global_sfm::AverageTranslations(
+      relative_poses, estimated_rotations, 50);
+
+  const Mat3d gauge = Gauge(estimated_rotations);
+  const double scale = (estimated.at("1") - estimated.at("0")).norm() /
+                       (centers.at("1") - centers.at("0")).norm();
+  for (const auto& center : centers) {
+    const Vec3d expected =
+        scale * gauge * (center.second - centers.at("0")) + estimated.at("0");
+    EXPECT_NEAR(0.0, (estimated.at(center.first) - expected).norm(), 1e-2);
+  }
+}
+
+TEST_F(GlobalSfMTest, KeepsLargestConnectedComponent) {
+  sfm::global_sfm::RelativePose isolated;
+  isolated.shot_id1 = "a";
+  isolated.shot_id2 = "b";
+  isolated.rotation = Mat3d::Identity();
+  isolated.translation = Vec3d::UnitX();
+  isolated.inliers = 1000;
+  relative_poses.push_back(isolated);
+
+  const auto estimated =
+      sfm::global_sfm::AverageRotations(relative_poses, 20);
+  ASSERT_EQ(num_shots, estimated.size());
+  ASSERT_EQ(0, estimated.count("a"));
+}
+
+TEST_F(GlobalSfMTest, ComputeRelativePoses) {
+  MakeScene(false);
+  std::vector<std::pair<map::ShotId, map::ShotId>> pairs;
+  for (const auto& relative_pose : relative_poses) {
+    pairs.emplace_back(relative_pose.shot_id1, relative_pose.shot_id2);
+  }
+  pairs.emplace_back("0", "unknown");
+
+  sfm::global_sfm::Parameters parameters;
+  parameters.num_threads = 4;
+  const auto estimated = sfm::global_sfm::ComputeRelativePoses(
+      map, tracks_manager, pairs, parameters);
+  ASSERT_EQ(relative_poses.size(), estimated.size());
+  for (size_t i = 0; i < estimated.size(); ++i) {
+    const auto& expected = relative_poses[i];
+    ASSERT_EQ(expected.shot_id1, estimated[i].shot_id1);
+    ASSERT_EQ(expected.shot_id2, estimated[i].shot_id2);
+    EXPECT_EQ(num_points, estimated[i].inliers);
+    EXPECT_NEAR(0.0, (estimated[i].rotation - expected.rotation).norm(),
+                1e-6);
+    EXPECT_NEAR(0.0,
+                (estimated[i].translation - expected.translation).norm(),
+                1e-6);
+  }
+}
+
+TEST_F(GlobalSfMTest, TriangulateTracks) {
+  MakeScene(true);
+  map.CreateLandmark("0", Vec3d::Zero());
+
+  sfm::global_sfm::Parameters parameters;
+  parameters.num_threads = 4;
+  ASSERT_EQ(num_points - 1, sfm::global_sfm::TriangulateTracks(
+                                map, tracks_manager, parameters));
+  ASSERT_EQ(num_points, map.NumberOfLandmarks());
+  ASSERT_EQ(Vec3d::Zero(), map.GetLandmark("0").GetGlobalPos());
+  for (const auto& point : points) {
+    if (point.first == "0") {
+      continue;
+    }
+    const auto& landmark = map.GetLandmark(point.first);
+    EXPECT_NEAR(0.0, (landmark.GetGlobalPos() - point.second).norm(), 1e-6);
+    EXPECT_EQ(num_shots, landmark.NumberOfObservations());
+  }
+}
+
+TEST_F(GlobalSfMTest, GlobalReconstruction) {
+  MakeScene(false);
+  map.CreateRigInstance("isolated");
+  map.CreateShot("isolated", "camera", "rig_camera", "isolated",
+                 geometry::Pose());
+
+  sfm::global_sfm::Parameters parameters;
+  parameters.num_threads = 4;
+  const auto report = sfm::global_sfm::GlobalReconstruction(
+      map, tracks_manager, {}, parameters);
+  EXPECT_EQ(num_shots * (num_shots - 1) / 2, report.num_pairs);
+  EXPECT_EQ(report.num_pairs, report.num_relative_poses);
+  ASSERT_EQ(std::vector<map::ShotId>{"isolated"}, report.removed_shots);
+  ASSERT_EQ(num_shots, map.NumberOfShots());
+  ASSERT_EQ(num_points, report.num_landmarks);
+
+  // Equal to the ground truth, up to a similarity
+  std::unordered_map<map::ShotId, Mat3d> estimated_rotations;
+  for (const auto& rotation : rotations) {
+    estimated_rotations[rotation.first] =
+        map.GetShot(rotation.first).GetPose()->RotationWorldToCamera();
+  }
+  const Mat3d gauge = Gauge(estimated_rotations);
+  const Vec3d origin = map.GetShot("0").GetPose()->GetOrigin();
+  const double scale =
+      (map.GetShot("1").GetPose()->GetOrigin() - origin).norm() /
+      (centers.at("1") - centers.at("0")).norm();
+  const auto similarity = [&](const Vec3d& point) -> Vec3d {
+    return scale * gauge * (point - centers.at("0")) + origin;
+  };
+  for (const auto& center : centers) {
+    const auto& pose = *map.GetShot(center.first).GetPose();
+    EXPECT_NEAR(0.0,
+                (pose.RotationWorldToCamera() -
+                 rotations.at(center.first) * gauge.transpose())
+                    .norm(),
+                1e-6);
+    EXPECT_NEAR(0.0, (pose.GetOrigin() - similarity(center.second)).norm(),
+                1e-4 * scale);
+  }
+  for (const auto& point : points) {
+    EXPECT_NEAR(0.0,
+                (map.GetLandmark(point.first).GetGlobalPos() -
+                 similarity(point.second))
+                    .norm(),
+                1e-4 * scale);
+  }
+}
+}  // namespace
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <sfm/merging.h>
+
+#include <random>
+
+namespace {
+
+class MergingFixture : public ::testing::Test {
+ public:
+  MergingFixture() {
+    // Two maps of the same scene, with some common landmarks and shots. The
+    // second one is expressed in another frame.
+    const Vec3d rotation(0.1, -0.3, 0.2);
+    const Vec3d translation(5.0, -2.0, 1.0);
+    second_to_first = geometry::Similarity(rotation, translation, 2.0);
+    first_to_second = second_to_first.Inverse();
+
+    FillMap(first, 0, 30, 0, 3, geometry::Similarity());
+    FillMap(second, 20, 50, 2, 5, first_to_second);
+  }
+
+  void FillMap(map::Map& map, int landmark_begin, int landmark_end,
+               int shot_begin, int shot_end,
+               const geometry::Similarity& transform) {
+    auto camera = geometry::Camera::CreatePerspectiveCamera(1.0, 0, 0);
+    camera.id = "camera";
+    map.CreateCamera(camera);
+    map.CreateRigCamera(map::RigCamera(geometry::Pose(), "rig_camera"));
+    for (int i = landmark_begin; i < landmark_end; ++i) {
+      map.CreateLandmark(std::to_string(i), transform.Transform(Position(i)));
+    }
+    for (int i = shot_begin; i < shot_end; ++i) {
+      const auto id = "shot" + std::to_string(i);
+      map.CreateRigInstance(id);
+      geometry::Pose pose;
+      pose.SetOrigin(Vec3d(i, 0.0, 0.0));
+      auto& shot = map.CreateShot(id, "camera", "rig_camera", id,
+                                  transform.TransformPose(pose));
+      for (int j = landmark_begin; j < landmark_end; ++j) {
+        const auto landmark_id = std::to_string(j);
+        const Vec2d projection =
+            shot.Project(map.GetLandmark(landmark_id).GetGlobalPos());
+        map.AddObservation(
+            id, landmark_id,
+            map::Observation(projection(0), projection(1), 0.004, 0, 0, 0, j));
+      }
+    }
+  }
+
+  static Vec3d Position(int i) {
+    return Vec3d(0.3 * (i % 7), 0.2 * (i % 5), 10.0 + 0.1 * i);
+  }
+
+  geometry::Similarity second_to_first;
+  geometry::Similarity first_to_second;
+  map::Map first;
+  map::Map second;
+};
+
+TEST_F(MergingFixture, AlignsMaps) {
+  sfm::merging::Parameters parameters;
+  const auto alignment = sfm::merging::AlignMaps(first, second, parameters);
+  ASSERT_TRUE(alignment.success);
+  ASSERT_EQ(10, alignment.num_common_landmarks);
+  ASSERT_EQ(10, alignment.num_inliers);
+  ASSERT_NEAR(second_to_first.Scale(), alignment.similarity.Scale(), 1e-8);
+  ASSERT_NEAR(0.0,
+              (second_to_first.Translation() -
+               alignment.similarity.Translation())
+                  .norm(),
+              1e-8);
+}
+
+TEST_F(MergingFixture, RefitsSimilarityOnAllInliers) {
+  // Noisy common landmarks, and a few outliers
+  std::mt19937 generator(42);
+  std::normal_distribution<double> noise(0.0, 0.01);
+  for (int i = 20; i < 30; ++i) {
+    auto& landmark = second.GetLandmark(std::to_string(i));
+    const Vec3d offset =
+        i < 22 ? Vec3d(5.0, 0.0, 0.0)
+               : Vec3d(noise(generator), noise(generator), noise(generator));
+    landmark.SetGlobalPos(landmark.GetGlobalPos() + offset);
+  }
+
+  sfm::merging::Parameters parameters;
+  parameters.threshold = 0.1;
+  parameters.min_inliers = 8;
+  const auto alignment = sfm::merging::AlignMaps(first, second, parameters);
+  ASSERT_TRUE(alignment.success);
+  ASSERT_EQ(8, alignment.num_inliers);
+  ASSERT_NEAR(second_to_first.Scale(), alignment.similarity.Scale(), 5e-2);
+  for (int i = 22; i < 30; ++i) {
+    const Vec3d aligned = alignment.similarity.Transform(
+        second.GetLandmark(std::to_string(i)).GetGlobalPos());
+    ASSERT_NEAR(0.0, (aligned - Position(i)).norm(), 0.1);
+  }
+}
+
+TEST_F(MergingFixture, MergesTwoMaps) {
+  sfm::merging::Parameters parameters;
+  ASSERT_TRUE(sfm::merging::MergeTwoMaps(second, first, parameters));
+  ASSERT_EQ(50, first.GetLandmarks().size());
+  ASSERT_EQ(5, first.GetShots().size());
+
+  for (int i = 0; i < 50; ++i) {
+    const auto& landmark = first.GetLandmark(std::to_string(i));
+    ASSERT_NEAR(0.0, (landmark.GetGlobalPos() - Position(i)).norm(), 1e-8);
+  }
+  for (int i = 0; i < 5; ++i) {
+    const Vec3d origin =
+        first.GetShot("shot" + std::to_string(i)).GetPose()->GetOrigin();
+    ASSERT_NEAR(0.0, (origin - Vec3d(i, 0.0, 0.0)).norm(), 1e-8);
+  }
+
+  // Observations of the new shots are copied, and still match
+  const auto& shot = first.GetShot("shot4");
+  ASSERT_EQ(30, shot.GetLandmarkObservations().size());
+  for (const auto& observation : shot.GetLandmarkObservations()) {
+    const Vec2d projection = shot.Project(observation.first->GetGlobalPos());
+    ASSERT_NEAR(0.0, (projection - observation.second.point).norm(), 1e-8);
+  }
+}
+
+TEST_F(MergingFixture, AttachesShotsToExistingRigInstances) {
+  // 'shot2' rig instance, common to both maps, gets a second shot in the
+  // second map
+  map::RigCamera side(geometry::Pose(Vec3d(0.0, 0.0, 0.0), Vec3d(0.5, 0.0, 0.0)),
+                      "side");
+  second.CreateRigCamera(side);
+  second.CreateShot("shot2_side", "camera", "side", "shot2");
+
+  const Vec3d instance_origin =
+      first.GetRigInstance("shot2").GetPose().GetOrigin();
+  sfm::merging::Parameters parameters;
+  const auto alignment = sfm::merging::AlignMaps(first, second, parameters);
+  ASSERT_TRUE(alignment.success);
+  ASSERT_EQ(0, sfm::merging::MergeMap(alignment.similarity, second, first,
+                                      parameters));
+
+  // The existing instance keeps its pose, and so its other shots
+  ASSERT_NEAR(
+      0.0,
+      (first.GetRigInstance("shot2").GetPose().GetOrigin() - instance_origin)
+          .norm(),
+      1e-8);
+  ASSERT_TRUE(first.HasShot("shot2_side"));
+  ASSERT_EQ(2, first.GetRigInstance("shot2").GetShots().size());
+}
+
+TEST_F(MergingFixture, SkipsShotsOfDisagreeingRigInstances) {
+  map::RigCamera side(geometry::Pose(Vec3d(0.0, 0.0, 0.0), Vec3d(0.5, 0.0, 0.0)),
+                      "side");
+  second.CreateRigCamera(side);
+  second.CreateShot("shot2_side", "camera", "side", "shot2");
+  auto& instance = first.GetRigInstance("shot2");
+  geometry::Pose moved = instance.GetPose();
+  moved.SetOrigin(moved.GetOrigin() + Vec3d(0.0, 3.0, 0.0));
+  instance.SetPose(moved);
+
+  sfm::merging::Parameters parameters;
+  const auto alignment = sfm::merging::AlignMaps(first, second, parameters);
+  ASSERT_TRUE(alignment.success);
+  ASSERT_EQ(1, sfm::merging::MergeMap(alignment.similarity, second, first,
+                                      parameters));
+  ASSERT_FALSE(first.HasShot("shot2_side"));
+  ASSERT_TRUE(first.HasShot("shot4"));
+  ASSERT_NEAR(
+      0.0,
+      (first.GetRigInstance("shot2").GetPose().GetOrigin() - moved.GetOrigin())
+          .norm(),
+      1e-8);
+}
+
+TEST_F(MergingFixture, KeepsMapsWithoutEnoughCommonLandmarks) {
+  map::Map unrelated;
+  FillMap(unrelated, 100, 120, 10, 12, geometry::Similarity());
+
+  sfm::merging::Parameters parameters;
+  parameters.num_threads = 2;
+  ASSERT_FALSE(sfm::merging::MergeTwoMaps(unrelated, first, parameters));
+  ASSERT_EQ(30, first.GetLandmarks().size());
+
+  const auto groups =
+      sfm::merging::MergeMaps({&first, &unrelated, &second}, parameters);
+  ASSERT_EQ(2, groups.size());
+  ASSERT_EQ(std::vector<int>({0, 2}), groups[0]);
+  ASSERT_EQ(std::vector<int>({1}), groups[1]);
+  ASSERT_EQ(50, first.GetLandmarks().size());
+}
+}  // namespace
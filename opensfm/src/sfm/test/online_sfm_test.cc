@@ -0,0 +1,174 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <sfm/online_sfm.h>
+
+#include <random>
+
+namespace {
+
+class OnlineSfMTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto camera = geometry::Camera::CreatePerspectiveCamera(1.0, 0, 0);
+    camera.id = "camera";
+    map.CreateCamera(camera);
+    map::RigCamera rig_camera;
+    rig_camera.id = "rig_camera";
+    map.CreateRigCamera(rig_camera);
+
+    // Points in front of a camera moving sideways, and slightly forward
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    for (int i = 0; i < num_points; ++i) {
+      points.emplace_back(num_frames * 0.25 + 6.0 * uniform(generator),
+                          3.0 * uniform(generator),
+                          10.0 + 4.0 * uniform(generator));
+    }
+    for (int i = 0; i < num_frames; ++i) {
+      const Vec3d center(0.5 * i, 0.0, 0.05 * i);
+      centers.push_back(center);
+      geometry::Pose pose(Vec3d(0.0, 0.02 * std::sin(i), 0.0));
+      pose.SetOrigin(center);
+      poses.push_back(pose);
+    }
+  }
+
+  // Add the i-th frame, matched with its two previous ones from 'first' on
+  sfm::online_sfm::FrameReport AddFrame(
+      sfm::online_sfm::OnlineReconstruction& reconstruction, int i,
+      int first = 0) {
+    const auto shot_id = std::to_string(i);
+    map.CreateRigInstance(shot_id);
+    map.CreateShot(shot_id, "camera", "rig_camera", shot_id);
+
+    MatX3d features(num_points, 3);
+    MatX3i colors(num_points, 3);
+    for (int j = 0; j < num_points; ++j) {
+      const Vec3d point = poses[i].RotationWorldToCamera() * points[j] +
+                          poses[i].TranslationWorldToCamera();
+      features.row(j) << point(0) / point(2), point(1) / point(2), 0.004;
+      colors.row(j) << j % 256, 0, 0;
+    }
+    MatX2i pairs(num_points, 2);
+    for (int j = 0; j < num_points; ++j) {
+      pairs.row(j) << j, j;
+    }
+    std::unordered_map<map::ShotId, MatX2i> matches;
+    for (int k = std::max(first, i - 2); k < i; ++k) {
+      matches[std::to_string(k)] = pairs;
+    }
+    return reconstruction.AddFrame(shot_id, features, colors, matches);
+  }
+
+  static constexpr int num_frames = 15;
+  static constexpr int num_points = 100;
+  map::Map map;
+  map::TracksManager tracks_manager;
+  std::vector<Vec3d> points;
+  std::vector<Vec3d> centers;
+  std::vector<geometry::Pose> poses;
+};
+
+TEST_F(OnlineSfMTest, ReconstructsSequence) {
+  sfm::online_sfm::Parameters parameters;
+  parameters.window_size = 5;
+  sfm::online_sfm::OnlineReconstruction reconstruction(map, tracks_manager,
+                                                       parameters);
+  for (int i = 0; i < num_frames; ++i) {
+    const auto report = AddFrame(reconstruction, i);
+    ASSERT_EQ(i > 0, report.reconstructed);
+    ASSERT_LE(report.num_window_shots, parameters.window_size);
+  }
+  ASSERT_TRUE(reconstruction.IsInitialized());
+  ASSERT_EQ(num_frames, map.NumberOfShots());
+  ASSERT_EQ(num_points, map.NumberOfLandmarks());
+  ASSERT_EQ(parameters.window_size, reconstruction.GetWindow().size());
+
+  // Equal to the ground truth, up to a similarity set by the first two frames
+  const auto& pose0 = *map.GetShot("0").GetPose();
+  const auto& pose1 = *map.GetShot("1").GetPose();
+  EXPECT_NEAR(0.0, pose0.GetOrigin().norm(), 1e-6);
+  const double scale = (pose1.GetOrigin() - pose0.GetOrigin()).norm() /
+                       (centers[1] - centers[0]).norm();
+  for (int i = 0; i < num_frames; ++i) {
+    const auto& pose = *map.GetShot(std::to_string(i)).GetPose();
+    const Vec3d expected = scale * poses[0].RotationWorldToCamera() *
+                           (centers[i] - centers[0]);
+    EXPECT_NEAR(0.0, (pose.GetOrigin() - expected).norm(),
+                1e-6 + 1e-3 * i);
+  }
+}
+
+TEST_F(OnlineSfMTest, WaitsForParallaxToInitialize) {
+  sfm::online_sfm::Parameters parameters;
+  parameters.triangulation_min_angle = 5.0 * M_PI / 180.0;
+  sfm::online_sfm::OnlineReconstruction reconstruction(map, tracks_manager,
+                                                       parameters);
+  int first_reconstructed = -1;
+  for (int i = 0; i < num_frames && first_reconstructed < 0; ++i) {
+    if (AddFrame(reconstruction, i).reconstructed) {
+      first_reconstructed = i;
+    }
+  }
+  ASSERT_GT(first_reconstructed, 1);
+  ASSERT_TRUE(reconstruction.IsInitialized());
+
+  // The frames in-between are resected once initialized
+  for (int i = 0; i <= first_reconstructed; ++i) {
+    ASSERT_TRUE(map.HasShot(std::to_string(i)));
+  }
+}
+
+TEST_F(OnlineSfMTest, StartsNewSegmentOnTrackingLoss) {
+  sfm::online_sfm::Parameters parameters;
+  parameters.window_size = 3;
+  sfm::online_sfm::OnlineReconstruction reconstruction(map, tracks_manager,
+                                                       parameters);
+  // Frames from 'cut' on aren't matched with the previous ones
+  const int cut = 6;
+  int lost = -1;
+  for (int i = 0; i < num_frames; ++i) {
+    const auto report = AddFrame(reconstruction, i, i < cut ? 0 : cut);
+    if (report.tracking_lost) {
+      ASSERT_EQ(-1, lost);
+      lost = i;
+    }
+    ASSERT_EQ(lost < 0 || i < lost ? 0 : 1, report.segment);
+    if (i > 0 && i < cut) {
+      ASSERT_TRUE(report.reconstructed);
+    }
+  }
+
+  // Lost once the last reconstructed frame left the window
+  ASSERT_EQ(cut + parameters.window_size - 1, lost);
+  ASSERT_TRUE(reconstruction.IsInitialized());
+  ASSERT_EQ(1, reconstruction.GetSegment());
+  ASSERT_EQ(num_frames, map.NumberOfShots());
+  ASSERT_EQ(2 * num_points, map.NumberOfLandmarks());
+  for (int i = 0; i < num_frames; ++i) {
+    ASSERT_EQ(i < cut ? 0 : 1, map.GetShot(std::to_string(i)).merge_cc);
+  }
+
+  // The new segment is initialized from the first frame after the cut
+  const auto& pose0 = *map.GetShot(std::to_string(cut)).GetPose();
+  const auto& pose1 = *map.GetShot(std::to_string(cut + 1)).GetPose();
+  EXPECT_NEAR(0.0, pose0.GetOrigin().norm(), 1e-6);
+  const double scale = (pose1.GetOrigin() - pose0.GetOrigin()).norm() /
+                       (centers[cut + 1] - centers[cut]).norm();
+  for (int i = cut; i < num_frames; ++i) {
+    const auto& pose = *map.GetShot(std::to_string(i)).GetPose();
+    const Vec3d expected = scale * poses[cut].RotationWorldToCamera() *
+                           (centers[i] - centers[cut]);
+    EXPECT_NEAR(0.0, (pose.GetOrigin() - expected).norm(),
+                1e-6 + 1e-3 * (i - cut));
+  }
+}
+
+TEST_F(OnlineSfMTest, ThrowsOnUnknownShot) {
+  sfm::online_sfm::OnlineReconstruction reconstruction(
+      map, tracks_manager, sfm::online_sfm::Parameters());
+  EXPECT_THROW(reconstruction.AddFrame("unknown", MatX3d(0, 3),
+                                       MatX3i(0, 3), {}),
+               std::runtime_error);
+}
+}  // namespace
@@ -0,0 +1,148 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <map/tracks_manager.h>
+#include <sfm/partition.h>
+
+#include <algorithm>
+
+namespace {
+
+sfm::partition::Graph MakeGraph(
+    int num_vertices,
+    const std::vector<std::tuple<int, int, int>>& weighted_edges) {
+  std::vector<std::vector<std::pair<int, int>>> neighbors(num_vertices);
+  for (const auto& edge : weighted_edges) {
+    neighbors[std::get<0>(edge)].emplace_back(std::get<1>(edge),
+                                              std::get<2>(edge));
+    neighbors[std::get<1>(edge)].emplace_back(std::get<0>(edge),
+                                              std::get<2>(edge));
+  }
+  sfm::partition::Graph graph;
+  graph.vertex_weights.assign(num_vertices, 1);
+  for (const auto& vertex_neighbors : neighbors) {
+    for (const auto& neighbor : vertex_neighbors) {
+      graph.adjacency.push_back(neighbor.first);
+      graph.edge_weights.push_back(neighbor.second);
+    }
+    graph.offsets.push_back(graph.adjacency.size());
+  }
+  return graph;
+}
+
+sfm::partition::Graph MakeGrid(int size) {
+  std::vector<std::tuple<int, int, int>> edges;
+  for (int i = 0; i < size; ++i) {
+    for (int j = 0; j < size; ++j) {
+      if (i + 1 < size) {
+        edges.emplace_back(i * size + j, (i + 1) * size + j, 1);
+      }
+      if (j + 1 < size) {
+        edges.emplace_back(i * size + j, i * size + j + 1, 1);
+      }
+    }
+  }
+  return MakeGraph(size * size, edges);
+}
+
+int CutWeight(const sfm::partition::Graph& graph,
+              const std::vector<int>& parts) {
+  int cut = 0;
+  for (int v = 0; v < graph.NumVertices(); ++v) {
+    for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+      cut += parts[v] != parts[graph.adjacency[e]] ? graph.edge_weights[e] : 0;
+    }
+  }
+  return cut / 2;
+}
+
+TEST(PartitionTest, PartitionsGridInBalancedParts) {
+  const auto graph = MakeGrid(40);
+  const auto parts = sfm::partition::PartitionGraph(graph, 4);
+
+  std::vector<int> sizes(4, 0);
+  for (const int part : parts) {
+    ++sizes[part];
+  }
+  for (const int size : sizes) {
+    EXPECT_NEAR(400, size, 400 * 0.05);
+  }
+  // Four quadrants cut 80 edges
+  EXPECT_LE(CutWeight(graph, parts), 120);
+}
+
+TEST(PartitionTest, SplitsAtWeakestLink) {
+  // Two cliques joined by a single light edge
+  std::vector<std::tuple<int, int, int>> edges;
+  for (int i = 0; i < 10; ++i) {
+    for (int j = i + 1; j < 10; ++j) {
+      edges.emplace_back(i, j, 50);
+      edges.emplace_back(10 + i, 10 + j, 50);
+    }
+  }
+  edges.emplace_back(3, 15, 10);
+  const auto graph = MakeGraph(20, edges);
+  const auto parts = sfm::partition::PartitionGraph(graph, 2);
+
+  EXPECT_EQ(10, CutWeight(graph, parts));
+  for (int i = 1; i < 10; ++i) {
+    EXPECT_EQ(parts[0], parts[i]);
+    EXPECT_EQ(parts[10], parts[10 + i]);
+  }
+}
+
+TEST(PartitionTest, GrowsPartAlongConnectivity) {
+  // A chain with strong edges, and a weak shortcut from 0 to 10
+  std::vector<std::tuple<int, int, int>> edges;
+  for (int i = 0; i + 1 < 20; ++i) {
+    edges.emplace_back(i, i + 1, 10);
+  }
+  edges.emplace_back(0, 10, 1);
+  const auto graph = MakeGraph(20, edges);
+
+  auto grown = sfm::partition::GrowPart(graph, {0, 1, 2}, 3);
+  std::sort(grown.begin(), grown.end());
+  EXPECT_THAT(grown, ::testing::ElementsAre(3, 4, 5));
+}
+
+TEST(PartitionTest, PartitionsShotsByCovisibility) {
+  // Shots along a line, each track seen by three consecutive shots
+  map::TracksManager tracks_manager;
+  const int num_shots = 100;
+  for (int i = 0; i < num_shots; ++i) {
+    for (int k = 0; k < 30; ++k) {
+      const auto track_id = std::to_string(i) + "_" + std::to_string(k);
+      for (int j = i; j < std::min(i + 3, num_shots); ++j) {
+        tracks_manager.AddObservation(std::to_string(j), track_id,
+                                      map::Observation());
+      }
+    }
+  }
+
+  sfm::partition::Parameters parameters;
+  parameters.max_cluster_size = 30;
+  parameters.overlap = 0.2;
+  const auto partition =
+      sfm::partition::PartitionShots(tracks_manager, {}, parameters);
+
+  ASSERT_EQ(num_shots, partition.labels.size());
+  ASSERT_EQ(partition.clusters.size(), 5);
+  for (int c = 0; c < static_cast<int>(partition.clusters.size()); ++c) {
+    const auto& cluster = partition.clusters[c];
+    EXPECT_LE(cluster.size(), parameters.max_cluster_size);
+
+    // Shots of a cluster are consecutive, and overlap with other clusters
+    std::vector<int> core;
+    int overlap = 0;
+    for (const auto& shot_id : cluster) {
+      if (partition.labels.at(shot_id) == c) {
+        core.push_back(std::stoi(shot_id));
+      } else {
+        ++overlap;
+      }
+    }
+    const auto range = std::minmax_element(core.begin(), core.end());
+    EXPECT_EQ(core.size(), *range.second - *range.first + 1);
+    EXPECT_GT(overlap, 0);
+  }
+}
+}  // namespace
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <sfm/pose_refinement.h>
+
+#include <random>
+
+namespace {
+
+class PoseRefinementFixture : public ::testing::Test {
+ public:
+  PoseRefinementFixture() {
+    auto perspective = geometry::Camera::CreatePerspectiveCamera(1.0, 0, 0);
+    perspective.id = "perspective";
+    map.CreateCamera(perspective);
+    auto spherical = geometry::Camera::CreateSphericalCamera();
+    spherical.id = "spherical";
+    map.CreateCamera(spherical);
+
+    map.CreateRigCamera(map::RigCamera(geometry::Pose(), "main"));
+    const Mat3d R_side =
+        geometry::VectorToRotationMatrix(Vec3d(0.0, 0.3, 0.0));
+    const Vec3d t_side(0.5, 0.0, 0.1);
+    geometry::Pose side_pose;
+    side_pose.SetFromWorldToCamera(R_side, t_side);
+    map.CreateRigCamera(map::RigCamera(side_pose, "side"));
+
+    // Single-shot instances along the X axis looking toward +Z, and one
+    // instance with a perspective and a spherical shot
+    for (int i = 0; i < 5; ++i) {
+      const auto id = std::to_string(i);
+      map.CreateRigInstance(id);
+      map.CreateShot(id, "perspective", "main", id);
+      geometry::Pose pose(Vec3d(0.02 * i, -0.01 * i, 0.0));
+      pose.SetOrigin(Vec3d(i, 0.2 * (i % 2), 0.0));
+      map.GetRigInstance(id).SetPose(pose);
+    }
+    map.CreateRigInstance("rig");
+    map.CreateShot("rig_main", "perspective", "main", "rig");
+    map.CreateShot("rig_side", "spherical", "side", "rig");
+    geometry::Pose rig_pose(Vec3d(0.0, 0.1, 0.05));
+    rig_pose.SetOrigin(Vec3d(2.0, 1.0, -1.0));
+    map.GetRigInstance("rig").SetPose(rig_pose);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> uniform(-3.0, 3.0);
+    for (int i = 0; i < 300; ++i) {
+      const auto id = std::to_string(i);
+      const Vec3d point(2.0 + uniform(generator), uniform(generator),
+                        10.0 + uniform(generator));
+      map.CreateLandmark(id, point);
+      for (const auto& shot_it : map.GetShots()) {
+        const Vec2d projection = shot_it.second.Project(point);
+        map.AddObservation(
+            shot_it.first, id,
+            map::Observation(projection(0), projection(1), 0.004, 0, 0, 0, i));
+      }
+    }
+
+    for (const auto& instance : map.GetRigInstances()) {
+      true_poses[instance.first] = instance.second.GetPose();
+    }
+  }
+
+  void Perturb(const map::RigInstanceId& instance_id) {
+    auto& pose = map.GetRigInstance(instance_id).GetPose();
+    const Mat3d rotation =
+        geometry::VectorToRotationMatrix(Vec3d(0.01, -0.02, 0.015)) *
+        pose.RotationWorldToCamera();
+    const Vec3d translation =
+        pose.TranslationWorldToCamera() + Vec3d(0.1, 0.05, -0.1);
+    pose.SetFromWorldToCamera(rotation, translation);
+  }
+
+  double PoseError(const map::RigInstanceId& instance_id) {
+    const auto& pose = map.GetRigInstance(instance_id).GetPose();
+    const auto& expected = true_poses.at(instance_id);
+    return (pose.WorldToCamera() - expected.WorldToCamera()).norm();
+  }
+
+  map::Map map;
+  std::unordered_map<map::RigInstanceId, geometry::Pose> true_poses;
+};
+
+TEST_F(PoseRefinementFixture, RecoversPerturbedPoses) {
+  std::unordered_set<map::ShotId> shot_ids;
+  for (const auto& shot_it : map.GetShots()) {
+    shot_ids.insert(shot_it.first);
+    Perturb(shot_it.second.GetRigInstanceId());
+  }
+
+  sfm::pose_refinement::Parameters parameters;
+  parameters.max_iterations = 20;
+  parameters.num_threads = 4;
+  const auto statistics =
+      sfm::pose_refinement::RefineShotPoses(map, shot_ids, parameters);
+  ASSERT_EQ(6, statistics.num_instances);
+  ASSERT_EQ(6, statistics.num_converged);
+  ASSERT_EQ(0, statistics.num_skipped);
+  ASSERT_LT(statistics.final_cost, 1e-12 * statistics.initial_cost);
+
+  for (const auto& instance : map.GetRigInstances()) {
+    ASSERT_NEAR(0.0, PoseError(instance.first), 1e-8);
+  }
+
+  // Shots poses follow their instance
+  const Vec3d point = map.GetLandmark("0").GetGlobalPos();
+  const auto& side = map.GetShot("rig_side");
+  const Vec2d observed = side.GetLandmarkObservations()
+                             .at(&map.GetLandmark("0"))
+                             .point;
+  ASSERT_NEAR(0.0, (side.Project(point) - observed).norm(), 1e-8);
+}
+
+TEST_F(PoseRefinementFixture, ReportsConvergenceOnlyWithinTolerances) {
+  std::unordered_set<map::ShotId> shot_ids;
+  for (const auto& shot_it : map.GetShots()) {
+    shot_ids.insert(shot_it.first);
+  }
+
+  // Already at the minimum, no step decreases the cost : giving up, or
+  // running out of iterations, isn't converging
+  sfm::pose_refinement::Parameters parameters;
+  parameters.max_iterations = 20;
+  parameters.step_tolerance = -1.0;
+  parameters.gradient_tolerance = -1.0;
+  const auto statistics =
+      sfm::pose_refinement::RefineShotPoses(map, shot_ids, parameters);
+  ASSERT_EQ(6, statistics.num_instances);
+  ASSERT_EQ(0, statistics.num_converged);
+  for (const auto& instance : map.GetRigInstances()) {
+    ASSERT_NEAR(0.0, PoseError(instance.first), 1e-8);
+  }
+}
+
+TEST_F(PoseRefinementFixture, RefinesOnlyInstancesOfShots) {
+  Perturb("0");
+  Perturb("1");
+  sfm::pose_refinement::Parameters parameters;
+  const auto statistics =
+      sfm::pose_refinement::RefineShotPoses(map, {"0"}, parameters);
+  ASSERT_EQ(1, statistics.num_instances);
+  ASSERT_NEAR(0.0, PoseError("0"), 1e-8);
+  ASSERT_GT(PoseError("1"), 0.1);
+}
+
+TEST_F(PoseRefinementFixture, UsesGPSPriors) {
+  const Vec3d gps = true_poses.at("0").GetOrigin() + Vec3d(0.0, 0.0, 1.0);
+  auto& measurements = map.GetShot("0").GetShotMeasurements();
+  measurements.gps_position_.SetValue(gps);
+  measurements.gps_accuracy_.SetValue(1e-6);
+
+  sfm::pose_refinement::Parameters parameters;
+  parameters.use_gps = true;
+  parameters.max_iterations = 20;
+  sfm::pose_refinement::RefineShotPoses(map, {"0"}, parameters);
+  const Vec3d origin = map.GetRigInstance("0").GetPose().GetOrigin();
+  ASSERT_NEAR(0.0, (origin - gps).norm(), 1e-3);
+}
+
+TEST_F(PoseRefinementFixture, SkipsInstancesWithoutObservations) {
+  map.CreateRigInstance("empty");
+  map.CreateShot("empty", "perspective", "main", "empty");
+  sfm::pose_refinement::Parameters parameters;
+  const auto statistics =
+      sfm::pose_refinement::RefineShotPoses(map, {"empty", "0"}, parameters);
+  ASSERT_EQ(2, statistics.num_instances);
+  ASSERT_EQ(1, statistics.num_skipped);
+}
+}  // namespace
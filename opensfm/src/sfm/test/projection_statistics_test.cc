@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <sfm/projection_statistics.h>
+
+namespace {
+
+class ProjectionStatisticsFixture : public ::testing::Test {
+ public:
+  ProjectionStatisticsFixture() {
+    auto camera = geometry::Camera::CreatePerspectiveCamera(1.0, 0, 0);
+    camera.id = "camera";
+    camera.width = 640;
+    camera.height = 480;
+    map.CreateCamera(camera);
+    map.CreateRigCamera(map::RigCamera(geometry::Pose(), "rig_camera"));
+    map.CreateRigInstance("instance");
+    map.CreateShot("shot", "camera", "rig_camera", "instance",
+                   geometry::Pose());
+
+    // Observations off by 1, 2 and 10 pixels along X
+    const double offsets[] = {1.0, 2.0, 10.0};
+    for (int i = 0; i < 3; ++i) {
+      const auto id = std::to_string(i);
+      const Vec3d position(0.1 * i, -0.1, 10.0);
+      map.CreateLandmark(id, position);
+      const Vec2d projection = map.GetShot("shot").Project(position);
+      const double x = projection(0) + offsets[i] / 640.0;
+      tracks_manager.AddObservation(
+          "shot", id, map::Observation(x, projection(1), 0.5, 0, 0, 0, i));
+    }
+  }
+
+  map::Map map;
+  map::TracksManager tracks_manager;
+};
+
+TEST(ProjectionStatistics, HistogramMatchesNumpy) {
+  // np.histogram([0, 1, 2, 3, 4], 4)
+  auto histogram =
+      sfm::projection_statistics::ComputeHistogram({0, 1, 2, 3, 4}, 4);
+  ASSERT_EQ(std::vector<int>({1, 1, 1, 2}), histogram.counts);
+  ASSERT_EQ(std::vector<double>({0, 1, 2, 3, 4}), histogram.edges);
+
+  // np.histogram([2, 2], 2)
+  histogram = sfm::projection_statistics::ComputeHistogram({2, 2}, 2);
+  ASSERT_EQ(std::vector<int>({0, 2}), histogram.counts);
+  ASSERT_EQ(std::vector<double>({1.5, 2.0, 2.5}), histogram.edges);
+
+  histogram = sfm::projection_statistics::ComputeHistogram({}, 2);
+  ASSERT_TRUE(histogram.counts.empty());
+}
+
+TEST_F(ProjectionStatisticsFixture, AggregatesInliers) {
+  sfm::projection_statistics::Parameters parameters;
+  parameters.num_threads = 2;
+  const auto statistics =
+      sfm::projection_statistics::ComputeProjectionStatistics(
+          {&map}, tracks_manager, parameters);
+
+  ASSERT_EQ(2, statistics.count);
+  ASSERT_NEAR(1.5, statistics.mean_pixels, 1e-8);
+  ASSERT_NEAR(2.0 * 1.5 / 640.0, statistics.mean_normalized, 1e-8);
+  ASSERT_GT(statistics.mean_angular, 0.0);
+  ASSERT_EQ(30, statistics.histogram_pixels.counts.size());
+  ASSERT_EQ(1, statistics.histogram_pixels.counts.front());
+  ASSERT_EQ(1, statistics.histogram_pixels.counts.back());
+
+  const auto& camera = statistics.cameras.at("camera");
+  ASSERT_EQ(2, camera.count);
+  ASSERT_NEAR(1.5, camera.mean_pixels, 1e-8);
+  ASSERT_EQ(40, camera.grid_width);
+  ASSERT_EQ(40, camera.grid_height);
+  int grid_count = 0;
+  Vec2d grid_error = Vec2d::Zero();
+  for (int i = 0; i < camera.grid_width * camera.grid_height; ++i) {
+    grid_count += camera.grid_counts[i];
+    grid_error += camera.grid_errors[i];
+  }
+  ASSERT_EQ(2, grid_count);
+  ASSERT_NEAR(2.0 * 3.0 / 640.0, grid_error(0), 1e-8);
+  ASSERT_NEAR(0.0, grid_error(1), 1e-8);
+}
+
+TEST_F(ProjectionStatisticsFixture, AccumulatesOverMaps) {
+  map::Map other;
+  other.CreateCamera(map.GetCamera("camera"));
+  other.CreateRigCamera(map::RigCamera(geometry::Pose(), "rig_camera"));
+  other.CreateRigInstance("instance");
+  other.CreateShot("shot", "camera", "rig_camera", "instance",
+                   geometry::Pose());
+  other.CreateLandmark("0", map.GetLandmark("0").GetGlobalPos());
+
+  sfm::projection_statistics::Parameters parameters;
+  const auto statistics =
+      sfm::projection_statistics::ComputeProjectionStatistics(
+          {&map, &other}, tracks_manager, parameters);
+  ASSERT_EQ(3, statistics.count);
+  ASSERT_EQ(1, statistics.cameras.size());
+  ASSERT_NEAR(4.0 / 3.0, statistics.mean_pixels, 1e-8);
+}
+
+TEST_F(ProjectionStatisticsFixture, HandlesNoInliers) {
+  sfm::projection_statistics::Parameters parameters;
+  parameters.pixel_cutoff = 0.5;
+  const auto statistics =
+      sfm::projection_statistics::ComputeProjectionStatistics(
+          {&map}, tracks_manager, parameters);
+  ASSERT_EQ(0, statistics.count);
+  ASSERT_EQ(-1.0, statistics.mean_pixels);
+  ASSERT_TRUE(statistics.histogram_pixels.counts.empty());
+  ASSERT_EQ(0, statistics.cameras.at("camera").count);
+}
+}  // namespace
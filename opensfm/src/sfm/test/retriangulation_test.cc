@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <sfm/retriangulation.h>
+
+#include <random>
+
+namespace {
+
+void CreateShot(map::Map& map, const map::ShotId& shot_id,
+                const geometry::Pose& pose) {
+  map.CreateRigInstance(shot_id);
+  map.CreateShot(shot_id, "camera", "rig_camera", shot_id, pose);
+}
+
+TEST(RealignMaps, AppliesSimilarityOfReference) {
+  map::Map reference, to_align;
+  for (auto* map : {&reference, &to_align}) {
+    auto camera = geometry::Camera::CreatePerspectiveCamera(1.0, 0, 0);
+    camera.id = "camera";
+    map->CreateCamera(camera);
+    map::RigCamera rig_camera;
+    rig_camera.id = "rig_camera";
+    map->CreateRigCamera(rig_camera);
+  }
+  reference.GetCamera("camera").SetParameterValue(
+      geometry::Camera::Parameters::Focal, 0.8);
+
+  // 'reference' is 'to_align' transformed by X -> s * R * X + t
+  const double s = 2.0;
+  const Mat3d R = geometry::VectorToRotationMatrix(Vec3d(0.1, -0.2, 0.3));
+  const Vec3d t(1.0, 2.0, 3.0);
+  const int num_shots = 10;
+  for (int i = 0; i < num_shots; ++i) {
+    const auto shot_id = std::to_string(i);
+    geometry::Pose pose(Vec3d(0.05 * i, 0.1, 0.0));
+    pose.SetOrigin(Vec3d(i, 0.1 * i, 0.0));
+    CreateShot(to_align, shot_id, pose);
+
+    const Mat3d R_wc = R * pose.RotationCameraToWorld();
+    const Vec3d origin = s * R * pose.GetOrigin() + t;
+    geometry::Pose reference_pose;
+    reference_pose.SetFromCameraToWorld(R_wc, origin);
+    CreateShot(reference, shot_id, reference_pose);
+    reference.GetShot(shot_id).scale = 1.0 / s;
+  }
+  CreateShot(to_align, "removed", geometry::Pose());
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> uniform(-5.0, 5.0);
+  std::vector<Vec3d> points;
+  for (int i = 0; i < 5000; ++i) {
+    const auto id = std::to_string(i);
+    points.emplace_back(uniform(generator), uniform(generator),
+                        uniform(generator));
+    to_align.CreateLandmark(id, points.back());
+    const map::Observation observation(0, 0, 1, 0, 0, 0, i);
+    to_align.AddObservation("removed", id, observation);
+    to_align.AddObservation(std::to_string(i % num_shots), id, observation);
+  }
+
+  sfm::retriangulation::RealignMaps(reference, to_align, true, 4);
+
+  ASSERT_FALSE(to_align.HasShot("removed"));
+  ASSERT_EQ(num_shots, to_align.NumberOfShots());
+  EXPECT_EQ(0.8, to_align.GetCamera("camera").GetParameterValue(
+                     geometry::Camera::Parameters::Focal));
+  for (int i = 0; i < num_shots; ++i) {
+    const auto shot_id = std::to_string(i);
+    const auto& shot = to_align.GetShot(shot_id);
+    const auto& expected = *reference.GetShot(shot_id).GetPose();
+    const Vec3d origin = shot.GetPose()->GetOrigin();
+    EXPECT_NEAR(0.0, (origin - expected.GetOrigin()).norm(), 1e-9);
+    EXPECT_DOUBLE_EQ(1.0 / s, shot.scale);
+  }
+  for (size_t i = 0; i < points.size(); ++i) {
+    const Vec3d expected = s * R * points[i] + t;
+    const Vec3d actual =
+        to_align.GetLandmark(std::to_string(i)).GetGlobalPos();
+    ASSERT_NEAR(0.0, (actual - expected).norm(), 1e-9);
+  }
+}
+}  // namespace
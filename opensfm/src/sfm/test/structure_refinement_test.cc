@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <sfm/structure_refinement.h>
+
+#include <random>
+
+namespace {
+
+class StructureRefinementFixture : public ::testing::Test {
+ public:
+  StructureRefinementFixture() {
+    auto perspective = geometry::Camera::CreatePerspectiveCamera(1.0, 0, 0);
+    perspective.id = "perspective";
+    map.CreateCamera(perspective);
+    auto spherical = geometry::Camera::CreateSphericalCamera();
+    spherical.id = "spherical";
+    map.CreateCamera(spherical);
+    map::RigCamera rig_camera;
+    rig_camera.id = "rig_camera";
+    map.CreateRigCamera(rig_camera);
+
+    // Shots along the X axis, looking toward +Z
+    for (int i = 0; i < num_shots; ++i) {
+      const auto shot_id = std::to_string(i);
+      geometry::Pose pose;
+      pose.SetOrigin(Vec3d(i, 0.2 * (i % 2), 0.0));
+      map.CreateRigInstance(shot_id);
+      map.CreateShot(shot_id, i % 3 ? "perspective" : "spherical",
+                     "rig_camera", shot_id, pose);
+    }
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> uniform(-3.0, 3.0);
+    for (int i = 0; i < num_points; ++i) {
+      const auto id = std::to_string(i);
+      const Vec3d point(uniform(generator), uniform(generator),
+                        10.0 + uniform(generator));
+      points.push_back(point);
+      map.CreateLandmark(id, point);
+      for (int j = 0; j < num_shots; ++j) {
+        const auto shot_id = std::to_string(j);
+        const Vec2d projection = map.GetShot(shot_id).Project(point);
+        const map::Observation observation(projection(0), projection(1),
+                                           0.004, 0, 0, 0, i);
+        map.AddObservation(shot_id, id, observation);
+      }
+    }
+  }
+
+  static constexpr int num_shots = 6;
+  static constexpr int num_points = 1000;
+  std::vector<Vec3d> points;
+  map::Map map;
+};
+
+TEST_F(StructureRefinementFixture, RecoversPerturbedPoints) {
+  std::mt19937 generator(7);
+  std::normal_distribution<double> normal(0.0, 0.1);
+  for (int i = 0; i < num_points; ++i) {
+    auto& landmark = map.GetLandmark(std::to_string(i));
+    landmark.SetGlobalPos(points[i] + Vec3d(normal(generator),
+                                            normal(generator),
+                                            normal(generator)));
+  }
+
+  sfm::structure_refinement::Parameters parameters;
+  parameters.num_threads = 4;
+  const auto statistics =
+      sfm::structure_refinement::RefineLandmarks(map, parameters);
+  ASSERT_EQ(num_points, statistics.num_points);
+  ASSERT_EQ(num_points, statistics.num_converged);
+  ASSERT_EQ(0, statistics.num_skipped);
+  ASSERT_LT(statistics.final_cost, 1e-12 * statistics.initial_cost);
+
+  for (int i = 0; i < num_points; ++i) {
+    const auto& landmark = map.GetLandmark(std::to_string(i));
+    ASSERT_NEAR(0.0, (landmark.GetGlobalPos() - points[i]).norm(), 1e-8);
+
+    const auto errors = landmark.GetReprojectionErrors();
+    ASSERT_EQ(num_shots, errors.size());
+    for (const auto& error : errors) {
+      const int size = std::stoi(error.first) % 3 ? 2 : 3;
+      ASSERT_EQ(size, error.second.size());
+      ASSERT_NEAR(0.0, error.second.norm(), 1e-9);
+    }
+  }
+}
+
+TEST_F(StructureRefinementFixture, ReportsConvergenceOnlyAtMinimum) {
+  // Far starting points, from which the first steps overshoot
+  std::mt19937 generator(3);
+  std::normal_distribution<double> normal(0.0, 2.0);
+  for (int i = 0; i < num_points; ++i) {
+    auto& landmark = map.GetLandmark(std::to_string(i));
+    landmark.SetGlobalPos(points[i] + Vec3d(normal(generator),
+                                            normal(generator),
+                                            normal(generator)));
+  }
+
+  // Two iterations can't reach the minimum : none of the points converged
+  sfm::structure_refinement::Parameters parameters;
+  parameters.loss_function = "CauchyLoss";
+  parameters.max_iterations = 2;
+  const auto first =
+      sfm::structure_refinement::RefineLandmarks(map, parameters);
+  ASSERT_EQ(0, first.num_converged);
+  ASSERT_LT(first.final_cost, first.initial_cost);
+
+  parameters.max_iterations = 100;
+  const auto second =
+      sfm::structure_refinement::RefineLandmarks(map, parameters);
+  ASSERT_EQ(num_points, second.num_converged);
+  for (int i = 0; i < num_points; ++i) {
+    const auto& landmark = map.GetLandmark(std::to_string(i));
+    ASSERT_NEAR(0.0, (landmark.GetGlobalPos() - points[i]).norm(), 1e-8);
+  }
+}
+
+TEST_F(StructureRefinementFixture, DownweightsOutliers) {
+  // One of the six observations of each point is an outlier
+  for (int i = 0; i < num_points; ++i) {
+    const auto id = std::to_string(i);
+    auto& shot = map.GetShot(std::to_string(1 + i % 2));
+    auto* observation = shot.GetLandmarkObservation(&map.GetLandmark(id));
+    observation->point += Vec2d(0.02, -0.02);
+  }
+
+  // Mean distance to the true points after refinement with a given loss
+  const auto refine = [this](const std::string& loss_function) {
+    for (int i = 0; i < num_points; ++i) {
+      map.GetLandmark(std::to_string(i)).SetGlobalPos(points[i]);
+    }
+    sfm::structure_refinement::Parameters parameters;
+    parameters.loss_function = loss_function;
+    parameters.max_iterations = 50;
+    sfm::structure_refinement::RefineLandmarks(map, parameters);
+    double error = 0.0;
+    for (int i = 0; i < num_points; ++i) {
+      const auto& landmark = map.GetLandmark(std::to_string(i));
+      error += (landmark.GetGlobalPos() - points[i]).norm();
+    }
+    return error / num_points;
+  };
+  ASSERT_LT(refine("CauchyLoss"), 0.2 * refine("TrivialLoss"));
+}
+
+TEST_F(StructureRefinementFixture, SkipsPointsSeenOnce) {
+  map.CreateLandmark("single", Vec3d(0.0, 0.0, 10.0));
+  map.AddObservation("1", "single",
+                     map::Observation(0.0, 0.0, 0.004, 0, 0, 0, num_points));
+
+  sfm::structure_refinement::Parameters parameters;
+  const auto statistics =
+      sfm::structure_refinement::RefineLandmarks(map, parameters);
+  ASSERT_EQ(num_points + 1, statistics.num_points);
+  ASSERT_EQ(1, statistics.num_skipped);
+  ASSERT_EQ(Vec3d(0.0, 0.0, 10.0), map.GetLandmark("single").GetGlobalPos());
+}
+
+TEST_F(StructureRefinementFixture, UnknownLossIsTrivial) {
+  // Like the bundle adjustment, unknown loss names fall back to no loss
+  const auto refine = [this](const std::string& loss_function) {
+    for (int i = 0; i < num_points; ++i) {
+      map.GetLandmark(std::to_string(i))
+          .SetGlobalPos(points[i] + Vec3d(0.1, -0.2, 0.3));
+    }
+    sfm::structure_refinement::Parameters parameters;
+    parameters.loss_function = loss_function;
+    parameters.loss_function_threshold = 1e-3;
+    parameters.max_iterations = 1;
+    return sfm::structure_refinement::RefineLandmarks(map, parameters)
+        .final_cost;
+  };
+  ASSERT_EQ(refine("TrivialLoss"), refine("UnknownLoss"));
+  ASSERT_NE(refine("CauchyLoss"), refine("UnknownLoss"));
+}
+}  // namespace
@@ -13,16 +13,12 @@ import matplotlib.cm as cm
 import matplotlib.colors as colors
 import matplotlib.pyplot as plt
 import numpy as np
-from opensfm import feature_loader, io, multiview, pygeometry, pymap, types
+from opensfm import feature_loader, io, multiview, pygeometry, pymap, pysfm, types
 from opensfm.dataset import DataSet, DataSetBase
 
 RESIDUAL_PIXEL_CUTOFF = 4
 
 
-def _norm2d(point: np.ndarray) -> float:
-    return math.sqrt(point[0] * point[0] + point[1] * point[1])
-
-
 def _length_histogram(
     tracks_manager: pymap.TracksManager, points: Dict[str, pymap.Landmark]
 ) -> Tuple[List[str], List[int]]:
@@ -107,19 +103,6 @@ def gcp_errors(
     return _gps_gcp_errors_stats(np.array(all_errors))
 
 
-def _compute_errors(
-    reconstructions: List[types.Reconstruction], tracks_manager: pymap.TracksManager
-) -> Any:
-    @lru_cache(10)
-    def _compute_errors_cached(index, error_type) -> Dict[str, Dict[str, np.ndarray]]:
-        return reconstructions[index].map.compute_reprojection_errors(
-            tracks_manager,
-            error_type,
-        )
-
-    return _compute_errors_cached
-
-
 def _get_valid_observations(
     reconstructions: List[types.Reconstruction], tracks_manager: pymap.TracksManager
 ) -> Any:
@@ -135,56 +118,38 @@ def _get_valid_observations(
 THist = Tuple[np.ndarray, np.ndarray]
 
 
-def _projection_error(
-    tracks_manager: pymap.TracksManager, reconstructions: List[types.Reconstruction]
-) -> Tuple[float, float, float, THist, THist, THist]:
-    all_errors_normalized, all_errors_pixels, all_errors_angular = [], [], []
-    average_error_normalized, average_error_pixels, average_error_angular = 0, 0, 0
-    for i in range(len(reconstructions)):
-        errors_normalized = _compute_errors(reconstructions, tracks_manager)(
-            i, pymap.ErrorType.Normalized
-        )
-        errors_unnormalized = _compute_errors(reconstructions, tracks_manager)(
-            i, pymap.ErrorType.Pixel
-        )
-        errors_angular = _compute_errors(reconstructions, tracks_manager)(
-            i, pymap.ErrorType.Angular
-        )
+def _projection_statistics(
+    tracks_manager: pymap.TracksManager,
+    reconstructions: List[types.Reconstruction],
+    num_threads: int,
+) -> Dict[str, Any]:
+    return pysfm.compute_projection_statistics(
+        [rec.map for rec in reconstructions],
+        tracks_manager,
+        pixel_cutoff=RESIDUAL_PIXEL_CUTOFF,
+        histogram_bins=30,
+        grid_buckets=40,
+        num_threads=num_threads,
+    )
 
-        for shot_id, shot_errors_normalized in errors_normalized.items():
-            shot = reconstructions[i].get_shot(shot_id)
-            normalizer = max(shot.camera.width, shot.camera.height)
 
-            for error_normalized, error_unnormalized, error_angular in zip(
-                shot_errors_normalized.values(),
-                errors_unnormalized[shot_id].values(),
-                errors_angular[shot_id].values(),
-            ):
-                norm_pixels = _norm2d(error_unnormalized * normalizer)
-                norm_normalized = _norm2d(error_normalized)
-                norm_angle = error_angular[0]
-                if norm_pixels > RESIDUAL_PIXEL_CUTOFF or math.isnan(norm_angle):
-                    continue
-                average_error_normalized += norm_normalized
-                average_error_pixels += norm_pixels
-                average_error_angular += norm_angle
-                all_errors_normalized.append(norm_normalized)
-                all_errors_pixels.append(norm_pixels)
-                all_errors_angular.append(norm_angle)
-
-    error_count = len(all_errors_normalized)
-    if error_count == 0:
+def _projection_error(
+    tracks_manager: pymap.TracksManager,
+    reconstructions: List[types.Reconstruction],
+    num_threads: int = 1,
+) -> Tuple[float, float, float, THist, THist, THist]:
+    statistics = _projection_statistics(tracks_manager, reconstructions, num_threads)
+    if statistics["count"] == 0:
         dummy = (np.array([]), np.array([]))
         return (-1.0, -1.0, -1.0, dummy, dummy, dummy)
 
-    bins = 30
     return (
-        average_error_normalized / error_count,
-        average_error_pixels / error_count,
-        average_error_angular / error_count,
-        np.histogram(all_errors_normalized, bins),
-        np.histogram(all_errors_pixels, bins),
-        np.histogram(all_errors_angular, bins),
+        statistics["mean_normalized"],
+        statistics["mean_pixels"],
+        statistics["mean_angular"],
+        statistics["histogram_normalized"],
+        statistics["histogram_pixels"],
+        statistics["histogram_angular"],
     )
 
 
@@ -250,7 +215,7 @@ def reconstruction_statistics(
         (hist_normalized, bins_normalized),
         (hist_pixels, bins_pixels),
         (hist_angular, bins_angular),
-    ) = _projection_error(tracks_manager, reconstructions)
+    ) = _projection_error(tracks_manager, reconstructions, data.config["processes"])
     stats["reprojection_error_normalized"] = avg_normalized
     stats["reprojection_error_pixels"] = avg_pixels
     stats["reprojection_error_angular"] = avg_angular
@@ -456,14 +421,6 @@ def compute_all_statistics(
     return stats
 
 
-def _grid_buckets(camera: pygeometry.Camera) -> Tuple[int, int]:
-    buckets = 40
-    if camera.projection_type == "spherical":
-        return 2 * buckets, buckets
-    else:
-        return buckets, buckets
-
-
 def _heatmap_buckets(camera: pygeometry.Camera) -> Tuple[int, int]:
     buckets = 500
     if camera.projection_type == "spherical":
@@ -872,62 +829,25 @@ def save_residual_grids(
     output_path: str,
     io_handler: io.IoFilesystemBase,
 ) -> None:
-    all_errors = {}
-
     scaling = 4
-    for rec in reconstructions:
-        for camera_id in rec.cameras:
-            all_errors[camera_id] = []
-
-    for i in range(len(reconstructions)):
-        valid_observations = _get_valid_observations(reconstructions, tracks_manager)(i)
-        errors_scaled = _compute_errors(reconstructions, tracks_manager)(
-            i, pymap.ErrorType.Normalized
-        )
-        errors_unscaled = _compute_errors(reconstructions, tracks_manager)(
-            i, pymap.ErrorType.Pixel
-        )
-
-        for shot_id, shot_errors in errors_scaled.items():
-            shot = reconstructions[i].get_shot(shot_id)
-            w = shot.camera.width
-            h = shot.camera.height
-            center = np.array([w / 2.0, h / 2.0])
-            normalizer = max(shot.camera.width, shot.camera.height)
-
-            buckets_x, buckets_y = _grid_buckets(shot.camera)
-            w_bucket = buckets_x / w
-            h_bucket = buckets_y / h
-
-            shots_errors = []
-            for error_scaled, error_unscaled, observation in zip(
-                shot_errors.values(),
-                errors_unscaled[shot_id].values(),
-                valid_observations[shot_id].values(),
-            ):
-                if _norm2d(error_unscaled * normalizer) > RESIDUAL_PIXEL_CUTOFF:
-                    continue
-
-                bucket = observation.point * normalizer + center
-                x = max([0, min([int(bucket[0] * w_bucket), buckets_x - 1])])
-                y = max([0, min([int(bucket[1] * h_bucket), buckets_y - 1])])
+    statistics = _projection_statistics(
+        tracks_manager, reconstructions, data.config["processes"]
+    )
 
-                shots_errors.append((x, y, error_scaled))
-            all_errors[shot.camera.id] += shots_errors
+    cameras = {}
+    for rec in reconstructions:
+        cameras.update(rec.cameras)
 
-    for camera_id, errors in all_errors.items():
-        if not errors:
+    for camera_id, camera_statistics in statistics["cameras"].items():
+        grid_counts = camera_statistics["grid_counts"]
+        if not grid_counts.any():
             continue
-        buckets_x, buckets_y = _grid_buckets(rec.cameras[camera_id])
-        camera_array_res = np.zeros((buckets_y, buckets_x, 2))
-        camera_array_count = np.full((buckets_y, buckets_x, 1), 1)
-        for x, y, e in errors:
-            camera_array_res[y, x] += e
-            camera_array_count[y, x, 0] += 1
-        camera_array_res = np.divide(camera_array_res, camera_array_count)
-        camera = rec.get_camera(camera_id)
+        buckets_y, buckets_x = grid_counts.shape
+        camera_array_res = np.divide(
+            camera_statistics["grid_errors"], grid_counts[:, :, np.newaxis] + 1
+        )
+        camera = cameras[camera_id]
         w, h = camera.width, camera.height
-        normalizer = max(w, h)
 
         clamp = 0.1
         res_colors = np.linalg.norm(camera_array_res[:, :, :2], axis=2)
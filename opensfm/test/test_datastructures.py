@@ -1,5 +1,6 @@
 # pyre-unsafe
 import copy
+import pickle
 
 import random
 from typing import Tuple
@@ -871,18 +872,31 @@ def test_point_add_from_point() -> None:
 
 
 def test_point_reproj_errors_assign() -> None:
-    # Given some created point
-    rec = _create_reconstruction(n_points=1)
+    # Given some created point, seen by two shots
+    rec = _create_reconstruction(1, n_shots_cam={"0": 2}, n_points=1)
     pt = rec.points["0"]
+    for shot_id in ("0", "1"):
+        obs = pymap.Observation(100, 200, 0.5, 255, 0, 0, 100)
+        rec.add_observation(shot_id, "0", obs)
 
     # When assigning reprojections errors
-    reproj_errors = dict({"shot1": np.random.rand(2), "shot2": np.random.rand(2)})
+    reproj_errors = dict({"0": np.random.rand(2), "1": np.random.rand(2)})
     pt.reprojection_errors = reproj_errors
 
     # They should be correct
     for k in reproj_errors.keys():
         assert np.allclose(pt.reprojection_errors[k], reproj_errors[k])
 
+    # ... also when read flat from the map
+    landmark_ids, shot_ids, errors = rec.map.get_reprojection_errors()
+    assert landmark_ids == ["0", "0"]
+    for shot_id, error in zip(shot_ids, errors):
+        assert np.allclose(error, reproj_errors[shot_id])
+
+    # Errors can only be set for shots observing the point
+    with pytest.raises(RuntimeError):
+        pt.reprojection_errors = {"2": np.random.rand(2)}
+
 
 def test_point_delete_non_existing() -> None:
     # Given some created points
@@ -1107,6 +1121,36 @@ def test_rec_deepcopy() -> None:
     assert_maps_equal(rec.map, rec2.map)
 
 
+def test_map_and_tracks_manager_pickle() -> None:
+    # Given a reconstruction with everything (shots, pano shots, metadata)
+    rec = _create_reconstruction(
+        n_cameras=2,
+        n_shots_cam={"0": 50, "1": 40},
+        n_pano_shots_cam={"0": 20, "1": 30},
+        n_points=200,
+        dist_to_shots=True,
+    )
+    for shot in rec.shots.values():
+        _helper_populate_metadata(shot.metadata)
+    tracks_manager = rec.map.to_tracks_manager()
+
+    # When we pickle them, with buffers sent out-of-band for protocol 5
+    for protocol in (2, 5):
+        buffers = []
+        callback = buffers.append if protocol >= 5 else None
+        data = pickle.dumps(
+            (rec.map, tracks_manager), protocol, buffer_callback=callback
+        )
+        map2, tracks_manager2 = pickle.loads(data, buffers=buffers)
+
+        # They are unchanged
+        assert len(buffers) == (2 if protocol >= 5 else 0)
+        assert_maps_equal(rec.map, map2)
+        assert sorted(tracks_manager2.as_string().splitlines()) == sorted(
+            tracks_manager.as_string().splitlines()
+        )
+
+
 def test_gcp() -> None:
     gcp = []
     for i in range(0, 10):
@@ -0,0 +1,74 @@
+# pyre-unsafe
+import numpy as np
+from opensfm import config, features, pyfeatures
+
+
+def synthetic_image() -> np.ndarray:
+    """Gray image of blobs of various contrasts, whose detection needs
+    decreasing peak thresholds."""
+    rng = np.random.RandomState(42)
+    height, width = 240, 320
+    image = np.full((height, width), 128.0)
+    ys, xs = np.mgrid[:height, :width]
+    for _ in range(300):
+        x, y = rng.uniform(10, width - 10), rng.uniform(10, height - 10)
+        sigma = rng.uniform(1.5, 4.0)
+        amplitude = rng.choice([-1, 1]) * rng.uniform(2, 100)
+        image += amplitude * np.exp(-((xs - x) ** 2 + (ys - y) ** 2) / (2 * sigma**2))
+    return image.clip(0, 255).astype(np.uint8)
+
+
+def test_sift_reuse_scale_space_reaches_features_count() -> None:
+    image = synthetic_image()
+    conf = config.default_config()
+    features_count = 400
+
+    detector, _ = features._create_sift(conf, conf["sift_peak_threshold"])
+    assert len(detector.detect(image)) < features_count
+
+    conf["feature_reuse_scale_space"] = False
+    retry_points, _ = features.extract_features_sift(image, conf, features_count)
+    assert len(retry_points) >= features_count
+
+    conf["feature_reuse_scale_space"] = True
+    reuse_points, _ = features.extract_features_sift(image, conf, features_count)
+    assert len(reuse_points) >= features_count
+
+
+def test_select_sift_points_above_threshold() -> None:
+    image = synthetic_image()
+    conf = config.default_config()
+    threshold = conf["sift_peak_threshold"]
+
+    # Enough points at the initial threshold : it is kept
+    points = features._select_sift_points(image, conf, 1, threshold)
+    contrasts = [p.response * conf["sift_octave_layers"] for p in points]
+    assert len(points) > 0
+    assert min(contrasts) >= threshold
+
+
+def test_hahog_min_peak_threshold_filters_points() -> None:
+    image = synthetic_image().astype(np.float32) / 255
+
+    def count(target_num_features: int, min_peak_threshold: float) -> int:
+        points, _ = pyfeatures.hahog(
+            image,
+            peak_threshold=1e-2,
+            edge_threshold=10,
+            target_num_features=target_num_features,
+            min_peak_threshold=min_peak_threshold,
+        )
+        return len(points)
+
+    # Without lowering the threshold, the target isn't reached
+    target = 800
+    assert count(target, 0.0) < target
+
+    # Lowering it enough reaches the target, and lowering it less filters
+    # points
+    assert count(target, 1e-6) >= target
+    assert count(target, 1e-3) < target
+    counts = [count(100000, t) for t in (1e-6, 1e-4, 1e-3, 1e-2)]
+    assert counts == sorted(counts, reverse=True)
+    assert counts[0] > counts[-1]
+    assert counts[-1] == count(100000, 0.0)
@@ -186,6 +186,30 @@ def test_outliers_similarity_ransac() -> None:
     )
 
 
+def test_outliers_plane_ransac() -> None:
+    samples = 100
+    normal = np.array([0.5, 0.2, -1.0])
+    x = np.random.rand(samples, 3) * 10
+    x[:, 2] = 0.5 * x[:, 0] + 0.2 * x[:, 1] + 1.0
+
+    ratio_outliers = 0.3
+    outliers = np.random.permutation(samples)[: int(ratio_outliers * samples)]
+    x[outliers, 2] += np.random.uniform(2.0, 5.0, size=len(outliers))
+
+    # Two directions on the plane, and one along its normal
+    vectors = np.array([[1.0, 0.0, 0.5], [0.0, 2.0, 0.4], normal])
+
+    params = pyrobust.RobustEstimatorParams()
+    result = pyrobust.ransac_plane(
+        x, vectors, 0.1, 5.0, params, pyrobust.RansacType.RANSAC
+    )
+
+    inliers = set(result.inliers_indices)
+    assert inliers == (set(range(samples + 2)) - set(outliers))
+    plane = result.lo_model
+    assert np.isclose(abs(plane[:3].dot(normal)), np.linalg.norm(normal))
+
+
 def test_uniform_essential_ransac(pairs_and_their_E) -> None:
     for f1, f2, _, _ in pairs_and_their_E:
         points = np.concatenate((f1, f2), axis=1)
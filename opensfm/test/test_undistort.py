@@ -1,6 +1,7 @@
 # pyre-unsafe
 import itertools
 
+import cv2
 import numpy as np
 from opensfm import pygeometry, types, undistort
 
@@ -33,3 +34,57 @@ def test_perspective_views_of_a_panorama() -> None:
         else:
             assert not np.allclose(shot.pose.rotation, spherical_shot.pose.rotation)
     assert front_found
+
+
+def test_render_perspective_views_of_a_panorama() -> None:
+    reconstruction = types.Reconstruction()
+    camera = pygeometry.Camera.create_spherical()
+    camera.id = "spherical_camera"
+    camera.width = 400
+    camera.height = 200
+    reconstruction.add_camera(camera)
+    pose = pygeometry.Pose(np.array([0.1, 0.2, 0.3]))
+    spherical_shot = reconstruction.create_shot("shot1", camera.id, pose=pose)
+
+    urec = types.Reconstruction()
+    shots = undistort.perspective_views_of_a_panorama(
+        spherical_shot, 50, urec, "jpg", itertools.count()
+    )
+
+    # Pixels of the panorama encode their coordinates
+    height, width = 200, 400
+    y, x = np.indices((height, width))
+    image = np.dstack([x % 256, y % 256, x // 256]).astype(np.uint8)
+
+    views = undistort.render_perspective_views_of_a_panorama(
+        image, spherical_shot, shots, cv2.INTER_NEAREST
+    )
+    assert len(views) == 6
+
+    for shot, view in zip(shots, views):
+        assert view.shape == (50, 50, 3)
+        v, u = np.indices((50, 50))
+        pixels = np.column_stack([u.ravel(), v.ravel()])
+        bearings = shot.camera.pixel_bearing_many(
+            shot.camera.pixel_to_normalized_coordinates_many(pixels)
+        )
+        rotation = spherical_shot.pose.get_rotation_matrix().dot(
+            shot.pose.get_rotation_matrix().T
+        )
+        expected = camera.normalized_to_pixel_coordinates_many(
+            camera.project_many(bearings.dot(rotation.T))
+        )
+        rendered = view.reshape(-1, 3).astype(int)
+        rendered_x = rendered[:, 0] + 256 * rendered[:, 2]
+        rendered_y = rendered[:, 1]
+        # Views across the panorama seam wrap around
+        dx = (rendered_x - expected[:, 0] + width / 2) % width - width / 2
+        assert np.all(np.abs(dx) <= 1)
+        assert np.all(np.abs(rendered_y - expected[:, 1]) <= 1)
+
+    # Grids are reused for the next panoramas
+    cached = undistort.panorama_renderer.num_cached_grids()
+    undistort.render_perspective_views_of_a_panorama(
+        image, spherical_shot, shots, cv2.INTER_NEAREST
+    )
+    assert undistort.panorama_renderer.num_cached_grids() == cached
@@ -0,0 +1,69 @@
+# pyre-unsafe
+"""Tracing of the native hot paths.
+
+Each native module records its own events on a common clock. This module
+switches recording on/off for all of them and merges their events into a
+single Chrome trace (chrome://tracing or https://ui.perfetto.dev).
+"""
+import contextlib
+from typing import Iterator, List
+
+from opensfm import (
+    io,
+    pybundle,
+    pydense,
+    pyfeatures,
+    pymap,
+    pyrobust,
+    pysfm,
+)
+
+
+NATIVE_MODULES = [pybundle, pydense, pyfeatures, pymap, pyrobust, pysfm]
+
+
+def enable() -> None:
+    """Start recording events in all the native modules."""
+    for module in NATIVE_MODULES:
+        module.set_tracing_enabled(True)
+
+
+def disable() -> None:
+    """Stop recording events in all the native modules."""
+    for module in NATIVE_MODULES:
+        module.set_tracing_enabled(False)
+
+
+def clear() -> None:
+    """Discard the events recorded so far."""
+    for module in NATIVE_MODULES:
+        module.clear_tracing()
+
+
+def chrome_trace() -> str:
+    """Recorded events of all the native modules as a Chrome trace JSON."""
+    events: List[str] = []
+    for module in NATIVE_MODULES:
+        module_events = module.get_tracing_events()
+        if module_events:
+            events.append(module_events)
+    return '{"traceEvents":[\n' + ",\n".join(events) + "\n]}\n"
+
+
+def save_chrome_trace(path: str) -> None:
+    """Write the recorded events as a Chrome trace JSON file."""
+    with io.open_wt(path) as fout:
+        fout.write(chrome_trace())
+
+
+@contextlib.contextmanager
+def traced(path: str) -> Iterator[None]:
+    """Record the events of a block of code and save them at path."""
+    clear()
+    enable()
+    try:
+        yield
+    finally:
+        disable()
+        save_chrome_trace(path)
+        clear()
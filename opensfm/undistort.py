@@ -6,9 +6,9 @@ from typing import Dict, Iterator, List, Optional
 import cv2
 import numpy as np
 from opensfm import (
-    features,
     features_processing,
     log,
+    pyfeatures,
     pygeometry,
     pymap,
     transformations as tf,
@@ -20,6 +20,9 @@ from opensfm.dataset_base import DataSetBase
 
 logger: logging.Logger = logging.getLogger(__name__)
 
+# Remap grids of the panorama views, shared by all the panoramas
+panorama_renderer = pyfeatures.PanoramaRenderer()
+
 
 def undistort_reconstruction(
     tracks_manager: Optional[pymap.TracksManager],
@@ -201,13 +204,13 @@ def undistort_image(
         height = width // 2
         image = cv2.resize(original, (width, height), interpolation=interpolation)
         mint = cv2.INTER_LINEAR if interpolation == cv2.INTER_AREA else interpolation
-        res = {}
-        for undistorted_shot in undistorted_shots:
-            undistorted = render_perspective_view_of_a_panorama(
-                image, shot, undistorted_shot, mint
-            )
-            res[undistorted_shot.id] = scale_image(undistorted, max_size)
-        return res
+        views = render_perspective_views_of_a_panorama(
+            image, shot, undistorted_shots, mint
+        )
+        return {
+            undistorted_shot.id: scale_image(undistorted, max_size)
+            for undistorted_shot, undistorted in zip(undistorted_shots, views)
+        }
     else:
         raise NotImplementedError(
             "Undistort not implemented for projection type: {}".format(
@@ -352,6 +355,35 @@ def perspective_views_of_a_panorama(
     return shots
 
 
+def render_perspective_views_of_a_panorama(
+    image: np.ndarray,
+    panoshot: pymap.Shot,
+    perspectiveshots: List[pymap.Shot],
+    interpolation=cv2.INTER_LINEAR,
+    borderMode=cv2.BORDER_WRAP,
+) -> List[np.ndarray]:
+    """Render perspective views of a panorama.
+
+    The remap grids from the views to the panorama are cached and reused
+    for the next panoramas having the same cameras and views.
+    """
+    rotations = [
+        np.dot(
+            panoshot.pose.get_rotation_matrix(),
+            perspectiveshot.pose.get_rotation_matrix().T,
+        )
+        for perspectiveshot in perspectiveshots
+    ]
+    return panorama_renderer.render(
+        image,
+        panoshot.camera,
+        [perspectiveshot.camera for perspectiveshot in perspectiveshots],
+        rotations,
+        interpolation,
+        borderMode,
+    )
+
+
 def render_perspective_view_of_a_panorama(
     image: np.ndarray,
     panoshot: pymap.Shot,
@@ -360,41 +392,10 @@ def render_perspective_view_of_a_panorama(
     borderMode=cv2.BORDER_WRAP,
 ) -> np.ndarray:
     """Render a perspective view of a panorama."""
-    # Get destination pixel coordinates
-    dst_shape = (perspectiveshot.camera.height, perspectiveshot.camera.width)
-    dst_y, dst_x = np.indices(dst_shape).astype(np.float32)
-    dst_pixels_denormalized = np.column_stack([dst_x.ravel(), dst_y.ravel()])
-
-    dst_pixels = features.normalized_image_coordinates(
-        dst_pixels_denormalized,
-        perspectiveshot.camera.width,
-        perspectiveshot.camera.height,
-    )
-
-    # Convert to bearing
-    dst_bearings = perspectiveshot.camera.pixel_bearing_many(dst_pixels)
-
-    # Rotate to panorama reference frame
-    rotation = np.dot(
-        panoshot.pose.get_rotation_matrix(),
-        perspectiveshot.pose.get_rotation_matrix().T,
-    )
-    rotated_bearings = np.dot(dst_bearings, rotation.T)
-
-    # Project to panorama pixels
-    src_pixels = panoshot.camera.project_many(rotated_bearings)
-    src_pixels_denormalized = features.denormalized_image_coordinates(
-        src_pixels, image.shape[1], image.shape[0]
+    [view] = render_perspective_views_of_a_panorama(
+        image, panoshot, [perspectiveshot], interpolation, borderMode
     )
-
-    src_pixels_denormalized.shape = dst_shape + (2,)
-
-    # Sample color
-    x = src_pixels_denormalized[..., 0].astype(np.float32)
-    y = src_pixels_denormalized[..., 1].astype(np.float32)
-    colors = cv2.remap(image, x, y, interpolation, borderMode=borderMode)
-
-    return colors
+    return view
 
 
 def add_subshot_tracks(